@@ -0,0 +1,30 @@
+# Try to find zstd
+# Once done, this will define
+#
+# ZSTD_FOUND - system has zstd
+# ZSTD_INCLUDE_DIRS - the zstd include directories
+# ZSTD_LIBRARIES - zstd libraries directories
+
+find_path( ZSTD_INCLUDE_DIR zstd.h
+  HINTS
+  ${ZSTD_DIR}
+  $ENV{ZSTD_DIR}
+  /usr
+  /opt
+  PATH_SUFFIXES include
+)
+
+find_library( ZSTD_LIBRARY zstd
+  HINTS
+  ${ZSTD_DIR}
+  $ENV{ZSTD_DIR}
+  /usr
+  /opt
+  PATH_SUFFIXES lib
+)
+
+set(ZSTD_INCLUDE_DIRS ${ZSTD_INCLUDE_DIR})
+set(ZSTD_LIBRARIES ${ZSTD_LIBRARY})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd DEFAULT_MSG ZSTD_INCLUDE_DIRS ZSTD_LIBRARIES)
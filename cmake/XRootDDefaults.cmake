@@ -25,4 +25,6 @@ option( PYPI_BUILD       "The project is being built for PyPI release"
 option( ENABLE_VOMS      "Enable VOMS plug-in if possible."                               TRUE )
 option( ENABLE_XRDEC     "Enable erasure coding component."                               FALSE )
 option( ENABLE_ASAN      "Enable adress sanitizer."                                       FALSE )
+option( ENABLE_ZSTD      "Enable the zstd compression codec for ZIP archives."            FALSE )
 define_default( XRD_PYTHON_REQ_VERSION 2.4 )
+define_default( CMS_MAX_NODES 64 )
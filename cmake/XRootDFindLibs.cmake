@@ -19,6 +19,14 @@ if( ZLIB_FOUND )
   add_definitions( -DHAVE_LIBZ )
 endif()
 
+if( ENABLE_ZSTD )
+  find_package( Zstd REQUIRED )
+  add_definitions( -DHAVE_ZSTD )
+  include_directories( ${ZSTD_INCLUDE_DIRS} )
+else()
+  set( ZSTD_LIBRARIES "" )
+endif()
+
 find_package( TinyXml )
 
 find_package( LibXml2 )
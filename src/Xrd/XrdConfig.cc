@@ -1452,6 +1452,12 @@ bool XrdConfig::SetupTLS()
 //
    if (!xrdTLS.isOK()) return false;
 
+// Indicate whether or not the kernel will be doing the encryption
+//
+   if (tlsOpts & XrdTlsContext::ktlON)
+      Log.Say("Config kernel TLS offload ",
+              (xrdTLS.kernelTLS() ? "enabled." : "unavailable; using openssl."));
+
 // Set address of out TLS object in the global area
 //
    XrdGlobal::tlsCtx = &xrdTLS;
@@ -2310,6 +2316,8 @@ int XrdConfig::xtcpmon(XrdSysError *eDest, XrdOucStream &Config)
              <opts>   options:
                       [no]detail       do [not] print TLS library msgs
                       hsto <sec>       handshake timeout (default 10).
+                      [no]ktls         do [not] use kernel TLS offload when
+                                       the kernel supports it (default noktls).
 
    Output: 0 upon success or 1 upon failure.
 */
@@ -2339,6 +2347,8 @@ int XrdConfig::xtls(XrdSysError *eDest, XrdOucStream &Config)
 
 do {     if (!strcmp(val,   "detail")) SSLmsgs = true;
     else if (!strcmp(val, "nodetail")) SSLmsgs = false;
+    else if (!strcmp(val,   "ktls"))   tlsOpts |=  XrdTlsContext::ktlON;
+    else if (!strcmp(val, "noktls"))   tlsOpts &= ~XrdTlsContext::ktlON;
     else if (!strcmp(val, "hsto" ))
             {if (!(val = Config.GetWord()))
                 {eDest->Emsg("Config", "tls hsto value not specified");
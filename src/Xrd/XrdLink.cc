@@ -122,6 +122,7 @@ void XrdLink::ResetLink()
    Instance =  0;
    isBridged= false;
    isTLS    = false;
+   isKTLS   = false;
 }
 
 /******************************************************************************/
@@ -330,8 +331,8 @@ bool XrdLink::Register(const char *hName)
   
 int XrdLink::Send(const char *Buff, int Blen)
 {
-   if (isTLS) return linkXQ.TLS_Send(Buff, Blen);
-   else       return linkXQ.Send    (Buff, Blen);
+   if (isTLS && !isKTLS) return linkXQ.TLS_Send(Buff, Blen);
+   else                  return linkXQ.Send    (Buff, Blen);
 }
 
 /******************************************************************************/
@@ -342,10 +343,10 @@ int XrdLink::Send(const struct iovec *iov, int iocnt, int bytes)
 //
    if (!bytes) for (int i = 0; i < iocnt; i++) bytes += iov[i].iov_len;
 
-// Execute the send
+// Execute the send. With kernel TLS the socket itself produces the records.
 //
-   if (isTLS) return linkXQ.TLS_Send(iov, iocnt, bytes);
-   else       return linkXQ.Send    (iov, iocnt, bytes);
+   if (isTLS && !isKTLS) return linkXQ.TLS_Send(iov, iocnt, bytes);
+   else                  return linkXQ.Send    (iov, iocnt, bytes);
 }
  
 /******************************************************************************/
@@ -359,10 +360,10 @@ int XrdLink::Send(const sfVec *sfP, int sfN)
        return -1;
       }
 
-// Do the send
+// Do the send. With kernel TLS we can use sendfile() as is.
 //
-   if (isTLS) return linkXQ.TLS_Send(sfP, sfN);
-   else       return linkXQ.Send    (sfP, sfN);
+   if (isTLS && !isKTLS) return linkXQ.TLS_Send(sfP, sfN);
+   else                  return linkXQ.Send    (sfP, sfN);
 }
 
 /******************************************************************************/
@@ -564,6 +564,17 @@ bool            hasBridge() const {return isBridged;}
 
 bool            hasTLS() const {return isTLS;}
 
+//-----------------------------------------------------------------------------
+//! Determine if this link offloads TLS transmission to the kernel (kTLS).
+//! When true, data sent on the link is encrypted by the kernel and zero-copy
+//! methods such as Send(sfVec) do not require a user-space bounce buffer.
+//!
+//! @return true    outgoing TLS records are produced by the kernel.
+//! @return false   the link does not use TLS or encrypts in user space.
+//-----------------------------------------------------------------------------
+
+bool            hasKTLS() const {return isKTLS;}
+
 //-----------------------------------------------------------------------------
 //! Return TLS protocol version being used.
 //!
@@ -594,6 +605,7 @@ char           *HostName;     // Pointer to the hostname
 unsigned int    Instance;     // Instance number of this object
 bool            isBridged;    // If true, this link is an in-memory bridge
 bool            isTLS;        // If true, this link uses TLS for all I/O
-char            rsvd2[2];
+bool            isKTLS;       // If true, the kernel encrypts what we send
+char            rsvd2[1];
 };
 #endif
@@ -115,6 +115,8 @@ using namespace XrdGlobal;
        int             XrdLinkXeq::LinkTimeOuts  = 0;
        int             XrdLinkXeq::LinkStalls    = 0;
        int             XrdLinkXeq::LinkSfIntr    = 0;
+       long long       XrdLinkXeq::LinkTlsOut    = 0;
+       long long       XrdLinkXeq::LinkTlsRecs   = 0;
        XrdSysMutex     XrdLinkXeq::statsMutex;
 
 /******************************************************************************/
@@ -136,6 +138,8 @@ void XrdLinkXeq::Reset()
    stallCnt = stallCntTot = 0;
    tardyCnt = tardyCntTot = 0;
    SfIntr   = 0;
+   TlsOut   = 0;
+   TlsRecs  = 0;
    isIdle   = 0;
    BytesOut = BytesIn = BytesOutTot = BytesInTot = 0;
    LockReads= false;
@@ -1004,7 +1008,7 @@ bool XrdLinkXeq::setTLS(bool enable, XrdTlsContext *ctx)
 //
    if (!enable)
       {tlsIO.Shutdown();
-       isTLS = enable;
+       isTLS = isKTLS = false;
        Addr.SetTLS(enable);
        return true;
       }
@@ -1031,8 +1035,10 @@ bool XrdLinkXeq::setTLS(bool enable, XrdTlsContext *ctx)
 //
    if (rc != XrdTls::TLS_AOK) Log.Emsg("LinkXeq", eMsg.c_str());
       else {isTLS = enable;
+            isKTLS = tlsIO.KernelSend();
             Addr.SetTLS(enable);
-            Log.Emsg("LinkXeq", ID, "connection upgraded to", verTLS());
+            Log.Emsg("LinkXeq", ID, (isKTLS ? "connection upgraded to kernel"
+                                            : "connection upgraded to"), verTLS());
            }
    return rc == XrdTls::TLS_AOK;
 }
@@ -1088,12 +1094,12 @@ int XrdLinkXeq::Stats(char *buff, int blen, bool do_sync)
    static const char statfmt[] = "<stats id=\"link\"><num>%d</num>"
           "<maxn>%d</maxn><tot>%lld</tot><in>%lld</in><out>%lld</out>"
           "<ctime>%lld</ctime><tmo>%d</tmo><stall>%d</stall>"
-          "<sfps>%d</sfps></stats>";
+          "<sfps>%d</sfps><tlsout>%lld</tlsout><tlsrec>%lld</tlsrec></stats>";
    int i;
 
 // Check if actual length wanted
 //
-   if (!buff) return sizeof(statfmt)+17*6;
+   if (!buff) return sizeof(statfmt)+17*8;
 
 // We must synchronize the statistical counters
 //
@@ -1110,7 +1116,9 @@ int XrdLinkXeq::Stats(char *buff, int blen, bool do_sync)
                                      AtomicGet(LinkConTime),
                                      AtomicGet(LinkTimeOuts),
                                      AtomicGet(LinkStalls),
-                                     AtomicGet(LinkSfIntr));
+                                     AtomicGet(LinkSfIntr),
+                                     AtomicGet(LinkTlsOut),
+                                     AtomicGet(LinkTlsRecs));
    AtomicEnd(statsMutex);
    return i;
 }
@@ -1161,6 +1169,10 @@ void XrdLinkXeq::syncStats(int *ctime)
    AtomicAdd(LinkBytesOut, tmpLL); AtomicAdd(BytesOutTot, tmpLL);
    tmpI4 = AtomicFAZ(SfIntr);
    AtomicAdd(LinkSfIntr, tmpI4);
+   tmpLL = AtomicFAZ(TlsOut);
+   AtomicAdd(LinkTlsOut, tmpLL);
+   tmpI4 = AtomicFAZ(TlsRecs);
+   AtomicAdd(LinkTlsRecs, tmpI4);
    AtomicEnd(statsMutex); AtomicEnd(wrMutex);
 
 // Make sure the protocol updates it's statistics as well
@@ -1346,9 +1358,6 @@ int XrdLinkXeq::TLS_RecvAll(char *Buff, int Blen, int timeout)
 int XrdLinkXeq::TLS_Send(const char *Buff, int Blen)
 {
    XrdSysMutexHelper lck(wrMutex);
-   ssize_t bytesleft = Blen;
-   XrdTls::RC retc;
-   int byteswritten;
 
 // Prepare to send
 //
@@ -1361,11 +1370,7 @@ int XrdLinkXeq::TLS_Send(const char *Buff, int Blen)
 
 // Write the data out
 //
-   while(bytesleft)
-        {retc = tlsIO.Write(Buff, bytesleft, byteswritten);
-         if (retc != XrdTls::TLS_AOK) return TLS_Error("send to", retc);
-         bytesleft -= byteswritten; Buff += byteswritten;
-        }
+   if (!TLS_Write(Buff, Blen)) return -1;
 
 // All done
 //
@@ -1378,7 +1383,7 @@ int XrdLinkXeq::TLS_Send(const struct iovec *iov, int iocnt, int bytes)
 {
    XrdSysMutexHelper lck(wrMutex);
    XrdTls::RC retc;
-   int byteswritten;
+   int byteswritten, records;
 
 // Get a lock and assume we will be successful (statistically we are). Note
 // that the calling interface gauranteed bytes are not zero.
@@ -1390,17 +1395,12 @@ int XrdLinkXeq::TLS_Send(const struct iovec *iov, int iocnt, int bytes)
 //
    if (sendQ) return sendQ->Send(iov, iocnt, bytes);
 
-// Write the data out.
+// Write the data out. The pieces are packed into as few records as possible
+// as a response header would otherwise be a record (and segment) by itself.
 //
-   for (int i = 0; i < iocnt; i++)
-       {ssize_t bytesleft = iov[i].iov_len;
-        char *Buff = (char *)iov[i].iov_base;
-        while(bytesleft)
-             {retc = tlsIO.Write(Buff, bytesleft, byteswritten);
-              if (retc != XrdTls::TLS_AOK) return TLS_Error("send to", retc);
-              bytesleft -= byteswritten; Buff += byteswritten;
-             }
-       }
+   retc = tlsIO.Write(iov, iocnt, byteswritten, records);
+   AtomicAdd(TlsOut, byteswritten); AtomicAdd(TlsRecs, records);
+   if (retc != XrdTls::TLS_AOK) return TLS_Error("send to", retc);
 
 // All done
 //
@@ -1430,13 +1430,13 @@ int XrdLinkXeq::TLS_Send(const sfVec *sfP, int sfN)
            }
         offset = sfP->offset;
         fileFD = sfP->fdnum;
-        buffsz = (bytes < (int)sizeof(myBuff) ? bytes : sizeof(myBuff));
-        do {do {retc = pread(fileFD, myBuff, buffsz, offset);}
+        do {buffsz = (bytes < (int)sizeof(myBuff) ? bytes : sizeof(myBuff));
+            do {retc = pread(fileFD, myBuff, buffsz, offset);}
                        while(retc < 0 && errno == EINTR);
             if (retc < 0) return SFError(errno);
             if (!retc) break;
-            if (!TLS_Write(myBuff, buffsz)) return -1;
-            offset += buffsz; bytes -= buffsz; totamt += retc;
+            if (!TLS_Write(myBuff, retc)) return -1;
+            offset += retc; bytes -= retc;
            } while(bytes > 0);
        }
 
@@ -1452,19 +1452,18 @@ int XrdLinkXeq::TLS_Send(const sfVec *sfP, int sfN)
 
 bool XrdLinkXeq::TLS_Write(const char *Buff, int Blen)
 {
+   struct iovec iov = {(void *)Buff, (size_t)Blen};
    XrdTls::RC retc;
-   int byteswritten;
+   int byteswritten, records;
 
 // Write the data out
 //
-   while(Blen)
-        {retc = tlsIO.Write(Buff, Blen, byteswritten);
-         if (retc != XrdTls::TLS_AOK)
-            {TLS_Error("write to", retc);
-             return false;
-            }
-         Blen -= byteswritten; Buff += byteswritten;
-        }
+   retc = tlsIO.Write(&iov, 1, byteswritten, records);
+   AtomicAdd(TlsOut, byteswritten); AtomicAdd(TlsRecs, records);
+   if (retc != XrdTls::TLS_AOK)
+      {TLS_Error("write to", retc);
+       return false;
+      }
 
 // All done
 //
@@ -167,6 +167,8 @@ static int          LinkCountMax;
 static int          LinkTimeOuts;
 static int          LinkStalls;
 static int          LinkSfIntr;
+static long long    LinkTlsOut;
+static long long    LinkTlsRecs;
        long long    BytesIn;
        long long    BytesInTot;
        long long    BytesOut;
@@ -176,6 +178,8 @@ static int          LinkSfIntr;
        int          tardyCnt;
        int          tardyCntTot;
        int          SfIntr;
+       long long    TlsOut;
+       int          TlsRecs;
 static XrdSysMutex  statsMutex;
 
 // Protocol section
@@ -27,10 +27,14 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
 #include <cerrno>
 #include <fcntl.h>
+#include <sched.h>
 #include <signal.h>
 #include <cstdio>
+#include <cstdlib>
+#include <ctime>
 #include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -42,6 +46,7 @@
 #include "Xrd/XrdJob.hh"
 #include "Xrd/XrdScheduler.hh"
 #include "XrdOuc/XrdOucTrace.hh"    // For ABI compatibility only!
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysLogger.hh"
 
@@ -54,6 +59,29 @@
 
        const char   *XrdScheduler::TraceID = "Sched";
 
+namespace
+{
+// Each worker thread records the scheduler it works for and its home lane so
+// that jobs scheduled by a worker go to that worker's lane.
+//
+thread_local XrdScheduler *myScheduler = 0;
+thread_local int           myLane      = 0;
+
+// Lanes are assigned one per cpu, up to this many.
+//
+const int maxLanes = 64;
+
+// Return the monotonic time in microseconds. Queue latency is measured on
+// this clock and the timing wheel runs on it in milliseconds.
+//
+inline long long Now()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (long long)ts.tv_sec*1000000LL + ts.tv_nsec/1000;
+}
+}
+
 /******************************************************************************/
 /*                         L o c a l   C l a s s e s                          */
 /******************************************************************************/
@@ -67,6 +95,390 @@ class XrdSchedulerPID
                         {next = prev; pid = newpid;}
      ~XrdSchedulerPID() {}
      };
+
+/******************************************************************************/
+
+// Each lane is a job queue with its own lock. Counters that are updated by
+// the lane's consumers are kept here as well so that statistics gathering
+// does not add a shared cache line. The trailing pad keeps adjacent lanes
+// from sharing a cache line.
+//
+// XrdJob has no room for the time a job was queued, so the lane keeps those
+// times in a ring that runs parallel to its queue: the n-th job taken from
+// the lane was queued at the n-th time put into the ring. The ring doubles
+// when it fills up and is otherwise never reallocated.
+//
+class XrdSchedulerLane
+     {public:
+      static const int  HistSize = 6;
+
+      XrdSysMutex             qMutex;
+      XrdJob                 *First;
+      XrdJob                 *Last;
+      long long              *qTimes;  // Ring of queue times
+      unsigned int            qMask;   // Ring size - 1
+      unsigned int            qHead;   // Next time to take
+      std::atomic<int>        Num;     // Jobs in this lane
+      int                     Node;    // NUMA node of the lane's cpu
+      int                    *Order;   // Lanes to look at, ours first
+      std::atomic<long long>  Steals;  // Jobs taken by home workers elsewhere
+      std::atomic<long long>  qLat[HistSize]; // From 10us by powers of 10
+      std::atomic<long long>  Idle[HistSize]; // From  1ms by powers of 10
+      char                    Pad[64];
+
+      // Return the histogram bucket for a time given the upper bound of the
+      // first bucket; each bucket is ten times wider than the previous one.
+      //
+      static int Bucket(long long usec, long long base)
+                       {int n = 0;
+                        while(n < HistSize-1 && usec >= base) {base *= 10; n++;}
+                        return n;
+                       }
+
+      // Add num jobs queued at time qTime (the caller holds qMutex and has
+      // not yet counted the jobs in Num).
+      //
+      void putTimes(int num, long long qTime)
+                   {unsigned int n = Num.load(std::memory_order_relaxed);
+                    if (n + num > qMask) growTimes(n + num);
+                    while(num--) qTimes[(qHead + n++) & qMask] = qTime;
+                   }
+
+      // Take the queue time of the first job (the caller holds qMutex).
+      //
+      long long getTime() {long long qTime = qTimes[qHead];
+                           qHead = (qHead + 1) & qMask;
+                           return qTime;
+                          }
+
+      XrdSchedulerLane() : First(0), Last(0), qTimes(new long long[256]),
+                           qMask(255), qHead(0), Num(0), Node(0), Order(0),
+                           Steals(0)
+                         {for (int i = 0; i < HistSize; i++)
+                              {qLat[i] = 0; Idle[i] = 0;}
+                         }
+     ~XrdSchedulerLane() {delete [] Order; delete [] qTimes;}
+
+     private:
+
+      void growTimes(unsigned int need)
+                    {unsigned int n = Num.load(std::memory_order_relaxed);
+                     unsigned int size = (qMask + 1) * 2;
+                     while(size <= need) size *= 2;
+                     long long *newTimes = new long long[size];
+                     for (unsigned int i = 0; i < n; i++)
+                         newTimes[i] = qTimes[(qHead + i) & qMask];
+                     delete [] qTimes;
+                     qTimes = newTimes; qMask = size - 1; qHead = 0;
+                    }
+     };
+
+/******************************************************************************/
+
+// The lanes of a scheduler. A job is placed in the lane of the cpu that
+// scheduled it and workers take jobs from their own lane, stealing from
+// other lanes (same NUMA node first) when their own lane is empty.
+//
+class XrdSchedulerLanes
+     {public:
+
+      XrdSchedulerLane          *Lane;
+      int                        Num;
+      std::atomic<unsigned int>  Next;  // For spreading workers over lanes
+
+      XrdSchedulerLanes();
+     ~XrdSchedulerLanes() {delete [] Lane;}
+     };
+
+/******************************************************************************/
+
+XrdSchedulerLanes::XrdSchedulerLanes() : Next(0)
+{
+   int i, k, n, cpuNum;
+
+// Allocate one lane per configured cpu
+//
+   if ((cpuNum = sysconf(_SC_NPROCESSORS_CONF)) < 1) cpuNum = 1;
+   Num  = (cpuNum > maxLanes ? maxLanes : cpuNum);
+   Lane = new XrdSchedulerLane[Num];
+
+// Determine the NUMA node of each lane's cpu (Linux only). Any cpu we can't
+// place stays in node 0, which is all there is on most machines.
+//
+#ifdef __linux__
+   char fName[64], cBuff[1024], *cP;
+   int fd, rdsz, cpuBeg, cpuEnd;
+   for (n = 0; n < 64; n++)
+       {snprintf(fName, sizeof(fName),
+                 "/sys/devices/system/node/node%d/cpulist", n);
+        if ((fd = open(fName, O_RDONLY)) < 0) continue;
+        rdsz = read(fd, cBuff, sizeof(cBuff)-1);
+        close(fd);
+        if (rdsz <= 0) continue;
+        cBuff[rdsz] = 0; cP = cBuff;
+        while(*cP >= '0' && *cP <= '9')
+             {cpuBeg = cpuEnd = strtol(cP, &cP, 10);
+              if (*cP == '-') cpuEnd = strtol(cP+1, &cP, 10);
+              for (i = cpuBeg; i <= cpuEnd && i < Num; i++)
+                  Lane[i].Node = n;
+              if (*cP == ',') cP++;
+             }
+       }
+#endif
+
+// Establish the order in which each lane's workers look at the lanes: their
+// own lane, then the other lanes on the same node, and then the rest.
+//
+   for (i = 0; i < Num; i++)
+       {Lane[i].Order = new int[Num];
+        Lane[i].Order[0] = i; n = 1;
+        for (k = 1; k < Num; k++)
+            if (Lane[(i+k)%Num].Node == Lane[i].Node)
+               Lane[i].Order[n++] = (i+k)%Num;
+        for (k = 1; k < Num; k++)
+            if (Lane[(i+k)%Num].Node != Lane[i].Node)
+               Lane[i].Order[n++] = (i+k)%Num;
+       }
+}
+
+/******************************************************************************/
+
+// The timing wheel holds timed jobs. It is hierarchical: level 0 has a slot
+// for each of the next 256 milliseconds, level 1 a slot for each of the next
+// 256 level 0 rotations, and so on. A job goes into the lowest level whose
+// range covers its delay and moves down a level each time the level below
+// wraps around, so insertion, cancellation and expiration are constant time.
+//
+// Each timed job is represented by a node taken from a pool that grows in
+// chunks and is never freed. While the job is on the wheel its NextJob points
+// to its node, just as it pointed to the next timed job when timed jobs were
+// kept in a list. A job is on the wheel only if NextJob points to a node in
+// the pool that refers back to the job. The caller serializes all calls.
+//
+class XrdSchedulerWheel
+     {public:
+
+      // Add (or move) a job to run at the given tick and return true if the
+      // timer thread must be woken up to handle it.
+      //
+      bool Add(XrdJob *jp, long long when)
+              {Node *np = Find(jp);
+               if (np) Unlink(np);
+                  else {if (!freeNodes) Grow();
+                        np = freeNodes; freeNodes = np->next;
+                        np->job = jp; numNodes++;
+                        jp->NextJob = reinterpret_cast<XrdJob *>(np);
+                       }
+               np->when = when;
+               Place(np);
+               return when < tWake;
+              }
+
+      // Remove a job, returning true if it was on the wheel.
+      //
+      bool Cancel(XrdJob *jp)
+              {Node *np = Find(jp);
+               if (!np) return false;
+               Unlink(np);
+               Free(np);
+               jp->NextJob = 0;
+               return true;
+              }
+
+      // Remove all jobs due at or before tick now, chaining them via NextJob.
+      // Returns the number of jobs removed.
+      //
+      int  Expire(long long now, XrdJob *&first, XrdJob *&last);
+
+      // Return the tick at which the timer thread should wake up next. There
+      // may be nothing due then (e.g. a higher level needs to be cascaded).
+      //
+      long long Next();
+
+      void      setWake(long long when) {tWake = when;}
+
+      XrdSchedulerWheel(long long now) : Chunks(0), freeNodes(0), numNodes(0),
+                                         curTick(now), tWake(now)
+                       {for (int i = 0; i < Levels; i++)
+                            for (int k = 0; k < Slots; k++) Wheel[i][k] = 0;
+                       }
+     ~XrdSchedulerWheel() {}
+
+      static const int       Levels   = 4;
+      static const int       SlotBits = 8;
+      static const int       Slots    = 1 << SlotBits;
+      static const int       SlotMask = Slots - 1;
+      static const long long MaxDelay = (1LL << (SlotBits*Levels)) - 1;
+
+     private:
+
+      struct Node  {XrdJob   *job;
+                    Node     *next;
+                    Node    **pprev;
+                    long long when;
+                   };
+
+      struct Chunk {Chunk    *next;
+                    Node     *nodes;
+                    int       num;
+                   };
+
+      void Cascade(int lvl, int slot)
+                  {Node *np = Wheel[lvl][slot], *nx;
+                   Wheel[lvl][slot] = 0;
+                   while(np) {nx = np->next; Place(np); np = nx;}
+                  }
+
+      Node *Find(XrdJob *jp);
+
+      void  Free(Node *np)
+                {np->job = 0; np->next = freeNodes; freeNodes = np; numNodes--;}
+
+      void  Grow();
+
+      void  Place(Node *np);
+
+      void  Unlink(Node *np)
+                  {if ((*(np->pprev) = np->next)) np->next->pprev = np->pprev;}
+
+      Chunk     *Chunks;                 // Node pool, newest chunk first
+      Node      *freeNodes;              // Nodes not on the wheel
+      int        numNodes;               // Nodes on the wheel
+      Node      *Wheel[Levels][Slots];
+      long long  curTick;                // Next tick to process
+      long long  tWake;                  // When timer thread wakes
+     };
+
+/******************************************************************************/
+
+XrdSchedulerWheel::Node *XrdSchedulerWheel::Find(XrdJob *jp)
+{
+   Node *np = reinterpret_cast<Node *>(jp->NextJob);
+
+// The job is on the wheel if its NextJob points to a node that is in use by
+// the job. Chunks double in size so there are only a few to look at.
+//
+   if (!np) return 0;
+   for (Chunk *cp = Chunks; cp; cp = cp->next)
+       if (np >= cp->nodes && np < cp->nodes + cp->num)
+          return (np->job == jp ? np : 0);
+   return 0;
+}
+
+/******************************************************************************/
+
+void XrdSchedulerWheel::Grow()
+{
+   Chunk *cp = new Chunk;
+
+// Add a chunk as large as all of the previous ones to the pool
+//
+   cp->num   = (Chunks ? Chunks->num * 2 : 256);
+   cp->nodes = new Node[cp->num];
+   cp->next  = Chunks;
+   Chunks    = cp;
+
+   for (int i = 0; i < cp->num; i++)
+       {cp->nodes[i].job  = 0;
+        cp->nodes[i].next = freeNodes;
+        freeNodes = &(cp->nodes[i]);
+       }
+}
+
+/******************************************************************************/
+
+int XrdSchedulerWheel::Expire(long long now, XrdJob *&first, XrdJob *&last)
+{
+   Node *np;
+   int i, idx, num = 0;
+
+// If the wheel is empty simply move the time forward
+//
+   if (!numNodes)
+      {if (now >= curTick) curTick = now+1;
+       return 0;
+      }
+
+// Process each tick up to now. When level 0 wraps we immediately bring down
+// the next slot from level 1 and so on up the levels. This way the slots for
+// the current tick never need cascading, which Next() relies on.
+//
+   first = last = 0;
+   while(curTick <= now)
+        {idx = curTick & SlotMask;
+         np = Wheel[0][idx]; Wheel[0][idx] = 0;
+         while(np)
+              {XrdJob *jp = np->job;
+               Node   *nx = np->next;
+               Free(np);
+               np = nx;
+               jp->NextJob = 0;
+               if (last) last->NextJob = jp;
+                  else   first = jp;
+               last = jp;
+               num++;
+              }
+         if (!(++curTick & SlotMask))
+            {for (i = 1; i < Levels; i++)
+                 {int slot = (curTick >> (SlotBits*i)) & SlotMask;
+                  Cascade(i, slot);
+                  if (slot) break;
+                 }
+            }
+        }
+   return num;
+}
+
+/******************************************************************************/
+
+long long XrdSchedulerWheel::Next()
+{
+   long long tick = curTick;
+   int i, k, idx, shift;
+
+// Nothing to do means we can sleep for as long as we want
+//
+   if (!numNodes) return curTick + MaxDelay;
+
+// Find the first occupied slot at the lowest level in the current rotation.
+// A slot at a higher level needs attention when it is cascaded. If a level
+// only has slots in its next rotation, we must look again when it wraps.
+//
+   for (i = 0; i < Levels; i++)
+       {shift = SlotBits*i;
+        idx   = (tick >> shift) & SlotMask;
+        for (k = idx; k < Slots; k++)
+            if (Wheel[i][k]) return tick + ((long long)(k - idx) << shift);
+        tick = ((tick >> (shift+SlotBits)) + 1) << (shift+SlotBits);
+        for (k = 0; k < idx; k++) if (Wheel[i][k]) return tick;
+       }
+   return tick;
+}
+
+/******************************************************************************/
+
+void XrdSchedulerWheel::Place(Node *np)
+{
+   long long when = np->when, delta = when - curTick;
+   Node **slot;
+   int lvl;
+
+// Jobs that are overdue go into the slot processed next. Jobs beyond the
+// wheel's range go into the last slot we have and are re-placed from there.
+//
+   if (delta < 0) slot = &Wheel[0][curTick & SlotMask];
+      else {if (delta > MaxDelay) when = curTick + MaxDelay;
+            for (lvl = 0; lvl < Levels-1; lvl++)
+                if (delta < (1LL << (SlotBits*(lvl+1)))) break;
+            slot = &Wheel[lvl][(when >> (SlotBits*lvl)) & SlotMask];
+           }
+
+// Link the node at the front of the slot
+//
+   if ((np->next = *slot)) np->next->pprev = &(np->next);
+   np->pprev = slot;
+   *slot = np;
+}
   
 /******************************************************************************/
 /*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
@@ -97,7 +509,8 @@ void *XrdStartWorking(void *carg)
 XrdScheduler::XrdScheduler(XrdSysError *eP, XrdSysTrace *tP,
                            int minw, int maxw, int maxi)
               : XrdJob("underused thread monitor"),
-                 XrdTraceOld(0), WorkAvail(0, "sched work")
+                 XrdTraceOld(0), WorkAvail(0, "sched work"),
+                TimerRings(0, "sched timer")
 {
    Boot(eP, tP, minw, maxw, maxi);
 }
@@ -108,7 +521,8 @@ XrdScheduler::XrdScheduler(XrdSysError *eP, XrdSysTrace *tP,
 XrdScheduler::XrdScheduler(XrdSysError *eP, XrdOucTrace *tP,
                            int minw, int maxw, int maxi)
               : XrdJob("underused thread monitor"),
-                XrdTraceOld(tP), WorkAvail(0, "sched work")
+                XrdTraceOld(tP), WorkAvail(0, "sched work"),
+                TimerRings(0, "sched timer")
 {
 
 // Invoke the main initialization function with a new style trace object
@@ -122,7 +536,8 @@ XrdScheduler::XrdScheduler(XrdSysError *eP, XrdOucTrace *tP,
 //
 XrdScheduler::XrdScheduler(int minw, int maxw, int maxi)
               : XrdJob("underused thread monitor"),
-                WorkAvail(0, "sched work")
+                XrdTraceOld(0), WorkAvail(0, "sched work"),
+                TimerRings(0, "sched timer")
 {
    XrdSysLogger *Logger;
    int eFD;
@@ -225,28 +640,12 @@ XrdScheduler::~XrdScheduler()  // The scheduler is never deleted!
 
 void XrdScheduler::Cancel(XrdJob *jp)
 {
-   XrdJob *p, *pp = 0;
-
-// Lock the queue
+// Remove the job from the timing wheel, if it is there
 //
-   TimerMutex.Lock();
-
-// Find the matching job, if any
-//
-   p = TimerQueue;
-   while(p && p != jp) {pp = p; p = p->NextJob;}
-
-// Delete the job element
-//
-   if (p)
-      {if (pp) pp->NextJob = p->NextJob;
-          else  TimerQueue = p->NextJob;
-       TRACE(SCHED, "time event " <<jp->Comment <<" cancelled");
-      }
-
-// All done
-//
-   TimerMutex.UnLock();
+   TimerRings.Lock();
+   if (TimerWheel->Cancel(jp))
+      {TRACE(SCHED, "time event " <<jp->Comment <<" cancelled");}
+   TimerRings.UnLock();
 }
   
 /******************************************************************************/
@@ -259,8 +658,8 @@ void XrdScheduler::DoIt()
 
 // Now check if there are too many idle threads (kill them if there are)
 //
-   if (!num_JobsinQ)
-      {DispatchMutex.Lock(); num_idle = idl_Workers; DispatchMutex.UnLock();
+   if (!AtomicGet(num_JobsinQ))
+      {num_idle = AtomicGet(idl_Workers);
        num_kill = num_idle - min_Workers;
        TRACE(SCHED, num_Workers <<" threads; " <<num_idle <<" idle");
        if (num_kill > 0)
@@ -369,40 +768,59 @@ void *XrdScheduler::Reaper()
   
 void XrdScheduler::Run()
 {
-   int waiting;
+   long long tBeg;
+   int home, waiting, inQ;
    XrdJob *jp;
 
-// Wait for work then do it (an endless task for a worker thread)
+// Pick the lane this worker favors. Workers are spread over the lanes so that
+// every lane has about the same number of home workers.
 //
-   do {do {DispatchMutex.Lock();          idl_Workers++;DispatchMutex.UnLock();
-           WorkAvail.Wait();
-           DispatchMutex.Lock();waiting = --idl_Workers;DispatchMutex.UnLock();
-           SchedMutex.Lock();
-           if ((jp = WorkFirst))
-              {if (!(WorkFirst = jp->NextJob)) WorkLast = 0;
-               if (num_JobsinQ) num_JobsinQ--;
-                  else XrdLog->Emsg("Scheduler","Job queue count underflow!");
-              } else {
-               num_JobsinQ = 0;
-               if (num_Layoffs > 0)
-                  {num_Layoffs--;
-                   if (waiting)
-                      {num_TDestroy++; num_Workers--;
-                       TRACE(SCHED, "terminating thread; workers=" <<num_Workers);
-                       SchedMutex.UnLock();
-                       return;
-                      }
-                  }
-              }
-           SchedMutex.UnLock();
-          } while(!jp);
+   home = WorkLanes->Next++ % WorkLanes->Num;
+   myScheduler = this;
+   myLane      = home;
+
+// Wait for work then do it (an endless task for a worker thread). When there
+// is work queued we take it without waiting. Otherwise we declare ourselves
+// idle and recheck before waiting; a scheduler only posts the semaphore when
+// it sees an idle worker after it queued the job, so one of the two will
+// always see the other.
+//
+   do {if ((jp = getJob(home))) waiting = AtomicGet(idl_Workers);
+          else {tBeg = Now();
+                do {AtomicBeg(DispatchMutex);
+                    AtomicInc(idl_Workers);
+                    inQ = AtomicGet(num_JobsinQ);
+                    AtomicEnd(DispatchMutex);
+                    if (inQ > 0 && (jp = getJob(home)))
+                       {idleDone(waiting); break;}
+                    WorkAvail.Wait();
+                    idleDone(waiting);
+                    if ((jp = getJob(home))) break;
+                    SchedMutex.Lock();
+                    if (num_Layoffs > 0)
+                       {num_Layoffs--;
+                        if (waiting)
+                           {num_TDestroy++; num_Workers--;
+                            TRACE(SCHED, "terminating thread; workers="
+                                         <<num_Workers);
+                            SchedMutex.UnLock();
+                            myScheduler = 0;
+                            return;
+                           }
+                       }
+                    SchedMutex.UnLock();
+                   } while(1);
+                WorkLanes->Lane[home].Idle[XrdSchedulerLane::Bucket(Now()-tBeg,
+                                                                   1000)]++;
+               }
 
     // Check if we should hire a new worker (we always want 1 idle thread)
     // before running this job.
     //
        if (!waiting) hireWorker();
        if (TRACING(TRACE_SCHED) && *(jp->Comment) != '.')
-          {TRACE(SCHED, "running " <<jp->Comment <<" inq=" <<num_JobsinQ);}
+          {TRACE(SCHED, "running " <<jp->Comment <<" inq="
+                        <<AtomicGet(num_JobsinQ));}
        jp->DoIt();
       } while(1);
 }
@@ -413,99 +831,84 @@ void XrdScheduler::Run()
   
 void XrdScheduler::Schedule(XrdJob *jp)
 {
-// Lock down our data area
-//
-   SchedMutex.Lock();
+   XrdSchedulerLane &lane = WorkLanes->Lane[pickLane()];
+   long long qTime = Now();
+   int idle;
 
-// Place the request on the queue and broadcast it
+// Place the request on the lane, noting when it was queued
 //
-   jp->NextJob  = 0;
-   if (WorkFirst)
-      {WorkLast->NextJob = jp;
-       WorkLast = jp;
-      } else {
-       WorkFirst = jp;
-       WorkLast  = jp;
-      }
-   WorkAvail.Post();
-
-// Calculate statistics
+   jp->NextJob = 0;
+   lane.qMutex.Lock();
+   lane.putTimes(1, qTime);
+   if (lane.First) lane.Last->NextJob = jp;
+      else         lane.First = jp;
+   lane.Last = jp;
+   lane.Num++;
+   lane.qMutex.UnLock();
+
+// Calculate statistics and see if anyone is idle
 //
-   num_Jobs++;
-   num_JobsinQ++;
-   if (num_JobsinQ > max_QLength) max_QLength = num_JobsinQ;
+   idle = Queued(1);
 
-// Unlock the data area and return
+// Wake up an idle worker if there is one. Busy workers will find the job.
 //
-   SchedMutex.UnLock();
+   if (idle > 0) WorkAvail.Post();
 }
 
 /******************************************************************************/
   
 void XrdScheduler::Schedule(int numjobs, XrdJob *jfirst, XrdJob *jlast)
 {
+   XrdSchedulerLane &lane = WorkLanes->Lane[pickLane()];
+   long long qTime = Now();
+   int idle;
 
-// Lock down our data area
-//
-   SchedMutex.Lock();
-
-// Place the request list on the queue
+// Place the request list on the lane, noting when it was queued
 //
    jlast->NextJob = 0;
-   if (WorkFirst)
-      {WorkLast->NextJob = jfirst;
-       WorkLast = jlast;
-      } else {
-       WorkFirst = jfirst;
-       WorkLast  = jlast;
-      }
-
-// Calculate statistics
-//
-   num_Jobs    += numjobs;
-   num_JobsinQ += numjobs;
-   if (num_JobsinQ > max_QLength) max_QLength = num_JobsinQ;
-
-// Indicate number of jobs to work on
+   lane.qMutex.Lock();
+   lane.putTimes(numjobs, qTime);
+   if (lane.First) lane.Last->NextJob = jfirst;
+      else         lane.First = jfirst;
+   lane.Last = jlast;
+   lane.Num += numjobs;
+   lane.qMutex.UnLock();
+
+// Calculate statistics and see if anyone is idle
 //
-   while(numjobs--) WorkAvail.Post();
+   idle = Queued(numjobs);
 
-// Unlock the data area and return
+// Wake up as many idle workers as we have jobs to work on
 //
-   SchedMutex.UnLock();
+   if (idle > numjobs) idle = numjobs;
+   while(idle-- > 0) WorkAvail.Post();
 }
 
 /******************************************************************************/
 
 void XrdScheduler::Schedule(XrdJob *jp, time_t atime)
 {
-   XrdJob *pp = 0, *p;
-
-// Cancel this event, if scheduled
-//
-   Cancel(jp);
+   time_t now = time(0);
 
-// Lock the queue
+// Times are given as wall clock seconds but the wheel runs on the monotonic
+// clock so convert it to a delay.
 //
    if (TRACING(TRACE_SCHED) && *(jp->Comment) != '.')
-      {TRACE(SCHED, "scheduling " <<jp->Comment <<" in " <<atime-time(0) <<" seconds");}
+      {TRACE(SCHED, "scheduling " <<jp->Comment <<" in " <<atime-now <<" seconds");}
    jp->SchedTime = atime;
-   TimerMutex.Lock();
-
-// Find the insertion point for the work element
-//
-   p = TimerQueue;
-   while(p && p->SchedTime <= atime) {pp = p; p = p->NextJob;}
+   setTimer(jp, (atime > now ? (long long)(atime - now)*1000 : 0));
+}
 
-// Insert the job element
-//
-   jp->NextJob = p;
-   if (pp)  pp->NextJob = jp;
-      else {TimerQueue = jp; TimerRings.Signal();}
+/******************************************************************************/
+/*                            S c h e d u l e I n                             */
+/******************************************************************************/
 
-// All done
-//
-   TimerMutex.UnLock();
+void XrdScheduler::ScheduleIn(XrdJob *jp, int msec)
+{
+   if (TRACING(TRACE_SCHED) && *(jp->Comment) != '.')
+      {TRACE(SCHED, "scheduling " <<jp->Comment <<" in " <<msec <<" msec");}
+   jp->SchedTime = time(0) + (msec > 0 ? (msec+999)/1000 : 0);
+   setTimer(jp, (msec > 0 ? msec : 0));
 }
 
 /******************************************************************************/
@@ -594,31 +997,46 @@ void XrdScheduler::Start() // Serialized one time call!
   
 int XrdScheduler::Stats(char *buff, int blen, int do_sync)
 {
+    const int hN = XrdSchedulerLane::HistSize;
+    long long cnt_Steals = 0, cnt_qLat[hN] = {0}, cnt_Idle[hN] = {0};
     int cnt_Jobs, cnt_JobsinQ, xam_QLength, cnt_Workers, cnt_idl;
     int cnt_TCreate, cnt_TDestroy, cnt_Limited;
     static char statfmt[] = "<stats id=\"sched\"><jobs>%d</jobs>"
                 "<inq>%d</inq><maxinq>%d</maxinq>"
                 "<threads>%d</threads><idle>%d</idle>"
                 "<tcr>%d</tcr><tde>%d</tde>"
-                "<tlimr>%d</tlimr></stats>";
+                "<tlimr>%d</tlimr>"
+                "<lanes>%d</lanes><steals>%lld</steals>"
+                "<qlat><u10>%lld</u10><u100>%lld</u100><m1>%lld</m1>"
+                "<m10>%lld</m10><m100>%lld</m100><big>%lld</big></qlat>"
+                "<idlt><m1>%lld</m1><m10>%lld</m10><m100>%lld</m100>"
+                "<s1>%lld</s1><s10>%lld</s10><big>%lld</big></idlt></stats>";
 
 // If only length wanted, do so
 //
-   if (!buff) return sizeof(statfmt) + 16*8;
+   if (!buff) return sizeof(statfmt) + 16*10 + 24*13;
 
-// Get values protected by the Dispatch lock (avoid lock if no sync needed)
+// Sum up the per-lane counters; these are never reset
 //
-   if (do_sync) DispatchMutex.Lock();
-   cnt_idl = idl_Workers;
-   if (do_sync) DispatchMutex.UnLock();
+   for (int i = 0; i < WorkLanes->Num; i++)
+       {XrdSchedulerLane &lane = WorkLanes->Lane[i];
+        cnt_Steals += lane.Steals;
+        for (int k = 0; k < hN; k++)
+            {cnt_qLat[k] += lane.qLat[k];
+             cnt_Idle[k] += lane.Idle[k];
+            }
+       }
 
 // Get values protected by the Scheduler lock (avoid lock if no sync needed)
 //
    if (do_sync) SchedMutex.Lock();
+   AtomicBeg(DispatchMutex);
+   cnt_idl     = AtomicGet(idl_Workers);
+   cnt_Jobs    = AtomicGet(num_Jobs);
+   cnt_JobsinQ = AtomicGet(num_JobsinQ);
+   xam_QLength = AtomicGet(max_QLength);
+   AtomicEnd(DispatchMutex);
    cnt_Workers = num_Workers;
-   cnt_Jobs    = num_Jobs;
-   cnt_JobsinQ = num_JobsinQ;
-   xam_QLength = max_QLength;
    cnt_TCreate = num_TCreate;
    cnt_TDestroy= num_TDestroy;
    cnt_Limited = num_Limited;
@@ -628,7 +1046,11 @@ int XrdScheduler::Stats(char *buff, int blen, int do_sync)
 //
    return snprintf(buff, blen, statfmt, cnt_Jobs, cnt_JobsinQ, xam_QLength,
                    cnt_Workers, cnt_idl, cnt_TCreate, cnt_TDestroy,
-                   cnt_Limited);
+                   cnt_Limited, WorkLanes->Num, cnt_Steals,
+                   cnt_qLat[0], cnt_qLat[1], cnt_qLat[2],
+                   cnt_qLat[3], cnt_qLat[4], cnt_qLat[5],
+                   cnt_Idle[0], cnt_Idle[1], cnt_Idle[2],
+                   cnt_Idle[3], cnt_Idle[4], cnt_Idle[5]);
 }
 
 /******************************************************************************/
@@ -637,29 +1059,66 @@ int XrdScheduler::Stats(char *buff, int blen, int do_sync)
   
 void XrdScheduler::TimeSched()
 {
-   XrdJob *jp;
-   int wtime;
+   XrdJob *first, *last;
+   long long now, wake;
+   int numjobs, wtime;
 
-// Continuous loop until we find some work here
+// Continuous loop until we find some work here. The wheel is only changed
+// while holding the condition variable's lock so no wakeup can be missed.
 //
-   do {TimerMutex.Lock();
-       if (TimerQueue) wtime = TimerQueue->SchedTime-time(0);
-          else wtime = 60*60;
-       if (wtime > 0)
-          {TimerMutex.UnLock();
-           TimerRings.Wait(wtime);
-          } else {
-           jp = TimerQueue;
-           TimerQueue = jp->NextJob;
-           Schedule(jp);
-           TimerMutex.UnLock();
+   TimerRings.Lock();
+   do {now = Now()/1000;
+       if ((numjobs = TimerWheel->Expire(now, first, last)))
+          {TimerRings.UnLock();
+           Schedule(numjobs, first, last);
+           TimerRings.Lock();
+           continue;
           }
-       } while(1);
+       wake = TimerWheel->Next();
+       if (wake - now > 60*60*1000) wake = now + 60*60*1000;
+       TimerWheel->setWake(wake);
+       if ((wtime = static_cast<int>(wake - now)) > 0) TimerRings.WaitMS(wtime);
+      } while(1);
 }
 
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
+/******************************************************************************/
+/*                                g e t J o b                                 */
+/******************************************************************************/
+
+XrdJob *XrdScheduler::getJob(int home)
+{
+   XrdSchedulerLane *lanes = WorkLanes->Lane;
+   int *order = lanes[home].Order;
+   long long qTime;
+   XrdJob *jp;
+
+// Look at our own lane first and then steal from the others, nearest first.
+// Lanes that look empty are skipped without locking them.
+//
+   for (int i = 0; i < WorkLanes->Num; i++)
+       {XrdSchedulerLane &lane = lanes[order[i]];
+        if (!lane.Num.load(std::memory_order_relaxed)) continue;
+        lane.qMutex.Lock();
+        if ((jp = lane.First))
+           {if (!(lane.First = jp->NextJob)) lane.Last = 0;
+            lane.Num--;
+            qTime = lane.getTime();
+            lane.qMutex.UnLock();
+            AtomicBeg(DispatchMutex);
+            AtomicDec(num_JobsinQ);
+            AtomicEnd(DispatchMutex);
+            if (i) lanes[home].Steals++;
+            lane.qLat[XrdSchedulerLane::Bucket(Now() - qTime, 10)]++;
+            return jp;
+           }
+        lane.qMutex.UnLock();
+       }
+   return 0;
+}
+
 /******************************************************************************/
 /*                           h i r e   W o r k e r                            */
 /******************************************************************************/
@@ -702,6 +1161,65 @@ void XrdScheduler::hireWorker(int dotrace)
       } else if (dotrace) TRACE(SCHED, "Now have " <<num_Workers <<" workers" );
 }
  
+/******************************************************************************/
+/*                              i d l e D o n e                               */
+/******************************************************************************/
+
+void XrdScheduler::idleDone(int &waiting)
+{
+// Account for a worker that is no longer idle and return how many still are
+//
+   AtomicBeg(DispatchMutex);
+   AtomicFSub(waiting, idl_Workers, 1);
+   AtomicEnd(DispatchMutex);
+   waiting--;
+}
+
+/******************************************************************************/
+/*                                Q u e u e d                                 */
+/******************************************************************************/
+
+int XrdScheduler::Queued(int numjobs)
+{
+   int inQ, maxQ, idle;
+
+// Account for jobs that were placed in a lane and return the idle count
+//
+   AtomicBeg(DispatchMutex);
+   AtomicAdd(num_Jobs, numjobs);
+   AtomicFAdd(inQ, num_JobsinQ, numjobs);
+   inQ += numjobs;
+#ifdef HAVE_ATOMICS
+   maxQ = AtomicGet(max_QLength);
+   while(inQ > maxQ && !AtomicCAS(max_QLength, maxQ, inQ))
+        maxQ = AtomicGet(max_QLength);
+#else
+   if (inQ > (maxQ = max_QLength)) max_QLength = inQ;
+#endif
+   idle = AtomicGet(idl_Workers);
+   AtomicEnd(DispatchMutex);
+   return idle;
+}
+
+/******************************************************************************/
+/*                              s e t T i m e r                               */
+/******************************************************************************/
+
+void XrdScheduler::setTimer(XrdJob *jp, long long msec)
+{
+// A tick expires as soon as the clock reaches it so round the current time up
+// to the next millisecond; otherwise the job could run up to 1ms too early.
+//
+   long long when = (Now()+999)/1000 + msec;
+
+// Place the job on the wheel and wake the timer thread if it would otherwise
+// sleep past this job's time
+//
+   TimerRings.Lock();
+   if (TimerWheel->Add(jp, when)) TimerRings.Signal();
+   TimerRings.UnLock();
+}
+
 /******************************************************************************/
 /*                                  I n i t                                   */
 /******************************************************************************/
@@ -722,7 +1240,26 @@ void XrdScheduler::Init(int minw, int maxw, int maxi)
    num_Layoffs =  0;
    num_Limited =  0;
    firstPID    =  0;
-   WorkFirst = WorkLast = TimerQueue = 0;
+   TimerWheel  =  new XrdSchedulerWheel(Now()/1000);
+   WorkLanes   =  new XrdSchedulerLanes;
+   WorkLast    =  0;
+}
+
+/******************************************************************************/
+/*                              p i c k L a n e                               */
+/******************************************************************************/
+
+int XrdScheduler::pickLane()
+{
+// Workers queue on their own lane. Anyone else queues on the lane of the cpu
+// they are running on so that the job is likely run by a nearby worker.
+//
+   if (myScheduler == this) return myLane;
+#ifdef __linux__
+   int cpu = sched_getcpu();
+   if (cpu >= 0) return cpu % WorkLanes->Num;
+#endif
+   return WorkLanes->Next++ % WorkLanes->Num;
 }
 
 /******************************************************************************/
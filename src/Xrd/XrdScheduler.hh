@@ -36,7 +36,9 @@
 #include "Xrd/XrdJob.hh"
 
 class XrdOucTrace;
+class XrdSchedulerLanes;
 class XrdSchedulerPID;
+class XrdSchedulerWheel;
 class XrdSysError;
 class XrdSysTrace;
 
@@ -65,6 +67,12 @@ void          Schedule(XrdJob *jp);
 void          Schedule(int num, XrdJob *jfirst, XrdJob *jlast);
 void          Schedule(XrdJob *jp, time_t atime);
 
+// Schedule a job to run after msec milliseconds. Timed jobs are kept in a
+// timing wheel with millisecond resolution; scheduling a job that is already
+// timed reschedules it and Cancel() removes it, both in constant time.
+//
+void          ScheduleIn(XrdJob *jp, int msec);
+
 void          setParms(int minw, int maxw, int avlt, int maxi, int once=0);
 
 void          Start();
@@ -104,7 +112,7 @@ XrdSysError *XrdLog;
 XrdSysTrace *XrdTrace;
 XrdOucTrace *XrdTraceOld;  // This is only used for ABI compatibility
 
-XrdSysMutex DispatchMutex; // Disp: Protects above area
+XrdSysMutex DispatchMutex; // Disp: Protects above area (if no atomics)
 int        idl_Workers;    // Disp: Number of idle workers
 
 int        min_Workers;   // Sched: Min threads we need to have
@@ -112,25 +120,30 @@ int        max_Workers;   // Sched: Max threads we can start
 int        max_Workidl;   // Sched: Max idle time for threads above min_Workers
 int        num_Workers;   // Sched: Number of threads we have
 int        stk_Workers;   // Sched: Number of sticky workers we can have
-int        num_JobsinQ;   // Sched: Number of outstanding jobs in the queue
+int        num_JobsinQ;   // Disp: Number of outstanding jobs in the queue
 int        num_Layoffs;   // Sched: Number of threads to terminate
 
-XrdJob                *WorkFirst;  // Pending work
-XrdJob                *WorkLast;
+XrdSchedulerLanes     *WorkLanes;  // Pending work, one lane per cpu
+XrdJob                *WorkLast;   // Not used, kept for ABI compatibility
 XrdSysSemaphore        WorkAvail;
 XrdSysMutex            SchedMutex; // Protects private area
 
-XrdJob                *TimerQueue; // Pending work
-XrdSysCondVar          TimerRings;
-XrdSysMutex            TimerMutex; // Protects scheduler area
+XrdSchedulerWheel     *TimerWheel; // Pending timed work
+XrdSysCondVar          TimerRings; // Protects the wheel (its lock)
+XrdSysMutex            TimerMutex; // Not used, kept for ABI compatibility
 
 XrdSchedulerPID       *firstPID;
 XrdSysMutex            ReaperMutex;
 
 void Boot(XrdSysError *eP, XrdSysTrace *tP, int minw, int maxw, int maxi);
+XrdJob *getJob(int lane);
 void hireWorker(int dotrace=1);
+void idleDone(int &waiting);
 void Init(int minw, int maxw, int maxi);
+int  pickLane();
 void Monitor();
+int  Queued(int numjobs);
+void setTimer(XrdJob *jp, long long msec);
 void traceExit(pid_t pid, int status);
 static const char *TraceID;
 };
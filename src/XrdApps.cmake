@@ -29,8 +29,7 @@ if( NOT XRDCL_ONLY )
     xrdadler32
     XrdPosix
     XrdUtils
-    ${CMAKE_THREAD_LIBS_INIT}
-    ${ZLIB_LIBRARIES} )
+    ${CMAKE_THREAD_LIBS_INIT} )
 
 
   #-----------------------------------------------------------------------------
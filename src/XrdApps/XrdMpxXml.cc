@@ -82,6 +82,8 @@ std::map<const char *, const char *, vCmp> vnMap {
 {"link.tmo",        "Read request timeouts:"},
 {"link.stall",      "Number of partial reads:"},
 {"link.sfps",       "Number of partial sends:"},
+{"link.tlsout",     "TLS bytes sent:"},
+{"link.tlsrec",     "TLS records sent:"},
 {"poll.att",        "Poll sockets:"},
 {"poll.en",         "Poll enables:"},
 {"poll.ev",         "Poll events: "},
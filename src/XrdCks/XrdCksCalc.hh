@@ -129,6 +129,45 @@ virtual void  Update(const char *Buff, int BLen) = 0;
 virtual      ~XrdCksCalc() {}
 };
 
+/******************************************************************************/
+/*           C h e c k s u m   C o m b i n i n g   I n t e r f a c e          */
+/******************************************************************************/
+
+//------------------------------------------------------------------------------
+//! A checksum calculation object that can combine the checksums of adjacent
+//! data segments also inherits this interface. This allows a checksum to be
+//! computed over separate segments in parallel. It is kept apart from
+//! XrdCksCalc so that plug-ins built without it are unaffected; the checksum
+//! manager uses dynamic_cast to find out whether an object implements it.
+//------------------------------------------------------------------------------
+
+class XrdCksCalcCombine
+{
+public:
+
+//------------------------------------------------------------------------------
+//! Combine the running checksum of a data segment that immediately follows all
+//! of the data processed so far by this object.
+//!
+//! @param    Next   -> Checksum object, obtained via New() from this object,
+//!                     holding the running checksum of the following segment.
+//!                     Its Final() method has not been called.
+//! @param    NLen   -> Length of the data in the following segment.
+//!
+//! @return   true if the checksums were combined and false otherwise. Upon
+//!           success, this object holds the running checksum of all of the
+//!           data and Next is left unchanged.
+//------------------------------------------------------------------------------
+
+virtual bool  Combine(XrdCksCalc &Next, long long NLen) = 0;
+
+//------------------------------------------------------------------------------
+//! Destructor
+//------------------------------------------------------------------------------
+
+virtual      ~XrdCksCalcCombine() {}
+};
+
 /******************************************************************************/
 /*               C h e c k s u m   O b j e c t   C r e a t o r                */
 /******************************************************************************/
@@ -35,76 +35,37 @@
 #include <cinttypes>
 
 #include "XrdCks/XrdCksCalc.hh"
+#include "XrdOuc/XrdOucAdler32.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 
-/* The following implementation of adler32 was derived from zlib and is
-                   * Copyright (C) 1995-1998 Mark Adler
-   Below are the zlib license terms for this implementation.
+/* The adler32 implementation, derived from zlib, lives in XrdOucAdler32 where
+   it is vectorized for the processor we are running on.
 */
-  
-/* zlib.h -- interface of the 'zlib' general purpose compression library
-  version 1.1.4, March 11th, 2002
 
-  Copyright (C) 1995-2002 Jean-loup Gailly and Mark Adler
-
-  This software is provided 'as-is', without any express or implied
-  warranty.  In no event will the authors be held liable for any damages
-  arising from the use of this software.
-
-  Permission is granted to anyone to use this software for any purpose,
-  including commercial applications, and to alter it and redistribute it
-  freely, subject to the following restrictions:
-
-  1. The origin of this software must not be misrepresented; you must not
-     claim that you wrote the original software. If you use this software
-     in a product, an acknowledgment in the product documentation would be
-     appreciated but is not required.
-  2. Altered source versions must be plainly marked as such, and must not be
-     misrepresented as being the original software.
-  3. This notice may not be removed or altered from any source distribution.
-
-  Jean-loup Gailly        Mark Adler
-  jloup@gzip.org          madler@alumni.caltech.edu
-
-
-  The data format used by the zlib library is described by RFCs (Request for
-  Comments) 1950 to 1952 in the files ftp://ds.internic.net/rfc/rfc1950.txt
-  (zlib format), rfc1951.txt (deflate format) and rfc1952.txt (gzip format).
-*/
-
-#define DO1(buf)  {unSum1 += *buf++; unSum2 += unSum1;}
-#define DO2(buf)  DO1(buf); DO1(buf);
-#define DO4(buf)  DO2(buf); DO2(buf);
-#define DO8(buf)  DO4(buf); DO4(buf);
-#define DO16(buf) DO8(buf); DO8(buf);
-
-class XrdCksCalcadler32 : public XrdCksCalc
+class XrdCksCalcadler32 : public XrdCksCalc, public XrdCksCalcCombine
 {
 public:
 
+bool        Combine(XrdCksCalc &Next, long long NLen)
+                   {XrdCksCalcadler32 &nP = static_cast<XrdCksCalcadler32 &>(Next);
+                    unSum = xrdadler32_combine(unSum, nP.unSum, NLen);
+                    return true;
+                   }
+
 char *Final()
-            {AdlerValue = (unSum2 << 16) | unSum1;
+            {AdlerValue = unSum;
 #ifndef Xrd_Big_Endian
              AdlerValue = htonl(AdlerValue);
 #endif
              return (char *)&AdlerValue;
             }
 
-void        Init() {unSum1 = AdlerStart; unSum2 = 0;}
+void        Init() {unSum = AdlerStart;}
 
 XrdCksCalc *New() {return (XrdCksCalc *)new XrdCksCalcadler32;}
 
 void        Update(const char *Buff, int BLen)
-                  {int k;
-                   unsigned char *buff = (unsigned char *)Buff;
-                   while(BLen > 0)
-                        {k = (BLen < AdlerNMax ? BLen : AdlerNMax);
-                         BLen -= k;
-                         while(k >= 16) {DO16(buff); k -= 16;}
-                         if (k != 0) do {DO1(buff);} while (--k);
-                         unSum1 %= AdlerBase; unSum2 %= AdlerBase;
-                        }
-                  }
+                  {if (BLen > 0) unSum = xrdadler32(unSum, Buff, BLen);}
 
 const char *Type(int &csSize) {csSize = sizeof(AdlerValue); return "adler32";}
 
@@ -113,14 +74,9 @@ virtual    ~XrdCksCalcadler32() {}
 
 private:
 
-static const unsigned int AdlerBase  = 0xFFF1;
-static const unsigned int AdlerStart = 0x0001;
-static const          int AdlerNMax  = 5552;
-
-/* NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
+static const uint32_t AdlerStart = 0x0001;
 
-             unsigned int AdlerValue;
-             unsigned int unSum1;
-             unsigned int unSum2;
+             uint32_t AdlerValue;
+             uint32_t unSum;
 };
 #endif
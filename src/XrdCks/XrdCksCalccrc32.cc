@@ -141,6 +141,59 @@ unsigned int XrdCksCalccrc32::crctable[256] =
 /*                   End of CRC Lookup Table                     */
 /*****************************************************************/
 
+/******************************************************************************/
+/*                               C o m b i n e                                */
+/******************************************************************************/
+
+/* The running CRC has no initial or final XOR applied so it is linear in the
+   data. The CRC of the concatenation of A and B is then the CRC of A shifted
+   by the length of B (i.e. multiplied by x^(8*len(B)) modulo the polynomial)
+   XOR'd with the CRC of B. Shifting by len(B) bytes is done by squaring so the
+   cost is proportional to log(len(B)).
+*/
+namespace
+{
+static const unsigned int CRC32_POLY = 0x04c11db7;
+
+// Return a(x) * b(x) modulo p(x) with the msb being the high order term.
+//
+unsigned int MultModP(unsigned int a, unsigned int b)
+{
+   unsigned int p = 0;
+
+   for (int i = 31; i >= 0; i--)
+       {p = (p << 1) ^ (p & 0x80000000 ? CRC32_POLY : 0);
+        if (a & (1U << i)) p ^= b;
+       }
+   return p;
+}
+}
+
+bool XrdCksCalccrc32::Combine(XrdCksCalc &Next, long long NLen)
+{
+   XrdCksCalccrc32 &nP = static_cast<XrdCksCalccrc32 &>(Next);
+   unsigned int xPow = 1, x2n = 0x100;   // x^0 and x^8
+   unsigned long long n = NLen;
+
+// Compute x^(8*NLen) modulo p(x)
+//
+   while(n)
+        {if (n & 1) xPow = MultModP(x2n, xPow);
+         x2n = MultModP(x2n, x2n);
+         n >>= 1;
+        }
+
+// Shift our crc past the next segment and fold in the segment's crc
+//
+   C32Result = MultModP(xPow, C32Result) ^ nP.C32Result;
+   TotLen   += NLen;
+   return true;
+}
+
+/******************************************************************************/
+/*                                U p d a t e                                 */
+/******************************************************************************/
+  
 /* Calculate CRC-32 Checksum for NAACCR Record,
    skipping area of record containing checksum field.
 
@@ -38,10 +38,12 @@
 #include "XrdCks/XrdCksCalc.hh"
 #include "XrdSys/XrdSysPlatform.hh"
   
-class XrdCksCalccrc32 : public XrdCksCalc
+class XrdCksCalccrc32 : public XrdCksCalc, public XrdCksCalcCombine
 {
 public:
 
+bool  Combine(XrdCksCalc &Next, long long NLen);
+
 char *Final() {char buff[sizeof(long long)];
                long long tLcs = TotLen;
                int i = 0;
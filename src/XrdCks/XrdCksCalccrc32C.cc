@@ -1,4 +1,5 @@
 #include "XrdCks/XrdCksCalccrc32C.hh"
+#include "XrdOuc/XrdOucCRC32C.hh"
 
 /*
     C++ implementation of CRC-32C checksums based upon
@@ -17,6 +18,13 @@
 
 */
 
+bool XrdCksCalccrc32C::Combine(XrdCksCalc &Next, long long NLen)
+{
+    XrdCksCalccrc32C &nP = static_cast<XrdCksCalccrc32C &>(Next);
+    C32CResult = crc32c_combine(C32CResult, nP.C32CResult, NLen);
+    return true;
+}
+
 void XrdCksCalccrc32C::Update(const char *Buff, int BLen)
 {
     C32CResult = (unsigned int)XrdOucCRC::Calc32C(Buff, BLen, C32CResult);
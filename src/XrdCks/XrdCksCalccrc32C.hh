@@ -39,9 +39,11 @@
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdOuc/XrdOucCRC.hh"
 
-class XrdCksCalccrc32C : public XrdCksCalc
+class XrdCksCalccrc32C : public XrdCksCalc, public XrdCksCalcCombine
 {
 public:
+    bool Combine(XrdCksCalc &Next, long long NLen);
+
     char *Final();
     
     void Init();
@@ -38,7 +38,7 @@
 //------------------------------------------------------------------------------
 // CRC32 checkum according to the algorithm implemented in zlib
 //------------------------------------------------------------------------------
-class XrdCksCalczcrc32: public XrdCksCalc
+class XrdCksCalczcrc32: public XrdCksCalc, public XrdCksCalcCombine
 {
   public:
 
@@ -57,6 +57,16 @@ class XrdCksCalczcrc32: public XrdCksCalc
     {
     }
 
+    //--------------------------------------------------------------------------
+    //! Combine with the checksum of the following segment
+    //--------------------------------------------------------------------------
+    bool Combine( XrdCksCalc &Next, long long NLen )
+    {
+      XrdCksCalczcrc32 &nP = static_cast<XrdCksCalczcrc32&>( Next );
+      pCheckSum = crc32_combine( pCheckSum, nP.pCheckSum, NLen );
+      return true;
+    }
+
     //--------------------------------------------------------------------------
     //! Final checksum
     //--------------------------------------------------------------------------
@@ -114,7 +114,7 @@ XrdCks *XrdCksConfig::addCks(XrdCks *pCks, XrdOucEnv *envP)
 /******************************************************************************/
   
 XrdCks *XrdCksConfig::Configure(const char *dfltCalc, int rdsz,
-                                XrdOss *ossP, XrdOucEnv *envP)
+                                XrdOss *ossP, XrdOucEnv *envP, int cpar)
 {
    XrdCks *myCks = getCks(ossP, rdsz);
    XrdOucTList *tP = CksList;
@@ -133,6 +133,11 @@ XrdCks *XrdCksConfig::Configure(const char *dfltCalc, int rdsz,
 //
    while(tP) {NoGo |= myCks->Config("ckslib", tP->text); tP = tP->next;}
 
+// Set the parallel checksum limit. This only applies to our own manager as a
+// foreign one has no notion of it.
+//
+   if (cpar > 1 && !CksLib) XrdCksManager::SetParallel(cpar);
+
 // Configure if all went well
 //
    if (!NoGo) NoGo = !myCks->Init(cfgFN, dfltCalc);
@@ -59,6 +59,50 @@
 #define ENOATTR ENODATA
 #endif
 
+/******************************************************************************/
+/*                         L o c a l   S t a t i c s                          */
+/******************************************************************************/
+
+namespace
+{
+// Helper threads for parallel checksums come out of one budget shared by all
+// calculations so that concurrent requests cannot multiply their number.
+//
+XrdSysMutex parMutex;
+int         parMax  = 1;   // Maximum number of parts a file is split into
+int         parFree = 0;   // Helper threads that may still be started
+
+int  parGet(int want)
+     {XrdSysMutexHelper mHelp(parMutex);
+      if (want > parFree) want = parFree;
+      parFree -= want;
+      return want;
+     }
+
+void parPut(int num)
+     {XrdSysMutexHelper mHelp(parMutex);
+      parFree += num;
+     }
+}
+
+/******************************************************************************/
+/*                        S t r u c t   c s P a r t                           */
+/******************************************************************************/
+
+struct XrdCksManager::csPart
+      {XrdCksManager *Mgr;
+       const char    *Pfn;
+       XrdCksCalc    *csP;
+       off_t          Offset;
+       off_t          Length;
+       pthread_t      tid;
+       int            FD;
+       int            rc;
+       bool           isRun;
+                      csPart() : Mgr(0), Pfn(0), csP(0), Offset(0), Length(0),
+                                 tid(0), FD(-1), rc(0), isRun(false) {}
+      };
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
@@ -158,9 +202,6 @@ int XrdCksManager::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
             ~ioFD() {if (FD >= 0) close(FD);}
         } In;
    struct stat Stat;
-   char *inBuff;
-   off_t  Offset=0, fileSize;
-   size_t ioSize, calcSize;
    int rc;
 
 // Open the input file
@@ -171,23 +212,147 @@ int XrdCksManager::Calc(const char *Pfn, time_t &MTime, XrdCksCalc *csP)
 //
    if (fstat(In.FD, &Stat)) return -errno;
    if (!(Stat.st_mode & S_IFREG)) return -EPERM;
-   calcSize = fileSize = Stat.st_size;
    MTime = Stat.st_mtime;
 
-// We now compute checksum 64MB at a time using mmap I/O
+// If the file spans more than one segment, try to do this in parallel. This
+// only fails with ENOTSUP when the checksum cannot be done that way.
+//
+   if (parMax > 1 && Stat.st_size > (off_t)segSize
+   &&  (rc = CalcPar(Pfn, In.FD, Stat.st_size, csP)) != -ENOTSUP) return rc;
+
+// Compute the checksum sequentially
+//
+   return CalcRange(Pfn, In.FD, 0, Stat.st_size, csP);
+}
+
+/******************************************************************************/
+/* Private:                      C a l c P a r                                */
+/******************************************************************************/
+  
+int XrdCksManager::CalcPar(const char *Pfn, int fd, off_t fSize,
+                           XrdCksCalc *csP)
+{
+   csPart Part[parLim];
+   XrdCksCalcCombine *cmbP = dynamic_cast<XrdCksCalcCombine *>(csP);
+   off_t numSegs = (fSize + segSize - 1) / segSize, partLen, Offset = 0;
+   int i, numHelp, numParts, rc = 0;
+
+// The algorithm must be able to combine checksums for this to work
+//
+   if (!cmbP) return -ENOTSUP;
+
+// Reserve a helper thread for every part but the first, which is ours. If none
+// are available right now, the checksum is simply done sequentially.
+//
+   numParts = (numSegs < parMax ? numSegs : parMax);
+   if (!(numHelp = parGet(numParts-1))) return -ENOTSUP;
+
+// Each part is a whole number of segments so that all offsets are suitably
+// aligned for mmap(). Recompute the number of parts as rounding may need fewer.
+//
+   numParts = numHelp+1;
+   partLen  = ((numSegs + numParts - 1) / numParts) * segSize;
+   numParts = (fSize + partLen - 1) / partLen;
+   if (numParts-1 < numHelp) {parPut(numHelp - (numParts-1)); numHelp = numParts-1;}
+   if (numParts < 2) return -ENOTSUP;
+
+// Obtain a checksum object for each part except the first which is ours
+//
+   Part[0].csP = csP;
+   for (i = 1; i < numParts; i++)
+       if (!(Part[i].csP = csP->New())) break;
+   if (i < numParts)
+      {while(--i > 0) Part[i].csP->Recycle();
+       parPut(numHelp);
+       return -ENOTSUP;
+      }
+
+// Start a thread for every part but the first, which we will do ourselves. If
+// a thread cannot be started, we do that part inline when we wait for it.
+//
+   for (i = 0; i < numParts; i++)
+       {Part[i].Mgr    = this;
+        Part[i].Pfn    = Pfn;
+        Part[i].FD     = fd;
+        Part[i].Offset = Offset;
+        Part[i].Length = (fSize - Offset < partLen ? fSize - Offset : partLen);
+        Offset += Part[i].Length;
+        if (i && !XrdSysThread::Run(&Part[i].tid, CalcPart, (void *)&Part[i],
+                                    XRDSYSTHREAD_HOLD, "cks calc"))
+           Part[i].isRun = true;
+       }
+
+// Do the first part and then wait for the others to finish
+//
+   CalcPart((void *)&Part[0]);
+   for (i = 1; i < numParts; i++)
+       {if (Part[i].isRun) XrdSysThread::Join(Part[i].tid, 0);
+           else CalcPart((void *)&Part[i]);
+       }
+   parPut(numHelp);
+
+// Combine all of the partial checksums in order
 //
-   ioSize = (fileSize < (off_t)segSize ? fileSize : segSize); rc = 0;
+   for (i = 0; i < numParts; i++)
+       {if (!rc && (rc = Part[i].rc) == 0 && i
+        &&  !cmbP->Combine(*Part[i].csP, Part[i].Length)) rc = -EIO;
+        if (i) Part[i].csP->Recycle();
+       }
+
+// All done
+//
+   return rc;
+}
+
+/******************************************************************************/
+/* Private:                     C a l c P a r t                               */
+/******************************************************************************/
+  
+void *XrdCksManager::CalcPart(void *pP)
+{
+   csPart *partP = (csPart *)pP;
+
+// Compute the checksum for this part of the file
+//
+   partP->rc = partP->Mgr->CalcRange(partP->Pfn, partP->FD, partP->Offset,
+                                     partP->Length, partP->csP);
+   return (void *)0;
+}
+
+/******************************************************************************/
+/* Private:                    C a l c R a n g e                              */
+/******************************************************************************/
+  
+int XrdCksManager::CalcRange(const char *Pfn, int fd, off_t Offset,
+                             off_t Length, XrdCksCalc *csP)
+{
+   char *inBuff;
+   size_t ioSize, calcSize = Length;
+   int rc;
+
+// We now compute checksum 64MB at a time using mmap I/O. While we checksum a
+// segment we ask the kernel to read ahead the next one so that I/O overlaps
+// the computation, this double buffers algorithms that must be sequential.
+//
+   ioSize = (calcSize < (size_t)segSize ? calcSize : segSize); rc = 0;
    while(calcSize)
         {if ((inBuff = (char *)mmap(0, ioSize, PROT_READ, 
 #if defined(__FreeBSD__)
-                       MAP_RESERVED0040|MAP_PRIVATE, In.FD, Offset)) == MAP_FAILED)
+                       MAP_RESERVED0040|MAP_PRIVATE, fd, Offset)) == MAP_FAILED)
 #elif defined(__GNU__)
-                       MAP_PRIVATE, In.FD, Offset)) == MAP_FAILED)
+                       MAP_PRIVATE, fd, Offset)) == MAP_FAILED)
 #else
-                       MAP_NORESERVE|MAP_PRIVATE, In.FD, Offset)) == MAP_FAILED)
+                       MAP_NORESERVE|MAP_PRIVATE, fd, Offset)) == MAP_FAILED)
 #endif
             {rc = errno; eDest->Emsg("Cks", rc, "memory map", Pfn); break;}
          madvise(inBuff, ioSize, MADV_SEQUENTIAL);
+#if defined(__linux__) || (defined(__FreeBSD_kernel__) && defined(__GLIBC__))
+         if (calcSize > ioSize)
+            posix_fadvise(fd, Offset + ioSize,
+                          (calcSize - ioSize < (size_t)segSize
+                                  ? calcSize - ioSize : segSize),
+                          POSIX_FADV_WILLNEED);
+#endif
          csP->Update(inBuff, ioSize);
          calcSize -= ioSize; Offset += ioSize;
          if (munmap(inBuff, ioSize) < 0)
@@ -614,6 +779,20 @@ int XrdCksManager::Set(const char *Pfn, XrdCksData &Cks, int myTime)
    return xCS.Set(Pfn);
 }
 
+/******************************************************************************/
+/*                           S e t P a r a l l e l                            */
+/******************************************************************************/
+
+void XrdCksManager::SetParallel(int maxThreads)
+{
+   XrdSysMutexHelper mHelp(parMutex);
+
+   if (maxThreads < 1) maxThreads = 1;
+      else if (maxThreads > parLim) maxThreads = parLim;
+   parFree += maxThreads - parMax;
+   parMax   = maxThreads;
+}
+
 /******************************************************************************/
 /*                                   V e r                                    */
 /******************************************************************************/
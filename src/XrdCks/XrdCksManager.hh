@@ -68,6 +68,14 @@ virtual int         Size( const char  *Name=0);
 
 virtual int         Set(  const char *Pfn, XrdCksData &Cks, int myTime=0);
 
+/* SetParallel() sets the maximum number of threads used to calculate the
+                 checksum of a file spanning more than one segment with an
+                 algorithm that can combine checksums. The helper threads
+                 are shared by all checksum calculations in the process, so
+                 at most maxThreads-1 of them run at any one time.
+*/
+static void         SetParallel(int maxThreads);
+
 virtual int         Ver(  const char *Pfn, XrdCksData &Cks);
 
                     XrdCksManager(XrdSysError *erP, int iosz,
@@ -80,6 +88,9 @@ protected:
               supplied CksObj and places the file's modification time in MTime.
               Otherwise, it returns -errno. The default implementation uses
               open(), fstat(), mmap(), and unmap() to calculate the results.
+              When parallel checksumming is enabled and the algorithm can
+              combine checksums, large files are split into ranges that are
+              checksummed by separate threads.
 */
 virtual int         Calc(const char *Pfn, time_t &MTime, XrdCksCalc *CksObj);
 
@@ -103,10 +114,18 @@ struct csInfo
                                 {memset(Name, 0, sizeof(Name));}
       };
 
+struct csPart;
+
+int     CalcPar(const char *Pfn, int fd, off_t fSize, XrdCksCalc *csP);
+static
+void   *CalcPart(void *pP);
+int     CalcRange(const char *Pfn, int fd, off_t Offset, off_t Length,
+                  XrdCksCalc *csP);
 int     Config(const char *cFN, csInfo &Info);
 csInfo *Find(const char *Name);
 
 static const int csMax = 8;
+static const int parLim = 64;
 csInfo           csTab[csMax];
 int              csLast;
 int              segSize;
@@ -20,6 +20,7 @@
 #define SRC_XRDCL_XRDCLASYNCMSGREADER_HH_
 
 #include "XrdCl/XrdClMessage.hh"
+#include "XrdCl/XrdClBufferPool.hh"
 #include "XrdCl/XrdClPostMasterInterfaces.hh"
 #include "XrdCl/XrdClXRootDResponses.hh"
 #include "XrdCl/XrdClSocket.hh"
@@ -93,7 +94,8 @@ namespace XrdCl
             //------------------------------------------------------------------
             case ReadStart:
             {
-              inmsg = std::make_shared<Message>();
+              inmsg = std::allocate_shared<Message>(
+                        BufferPool::Allocator<Message>() );
               //----------------------------------------------------------------
               // The next step is to read the header
               //----------------------------------------------------------------
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClBuffer.hh"
+#include "XrdCl/XrdClBufferPool.hh"
+
+//------------------------------------------------------------------------------
+// A buffer's block may come from the pool or, when the buffer was filled by
+// Grab() or by code built against an older XrdClBuffer.hh, be a malloc block
+// of exactly the buffer size. Only blocks the pool recognizes as its own are
+// reused within their size class; anything else is reallocated or moved into
+// the pool when it has to grow.
+//------------------------------------------------------------------------------
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Reallocate the buffer to a new location of a given size
+  //----------------------------------------------------------------------------
+  void Buffer::ReAllocate( uint32_t size )
+  {
+    if( !pBuffer )
+    {
+      Allocate( size );
+      return;
+    }
+
+    uint32_t have = BufferPool::Capacity( pSize );
+    uint32_t need = BufferPool::Capacity( size );
+    if( have == need && BufferPool::Owns( pBuffer, have ) )
+    {
+      pSize = size;
+      return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Large blocks are not pooled, let realloc do its best with them; if it
+    // cannot shrink the block the old one is still big enough
+    //--------------------------------------------------------------------------
+    if( have > BufferPool::MaxSize && need > BufferPool::MaxSize )
+    {
+      char *buffer = (char *)realloc( pBuffer, size );
+      if( buffer )
+        pBuffer = buffer;
+      else if( size > pSize )
+        throw std::bad_alloc();
+      pSize = size;
+      return;
+    }
+
+    uint32_t capacity;
+    char *buffer = BufferPool::Get( size, capacity );
+    memcpy( buffer, pBuffer, pSize < size ? pSize : size );
+    BufferPool::Put( pBuffer, have );
+    pBuffer = buffer;
+    pSize   = size;
+  }
+
+  //----------------------------------------------------------------------------
+  // Free the buffer
+  //----------------------------------------------------------------------------
+  void Buffer::Free()
+  {
+    BufferPool::Put( pBuffer, BufferPool::Capacity( pSize ) );
+    pBuffer = 0;
+    pSize   = 0;
+    pCursor = 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Allocate the buffer
+  //----------------------------------------------------------------------------
+  void Buffer::Allocate( uint32_t size )
+  {
+    if( !size )
+     return;
+
+    uint32_t capacity;
+    pBuffer = BufferPool::Get( size, capacity );
+    pSize   = size;
+  }
+
+  //----------------------------------------------------------------------------
+  // Grab a buffer allocated outside with malloc
+  //----------------------------------------------------------------------------
+  void Buffer::Grab( char *buffer, uint32_t size )
+  {
+    Free();
+    pBuffer = buffer;
+    pSize   = size;
+  }
+}
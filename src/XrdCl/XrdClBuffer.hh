@@ -29,6 +29,11 @@ namespace XrdCl
 {
   //----------------------------------------------------------------------------
   //! Binary blob representation
+  //!
+  //! Small buffers are backed by a block of the size class of their size,
+  //! so growing or shrinking them within that class does not allocate. The
+  //! blocks are malloc blocks, Grab() takes and Release() gives ones that
+  //! are to be freed with free().
   //----------------------------------------------------------------------------
   class Buffer
   {
@@ -85,38 +90,17 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Reallocate the buffer to a new location of a given size
       //------------------------------------------------------------------------
-      void ReAllocate( uint32_t size )
-      {
-        pBuffer = (char *)realloc( pBuffer, size );
-        if( !pBuffer )
-          throw std::bad_alloc();
-        pSize = size;
-      }
+      void ReAllocate( uint32_t size );
 
       //------------------------------------------------------------------------
       //! Free the buffer
       //------------------------------------------------------------------------
-      void Free()
-      {
-        free( pBuffer );
-        pBuffer = 0;
-        pSize   = 0;
-        pCursor = 0;
-      }
+      void Free();
 
       //------------------------------------------------------------------------
       //! Allocate the buffer
       //------------------------------------------------------------------------
-      void Allocate( uint32_t size )
-      {
-        if( !size )
-         return;
-
-        pBuffer = (char *)malloc( size );
-        if( !pBuffer )
-          throw std::bad_alloc();
-        pSize = size;
-      }
+      void Allocate( uint32_t size );
 
       //------------------------------------------------------------------------
       //! Zero
@@ -223,17 +207,12 @@ namespace XrdCl
       }
 
       //------------------------------------------------------------------------
-      //! Grab a buffer allocated outside
+      //! Grab a buffer allocated outside with malloc
       //------------------------------------------------------------------------
-      void Grab( char *buffer, uint32_t size )
-      {
-        Free();
-        pBuffer = buffer;
-        pSize   = size;
-      }
+      void Grab( char *buffer, uint32_t size );
 
       //------------------------------------------------------------------------
-      //! Release the buffer
+      //! Release the buffer, it needs to be freed with free
       //------------------------------------------------------------------------
       char *Release()
       {
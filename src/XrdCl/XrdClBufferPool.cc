@@ -0,0 +1,431 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClBufferPool.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__linux__)
+#include <malloc.h>
+#endif
+
+namespace
+{
+  using XrdCl::BufferPool;
+
+  //----------------------------------------------------------------------------
+  // Size classes are the powers of two from MinSize to MaxSize
+  //----------------------------------------------------------------------------
+  const int nClasses = 11;
+  static_assert( ( BufferPool::MinSize << ( nClasses - 1 ) ) ==
+                 BufferPool::MaxSize, "size classes do not match" );
+
+  inline int ClassOf( uint32_t capacity )
+  {
+    return __builtin_ctz( capacity ) - __builtin_ctz( BufferPool::MinSize );
+  }
+
+  inline bool IsPooled( uint32_t capacity )
+  {
+    return capacity >= BufferPool::MinSize && capacity <= BufferPool::MaxSize &&
+           !( capacity & ( capacity - 1 ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // A pooled block is allocated with room for a tag word past its capacity.
+  // The tag depends on the address and the capacity so that a block that
+  // merely holds a copy of another block's data does not pass for a pool block.
+  //----------------------------------------------------------------------------
+  const uint32_t tagSize = sizeof( uint64_t );
+
+  inline uint64_t TagOf( const char *block, uint32_t capacity )
+  {
+    return (uint64_t)(uintptr_t)block ^ capacity ^ 0x58726443506f6f6cULL;
+  }
+
+  //----------------------------------------------------------------------------
+  // The number of bytes the allocator really gave a block, zero if we cannot
+  // tell, in which case nothing is ever taken back into the pool
+  //----------------------------------------------------------------------------
+  inline size_t UsableSize( const char *block )
+  {
+#if defined(__APPLE__)
+    return malloc_size( block );
+#elif defined(__linux__)
+    return malloc_usable_size( const_cast<char*>( block ) );
+#else
+    (void)block;
+    return 0;
+#endif
+  }
+
+  //----------------------------------------------------------------------------
+  // How many blocks of a class a thread and the depot may hold; we keep about
+  // 64kB per class in each thread and 1MB per class in the depot
+  //----------------------------------------------------------------------------
+  inline uint32_t ThreadSlots( int cls )
+  {
+    return std::max( 4u, ( 64u*1024 ) >> ( cls + 6 ) );
+  }
+
+  inline uint32_t DepotSlots( int cls )
+  {
+    return std::max( 16u, ( 1024u*1024 ) >> ( cls + 6 ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Per-thread cache. The counters are only written by the owning thread and
+  // read by GetStats(), hence relaxed loads and stores rather than atomic
+  // read-modify-write operations.
+  //----------------------------------------------------------------------------
+  struct ThreadCache
+  {
+    std::vector<char*>    blocks[nClasses];
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> puts;
+    std::atomic<uint64_t> frees;
+    std::atomic<uint64_t> foreign;
+    std::atomic<uint64_t> cached;
+
+    ThreadCache(): hits( 0 ), misses( 0 ), puts( 0 ), frees( 0 ), foreign( 0 ),
+                   cached( 0 )
+    {
+      for( int i = 0; i < nClasses; ++i )
+        blocks[i].reserve( ThreadSlots( i ) );
+    }
+
+    static void Bump( std::atomic<uint64_t> &ctr, int64_t n = 1 )
+    {
+      ctr.store( ctr.load( std::memory_order_relaxed ) + n,
+                 std::memory_order_relaxed );
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  // The shared depot, also keeping track of the thread caches and of the
+  // counters of threads that have exited
+  //----------------------------------------------------------------------------
+  struct Depot
+  {
+    XrdSysMutex             mutex;
+    std::vector<char*>      blocks[nClasses];
+    std::list<ThreadCache*> caches;
+    BufferPool::Stats       retired;
+    uint64_t                cached;
+
+    Depot(): retired(), cached( 0 ) {}
+  };
+
+  //----------------------------------------------------------------------------
+  // The depot is never destroyed so that buffers may be released during
+  // static destruction
+  //----------------------------------------------------------------------------
+  Depot &GetDepot()
+  {
+    static Depot *depot = new Depot();
+    return *depot;
+  }
+
+  //----------------------------------------------------------------------------
+  // Release a pool block, clearing its tag so that the memory does not pass
+  // for a pool block when malloc hands it out again
+  //----------------------------------------------------------------------------
+  void Release( char *block, uint32_t capacity )
+  {
+    memset( block + capacity, 0, tagSize );
+    free( block );
+  }
+
+  //----------------------------------------------------------------------------
+  // Move the blocks of a thread cache to the depot, releasing what does not
+  // fit (depot locked)
+  //----------------------------------------------------------------------------
+  void Drain( Depot &depot, ThreadCache *tc, int cls, uint32_t keep )
+  {
+    std::vector<char*> &from = tc->blocks[cls];
+    std::vector<char*> &to   = depot.blocks[cls];
+    uint32_t capacity = BufferPool::MinSize << cls;
+
+    while( from.size() > keep )
+    {
+      char *block = from.back();
+      from.pop_back();
+      ThreadCache::Bump( tc->cached, -(int64_t)capacity );
+      if( to.size() < DepotSlots( cls ) )
+      {
+        to.push_back( block );
+        depot.cached += capacity;
+      }
+      else
+      {
+        Release( block, capacity );
+        ThreadCache::Bump( tc->frees );
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Empty the cache of an exiting thread and keep its counters (depot locked)
+  //----------------------------------------------------------------------------
+  void Retire( Depot &depot, ThreadCache *tc )
+  {
+    for( int i = 0; i < nClasses; ++i )
+      Drain( depot, tc, i, 0 );
+    depot.retired.hits   += tc->hits.load( std::memory_order_relaxed );
+    depot.retired.misses += tc->misses.load( std::memory_order_relaxed );
+    depot.retired.puts   += tc->puts.load( std::memory_order_relaxed );
+    depot.retired.frees  += tc->frees.load( std::memory_order_relaxed );
+    depot.retired.foreign += tc->foreign.load( std::memory_order_relaxed );
+    depot.caches.remove( tc );
+  }
+
+  //----------------------------------------------------------------------------
+  // The thread cache is created on first use and retired when the thread
+  // exits. The pointer and the flag are trivially destructible so they stay
+  // valid while other thread-local objects are destroyed; after the guard has
+  // run the thread goes straight to the depot.
+  //----------------------------------------------------------------------------
+  thread_local ThreadCache *tlsCache = 0;
+  thread_local bool         tlsDone  = false;
+
+  struct CacheGuard
+  {
+    ~CacheGuard()
+    {
+      if( tlsCache )
+      {
+        Depot &depot = GetDepot();
+        XrdSysMutexHelper scopedLock( depot.mutex );
+        Retire( depot, tlsCache );
+        delete tlsCache;
+        tlsCache = 0;
+      }
+      tlsDone = true;
+    }
+  };
+  thread_local CacheGuard tlsGuard;
+
+  ThreadCache *GetCache()
+  {
+    if( tlsCache || tlsDone ) return tlsCache;
+    (void)&tlsGuard;
+
+    ThreadCache *tc = new ThreadCache();
+    Depot &depot = GetDepot();
+    XrdSysMutexHelper scopedLock( depot.mutex );
+    depot.caches.push_back( tc );
+    tlsCache = tc;
+    return tc;
+  }
+
+  //----------------------------------------------------------------------------
+  // Allocate a block with malloc, tagging it if it belongs to a size class
+  //----------------------------------------------------------------------------
+  inline char *Allocate( uint32_t capacity )
+  {
+    bool  pooled = IsPooled( capacity );
+    char *block  = (char*)malloc( pooled ? capacity + tagSize : capacity );
+    if( !block ) throw std::bad_alloc();
+    if( pooled )
+    {
+      uint64_t tag = TagOf( block, capacity );
+      memcpy( block + capacity, &tag, tagSize );
+    }
+    return block;
+  }
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Get a block of at least the given size
+  //----------------------------------------------------------------------------
+  char *BufferPool::Get( uint32_t size, uint32_t &capacity )
+  {
+    capacity = Capacity( size );
+    if( capacity > MaxSize ) return Allocate( capacity );
+
+    int          cls = ClassOf( capacity );
+    ThreadCache *tc  = GetCache();
+
+    //--------------------------------------------------------------------------
+    // Serve from the thread cache, refilling it with half its slots from the
+    // depot if empty
+    //--------------------------------------------------------------------------
+    if( tc )
+    {
+      std::vector<char*> &blocks = tc->blocks[cls];
+      if( blocks.empty() )
+      {
+        Depot &depot = GetDepot();
+        std::vector<char*> &from = depot.blocks[cls];
+        XrdSysMutexHelper scopedLock( depot.mutex );
+        uint32_t n = std::min<size_t>( from.size(), ThreadSlots( cls ) / 2 );
+        blocks.insert( blocks.end(), from.end() - n, from.end() );
+        from.resize( from.size() - n );
+        depot.cached -= (uint64_t)n * capacity;
+        ThreadCache::Bump( tc->cached, (int64_t)n * capacity );
+      }
+
+      if( !blocks.empty() )
+      {
+        char *block = blocks.back();
+        blocks.pop_back();
+        ThreadCache::Bump( tc->cached, -(int64_t)capacity );
+        ThreadCache::Bump( tc->hits );
+        return block;
+      }
+      ThreadCache::Bump( tc->misses );
+      return Allocate( capacity );
+    }
+
+    //--------------------------------------------------------------------------
+    // The thread is exiting, use the depot
+    //--------------------------------------------------------------------------
+    Depot &depot = GetDepot();
+    XrdSysMutexHelper scopedLock( depot.mutex );
+    std::vector<char*> &from = depot.blocks[cls];
+    if( from.empty() )
+    {
+      depot.retired.misses++;
+      scopedLock.UnLock();
+      return Allocate( capacity );
+    }
+    char *block = from.back();
+    from.pop_back();
+    depot.cached -= capacity;
+    depot.retired.hits++;
+    return block;
+  }
+
+  //----------------------------------------------------------------------------
+  // Hand back a block
+  //----------------------------------------------------------------------------
+  void BufferPool::Put( char *buffer, uint32_t capacity )
+  {
+    if( !buffer ) return;
+    if( !IsPooled( capacity ) )
+    {
+      free( buffer );
+      return;
+    }
+
+    ThreadCache *tc = GetCache();
+
+    //--------------------------------------------------------------------------
+    // Blocks that we did not allocate are released, they may be smaller than
+    // the size class
+    //--------------------------------------------------------------------------
+    if( !Owns( buffer, capacity ) )
+    {
+      if( tc ) ThreadCache::Bump( tc->foreign );
+      else
+      {
+        Depot &depot = GetDepot();
+        XrdSysMutexHelper scopedLock( depot.mutex );
+        depot.retired.foreign++;
+      }
+      free( buffer );
+      return;
+    }
+
+    int cls = ClassOf( capacity );
+
+    //--------------------------------------------------------------------------
+    // Keep it in the thread cache, moving half of it to the depot if full
+    //--------------------------------------------------------------------------
+    if( tc )
+    {
+      std::vector<char*> &blocks = tc->blocks[cls];
+      if( blocks.size() >= ThreadSlots( cls ) )
+      {
+        Depot &depot = GetDepot();
+        XrdSysMutexHelper scopedLock( depot.mutex );
+        Drain( depot, tc, cls, ThreadSlots( cls ) / 2 );
+      }
+      blocks.push_back( buffer );
+      ThreadCache::Bump( tc->cached, capacity );
+      ThreadCache::Bump( tc->puts );
+      return;
+    }
+
+    //--------------------------------------------------------------------------
+    // The thread is exiting, use the depot
+    //--------------------------------------------------------------------------
+    Depot &depot = GetDepot();
+    XrdSysMutexHelper scopedLock( depot.mutex );
+    depot.retired.puts++;
+    if( depot.blocks[cls].size() < DepotSlots( cls ) )
+    {
+      depot.blocks[cls].push_back( buffer );
+      depot.cached += capacity;
+      return;
+    }
+    depot.retired.frees++;
+    scopedLock.UnLock();
+    Release( buffer, capacity );
+  }
+
+  //----------------------------------------------------------------------------
+  // Check if a block was obtained from the pool with the given capacity
+  //----------------------------------------------------------------------------
+  bool BufferPool::Owns( const char *buffer, uint32_t capacity )
+  {
+    if( !buffer || !IsPooled( capacity ) ) return false;
+    if( UsableSize( buffer ) < capacity + tagSize ) return false;
+
+    uint64_t tag;
+    memcpy( &tag, buffer + capacity, tagSize );
+    return tag == TagOf( buffer, capacity );
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the pool statistics
+  //----------------------------------------------------------------------------
+  BufferPool::Stats BufferPool::GetStats()
+  {
+    Depot &depot = GetDepot();
+    XrdSysMutexHelper scopedLock( depot.mutex );
+    Stats stats = depot.retired;
+    stats.cachedBytes = depot.cached;
+    for( auto tc : depot.caches )
+    {
+      stats.hits        += tc->hits.load( std::memory_order_relaxed );
+      stats.misses      += tc->misses.load( std::memory_order_relaxed );
+      stats.puts        += tc->puts.load( std::memory_order_relaxed );
+      stats.frees       += tc->frees.load( std::memory_order_relaxed );
+      stats.foreign     += tc->foreign.load( std::memory_order_relaxed );
+      stats.cachedBytes += tc->cached.load( std::memory_order_relaxed );
+    }
+    return stats;
+  }
+}
@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_BUFFER_POOL_HH__
+#define __XRD_CL_BUFFER_POOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Size-classed pool of memory blocks used for messages and buffers.
+  //!
+  //! Requests up to MaxSize bytes are rounded up to a power of two (at least
+  //! MinSize) and served from a per-thread cache, which is refilled from and
+  //! drained to a shared depot in batches. Larger requests go straight to
+  //! malloc. Every block is an ordinary malloc block, so memory obtained here
+  //! may be released with free().
+  //!
+  //! A pooled block carries a tag word just past its capacity. Put() only
+  //! keeps blocks that the allocator reports to be large enough to hold the
+  //! tag and that carry it; anything else, such as an exact size block made
+  //! by code built against an older XrdClBuffer.hh, is released with free().
+  //----------------------------------------------------------------------------
+  class BufferPool
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Pool statistics
+      //------------------------------------------------------------------------
+      struct Stats
+      {
+        uint64_t hits;        //!< blocks served from the pool
+        uint64_t misses;      //!< blocks allocated with malloc
+        uint64_t puts;        //!< blocks handed back to the pool
+        uint64_t frees;       //!< pool blocks released with free
+        uint64_t foreign;     //!< blocks handed back that were not pool blocks
+        uint64_t cachedBytes; //!< bytes held by the pool
+      };
+
+      static const uint32_t MinSize = 64;
+      static const uint32_t MaxSize = 64*1024;
+
+      //------------------------------------------------------------------------
+      //! Get the capacity of the block that serves a request of given size
+      //------------------------------------------------------------------------
+      static uint32_t Capacity( uint32_t size )
+      {
+        if( size > MaxSize ) return size;
+        if( size <= MinSize ) return MinSize;
+        return 1u << ( 32 - __builtin_clz( size - 1 ) );
+      }
+
+      //------------------------------------------------------------------------
+      //! Get a block of at least the given size
+      //!
+      //! @param size     : the number of bytes needed
+      //! @param capacity : set to the usable size of the block
+      //! @return         : the block, never null (throws std::bad_alloc)
+      //------------------------------------------------------------------------
+      static char *Get( uint32_t size, uint32_t &capacity );
+
+      //------------------------------------------------------------------------
+      //! Hand back a block
+      //!
+      //! @param buffer   : the block, may be null
+      //! @param capacity : the number of bytes allocated for the block
+      //------------------------------------------------------------------------
+      static void Put( char *buffer, uint32_t capacity );
+
+      //------------------------------------------------------------------------
+      //! Check if a block was obtained from the pool with the given capacity
+      //!
+      //! @param buffer   : the block, may be null
+      //! @param capacity : the capacity it was obtained with
+      //! @return         : true if it is a pool block of that capacity
+      //------------------------------------------------------------------------
+      static bool Owns( const char *buffer, uint32_t capacity );
+
+      //------------------------------------------------------------------------
+      //! Get the pool statistics
+      //------------------------------------------------------------------------
+      static Stats GetStats();
+
+      //------------------------------------------------------------------------
+      //! Standard allocator drawing from the pool, mainly for allocate_shared
+      //------------------------------------------------------------------------
+      template<typename T>
+      struct Allocator
+      {
+        typedef T value_type;
+
+        Allocator() {}
+        template<typename U> Allocator( const Allocator<U>& ) {}
+
+        T *allocate( size_t n )
+        {
+          uint32_t capacity;
+          if( n * sizeof( T ) > UINT32_MAX ) throw std::bad_alloc();
+          return reinterpret_cast<T*>( Get( n * sizeof( T ), capacity ) );
+        }
+
+        void deallocate( T *ptr, size_t n )
+        {
+          Put( reinterpret_cast<char*>( ptr ), Capacity( n * sizeof( T ) ) );
+        }
+
+        template<typename U>
+        bool operator==( const Allocator<U>& ) const { return true; }
+        template<typename U>
+        bool operator!=( const Allocator<U>& ) const { return false; }
+      };
+  };
+}
+
+#endif // __XRD_CL_BUFFER_POOL_HH__
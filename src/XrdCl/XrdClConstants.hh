@@ -96,6 +96,8 @@ namespace XrdCl
   const int DefaultRetryWrtAtLBLimit       = 3;
   const int DefaultCpRetry                 = 0;
   const int DefaultCpUsePgWrtRd            = 1;
+  const int DefaultReadAheadBlocks         = 0;
+  const int DefaultReadAheadBlockSize      = 1024*1024;
 
   const char * const DefaultPollerPreference   = "built-in";
   const char * const DefaultNetworkStack       = "IPAuto";
@@ -161,7 +163,9 @@ namespace XrdCl
       { to_lower( "ZipMtlnCksum" ),            DefaultZipMtlnCksum },
       { to_lower( "IPNoShuffle" ),             DefaultIPNoShuffle },
       { to_lower( "WantTlsOnNoPgrw" ),         DefaultWantTlsOnNoPgrw },
-      { to_lower( "RetryWrtAtLBLimit" ),       DefaultRetryWrtAtLBLimit }
+      { to_lower( "RetryWrtAtLBLimit" ),       DefaultRetryWrtAtLBLimit },
+      { to_lower( "ReadAheadBlocks" ),         DefaultReadAheadBlocks },
+      { to_lower( "ReadAheadBlockSize" ),      DefaultReadAheadBlockSize }
     };
 
   static std::unordered_map<std::string, std::string> theDefaultStrs
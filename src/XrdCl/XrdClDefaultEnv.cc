@@ -306,6 +306,8 @@ namespace XrdCl
     REGISTER_VAR_INT( varsInt, "XRateThreshold",          DefaultXRateThreshold          );
     REGISTER_VAR_INT( varsInt, "CpRetry",                 DefaultCpRetry                 );
     REGISTER_VAR_INT( varsInt, "CpUsePgWrtRd",            DefaultCpUsePgWrtRd            );
+    REGISTER_VAR_INT( varsInt, "ReadAheadBlocks",         DefaultReadAheadBlocks         );
+    REGISTER_VAR_INT( varsInt, "ReadAheadBlockSize",      DefaultReadAheadBlockSize      );
 
     REGISTER_VAR_STR( varsStr, "ClientMonitor",           DefaultClientMonitor           );
     REGISTER_VAR_STR( varsStr, "ClientMonitorParam",      DefaultClientMonitorParam      );
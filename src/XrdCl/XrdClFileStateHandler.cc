@@ -38,6 +38,7 @@
 #include "XrdCl/XrdClJobManager.hh"
 #include "XrdCl/XrdClRedirectorRegistry.hh"
 #include "XrdCl/XrdClAnyObject.hh"
+#include "XrdCl/XrdClReadAhead.hh"
 
 #ifdef WITH_XRDEC
 #include "XrdCl/XrdClEcHandler.hh"
@@ -749,6 +750,7 @@ namespace XrdCl
     pIsChannelEncrypted( false ),
     pAllowBundledClose( false ),
     pReOpenHandler( 0 ),
+    pReadAhead( 0 ),
     pPlugin( plugin )
   {
     pFileHandle = new uint8_t[4];
@@ -782,6 +784,7 @@ namespace XrdCl
     pUseVirtRedirector( useVirtRedirector ),
     pAllowBundledClose( false ),
     pReOpenHandler( 0 ),
+    pReadAhead( 0 ),
     pPlugin( plugin )
   {
     pFileHandle = new uint8_t[4];
@@ -836,6 +839,7 @@ namespace XrdCl
     delete pLoadBalancer;
     delete [] pFileHandle;
     delete pLFileHandler;
+    delete pReadAhead;
   }
 
   //----------------------------------------------------------------------------
@@ -970,6 +974,16 @@ namespace XrdCl
   XRootDStatus FileStateHandler::Close( ResponseHandler *handler,
                                         uint16_t         timeout )
   {
+    //--------------------------------------------------------------------------
+    // Wait for the read-ahead requests to return before closing
+    //--------------------------------------------------------------------------
+    if( pReadAhead )
+    {
+      XRootDStatus st;
+      if( pReadAhead->DeferClose( handler, timeout, st ) )
+        return st;
+    }
+
     XrdSysMutexHelper scopedLock( pMutex );
 
     //--------------------------------------------------------------------------
@@ -1105,6 +1119,21 @@ namespace XrdCl
                                        void            *buffer,
                                        ResponseHandler *handler,
                                        uint16_t         timeout )
+  {
+    if( pReadAhead )
+      return pReadAhead->Read( offset, size, buffer, handler, timeout );
+
+    return ReadImpl( offset, size, buffer, handler, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Read a data chunk at a given offset bypassing the read-ahead
+  //----------------------------------------------------------------------------
+  XRootDStatus FileStateHandler::ReadImpl( uint64_t         offset,
+                                           uint32_t         size,
+                                           void            *buffer,
+                                           ResponseHandler *handler,
+                                           uint16_t         timeout )
   {
     XrdSysMutexHelper scopedLock( pMutex );
 
@@ -2509,6 +2538,24 @@ namespace XrdCl
       //------------------------------------------------------------------------
       ReSendQueuedMessages();
       pFileState  = Opened;
+
+      //------------------------------------------------------------------------
+      // Set up the read-ahead for files opened for reading
+      //------------------------------------------------------------------------
+      if( IsReadOnly() && !pDataServer->IsLocalFile() )
+      {
+        if( !pReadAhead )
+        {
+          int raBlocks    = DefaultReadAheadBlocks;
+          int raBlockSize = DefaultReadAheadBlockSize;
+          DefaultEnv::GetEnv()->GetInt( "ReadAheadBlocks", raBlocks );
+          DefaultEnv::GetEnv()->GetInt( "ReadAheadBlockSize", raBlockSize );
+          if( raBlocks > 0 && raBlockSize > 0 )
+            pReadAhead = new ReadAhead( this, raBlockSize, raBlocks );
+        }
+        if( pReadAhead )
+          pReadAhead->Start( pStatInfo ? pStatInfo->GetSize() : 0 );
+      }
     }
   }
 
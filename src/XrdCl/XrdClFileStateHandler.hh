@@ -55,6 +55,7 @@ namespace XrdCl
   class ResponseHandlerHolder;
   class Message;
   class EcHandler;
+  class ReadAhead;
 
   //----------------------------------------------------------------------------
   //! PgRead flags
@@ -242,6 +243,23 @@ namespace XrdCl
                                ResponseHandler  *handler,
                                uint16_t          timeout = 0 );
 
+      //------------------------------------------------------------------------
+      //! Read a data chunk at a given offset bypassing the read-ahead
+      //!
+      //! @param offset  offset from the beginning of the file
+      //! @param size    number of bytes to be read
+      //! @param buffer  a pointer to a buffer big enough to hold the data
+      //! @param handler handler to be notified when the response arrives
+      //! @param timeout timeout value, if 0 the environment default will be
+      //!                used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus ReadImpl( uint64_t         offset,
+                             uint32_t         size,
+                             void            *buffer,
+                             ResponseHandler *handler,
+                             uint16_t         timeout = 0 );
+
       //------------------------------------------------------------------------
       //! Write a data chunk at a given offset - async
       //!
@@ -863,6 +881,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       LocalFileHandler      *pLFileHandler;
 
+      //------------------------------------------------------------------------
+      // Reads ahead of a sequential or strided reader, if enabled
+      //------------------------------------------------------------------------
+      ReadAhead             *pReadAhead;
+
       //------------------------------------------------------------------------
       // Responsible for Writing/Reading erasure-coded files
       //------------------------------------------------------------------------
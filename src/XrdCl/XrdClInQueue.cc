@@ -22,9 +22,27 @@
 #include "XrdCl/XrdClMessage.hh"
 
 #include <arpa/inet.h>              // for network unmarshalling stuff
+#include <cstring>
 
 namespace XrdCl
 {
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  InQueue::InQueue()
+  {
+    memset( pPages, 0, sizeof( pPages ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  InQueue::~InQueue()
+  {
+    for( int i = 0; i < 256; ++i )
+      delete pPages[i];
+  }
+
   //----------------------------------------------------------------------------
   // Filter messages
   //----------------------------------------------------------------------------
@@ -59,6 +77,65 @@ namespace XrdCl
     return false;
   }
 
+  //----------------------------------------------------------------------------
+  // Get the slot of a SID
+  //----------------------------------------------------------------------------
+  InQueue::Slot *InQueue::GetSlot( uint16_t sid, bool create )
+  {
+    Page *&page = pPages[sid >> 8];
+    if( !page )
+    {
+      if( !create ) return 0;
+      page = new Page();
+    }
+    return &page->slots[sid & 0xff];
+  }
+
+  //----------------------------------------------------------------------------
+  // Store a handler in the slot of its SID
+  //----------------------------------------------------------------------------
+  void InQueue::SetHandler( uint16_t sid, MsgHandler *handler, time_t expires )
+  {
+    Slot *slot = GetSlot( sid, handler != 0 );
+    if( !slot ) return;
+
+    uint64_t &used = pPages[sid >> 8]->used[( sid & 0xff ) >> 6];
+    uint64_t  bit  = 1ULL << ( sid & 63 );
+    if( handler ) used |= bit;
+    else used &= ~bit;
+    slot->handler = handler;
+    slot->expires = expires;
+  }
+
+  //----------------------------------------------------------------------------
+  // Call a function for each handler; the function may change the table
+  // so the occupied slots are checked again before being used
+  //----------------------------------------------------------------------------
+  template<typename Func>
+  void InQueue::ForEachHandler( Func func )
+  {
+    for( int p = 0; p < 256; ++p )
+    {
+      Page *page = pPages[p];
+      if( !page ) continue;
+
+      for( int w = 0; w < 4; ++w )
+      {
+        uint64_t bits = page->used[w];
+        while( bits )
+        {
+          uint16_t sid = p << 8 | w << 6 | __builtin_ctzll( bits );
+          bits &= bits - 1;
+
+          Slot &slot = page->slots[sid & 0xff];
+          if( !slot.handler ) continue;
+          if( !func( slot.handler, slot.expires ) )
+            SetHandler( sid, 0, 0 );
+        }
+      }
+    }
+  }
+
   //----------------------------------------------------------------------------
   // Add a message to the queue
   //----------------------------------------------------------------------------
@@ -73,17 +150,17 @@ namespace XrdCl
       return true;
     }
 
-    // Lookup the sid in the map of handlers
+    // Lookup the sid in the table of handlers
     pMutex.Lock();
-    HandlerMap::iterator it = pHandlers.find(msgSid);
+    Slot *slot = GetSlot( msgSid, false );
 
-    if (it != pHandlers.end())
+    if( slot && slot->handler )
     {
-      handler = it->second.first;
+      handler = slot->handler;
       action  = handler->Examine( msg );
 
       if( action & MsgHandler::RemoveHandler )
-        pHandlers.erase( it );
+        SetHandler( msgSid, 0, 0 );
     }
     else
       pMessages[msgSid] = msg;
@@ -102,18 +179,18 @@ namespace XrdCl
   void InQueue::AddMessageHandler( MsgHandler *handler, time_t expires, bool &rmMsg )
   {
     uint16_t handlerSid = handler->GetSid();
-    XrdSysMutexHelper scopedLock( pMutex );
-    MessageMap::iterator it = pMessages.find(handlerSid);
 
     //--------------------------------------------------------------------------
     // If there is a leftover message in the in-queue simply remove it, there's
     // no way this is the actual message we are waiting for as we just send it
     // over the wire and we are still occupying the event-loop thread
     //--------------------------------------------------------------------------
+    XrdSysMutexHelper scopedLock( pMutex );
+    MessageMap::iterator it = pMessages.find(handlerSid);
     if( ( rmMsg = it != pMessages.end() ) )
       pMessages.erase( it );
 
-    pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+    SetHandler( handlerSid, handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -121,8 +198,8 @@ namespace XrdCl
   // is stored in msg
   //----------------------------------------------------------------------------
   MsgHandler *InQueue::GetHandlerForMessage( std::shared_ptr<Message> &msg,
-						                                         time_t                   &expires,
-						                                         uint16_t                 &action )
+                                             time_t                   &expires,
+                                             uint16_t                 &action )
   {
     time_t   exp = 0;
     uint16_t act = 0;
@@ -135,20 +212,17 @@ namespace XrdCl
     }
 
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.find(msgSid);
+    Slot *slot = GetSlot( msgSid, false );
 
-    if (it != pHandlers.end())
+    if( slot && slot->handler )
     {
-      handler = it->second.first;
+      handler = slot->handler;
       act     = handler->Examine( msg );
-      exp     = it->second.second;
+      exp     = slot->expires;
 
       if( act & MsgHandler::RemoveHandler )
-        pHandlers.erase( it );
-    }
+        SetHandler( msgSid, 0, 0 );
 
-    if( handler )
-    {
       expires = exp;
       action  = act;
     }
@@ -160,11 +234,10 @@ namespace XrdCl
   // Re-insert the handler without scanning the cached messages
   //----------------------------------------------------------------------------
   void InQueue::ReAddMessageHandler( MsgHandler *handler,
-				     time_t              expires )
+                                     time_t      expires )
   {
-    uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+    SetHandler( handler->GetSid(), handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -172,32 +245,22 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void InQueue::RemoveMessageHandler( MsgHandler *handler )
   {
-    uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers.erase(handlerSid);
+    SetHandler( handler->GetSid(), 0, 0 );
   }
 
   //----------------------------------------------------------------------------
   // Report an event to the handlers
   //----------------------------------------------------------------------------
   void InQueue::ReportStreamEvent( MsgHandler::StreamEvent event,
-				   XRootDStatus                    status )
+                                   XRootDStatus            status )
   {
-    uint8_t action = 0;
     XrdSysMutexHelper scopedLock( pMutex );
-    for( HandlerMap::iterator it = pHandlers.begin(); it != pHandlers.end(); )
+    ForEachHandler( [&]( MsgHandler *handler, time_t )
     {
-      action = it->second.first->OnStreamEvent( event, status );
-
-      if( action & MsgHandler::RemoveHandler )
-      {
-        auto next = it; ++next;
-        pHandlers.erase( it );
-        it = next;
-      }
-      else
-        ++it;
-    }
+      uint8_t action = handler->OnStreamEvent( event, status );
+      return !( action & MsgHandler::RemoveHandler );
+    } );
   }
 
   //----------------------------------------------------------------------------
@@ -209,20 +272,12 @@ namespace XrdCl
       now = ::time(0);
 
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.begin();
-    while( it != pHandlers.end() )
+    ForEachHandler( [&]( MsgHandler *handler, time_t expires )
     {
-      if( it->second.second <= now )
-      {
-        uint8_t act = it->second.first->OnStreamEvent( MsgHandler::Timeout,
-                                         Status( stError, errOperationExpired ) );
-        auto next = it; ++next;
-        if( act & MsgHandler::RemoveHandler )
-          pHandlers.erase( it );
-        it = next;
-      }
-      else
-        ++it;
-    }
+      if( expires > now ) return true;
+      uint8_t act = handler->OnStreamEvent( MsgHandler::Timeout,
+                                            Status( stError, errOperationExpired ) );
+      return !( act & MsgHandler::RemoveHandler );
+    } );
   }
 }
@@ -32,10 +32,27 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! A synchronize queue for incoming data
+  //!
+  //! The handlers are kept in a table indexed by SID made of 256 pages of 256
+  //! slots, a page being allocated when the first handler for a SID in it is
+  //! added, so that neither adding nor finding a handler allocates memory or
+  //! walks a tree. Like before, the handlers are called with the recursive
+  //! queue mutex held: a handler is never called from two threads at the
+  //! same time and may add or remove handlers from within its callbacks.
   //----------------------------------------------------------------------------
   class InQueue
   {
     public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      InQueue();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~InQueue();
+
       //------------------------------------------------------------------------
       //! Add a fully reconstructed message to the queue
       //------------------------------------------------------------------------
@@ -100,11 +117,44 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool DiscardMessage(Message& msg, uint16_t& sid) const;
 
-      typedef std::pair<MsgHandler *, time_t> HandlerAndExpire;
-      typedef std::map<uint16_t, HandlerAndExpire> HandlerMap;
+      struct Slot
+      {
+        MsgHandler *handler;
+        time_t      expires;
+      };
+
+      struct Page
+      {
+        Slot     slots[256];
+        uint64_t used[4];   //!< slots holding a handler
+      };
+
+      //------------------------------------------------------------------------
+      //! Get the slot of a SID, must be called with the mutex held
+      //!
+      //! @param sid    : the SID
+      //! @param create : create the page if it does not exist
+      //!
+      //! @return the slot or null if its page does not exist
+      //------------------------------------------------------------------------
+      Slot *GetSlot( uint16_t sid, bool create );
+
+      //------------------------------------------------------------------------
+      //! Store a handler in the slot of its SID, null removes it; must be
+      //! called with the mutex held
+      //------------------------------------------------------------------------
+      void SetHandler( uint16_t sid, MsgHandler *handler, time_t expires );
+
+      //------------------------------------------------------------------------
+      //! Call a function for each handler, removing the handler if it returns
+      //! false; must be called with the mutex held
+      //------------------------------------------------------------------------
+      template<typename Func>
+      void ForEachHandler( Func func );
+
       typedef std::map<uint16_t, std::shared_ptr<Message>> MessageMap;
-      MessageMap pMessages;
-      HandlerMap pHandlers;
+      MessageMap     pMessages;
+      Page          *pPages[256];
       XrdSysRecMutex pMutex;
   };
 }
@@ -201,7 +201,6 @@ namespace XrdCl
       {
           msg = new Message( sizeof(Request) +  payloadSize );
           req = (Request*)msg->GetBuffer();
-          msg->Zero();
       }
 
       //------------------------------------------------------------------------
@@ -0,0 +1,720 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClReadAhead.hh"
+#include "XrdCl/XrdClFileStateHandler.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClPostMaster.hh"
+#include "XrdCl/XrdClJobManager.hh"
+#include "XrdCl/XrdClLocalFileTask.hh"
+#include "XrdCl/XrdClMessageUtils.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Stride value denoting a sequential read pattern
+  //----------------------------------------------------------------------------
+  const int64_t kSequential = INT64_MIN;
+
+  //----------------------------------------------------------------------------
+  // Monotonic time in microseconds
+  //----------------------------------------------------------------------------
+  inline uint64_t Now()
+  {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(
+             steady_clock::now().time_since_epoch() ).count();
+  }
+
+  //----------------------------------------------------------------------------
+  // Hand a response to the job manager so that the user handler is not
+  // called from within Read() or with our locks held; a sync handler only
+  // posts a semaphore, so it is called right away
+  //----------------------------------------------------------------------------
+  void QueueResponse( XrdCl::XRootDStatus *status, XrdCl::AnyObject *resp,
+                      XrdCl::HostList *hosts, XrdCl::ResponseHandler *handler )
+  {
+    using namespace XrdCl;
+
+    SyncResponseHandler *syncHandler =
+        dynamic_cast<SyncResponseHandler*>( handler );
+    if( syncHandler )
+    {
+      syncHandler->HandleResponseWithHosts( status, resp, hosts );
+      return;
+    }
+
+    JobManager *jmngr = DefaultEnv::GetPostMaster()->GetJobManager();
+    jmngr->QueueJob( new LocalFileTask( status, resp, hosts, handler ) );
+  }
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // What the block handlers know about the read-ahead; cleared when it is
+  // destroyed, after which the handlers free their blocks themselves
+  //----------------------------------------------------------------------------
+  struct ReadAhead::Anchor
+  {
+    Anchor( ReadAhead *readAhead ): readAhead( readAhead ) {}
+
+    XrdSysMutex  mutex;
+    ReadAhead   *readAhead;
+  };
+
+  //----------------------------------------------------------------------------
+  // A block of the file that has been requested ahead of the reader
+  //----------------------------------------------------------------------------
+  struct ReadAhead::Block
+  {
+    enum State { Pending, Ready, Failed };
+
+    uint64_t             offset;
+    uint32_t             size;    // bytes requested
+    uint32_t             length;  // bytes received
+    char                *data;
+    uint64_t             issued;  // when the request was sent
+    uint64_t             ready;   // when the response arrived
+    State                state;
+    int                  pins;    // waiters referring to this block
+    bool                 used;    // a read has been served from it
+    std::vector<Waiter*> waiters; // waiters for a pending block
+  };
+
+  //----------------------------------------------------------------------------
+  // A user read that is served from the ring
+  //----------------------------------------------------------------------------
+  struct ReadAhead::Waiter
+  {
+    uint64_t             offset;
+    uint32_t             size;
+    char                *buffer;
+    ResponseHandler     *handler;
+    uint16_t             timeout;
+    uint32_t             pending; // blocks still in flight
+    bool                 failed;  // one of the blocks could not be read
+    ChunkInfo           *info;    // the response, once complete
+    std::vector<Block*>  blocks;
+  };
+
+  //----------------------------------------------------------------------------
+  // Handler for a read-ahead request
+  //----------------------------------------------------------------------------
+  class ReadAhead::BlockHandler: public ResponseHandler
+  {
+    public:
+      BlockHandler( const std::shared_ptr<Anchor> &anchor, Block *block ):
+        pAnchor( anchor ), pBlock( block )
+      {
+      }
+
+      virtual void HandleResponse( XRootDStatus *status, AnyObject *response )
+      {
+        {
+          XrdSysMutexHelper scopedLock( pAnchor->mutex );
+          if( pAnchor->readAhead )
+            pAnchor->readAhead->Done( pBlock, status, response );
+          else
+          {
+            delete [] pBlock->data;
+            delete pBlock;
+            delete status;
+            delete response;
+          }
+        }
+        delete this;
+      }
+
+    private:
+      std::shared_ptr<Anchor>  pAnchor;
+      Block                   *pBlock;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  ReadAhead::ReadAhead( FileStateHandler *stateHandler, uint32_t blockSize,
+                        uint32_t maxBlocks ):
+    pStateHandler( stateHandler ),
+    pAnchor( std::make_shared<Anchor>( this ) ),
+    pCloseHandler( 0 ),
+    pFileSize( 0 ),
+    pLastOffset( 0 ),
+    pNextOffset( 0 ),
+    pStride( 0 ),
+    pRtt( 0 ),
+    pBandwidth( 0 ),
+    pLastDone( 0 ),
+    pLastSize( 0 ),
+    pBlockSize( blockSize ),
+    pMaxBlocks( std::max( maxBlocks, 1u ) ),
+    pWindow( 1 ),
+    pInFlight( 0 ),
+    pStreak( 0 ),
+    pCloseTimeout( 0 ),
+    pHavePlan( false ),
+    pStopped( true )
+  {
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  ReadAhead::~ReadAhead()
+  {
+    //--------------------------------------------------------------------------
+    // Once the anchor is cleared no block handler looks at us anymore. The
+    // blocks still in flight are left to their handlers and the reads that
+    // were waiting for them fail. This only happens if the file object is
+    // destroyed without being closed.
+    //--------------------------------------------------------------------------
+    {
+      XrdSysMutexHelper scopedLock( pAnchor->mutex );
+      pAnchor->readAhead = 0;
+    }
+
+    std::vector<Waiter*> orphans;
+    for( auto block : pRing )
+    {
+      if( block->state != Block::Pending )
+      {
+        Recycle( block );
+        continue;
+      }
+      for( auto waiter : block->waiters )
+        if( !--waiter->pending ) orphans.push_back( waiter );
+    }
+
+    for( auto waiter : orphans )
+    {
+      QueueResponse( new XRootDStatus( stError, errOperationInterrupted ), 0,
+                     0, waiter->handler );
+      delete waiter;
+    }
+
+    for( auto buff : pFreeBuff )
+      delete [] buff;
+  }
+
+  //----------------------------------------------------------------------------
+  // Defer a close until all read-ahead requests have returned
+  //----------------------------------------------------------------------------
+  bool ReadAhead::DeferClose( ResponseHandler *handler, uint16_t timeout,
+                              XRootDStatus &status )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    //--------------------------------------------------------------------------
+    // Stop the read-ahead and release whatever is not needed anymore
+    //--------------------------------------------------------------------------
+    pStopped = true;
+    while( Evict( true, 0, 0 ) ) {}
+
+    if( pCloseHandler )
+    {
+      status = XRootDStatus( stError, errInProgress );
+      return true;
+    }
+
+    if( !pInFlight ) return false;
+
+    DefaultEnv::GetLog()->Debug( FileMsg, "[0x%x] Deferring close until %d "
+                                 "read-ahead requests return", pStateHandler,
+                                 pInFlight );
+    pCloseHandler = handler;
+    pCloseTimeout = timeout;
+    status        = XRootDStatus();
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Read a data chunk, from the ring if possible
+  //----------------------------------------------------------------------------
+  XRootDStatus ReadAhead::Read( uint64_t         offset,
+                                uint32_t         size,
+                                void            *buffer,
+                                ResponseHandler *handler,
+                                uint16_t         timeout )
+  {
+    std::vector<Block*> cover, issue;
+    Waiter    *waiter = 0;
+    ChunkInfo *info   = 0;
+    XRootDStatus st;
+
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      if( pStopped || !size )
+      {
+        scopedLock.UnLock();
+        return pStateHandler->ReadImpl( offset, size, buffer, handler,
+                                        timeout );
+      }
+
+      //------------------------------------------------------------------------
+      // Follow the read pattern and see if the ring covers this read
+      //------------------------------------------------------------------------
+      Track( offset, size );
+      if( Cover( offset, size, cover ) )
+      {
+        uint64_t now = Now();
+        waiter = new Waiter{ offset, size, (char*)buffer, handler, timeout,
+                             0, false, 0, cover };
+        for( auto block : cover )
+        {
+          block->pins++;
+          block->used = true;
+          if( block->state == Block::Pending )
+          {
+            block->waiters.push_back( waiter );
+            waiter->pending++;
+          }
+        }
+
+        //----------------------------------------------------------------------
+        // If the reader has to wait we are not far enough ahead. If the data
+        // has been sitting here for a while we are further ahead than needed.
+        //----------------------------------------------------------------------
+        if( waiter->pending )
+          pWindow = std::min( std::max( pWindow * 2, 2u ), WindowCap() );
+        else if( pWindow > 1 && now - cover[0]->ready > 2 * pRtt )
+          pWindow--;
+
+        if( !waiter->pending ) info = Copy( waiter );
+      }
+
+      //------------------------------------------------------------------------
+      // Drop what is behind the reader and request what is ahead of it
+      //------------------------------------------------------------------------
+      while( Evict( false, offset, size ) ) {}
+      if( pStreak ) Plan( offset, size, issue );
+    }
+
+    //--------------------------------------------------------------------------
+    // A read that is not in the ring goes out before the read-ahead so that
+    // it does not queue up behind it
+    //--------------------------------------------------------------------------
+    if( !waiter )
+      st = pStateHandler->ReadImpl( offset, size, buffer, handler, timeout );
+
+    if( !issue.empty() ) Fetch( issue, timeout );
+
+    //--------------------------------------------------------------------------
+    // If everything was here, respond right away
+    //--------------------------------------------------------------------------
+    if( info )
+    {
+      AnyObject *obj = new AnyObject();
+      obj->Set( info );
+      QueueResponse( new XRootDStatus(), obj, new HostList(), handler );
+      delete waiter;
+    }
+    return st;
+  }
+
+  //----------------------------------------------------------------------------
+  // (Re)enable read-ahead after the file has been opened
+  //----------------------------------------------------------------------------
+  void ReadAhead::Start( uint64_t fileSize )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    pFileSize = fileSize;
+    pLastSize = 0;
+    pStreak   = 0;
+    pStride   = 0;
+    pWindow   = std::min( 2u, pMaxBlocks );
+    pHavePlan = false;
+    pStopped  = false;
+  }
+
+  //----------------------------------------------------------------------------
+  // Copy the data for a waiter whose blocks have all arrived (locked)
+  //----------------------------------------------------------------------------
+  ChunkInfo *ReadAhead::Copy( Waiter *waiter )
+  {
+    uint64_t cur = waiter->offset, end = waiter->offset + waiter->size;
+    bool eof = false;
+
+    for( auto block : waiter->blocks )
+    {
+      if( !eof && cur < end )
+      {
+        uint64_t bEnd = block->offset + block->length;
+        if( block->offset <= cur && cur < bEnd )
+        {
+          uint64_t n = std::min( end, bEnd ) - cur;
+          memcpy( waiter->buffer + ( cur - waiter->offset ),
+                  block->data + ( cur - block->offset ), n );
+          cur += n;
+        }
+        if( block->length < block->size ) eof = true;
+      }
+      block->pins--;
+    }
+    return new ChunkInfo( waiter->offset, cur - waiter->offset,
+                          waiter->buffer );
+  }
+
+  //----------------------------------------------------------------------------
+  // Find the blocks that cover a read (locked)
+  //----------------------------------------------------------------------------
+  bool ReadAhead::Cover( uint64_t offset, uint32_t size,
+                         std::vector<Block*> &blocks )
+  {
+    uint64_t cur = offset, end = offset + size;
+
+    while( cur < end )
+    {
+      Block *found = 0;
+      for( auto block : pRing )
+        if( block->state != Block::Failed && block->offset <= cur &&
+            cur < block->offset + block->size )
+        {
+          found = block;
+          break;
+        }
+
+      if( !found )
+      {
+        blocks.clear();
+        return false;
+      }
+
+      //------------------------------------------------------------------------
+      // A short block marks the end of the file, nothing lies beyond it
+      //------------------------------------------------------------------------
+      blocks.push_back( found );
+      if( found->state == Block::Ready && found->length < found->size ) break;
+      cur = found->offset + found->size;
+    }
+    return !blocks.empty();
+  }
+
+  //----------------------------------------------------------------------------
+  // Handle a returning read-ahead request
+  //----------------------------------------------------------------------------
+  void ReadAhead::Done( Block *block, XRootDStatus *status,
+                        AnyObject *response )
+  {
+    std::vector<Waiter*> waiters;
+    ResponseHandler *closeHandler = 0;
+    uint16_t closeTimeout = 0;
+    ChunkInfo *chunk = 0;
+    uint64_t now = Now();
+
+    if( status->IsOK() && response ) response->Get( chunk );
+
+    {
+      XrdSysMutexHelper scopedLock( pMutex );
+      pInFlight--;
+
+      //------------------------------------------------------------------------
+      // Record the outcome and update the round trip time and bandwidth
+      //------------------------------------------------------------------------
+      if( chunk )
+      {
+        uint64_t rtt  = std::max( now - block->issued, (uint64_t)1 );
+        uint64_t span = pLastDone ? std::min( now - pLastDone, rtt ) : rtt;
+        uint64_t bw   = (uint64_t)chunk->length * 1000000 /
+                        std::max( span, (uint64_t)1 );
+        pRtt          = pRtt ? ( 7 * pRtt + rtt ) / 8 : rtt;
+        pBandwidth    = pBandwidth ? ( 7 * pBandwidth + bw ) / 8 : bw;
+        pLastDone     = now;
+        block->length = chunk->length;
+        block->ready  = now;
+        block->state  = Block::Ready;
+      }
+      else
+      {
+        DefaultEnv::GetLog()->Debug( FileMsg, "[0x%x] Read-ahead of %d@%ld "
+                                     "failed: %s", pStateHandler, block->size,
+                                     block->offset, status->ToStr().c_str() );
+        block->state = Block::Failed;
+      }
+
+      //------------------------------------------------------------------------
+      // Complete the waiters that were waiting for this block
+      //------------------------------------------------------------------------
+      for( auto waiter : block->waiters )
+      {
+        if( block->state == Block::Failed ) waiter->failed = true;
+        if( --waiter->pending ) continue;
+        if( waiter->failed )
+          for( auto b : waiter->blocks ) b->pins--;
+        else waiter->info = Copy( waiter );
+        waiters.push_back( waiter );
+      }
+      block->waiters.clear();
+
+      if( pStopped )
+      {
+        while( Evict( true, 0, 0 ) ) {}
+        if( !pInFlight && pCloseHandler )
+        {
+          closeHandler  = pCloseHandler;
+          closeTimeout  = pCloseTimeout;
+          pCloseHandler = 0;
+        }
+      }
+    }
+
+    delete status;
+    delete response;
+
+    Finish( waiters );
+
+    //--------------------------------------------------------------------------
+    // Issue the close that was waiting for us
+    //--------------------------------------------------------------------------
+    if( closeHandler )
+    {
+      XRootDStatus st = pStateHandler->Close( closeHandler, closeTimeout );
+      if( !st.IsOK() )
+        QueueResponse( new XRootDStatus( st ), 0, 0, closeHandler );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop one block that is behind the reader, or any block that is no longer
+  // needed if any is true (locked)
+  //----------------------------------------------------------------------------
+  bool ReadAhead::Evict( bool any, uint64_t offset, uint32_t size )
+  {
+    for( auto it = pRing.begin(); it != pRing.end(); ++it )
+    {
+      Block *block = *it;
+      if( block->pins || block->state == Block::Pending ) continue;
+      if( !any && block->state == Block::Ready )
+      {
+        bool behind = ( pStride < 0 && pStride != kSequential ) ?
+                      block->offset >= offset + size :
+                      block->offset + block->size <= offset;
+        if( !behind ) continue;
+      }
+
+      //------------------------------------------------------------------------
+      // A block that was never read means we are reading too far ahead
+      //------------------------------------------------------------------------
+      if( !block->used && block->state == Block::Ready && !pStopped &&
+          pWindow > 1 ) pWindow--;
+      pRing.erase( it );
+      Recycle( block );
+      return true;
+    }
+    return false;
+  }
+
+  //----------------------------------------------------------------------------
+  // Send the read-ahead requests
+  //----------------------------------------------------------------------------
+  void ReadAhead::Fetch( std::vector<Block*> &blocks, uint16_t timeout )
+  {
+    for( auto block : blocks )
+    {
+      BlockHandler *handler = new BlockHandler( pAnchor, block );
+      XRootDStatus st = pStateHandler->ReadImpl( block->offset, block->size,
+                                                 block->data, handler,
+                                                 timeout );
+      if( !st.IsOK() )
+      {
+        delete handler;
+        Done( block, new XRootDStatus( st ), 0 );
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Respond to completed waiters, reading through if the ring failed them
+  //----------------------------------------------------------------------------
+  void ReadAhead::Finish( std::vector<Waiter*> &waiters )
+  {
+    for( auto waiter : waiters )
+    {
+      if( waiter->failed )
+      {
+        XRootDStatus st = pStateHandler->ReadImpl( waiter->offset,
+                                                   waiter->size,
+                                                   waiter->buffer,
+                                                   waiter->handler,
+                                                   waiter->timeout );
+        if( !st.IsOK() )
+          QueueResponse( new XRootDStatus( st ), 0, 0, waiter->handler );
+      }
+      else
+      {
+        AnyObject *obj = new AnyObject();
+        obj->Set( waiter->info );
+        QueueResponse( new XRootDStatus(), obj, new HostList(),
+                       waiter->handler );
+      }
+      delete waiter;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Create the blocks needed to keep the window ahead of the reader (locked)
+  //----------------------------------------------------------------------------
+  void ReadAhead::Plan( uint64_t offset, uint32_t size,
+                        std::vector<Block*> &blocks )
+  {
+    bool     seq    = pStride == kSequential;
+    bool     back   = !seq && pStride < 0;
+    uint32_t bSize  = seq ? pBlockSize : size;
+    uint64_t rdEnd  = offset + size;
+    uint32_t ahead  = 0, window;
+
+    //--------------------------------------------------------------------------
+    // We only follow strides that do not overlap and fit in a block
+    //--------------------------------------------------------------------------
+    if( !seq && ( size > pBlockSize ||
+                  (uint64_t)( back ? -pStride : pStride ) < size ) )
+      return;
+
+    //--------------------------------------------------------------------------
+    // The window must at least cover the next read
+    //--------------------------------------------------------------------------
+    window = std::min( WindowCap(), pWindow );
+    if( seq ) window = std::max( window, ( size + bSize - 1 ) / bSize );
+    window = std::min( window, pMaxBlocks );
+
+    //--------------------------------------------------------------------------
+    // Count what is already ahead of the reader
+    //--------------------------------------------------------------------------
+    for( auto block : pRing )
+    {
+      if( block->state == Block::Failed ) continue;
+      if( back ? block->offset < offset : block->offset + block->size > rdEnd )
+        ahead++;
+    }
+
+    //--------------------------------------------------------------------------
+    // Figure out where the next block starts. If the reader got ahead of us
+    // or the pattern changed, start right after the current read.
+    //--------------------------------------------------------------------------
+    if( seq )
+    {
+      if( !pHavePlan || pNextOffset < rdEnd ) pNextOffset = rdEnd;
+    }
+    else if( !pHavePlan || ( back ? pNextOffset >= offset
+                                  : pNextOffset <= offset ) )
+    {
+      if( back && offset < (uint64_t)-pStride ) return;
+      pNextOffset = offset + pStride;
+    }
+    pHavePlan = true;
+
+    //--------------------------------------------------------------------------
+    // Create the blocks
+    //--------------------------------------------------------------------------
+    uint64_t now = Now();
+    while( ahead < window )
+    {
+      if( pFileSize && pNextOffset >= pFileSize ) break;
+      if( pRing.size() >= pMaxBlocks && !Evict( true, 0, 0 ) ) break;
+
+      Block *block = new Block();
+      block->offset = pNextOffset;
+      block->size   = bSize;
+      block->length = 0;
+      block->issued = now;
+      block->ready  = 0;
+      block->state  = Block::Pending;
+      block->pins   = 0;
+      block->used   = false;
+      if( pFreeBuff.empty() ) block->data = new char[pBlockSize];
+      else
+      {
+        block->data = pFreeBuff.back();
+        pFreeBuff.pop_back();
+      }
+      pRing.push_back( block );
+      blocks.push_back( block );
+      pInFlight++;
+      ahead++;
+
+      if( seq ) pNextOffset += bSize;
+      else
+      {
+        if( back && pNextOffset < (uint64_t)-pStride ) break;
+        pNextOffset += pStride;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Release a block that is no longer in the ring (locked)
+  //----------------------------------------------------------------------------
+  void ReadAhead::Recycle( Block *block )
+  {
+    if( pFreeBuff.size() < pMaxBlocks ) pFreeBuff.push_back( block->data );
+    else delete [] block->data;
+    delete block;
+  }
+
+  //----------------------------------------------------------------------------
+  // Follow the read pattern (locked)
+  //----------------------------------------------------------------------------
+  void ReadAhead::Track( uint64_t offset, uint32_t size )
+  {
+    int64_t delta = (int64_t)( offset - pLastOffset );
+
+    if( pLastSize && delta == (int64_t)pLastSize )
+    {
+      if( pStride != kSequential )
+      {
+        pStride   = kSequential;
+        pStreak   = 0;
+        pHavePlan = false;
+      }
+      pStreak++;
+    }
+    else if( pLastSize && delta == pStride && delta != 0 ) pStreak++;
+    else
+    {
+      pStride   = pLastSize ? delta : 0;
+      pStreak   = 0;
+      pHavePlan = false;
+    }
+
+    pLastOffset = offset;
+    pLastSize   = size;
+  }
+
+  //----------------------------------------------------------------------------
+  // The largest useful window: twice the bandwidth-delay product (locked)
+  //----------------------------------------------------------------------------
+  uint32_t ReadAhead::WindowCap()
+  {
+    if( !pRtt || !pBandwidth ) return pMaxBlocks;
+    uint64_t bdp = pRtt * pBandwidth / 1000000;
+    uint64_t cap = 2 * ( ( bdp + pBlockSize - 1 ) / pBlockSize );
+    return (uint32_t)std::min( std::max( cap, (uint64_t)2 ),
+                               (uint64_t)pMaxBlocks );
+  }
+}
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_READ_AHEAD_HH__
+#define __XRD_CL_READ_AHEAD_HH__
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace XrdCl
+{
+  class FileStateHandler;
+
+  //----------------------------------------------------------------------------
+  //! Adaptive read-ahead for a file opened for reading.
+  //!
+  //! The read pattern is followed and once two consecutive reads agree on a
+  //! sequential or strided pattern, blocks ahead of the reader are requested
+  //! with kXR_read and kept in a ring. Reads that fall entirely into the ring
+  //! are served from memory, waiting for blocks that are still in flight.
+  //! Everything else goes to the server as usual, ahead of any read-ahead
+  //! requests it triggers.
+  //!
+  //! The number of blocks kept ahead of the reader (the window) doubles when
+  //! the reader has to wait for a block and shrinks when blocks arrive more
+  //! than a round trip before they are needed. It never exceeds twice the
+  //! bandwidth-delay product observed for the prefetch requests nor the
+  //! configured number of blocks.
+  //!
+  //! Responses served from the ring are queued to the job manager rather
+  //! than called from within Read().
+  //----------------------------------------------------------------------------
+  class ReadAhead
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param stateHandler : the file the blocks are read from
+      //! @param blockSize    : size of a block (sequential reads)
+      //! @param maxBlocks    : maximum number of blocks held
+      //------------------------------------------------------------------------
+      ReadAhead( FileStateHandler *stateHandler, uint32_t blockSize,
+                 uint32_t maxBlocks );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~ReadAhead();
+
+      //------------------------------------------------------------------------
+      //! Defer a close until all read-ahead requests have returned
+      //!
+      //! @param handler : the close handler
+      //! @param timeout : the close timeout
+      //! @param status  : the status to return to the caller if the close
+      //!                  has been deferred
+      //! @return        : true if the caller must return status, false if
+      //!                  the close may proceed
+      //------------------------------------------------------------------------
+      bool DeferClose( ResponseHandler *handler, uint16_t timeout,
+                       XRootDStatus &status );
+
+      //------------------------------------------------------------------------
+      //! Read a data chunk, from the ring if possible, otherwise from the
+      //! server
+      //!
+      //! @return status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus Read( uint64_t         offset,
+                         uint32_t         size,
+                         void            *buffer,
+                         ResponseHandler *handler,
+                         uint16_t         timeout );
+
+      //------------------------------------------------------------------------
+      //! (Re)enable read-ahead after the file has been opened
+      //!
+      //! @param fileSize : the size of the file, 0 if unknown
+      //------------------------------------------------------------------------
+      void Start( uint64_t fileSize );
+
+    private:
+
+      struct Anchor;
+      struct Block;
+      struct Waiter;
+      class  BlockHandler;
+      friend class BlockHandler;
+
+      ChunkInfo *Copy( Waiter *waiter );
+      bool       Cover( uint64_t offset, uint32_t size,
+                        std::vector<Block*> &blocks );
+      void       Done( Block *block, XRootDStatus *status,
+                       AnyObject *response );
+      bool       Evict( bool any, uint64_t offset, uint32_t size );
+      void       Fetch( std::vector<Block*> &blocks, uint16_t timeout );
+      void       Finish( std::vector<Waiter*> &waiters );
+      void       Plan( uint64_t offset, uint32_t size,
+                       std::vector<Block*> &blocks );
+      void       Recycle( Block *block );
+      void       Track( uint64_t offset, uint32_t size );
+      uint32_t   WindowCap();
+
+      FileStateHandler        *pStateHandler;
+      std::shared_ptr<Anchor> pAnchor;   // Shared with the block handlers
+      XrdSysMutex             pMutex;
+      std::deque<Block*>      pRing;      // Blocks in the order they were issued
+      std::vector<char*>      pFreeBuff;  // Block buffers available for reuse
+      ResponseHandler         *pCloseHandler;
+      uint64_t                pFileSize;
+      uint64_t                pLastOffset;
+      uint64_t                pNextOffset; // Where the next block will start
+      int64_t                 pStride;
+      uint64_t                pRtt;       // Smoothed block round trip (usec)
+      uint64_t                pBandwidth; // Smoothed delivered bandwidth (B/s)
+      uint64_t                pLastDone;  // When the last block returned (usec)
+      uint32_t                pLastSize;
+      uint32_t                pBlockSize;
+      uint32_t                pMaxBlocks;
+      uint32_t                pWindow;    // Blocks to keep ahead of the reader
+      uint32_t                pInFlight;  // Read-ahead requests outstanding
+      uint32_t                pStreak;    // Reads that matched the pattern
+      uint16_t                pCloseTimeout;
+      bool                    pHavePlan;  // pNextOffset follows the pattern
+      bool                    pStopped;
+  };
+}
+
+#endif // __XRD_CL_READ_AHEAD_HH__
@@ -25,41 +25,98 @@ namespace XrdCl
   //---------------------------------------------------------------------------
   Status SIDManager::AllocateSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-
-    uint16_t allocSID = 1;
+    uint16_t allocSID = 0;
 
     //--------------------------------------------------------------------------
-    // Get a SID from the list of free SIDs if it's not empty
+    // Pop a SID from the stack of free SIDs if it's not empty. The tag in the
+    // upper bits of the head changes on every update so that a SID that was
+    // popped and pushed back in the meantime does not go unnoticed.
     //--------------------------------------------------------------------------
-    if( !pFreeSIDs.empty() )
+    uint64_t head = pFreeHead.load( std::memory_order_acquire );
+    while( ( allocSID = head & 0xffff ) )
     {
-      allocSID = pFreeSIDs.front();
-      pFreeSIDs.pop_front();
+      uint16_t next = GetEntry( allocSID ).next.load( std::memory_order_relaxed );
+      uint64_t newHead = ( ( head >> 16 ) + 1 ) << 16 | next;
+      if( pFreeHead.compare_exchange_weak( head, newHead,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire ) )
+        break;
     }
+
     //--------------------------------------------------------------------------
     // Allocate a new SID if possible
     //--------------------------------------------------------------------------
-    else
+    if( !allocSID )
     {
-      if( pSIDCeiling == 0xffff )
-        return Status( stError, errNoMoreFreeSIDs );
-      allocSID = pSIDCeiling++;
+      uint32_t ceiling = pSIDCeiling.load( std::memory_order_relaxed );
+      do
+      {
+        if( ceiling == 0xffff )
+          return Status( stError, errNoMoreFreeSIDs );
+      }
+      while( !pSIDCeiling.compare_exchange_weak( ceiling, ceiling + 1,
+                                                 std::memory_order_relaxed ) );
+      allocSID = ceiling;
+
+      //------------------------------------------------------------------------
+      // Make sure the page of the new SID exists, whoever loses the race for
+      // creating it throws its copy away
+      //------------------------------------------------------------------------
+      std::atomic<Entry*> &page = pPages[allocSID >> 8];
+      if( !page.load( std::memory_order_acquire ) )
+      {
+        Entry *newPage = new Entry[256]();
+        Entry *expected = 0;
+        if( !page.compare_exchange_strong( expected, newPage,
+                                           std::memory_order_acq_rel ) )
+          delete [] newPage;
+      }
     }
 
+    GetEntry( allocSID ).state.store( InUse, std::memory_order_relaxed );
+    pAllocated.fetch_add( 1, std::memory_order_relaxed );
     memcpy( sid, &allocSID, 2 );
     return Status();
   }
 
+  //----------------------------------------------------------------------------
+  // Push a SID onto the stack of free SIDs
+  //----------------------------------------------------------------------------
+  void SIDManager::PushFree( uint16_t sid )
+  {
+    Entry &entry = GetEntry( sid );
+    uint64_t head = pFreeHead.load( std::memory_order_relaxed );
+    uint64_t newHead;
+    do
+    {
+      entry.next.store( head & 0xffff, std::memory_order_relaxed );
+      newHead = ( ( head >> 16 ) + 1 ) << 16 | sid;
+    }
+    while( !pFreeHead.compare_exchange_weak( head, newHead,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed ) );
+  }
+
   //----------------------------------------------------------------------------
   // Release the SID that is no longer needed
   //----------------------------------------------------------------------------
   void SIDManager::ReleaseSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t relSID = 0;
     memcpy( &relSID, sid, 2 );
-    pFreeSIDs.push_back( relSID );
+    Entry *entry = FindEntry( relSID );
+    if( !entry ) return;
+
+    //--------------------------------------------------------------------------
+    // Releasing a SID twice must not put it on the stack twice
+    //--------------------------------------------------------------------------
+    uint8_t old = entry->state.exchange( Free, std::memory_order_relaxed );
+    if( old == Free ) return;
+    if( old == TimedOut )
+      pTimedOut.fetch_sub( 1, std::memory_order_relaxed );
+    else
+      pAllocated.fetch_sub( 1, std::memory_order_relaxed );
+    PushFree( relSID );
   }
 
   //----------------------------------------------------------------------------
@@ -67,10 +124,18 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void SIDManager::TimeOutSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.insert( tiSID );
+    Entry *entry = FindEntry( tiSID );
+    if( !entry ) return;
+
+    uint8_t expected = InUse;
+    if( entry->state.compare_exchange_strong( expected, TimedOut,
+                                              std::memory_order_relaxed ) )
+    {
+      pAllocated.fetch_sub( 1, std::memory_order_relaxed );
+      pTimedOut.fetch_add( 1, std::memory_order_relaxed );
+    }
   }
 
   //----------------------------------------------------------------------------
@@ -78,13 +143,10 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   bool SIDManager::IsTimedOut( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    std::set<uint16_t>::iterator it = pTimeOutSIDs.find( tiSID );
-    if( it != pTimeOutSIDs.end() )
-      return true;
-    return false;
+    Entry *entry = FindEntry( tiSID );
+    return entry && entry->state.load( std::memory_order_relaxed ) == TimedOut;
   }
 
   //----------------------------------------------------------------------------
@@ -92,11 +154,18 @@ namespace XrdCl
   //-----------------------------------------------------------------------------
   void SIDManager::ReleaseTimedOut( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.erase( tiSID );
-    pFreeSIDs.push_back( tiSID );
+    Entry *entry = FindEntry( tiSID );
+    if( !entry ) return;
+
+    uint8_t expected = TimedOut;
+    if( entry->state.compare_exchange_strong( expected, Free,
+                                              std::memory_order_relaxed ) )
+    {
+      pTimedOut.fetch_sub( 1, std::memory_order_relaxed );
+      PushFree( tiSID );
+    }
   }
 
   //------------------------------------------------------------------------
@@ -104,11 +173,22 @@ namespace XrdCl
   //------------------------------------------------------------------------
   void SIDManager::ReleaseAllTimedOut()
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-    std::set<uint16_t>::iterator it;
-    for( it = pTimeOutSIDs.begin(); it != pTimeOutSIDs.end(); ++it )
-      pFreeSIDs.push_back( *it );
-    pTimeOutSIDs.clear();
+    uint32_t ceiling = pSIDCeiling.load( std::memory_order_relaxed );
+    for( uint32_t p = 0; p <= ( ceiling - 1 ) >> 8; ++p )
+    {
+      Entry *page = pPages[p].load( std::memory_order_acquire );
+      if( !page ) continue;
+      for( uint32_t i = 0; i < 256; ++i )
+      {
+        uint8_t expected = TimedOut;
+        if( page[i].state.compare_exchange_strong( expected, Free,
+                                                   std::memory_order_relaxed ) )
+        {
+          pTimedOut.fetch_sub( 1, std::memory_order_relaxed );
+          PushFree( p << 8 | i );
+        }
+      }
+    }
   }
 
   //----------------------------------------------------------------------------
@@ -116,8 +196,7 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   uint16_t SIDManager::GetNumberOfAllocatedSIDs() const
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-    return pSIDCeiling - pFreeSIDs.size() - pTimeOutSIDs.size() - 1;
+    return pAllocated.load( std::memory_order_relaxed );
   }
 
   //----------------------------------------------------------------------------
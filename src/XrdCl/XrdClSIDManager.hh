@@ -19,8 +19,7 @@
 #ifndef __XRD_CL_SID_MANAGER_HH__
 #define __XRD_CL_SID_MANAGER_HH__
 
-#include <list>
-#include <set>
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <string>
@@ -38,6 +37,11 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! Handle XRootD stream IDs
+  //!
+  //! The state of every SID lives in a table of 256 pages of 256 entries,
+  //! a page being allocated when the first SID in it is handed out. Free
+  //! SIDs are kept in a lock-free stack linked through the table, so none of
+  //! the operations on a SID take a lock.
   //----------------------------------------------------------------------------
   class SIDManager
   {
@@ -48,7 +52,12 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Constructor
       //------------------------------------------------------------------------
-      SIDManager(): pSIDCeiling(1), pRefCount(0) { }
+      SIDManager(): pFreeHead(0), pSIDCeiling(1), pAllocated(0), pTimedOut(0),
+        pRefCount(0)
+      {
+        for( int i = 0; i < 256; ++i )
+          pPages[i].store( 0, std::memory_order_relaxed );
+      }
 
 #if __cplusplus < 201103L
     //------------------------------------------------------------------------
@@ -61,7 +70,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Destructor
       //------------------------------------------------------------------------
-      ~SIDManager() { }
+      ~SIDManager()
+      {
+        for( int i = 0; i < 256; ++i )
+          delete [] pPages[i].load( std::memory_order_relaxed );
+      }
 
     public:
 
@@ -103,8 +116,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       uint32_t NumberOfTimedOutSIDs() const
       {
-        XrdSysMutexHelper scopedLock( pMutex );
-        return pTimeOutSIDs.size();
+        return pTimedOut.load( std::memory_order_relaxed );
       }
 
       //------------------------------------------------------------------------
@@ -113,11 +125,41 @@ namespace XrdCl
       uint16_t GetNumberOfAllocatedSIDs() const;
 
     private:
-      std::list<uint16_t>  pFreeSIDs;
-      std::set<uint16_t>   pTimeOutSIDs;
-      uint16_t             pSIDCeiling;
-      mutable XrdSysMutex  pMutex;
-      mutable size_t       pRefCount;
+
+      //------------------------------------------------------------------------
+      //! State of a SID
+      //------------------------------------------------------------------------
+      enum SIDState : uint8_t { Free = 0, InUse, TimedOut };
+
+      struct Entry
+      {
+        std::atomic<uint16_t> next;   //!< next free SID, 0 ends the stack
+        std::atomic<uint8_t>  state;
+      };
+
+      Entry &GetEntry( uint16_t sid )
+      {
+        return pPages[sid >> 8].load( std::memory_order_acquire )[sid & 0xff];
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the entry of a SID coming from outside, null if never allocated
+      //------------------------------------------------------------------------
+      Entry *FindEntry( uint16_t sid )
+      {
+        Entry *page = pPages[sid >> 8].load( std::memory_order_acquire );
+        return sid && page ? page + ( sid & 0xff ) : 0;
+      }
+
+      void PushFree( uint16_t sid );
+
+      std::atomic<Entry*>   pPages[256];
+      std::atomic<uint64_t> pFreeHead;   //!< ABA tag << 16 | top of the stack
+      std::atomic<uint32_t> pSIDCeiling;
+      std::atomic<uint32_t> pAllocated;
+      std::atomic<uint32_t> pTimedOut;
+      mutable XrdSysMutex   pMutex;      //!< only guards pRefCount
+      mutable size_t        pRefCount;
   };
 
   //----------------------------------------------------------------------------
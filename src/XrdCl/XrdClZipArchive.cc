@@ -25,17 +25,44 @@
 #include "XrdCl/XrdClFileOperations.hh"
 #include "XrdCl/XrdClCheckpointOperation.hh"
 #include "XrdCl/XrdClZipArchive.hh"
+#include "XrdCl/XrdClZipCodecCache.hh"
 #include "XrdCl/XrdClLog.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClConstants.hh"
 #include "XrdZip/XrdZipZIP64EOCDL.hh"
 
 #include <sys/stat.h>
+#include <algorithm>
 
 namespace XrdCl
 {
   using namespace XrdZip;
 
+  //---------------------------------------------------------------------------
+  // Feed the compressed data of a file we hold in memory to its ZIP cache
+  //---------------------------------------------------------------------------
+  class DecompressJob: public Job
+  {
+    public:
+
+      DecompressJob( const std::shared_ptr<ZipCodecCache> &cache,
+                     buffer_t &&buffer ) : cache( cache ),
+                                           buffer( std::move( buffer ) )
+      {
+      }
+
+      void Run( void* )
+      {
+        cache->QueueRsp( XRootDStatus(), 0, std::move( buffer ) );
+        delete this;
+      }
+
+    private:
+
+      std::shared_ptr<ZipCodecCache> cache; // the archive may be gone by now
+      buffer_t                       buffer;
+  };
+
   //---------------------------------------------------------------------------
   // Read data from a given file
   //---------------------------------------------------------------------------
@@ -60,8 +87,9 @@ namespace XrdCl
 
     CDFH *cdfh = me.cdvec[cditr->second].get();
 
-    // check if the file is compressed, for now we only support uncompressed and inflate/deflate compression
-    if( cdfh->compressionMethod != 0 && cdfh->compressionMethod != Z_DEFLATED )
+    // check if the file is compressed, and if so if we have a codec for it
+    if( cdfh->compressionMethod != ZipCodec::Stored &&
+        !ZipCodec::IsSupported( cdfh->compressionMethod ) )
       return XRootDStatus( stError, errNotSupported,
                            0, "The compression algorithm is not supported!" );
 
@@ -85,14 +113,18 @@ namespace XrdCl
     if( size > sizeTillEnd ) size = sizeTillEnd;
 
     // if it is a compressed file use ZIP cache to read from the file
-    if( cdfh->compressionMethod == Z_DEFLATED )
+    if( cdfh->compressionMethod != ZipCodec::Stored )
     {
       log->Dump( ZipMsg, "[0x%x] Reading compressed data.", &me );
       // check if respective ZIP cache exists
-      bool empty = me.zipcache.find( fn ) == me.zipcache.end();
-      // if the entry does not exist, it will be created using
-      // default constructor
-      ZipCache &cache = me.zipcache[fn];
+      auto cacheitr = me.zipcache.find( fn );
+      bool empty = cacheitr == me.zipcache.end();
+      // if the entry does not exist, create it for the compression
+      // method of the file
+      if( empty )
+        cacheitr = me.zipcache.emplace( fn,
+                     std::make_shared<ZipCodecCache>( cdfh->compressionMethod ) ).first;
+      std::shared_ptr<ZipCodecCache> cache = cacheitr->second;
 
       if( relativeOffset > cdfh->uncompressedSize )
       {
@@ -108,16 +140,17 @@ namespace XrdCl
       uint32_t sizereq = size;
       if( relativeOffset + size > cdfh->uncompressedSize )
         sizereq = cdfh->uncompressedSize - relativeOffset;
-      cache.QueueReq( relativeOffset, sizereq, usrbuff, usrHandler );
+      cache->QueueReq( relativeOffset, sizereq, usrbuff, usrHandler );
 
       // if we have the whole ZIP archive we can populate the cache
-      // straight away
+      // straight away, the decompression is done in the thread-pool
+      // so that independent files are decompressed in parallel
       if( empty && me.buffer)
       {
         auto begin = me.buffer.get() + fileoff;
         auto end   = begin + filesize ;
-        buffer_t buff( begin, end );
-        cache.QueueRsp( XRootDStatus(), 0, std::move( buff ) );
+        DecompressJob *job = new DecompressJob( cache, buffer_t( begin, end ) );
+        DefaultEnv::GetPostMaster()->GetJobManager()->QueueJob( job );
         return XRootDStatus();
       }
 
@@ -145,14 +178,14 @@ namespace XrdCl
 
 
         // now read the data ...
-        auto rdbuff = std::make_shared<ZipCache::buffer_t>( rdsize );
+        auto rdbuff = std::make_shared<ZipCodecCache::buffer_t>( rdsize );
         Pipeline p = XrdCl::RdWithRsp<RSP>( me.archive, offset, rdbuff->size(), rdbuff->data() ) >>
-                       [relativeOffset, rdbuff, &cache, &me]( XRootDStatus &st, RSP &rsp )
+                       [relativeOffset, rdbuff, cache, &me]( XRootDStatus &st, RSP &rsp )
                        {
                          Log *log = DefaultEnv::GetLog();
                          log->Dump( ZipMsg, "[0x%x] Read %d bytes of remote data at offset %d.",
                                             &me, rsp.GetLength(), rsp.GetOffset() );
-                         cache.QueueRsp( st, relativeOffset, std::move( *rdbuff ) );
+                         cache->QueueRsp( st, relativeOffset, std::move( *rdbuff ) );
                        };
         Async( std::move( p ), timeout );
       }
@@ -719,10 +752,11 @@ namespace XrdCl
   //-----------------------------------------------------------------------
   // Append data to a new file, implementation
   //-----------------------------------------------------------------------
-  XRootDStatus ZipArchive::WriteImpl( uint32_t               size,
-                                      const void            *buffer,
-                                      ResponseHandler       *handler,
-                                      uint16_t               timeout )
+  XRootDStatus ZipArchive::WriteImpl( uint32_t                   size,
+                                      const void                *buffer,
+                                      ResponseHandler           *handler,
+                                      uint16_t                   timeout,
+                                      std::shared_ptr<buffer_t>  keep )
   {
     Log *log = DefaultEnv::GetLog();
     std::vector<iovec> iov( 2 );
@@ -764,6 +798,7 @@ namespace XrdCl
                       {
                         if( st.IsOK() ) updated = true;
                         lfhbuf.reset();
+                        keep.reset();
                         if( handler )
                           handler->HandleResponse( make_status( st ), nullptr );
                       };
@@ -868,4 +903,60 @@ namespace XrdCl
     return WriteImpl( size, buffer, handler, timeout );
   }
 
+  //-----------------------------------------------------------------------
+  // Create a new compressed file in the ZIP archive and append the data
+  //-----------------------------------------------------------------------
+  XRootDStatus ZipArchive::AppendFile( const std::string &fn,
+                                       uint16_t           method,
+                                       uint32_t           crc32,
+                                       uint32_t           size,
+                                       const void        *buffer,
+                                       ResponseHandler   *handler,
+                                       uint16_t           timeout )
+  {
+    if( method == ZipCodec::Stored )
+      return AppendFile( fn, crc32, size, buffer, handler, timeout );
+
+    Log  *log = DefaultEnv::GetLog();
+    auto  itr   = cdmap.find( fn );
+    // check if the file already exists in the archive
+    if( itr != cdmap.end() )
+    {
+      log->Dump( ZipMsg, "[0x%x] Open failed: file exists %s, cannot append.",
+                         this, fn.c_str() );
+      return XRootDStatus( stError, errInvalidOp );
+    }
+
+    std::unique_ptr<ZipCodec> codec( ZipCodec::Create( method ) );
+    if( !codec )
+      return XRootDStatus( stError, errNotSupported,
+                           0, "The compression algorithm is not supported!" );
+
+    //-------------------------------------------------------------------------
+    // Compress the data, if that does not pay off store them as they are
+    //-------------------------------------------------------------------------
+    auto cmpbuf = std::make_shared<buffer_t>();
+    XRootDStatus st = codec->Compress( reinterpret_cast<const char*>( buffer ),
+                                       size, *cmpbuf );
+    if( !st.IsOK() ) return st;
+    if( cmpbuf->size() >= size )
+      return AppendFile( fn, crc32, size, buffer, handler, timeout );
+
+    log->Dump( ZipMsg, "[0x%x] Appending file: %s (method %u, %u bytes "
+                       "compressed to %u).", this, fn.c_str(), method, size,
+                       (uint32_t)cmpbuf->size() );
+    //-------------------------------------------------------------------------
+    // Create Local File Header record
+    //-------------------------------------------------------------------------
+    lfh.reset( new LFH( fn, crc32, size, time( 0 ) ) );
+    lfh->compressionMethod = method;
+    lfh->compressedSize    = cmpbuf->size();
+    lfh->minZipVersion     = std::max<uint16_t>( lfh->minZipVersion,
+                                 method == ZipCodec::Deflate ? 20 : 63 );
+    //-------------------------------------------------------------------------
+    // And write it all
+    //-------------------------------------------------------------------------
+    return WriteImpl( cmpbuf->size(), cmpbuf->data(), handler, timeout, cmpbuf );
+  }
+
 } /* namespace XrdZip */
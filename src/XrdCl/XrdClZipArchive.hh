@@ -47,6 +47,8 @@ class MicroTest;
 
 namespace XrdCl
 {
+  class ZipCodecCache;
+
   using namespace XrdZip;
 
   //---------------------------------------------------------------------------
@@ -230,6 +232,28 @@ namespace XrdCl
                                ResponseHandler   *handler,
                                uint16_t           timeout = 0 );
 
+      //-----------------------------------------------------------------------
+      //! Create a new file in the ZIP archive and append the data compressed
+      //! with given method (@see ZipCodec). If compression does not make the
+      //! data smaller they are stored as they are.
+      //!
+      //! @param fn      : the name of the new file to be created
+      //! @param method  : the compression method
+      //! @param crc32   : the crc32 of the (uncompressed) file
+      //! @param size    : the size of the (uncompressed) file
+      //! @param buffer  : the buffer with the data
+      //! @param handler : user callback
+      //! @param timeout : operation timeout
+      //! @return        : the status of the operation
+      //-----------------------------------------------------------------------
+      XRootDStatus AppendFile( const std::string &fn,
+                               uint16_t           method,
+                               uint32_t           crc32,
+                               uint32_t           size,
+                               const void        *buffer,
+                               ResponseHandler   *handler,
+                               uint16_t           timeout = 0 );
+
       //-----------------------------------------------------------------------
       //! Get stat info for given file
       //!
@@ -365,12 +389,14 @@ namespace XrdCl
       //! @param buffer  : the buffer with the data to be appended
       //! @param handler : user callback
       //! @param timeout : operation timeout
+      //! @param keep    : buffer to be kept until the write is done
       //! @return        : the status of the operation
       //-----------------------------------------------------------------------
-      XRootDStatus WriteImpl( uint32_t               size,
-                              const void            *buffer,
-                              ResponseHandler       *handler,
-                              uint16_t               timeout );
+      XRootDStatus WriteImpl( uint32_t                   size,
+                              const void                *buffer,
+                              ResponseHandler           *handler,
+                              uint16_t                   timeout,
+                              std::shared_ptr<buffer_t>  keep = nullptr );
 
       //-----------------------------------------------------------------------
       //! Open the ZIP archive in read-only mode without parsing the central
@@ -534,9 +560,10 @@ namespace XrdCl
       };
 
       //-----------------------------------------------------------------------
-      //! Type that maps file name to its cache
+      //! Type that maps file name to its cache, the cache is shared with the
+      //! decompression jobs and read callbacks that may outlive the archive
       //-----------------------------------------------------------------------
-      typedef std::unordered_map<std::string, ZipCache> zipcache_t;
+      typedef std::unordered_map<std::string, std::shared_ptr<ZipCodecCache>> zipcache_t;
       typedef std::unordered_map<std::string, NewFile>  new_files_t;
 
       File                        archive;   //> File object for handling the ZIP archive
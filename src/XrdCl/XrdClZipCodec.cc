@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClZipCodec.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <map>
+#include <string>
+#include <zlib.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Deflate, raw streams without zlib or gzip headers
+  //----------------------------------------------------------------------------
+  class DeflateCodec: public ZipCodec
+  {
+    public:
+      DeflateCodec()
+      {
+        strm.zalloc    = Z_NULL;
+        strm.zfree     = Z_NULL;
+        strm.opaque    = Z_NULL;
+        strm.avail_in  = 0;
+        strm.next_in   = Z_NULL;
+        strm.avail_out = 0;
+        strm.next_out  = Z_NULL;
+
+        // make sure zlib doesn't look for gzip headers, in order to do so
+        // pass negative window bits !!!
+        initst = ToXRootDStatus( inflateInit2( &strm, -MAX_WBITS ),
+                                 "inflateInit2" );
+      }
+
+      ~DeflateCodec()
+      {
+        if( initst.IsOK() ) inflateEnd( &strm );
+      }
+
+      XRootDStatus Decompress( const char *&in,  uint32_t &inlen,
+                               char       *&out, uint32_t &outlen )
+      {
+        if( !initst.IsOK() ) return initst;
+
+        strm.next_in   = (Bytef*)in;
+        strm.avail_in  = inlen;
+        strm.next_out  = (Bytef*)out;
+        strm.avail_out = outlen;
+        int rc = inflate( &strm, Z_SYNC_FLUSH );
+        XRootDStatus st = ToXRootDStatus( rc, "inflate" );
+        if( !st.IsOK() ) return st;
+
+        bool progress = strm.avail_in != inlen || strm.avail_out != outlen;
+        in     = (const char*)strm.next_in;
+        inlen  = strm.avail_in;
+        out    = (char*)strm.next_out;
+        outlen = strm.avail_out;
+        if( !progress ) return XRootDStatus( stOK, suContinue );
+        return XRootDStatus();
+      }
+
+      XRootDStatus Compress( const char *in, uint32_t inlen,
+                             std::vector<char> &out )
+      {
+        z_stream dstrm;
+        dstrm.zalloc = Z_NULL;
+        dstrm.zfree  = Z_NULL;
+        dstrm.opaque = Z_NULL;
+        int rc = deflateInit2( &dstrm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                               -MAX_WBITS, 8, Z_DEFAULT_STRATEGY );
+        XRootDStatus st = ToXRootDStatus( rc, "deflateInit2" );
+        if( !st.IsOK() ) return st;
+
+        out.resize( deflateBound( &dstrm, inlen ) );
+        dstrm.next_in   = (Bytef*)in;
+        dstrm.avail_in  = inlen;
+        dstrm.next_out  = (Bytef*)out.data();
+        dstrm.avail_out = out.size();
+        rc = deflate( &dstrm, Z_FINISH );
+        out.resize( out.size() - dstrm.avail_out );
+        deflateEnd( &dstrm );
+        if( rc != Z_STREAM_END )
+          return XRootDStatus( stError, errInternal, rc,
+                               "[zlib] deflate : incomplete." );
+        return XRootDStatus();
+      }
+
+      static ZipCodec *Create()
+      {
+        return new DeflateCodec();
+      }
+
+    private:
+
+      static XRootDStatus ToXRootDStatus( int rc, const std::string &func )
+      {
+        std::string msg = "[zlib] " + func + " : ";
+
+        switch( rc )
+        {
+          case Z_STREAM_END    :
+          case Z_OK            : return XrdCl::XRootDStatus();
+          case Z_BUF_ERROR     : return XrdCl::XRootDStatus( XrdCl::stOK,    XrdCl::suContinue );
+          case Z_MEM_ERROR     : return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errInternal,    Z_MEM_ERROR,     msg + "not enough memory." );
+          case Z_VERSION_ERROR : return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errInternal,    Z_VERSION_ERROR, msg + "version mismatch." );
+          case Z_STREAM_ERROR  : return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errInvalidArgs, Z_STREAM_ERROR,  msg + "invalid argument." );
+          case Z_NEED_DICT     : return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errDataError,   Z_NEED_DICT,     msg + "need dict.");
+          case Z_DATA_ERROR    : return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errDataError,   Z_DATA_ERROR,    msg + "corrupted data." );
+          default              : return XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errUnknown );
+        }
+      }
+
+      z_stream     strm;
+      XRootDStatus initst;
+  };
+
+#ifdef HAVE_ZSTD
+  //----------------------------------------------------------------------------
+  // Zstandard, one or more frames
+  //----------------------------------------------------------------------------
+  class ZstdCodec: public ZipCodec
+  {
+    public:
+      ZstdCodec(): dstrm( ZSTD_createDStream() )
+      {
+        if( dstrm ) ZSTD_initDStream( dstrm );
+      }
+
+      ~ZstdCodec()
+      {
+        ZSTD_freeDStream( dstrm );
+      }
+
+      XRootDStatus Decompress( const char *&in,  uint32_t &inlen,
+                               char       *&out, uint32_t &outlen )
+      {
+        if( !dstrm )
+          return XRootDStatus( stError, errInternal, 0,
+                               "[zstd] not enough memory." );
+
+        ZSTD_inBuffer  ibuf = { in, inlen, 0 };
+        ZSTD_outBuffer obuf = { out, outlen, 0 };
+        size_t rc = ZSTD_decompressStream( dstrm, &obuf, &ibuf );
+        if( ZSTD_isError( rc ) )
+          return XRootDStatus( stError, errDataError, 0,
+                               std::string( "[zstd] decompress : " ) +
+                               ZSTD_getErrorName( rc ) );
+
+        in     += ibuf.pos;
+        inlen  -= ibuf.pos;
+        out    += obuf.pos;
+        outlen -= obuf.pos;
+        if( !ibuf.pos && !obuf.pos ) return XRootDStatus( stOK, suContinue );
+        return XRootDStatus();
+      }
+
+      XRootDStatus Compress( const char *in, uint32_t inlen,
+                             std::vector<char> &out )
+      {
+        out.resize( ZSTD_compressBound( inlen ) );
+        size_t rc = ZSTD_compress( out.data(), out.size(), in, inlen, 3 );
+        if( ZSTD_isError( rc ) )
+          return XRootDStatus( stError, errInternal, 0,
+                               std::string( "[zstd] compress : " ) +
+                               ZSTD_getErrorName( rc ) );
+        out.resize( rc );
+        return XRootDStatus();
+      }
+
+      static ZipCodec *Create()
+      {
+        return new ZstdCodec();
+      }
+
+    private:
+
+      ZSTD_DStream *dstrm;
+  };
+#endif
+
+  //----------------------------------------------------------------------------
+  // The codec registry, pre-loaded with the built-in codecs
+  //----------------------------------------------------------------------------
+  struct Registry
+  {
+    Registry()
+    {
+      factories[ZipCodec::Deflate] = DeflateCodec::Create;
+#ifdef HAVE_ZSTD
+      factories[ZipCodec::Zstd]    = ZstdCodec::Create;
+#endif
+    }
+
+    XrdSysMutex                           mutex;
+    std::map<uint16_t, ZipCodec::Factory> factories;
+  };
+
+  Registry &GetRegistry()
+  {
+    static Registry registry;
+    return registry;
+  }
+}
+
+namespace XrdCl
+{
+  const uint16_t ZipCodec::Stored;
+  const uint16_t ZipCodec::Deflate;
+  const uint16_t ZipCodec::Zstd;
+
+  //----------------------------------------------------------------------------
+  // Create a codec object for a compression method
+  //----------------------------------------------------------------------------
+  ZipCodec *ZipCodec::Create( uint16_t method )
+  {
+    Registry &registry = GetRegistry();
+    XrdSysMutexHelper scopedLock( registry.mutex );
+    auto itr = registry.factories.find( method );
+    if( itr == registry.factories.end() ) return nullptr;
+    Factory factory = itr->second;
+    scopedLock.UnLock();
+    return factory();
+  }
+
+  //----------------------------------------------------------------------------
+  // Check whether a compression method is supported
+  //----------------------------------------------------------------------------
+  bool ZipCodec::IsSupported( uint16_t method )
+  {
+    Registry &registry = GetRegistry();
+    XrdSysMutexHelper scopedLock( registry.mutex );
+    return registry.factories.count( method );
+  }
+
+  //----------------------------------------------------------------------------
+  // Register a codec for a compression method
+  //----------------------------------------------------------------------------
+  void ZipCodec::Register( uint16_t method, Factory factory )
+  {
+    Registry &registry = GetRegistry();
+    XrdSysMutexHelper scopedLock( registry.mutex );
+    if( factory ) registry.factories[method] = factory;
+    else registry.factories.erase( method );
+  }
+}
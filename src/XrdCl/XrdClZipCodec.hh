@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_ZIP_CODEC_HH__
+#define __XRD_CL_ZIP_CODEC_HH__
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+
+#include <cstdint>
+#include <vector>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Compression method of ZIP archive members.
+  //!
+  //! A codec object decompresses a single member, being fed the compressed
+  //! data in order, possibly in pieces. Codecs are created by compression
+  //! method (as stored in the local and central file headers) from a registry
+  //! that knows deflate and, if built with libzstd, zstd (method 93). Other
+  //! methods, e.g. lz4 under an experiment-specific method number, may be
+  //! added with Register().
+  //----------------------------------------------------------------------------
+  class ZipCodec
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Well known compression methods
+      //------------------------------------------------------------------------
+      static const uint16_t Stored  = 0;
+      static const uint16_t Deflate = 8;
+      static const uint16_t Zstd    = 93;
+
+      //------------------------------------------------------------------------
+      //! Create a codec object
+      //------------------------------------------------------------------------
+      typedef ZipCodec* (*Factory)();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      virtual ~ZipCodec() {}
+
+      //------------------------------------------------------------------------
+      //! Decompress the next piece of the member, advancing the input and
+      //! output pointers by what has been consumed and produced.
+      //!
+      //! @param in     : the compressed data
+      //! @param inlen  : the number of compressed bytes
+      //! @param out    : where the decompressed data go
+      //! @param outlen : the space available at out
+      //! @return       : stOK if progress has been made, stOK and suContinue
+      //!                 if none was possible, an error otherwise
+      //------------------------------------------------------------------------
+      virtual XRootDStatus Decompress( const char *&in,  uint32_t &inlen,
+                                       char       *&out, uint32_t &outlen ) = 0;
+
+      //------------------------------------------------------------------------
+      //! Compress a whole member
+      //!
+      //! @param in    : the data
+      //! @param inlen : the number of bytes
+      //! @param out   : the compressed data
+      //! @return      : the status of the operation
+      //------------------------------------------------------------------------
+      virtual XRootDStatus Compress( const char *in, uint32_t inlen,
+                                     std::vector<char> &out ) = 0;
+
+      //------------------------------------------------------------------------
+      //! Create a codec object for a compression method
+      //!
+      //! @return : the codec object, nullptr if the method is not supported
+      //------------------------------------------------------------------------
+      static ZipCodec *Create( uint16_t method );
+
+      //------------------------------------------------------------------------
+      //! Check whether a compression method is supported
+      //------------------------------------------------------------------------
+      static bool IsSupported( uint16_t method );
+
+      //------------------------------------------------------------------------
+      //! Register a codec for a compression method, replacing the one that
+      //! was registered before, if any
+      //!
+      //! @param method  : the compression method
+      //! @param factory : creates codec objects, nullptr removes the method
+      //------------------------------------------------------------------------
+      static void Register( uint16_t method, Factory factory );
+  };
+}
+
+#endif // __XRD_CL_ZIP_CODEC_HH__
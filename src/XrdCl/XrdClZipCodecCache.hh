@@ -0,0 +1,230 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2014 by European Organization for Nuclear Research (CERN)
+// Author: Michal Simon <michal.simon@cern.ch>
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#ifndef SRC_XRDCL_XRDCLZIPCODECCACHE_HH_
+#define SRC_XRDCL_XRDCLZIPCODECCACHE_HH_
+
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdCl/XrdClZipCache.hh"
+#include "XrdCl/XrdClZipCodec.hh"
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <queue>
+#include <tuple>
+
+namespace XrdCl
+{
+  //---------------------------------------------------------------------------
+  //! Utility class for decompressing a compressed buffer with the codec of
+  //! its compression method; it supersedes ZipCache, which only inflates
+  //---------------------------------------------------------------------------
+  class ZipCodecCache
+  {
+    public:
+
+      typedef std::vector<char> buffer_t;
+
+    private:
+
+      typedef std::tuple<uint64_t, uint32_t, void*, ResponseHandler*> read_args_t;
+      typedef std::tuple<XRootDStatus, uint64_t, buffer_t> read_resp_t;
+      typedef std::vector<std::pair<read_args_t, XRootDStatus>> done_t;
+
+      struct greater_read_resp_t
+      {
+        inline bool operator() ( const read_resp_t &lhs, const read_resp_t &rhs ) const
+        {
+          return std::get<1>( lhs ) > std::get<1>( rhs );
+        }
+      };
+
+      typedef std::priority_queue<read_resp_t, std::vector<read_resp_t>, greater_read_resp_t> resp_queue_t;
+
+    public:
+
+      ZipCodecCache( uint16_t method = ZipCodec::Deflate ) : codec( ZipCodec::Create( method ) ),
+                                                             inabsoff( 0 ),
+                                                             next_in( nullptr ),
+                                                             avail_in( 0 ),
+                                                             next_out( nullptr ),
+                                                             avail_out( 0 )
+      {
+        if( !codec )
+          throw ZipError( XRootDStatus( stError, errNotSupported, 0,
+                                        "The compression algorithm is not supported!" ) );
+      }
+
+      inline void QueueReq( uint64_t offset, uint32_t length, void *buffer, ResponseHandler *handler )
+      {
+        done_t done;
+        std::unique_lock<std::mutex> lck( mtx );
+        rdreqs.emplace( offset, length, buffer, handler );
+        Decompress( done );
+        lck.unlock();
+        CallHandlers( done );
+      }
+
+      inline void QueueRsp( const XRootDStatus &st, uint64_t offset, buffer_t &&buffer )
+      {
+        done_t done;
+        std::unique_lock<std::mutex> lck( mtx );
+        rdrsps.emplace( st, offset, std::move( buffer ) );
+        Decompress( done );
+        lck.unlock();
+        CallHandlers( done );
+      }
+
+    private:
+
+      inline bool HasInput() const
+      {
+        return avail_in != 0;
+      }
+
+      inline bool HasOutput() const
+      {
+        return avail_out != 0;
+      }
+
+      inline void Input( const read_resp_t &rdrsp )
+      {
+        const buffer_t &buffer = std::get<2>( rdrsp );
+        avail_in = buffer.size();
+        next_in  = buffer.data();
+      }
+
+      inline void Output( const read_args_t &rdreq )
+      {
+        avail_out = std::get<1>( rdreq );
+        next_out  = (char*)std::get<2>( rdreq );
+      }
+
+      inline bool Consecutive( const read_resp_t &resp ) const
+      {
+        return ( std::get<1>( resp ) == inabsoff );
+      }
+
+      //-----------------------------------------------------------------------
+      // Decompress as much as we can, the requests that are done are moved
+      // to the done list so that their handlers are called without holding
+      // the lock (a handler may well queue the next request)
+      //-----------------------------------------------------------------------
+      void Decompress( done_t &done )
+      {
+        while( HasInput() || HasOutput() || !rdreqs.empty() || !rdrsps.empty() )
+        {
+          if( !HasOutput() && !rdreqs.empty() )
+          {
+            // there's nothing to decompress for an empty request
+            if( !std::get<1>( rdreqs.front() ) )
+            {
+              Done( XRootDStatus(), done );
+              continue;
+            }
+            Output( rdreqs.front() );
+          }
+
+          if( !HasInput() && !rdrsps.empty() && Consecutive( rdrsps.top() ) ) // the response might come out of order so we need to check the offset
+            Input( rdrsps.top() );
+
+          if( !HasInput() || !HasOutput() ) return;
+
+          // check the response status
+          XRootDStatus st = std::get<0>( rdrsps.top() );
+          if( !st.IsOK() ) return Done( st, done );
+
+          // the available space in output buffer before decompressing
+          uint32_t avail_before = avail_in;
+          // decompress the data
+          st = codec->Decompress( next_in, avail_in, next_out, avail_out );
+          if( !st.IsOK() ) return Done( st, done ); // report error to user handler
+          // update the absolute input offset by the number of bytes we consumed
+          inabsoff += avail_before - avail_in;
+
+          if( !avail_out ) // the output buffer is full meaning a request has been fulfilled
+            Done( XRootDStatus(), done );
+
+          // the input buffer is empty meaning a response has been consumed
+          // (we need to check if there are any elements in the responses
+          // queue as the input buffer might have been set directly by the user)
+          if( !avail_in && !rdrsps.empty() )
+            rdrsps.pop();
+
+          // no progress was possible, wait for more data
+          if( st.code == suContinue ) return;
+        }
+      }
+
+      static inline AnyObject* PkgRsp( ChunkInfo *chunk )
+      {
+        if( !chunk ) return nullptr;
+        AnyObject *rsp = new AnyObject();
+        rsp->Set( chunk );
+        return rsp;
+      }
+
+      inline void Done( const XRootDStatus &st, done_t &done )
+      {
+        if( rdreqs.empty() ) return;
+        done.emplace_back( std::move( rdreqs.front() ), st );
+        rdreqs.pop();
+        avail_out = 0;
+        next_out  = nullptr;
+      }
+
+      static inline void CallHandlers( done_t &done )
+      {
+        for( auto &d : done )
+        {
+          read_args_t        &args = d.first;
+          const XRootDStatus &st   = d.second;
+
+          ChunkInfo *chunk = nullptr;
+          if( st.IsOK() ) chunk = new ChunkInfo( std::get<0>( args ),
+                                                 std::get<1>( args ),
+                                                 std::get<2>( args ) );
+
+          ResponseHandler *handler = std::get<3>( args );
+          handler->HandleResponse( new XRootDStatus( st ), PkgRsp( chunk ) );
+        }
+      }
+
+      std::unique_ptr<ZipCodec> codec; //< the codec we use for decompressing
+
+      std::mutex              mtx;
+      uint64_t                inabsoff;  //< the absolute offset in the input file (compressed), ensures the user is actually streaming the data
+      const char             *next_in;   //< next compressed byte
+      uint32_t                avail_in;  //< compressed bytes at next_in
+      char                   *next_out;  //< where the next decompressed byte goes
+      uint32_t                avail_out; //< space left at next_out
+      std::queue<read_args_t> rdreqs;    //< pending read requests  (we only allow read requests to be submitted in order)
+      resp_queue_t            rdrsps;    //< pending read responses (due to multiple-streams the read response may come out of order)
+  };
+
+}
+
+#endif /* SRC_XRDCL_XRDCLZIPCODECCACHE_HH_ */
@@ -63,13 +63,14 @@ public:
 
 void   DoIt() {Cache.Recycle(myList); delete this;}
 
-       XrdCmsCacheJob(XrdCmsKeyItem *List)
-                     : XrdJob("cache scrubber"), myList(List) {}
+       XrdCmsCacheJob(XrdCmsKeyItem **List)
+                     : XrdJob("cache scrubber")
+                     {memcpy(myList, List, sizeof(myList));}
       ~XrdCmsCacheJob() {}
 
 private:
 
-XrdCmsKeyItem *myList;
+XrdCmsKeyItem *myList[XrdCmsCache::ShardNum];
 };
 
 /******************************************************************************/
@@ -120,14 +121,14 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
    SMask_t xmask;
    int isrw = (Sel.Opts & XrdCmsSelect::Write), isnew = 0;
 
-// Serialize processing
+// Serialize processing for the shard holding this path
 //
-   myMutex.Lock();
+   Shard &sP = Lock(Sel.Path);
 
 // Check for fast path processing
 //
    if (  !(iP = Sel.Path.TODRef) || !(iP->Key.Equiv(Sel.Path)))
-      if ((iP = Sel.Path.TODRef = CTable.Find(Sel.Path)))
+      if ((iP = Sel.Path.TODRef = sP.CTable.Find(Sel.Path)))
          Sel.Path.Ref = iP->Key.Ref;
 
 // Add/Modify the entry
@@ -138,7 +139,7 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
            iP->Loc.lifeline = nilTMO + iP->Loc.deadline;
            iP->Loc.hfvec = 0; iP->Loc.pfvec = 0; iP->Loc.qfvec = 0;
            iP->Loc.TOD_B = BClock;
-           iP->Key.TOD = Tock;
+           iP->Key.TOD = sP.Tock;
           } else {
            xmask = iP->Loc.pfvec;
            if (Sel.Opts & XrdCmsSelect::Pending) iP->Loc.pfvec |= mask;
@@ -155,8 +156,8 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
                      }
           }
       } else if (!(Sel.Opts & XrdCmsSelect::Advisory))
-                {Sel.Path.TOD = Tock;
-                 if ((iP = CTable.Add(Sel.Path)))
+                {Sel.Path.TOD = sP.Tock;
+                 if ((iP = sP.CTable.Add(Sel.Path)))
                     {iP->Loc.pfvec    = (Sel.Opts&XrdCmsSelect::Pending?mask:0);
                      iP->Loc.hfvec    = mask;
                      iP->Loc.TOD_B    = BClock;
@@ -170,7 +171,7 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
 
 // All done
 //
-   myMutex.UnLock();
+   sP.sLock.UnLock();
    return isnew;
 }
   
@@ -195,24 +196,24 @@ int XrdCmsCache::DelFile(XrdCmsSelect &Sel, SMask_t mask)
 
 // Lock the hash table
 //
-   myMutex.Lock();
+   Shard &sP = Lock(Sel.Path);
 
 // Look up the entry and remove server
 //
-   if ((iP = CTable.Find(Sel.Path)))
+   if ((iP = sP.CTable.Find(Sel.Path)))
       {iP->Loc.hfvec &= ~mask;
        iP->Loc.pfvec &= ~mask;
        if ((gone4good = (iP->Loc.hfvec == 0)))
           {if (nilTMO) iP->Loc.lifeline = nilTMO + time(0);
            if (!(Sel.Opts & XrdCmsSelect::Advisory)
-           &&  XrdCmsKeyItem::Unload(iP) && !CTable.Recycle(iP))
+           &&  sP.CTable.Unload(iP) && !sP.CTable.Recycle(iP))
               Say.Emsg("DelFile", "Delete failed for", iP->Key.Val);
           }
       } else gone4good = 0;
 
 // All done
 //
-   myMutex.UnLock();
+   sP.sLock.UnLock();
    return gone4good;
 }
   
@@ -232,18 +233,61 @@ int XrdCmsCache::DelFile(XrdCmsSelect &Sel, SMask_t mask)
 int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
 {
    XrdCmsKeyItem *iP;
-   SMask_t bVec;
+   time_t Now;
    int retc;
 
-// Lock the hash table
+// Most lookups find an entry that needs no update: no server bounced since it
+// was last looked at, no unqueried servers to report, and no deadline that
+// has passed. These only read the entry so we do them under a shared lock.
+//
+   Shard &sP = Lock(Sel.Path, true);
+   if ((iP = sP.CTable.Find(Sel.Path)))
+      {Now = time(0);
+       if (iP->Loc.TOD_B < BClock || iP->Loc.qfvec
+       || (iP->Loc.deadline && iP->Loc.deadline <= Now))
+          {sP.sLock.UnLock();
+           Lock(Sel.Path);
+           return GetFileX(sP, Sel, mask);
+          }
+       sP.Hits++;
+       retc = (iP->Loc.deadline ? -1 : 1);
+       if (nilTMO && retc == 1 && iP->Loc.hfvec == 0
+       &&  iP->Loc.lifeline <= Now) retc = 0;
+
+       Sel.Vec.hf      = okVec & iP->Loc.hfvec;
+       Sel.Vec.pf      = okVec & iP->Loc.pfvec;
+       Sel.Vec.bf      = 0;
+       Sel.Path.Ref    = iP->Key.Ref;
+      } else {sP.Miss++; retc = 0;}
+
+// All done
 //
-   myMutex.Lock();
+   sP.sLock.UnLock();
+   Sel.Path.TODRef = iP;
+   return retc;
+}
+
+/******************************************************************************/
+/* Private                      G e t F i l e X                               */
+/******************************************************************************/
+
+// This is GetFile() for entries that need to be updated. The shard must be
+// exclusively locked; it is unlocked upon return. The entry is looked up again
+// as it may have changed or gone away while the shard was unlocked.
+  
+int  XrdCmsCache::GetFileX(XrdCmsCache::Shard &sP, XrdCmsSelect &Sel,
+                           SMask_t mask)
+{
+   XrdCmsKeyItem *iP;
+   SMask_t bVec;
+   int retc;
 
 // Look up the entry and return location information
 //
-   if ((iP = CTable.Find(Sel.Path)))
-      {if ((bVec = (iP->Loc.TOD_B < BClock 
-                 ? getBVec(iP->Key.TOD, iP->Loc.TOD_B) & mask : 0)))
+   if ((iP = sP.CTable.Find(Sel.Path)))
+      {sP.Hits++;
+       if ((bVec = (iP->Loc.TOD_B < BClock 
+                 ? getBVec(sP, iP->Key.TOD, iP->Loc.TOD_B) & mask : 0)))
           {iP->Loc.hfvec &= ~bVec; 
            iP->Loc.pfvec &= ~bVec;
            iP->Loc.qfvec &= ~mask;
@@ -262,15 +306,15 @@ int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
        Sel.Vec.pf      = okVec & iP->Loc.pfvec;
        Sel.Vec.bf      = okVec & (bVec | iP->Loc.qfvec); iP->Loc.qfvec = 0;
        Sel.Path.Ref    = iP->Key.Ref;
-      } else retc = 0;
+      } else {sP.Miss++; retc = 0;}
 
 // All done
 //
-   myMutex.UnLock();
+   sP.sLock.UnLock();
    Sel.Path.TODRef = iP;
    return retc;
 }
-
+  
 /******************************************************************************/
 /* Public                        U n k F i l e                                */
 /******************************************************************************/
@@ -282,7 +326,7 @@ int XrdCmsCache::UnkFile(XrdCmsSelect &Sel, SMask_t mask)
 
 // Make sure we have the proper information. If so, lock the hash table
 //
-   myMutex.Lock();
+   Shard &sP = Lock(Sel.Path);
 
 // Look up the entry and if valid update the unqueried vector. Note that
 // this method may only be called after GetFile() or AddFile() for a new entry
@@ -294,7 +338,7 @@ int XrdCmsCache::UnkFile(XrdCmsSelect &Sel, SMask_t mask)
 
 // Return result
 //
-   myMutex.UnLock();
+   sP.sLock.UnLock();
    DEBUG("rc=" <<(iP ? 1 : 0) <<" path=" <<Sel.Path.Val);
    return (iP ? 1 : 0);
 }
@@ -313,7 +357,7 @@ int XrdCmsCache::WT4File(XrdCmsSelect &Sel, SMask_t mask)
 // Make sure we have the proper information. If so, lock the hash table
 //
    if (!Sel.InfoP) return DLTime;
-   myMutex.Lock();
+   Shard &sP = Lock(Sel.Path);
 
 // Look up the entry and if valid add it to the callback queue. Note that
 // this method may only be called after GetFile() or AddFile() for a new entry
@@ -328,7 +372,7 @@ int XrdCmsCache::WT4File(XrdCmsSelect &Sel, SMask_t mask)
 
 // Return result
 //
-   myMutex.UnLock();
+   sP.sLock.UnLock();
    DEBUG("rc=" <<retc <<" path=" <<Sel.Path.Val);
    return retc;
 }
@@ -345,11 +389,11 @@ void XrdCmsCache::Bounce(SMask_t smask, int SNum)
 
 // Simply indicate that this server bounced
 //
-   myMutex.Lock();
+   LockAll();
    Bounced[SNum] = ++BClock;
    okVec |= smask;
    if (SNum > vecHi) vecHi = SNum;
-   myMutex.UnLock();
+   UnLockAll();
 }
 
 /******************************************************************************/
@@ -366,11 +410,11 @@ void XrdCmsCache::Drop(SMask_t smask, int SNum, int xHi)
 
 // Remove the node from the list of valid nodes
 //
-   myMutex.Lock();
+   LockAll();
    Bounced[SNum] = 0;
    okVec &= nmask;
    vecHi = xHi;
-   myMutex.UnLock();
+   UnLockAll();
 }
 
 /******************************************************************************/
@@ -379,7 +423,6 @@ void XrdCmsCache::Drop(SMask_t smask, int SNum, int xHi)
   
 int XrdCmsCache::Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold)
 {
-   XrdCmsKeyItem *iP;
    pthread_t tid;
 
 // Indicate whether we are a shared-everything setup as this changes how we
@@ -411,32 +454,59 @@ int XrdCmsCache::Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold
 
 // Get the first reserve of cache items
 //
-   iP = XrdCmsKeyItem::Alloc(0);
-   XrdCmsKeyItem::Unload((unsigned int)0);
-   iP->Recycle();
+   XrdCmsKeyItem::Replenish();
 
 // All done
 //
    return 1;
 }
 
+/******************************************************************************/
+/* public                     S t a t i s t i c s                             */
+/******************************************************************************/
+
+void XrdCmsCache::Statistics(XrdCmsCache::Info &Data)
+{
+   memset(&Data, 0, sizeof(Data));
+
+// Sum up the counters of each shard
+//
+   for (int i = 0; i < ShardNum; i++)
+       {Shards[i].sLock.ReadLock();
+        Data.Hits  += Shards[i].Hits;
+        Data.Miss  += Shards[i].Miss;
+        Data.Wait  += Shards[i].Wait;
+        Data.Bhits += Shards[i].Bhits;
+        Data.Bmiss += Shards[i].Bmiss;
+        Shards[i].sLock.UnLock();
+       }
+   Data.Shards = ShardNum;
+}
+
 /******************************************************************************/
 /* public                       T i c k T o c k                               */
 /******************************************************************************/
 
 void *XrdCmsCache::TickTock()
 {
-   XrdCmsKeyItem *iP;
+   XrdCmsKeyItem *iP[ShardNum];
+   bool haveItems;
 
-// Simply adjust the clock and trim old entries
+// Simply adjust the clock and trim old entries. Each shard is done on its own
+// so that lookups in the other shards can proceed while we do so.
 //
    do {XrdSysTimer::Snooze(Tick);
-       myMutex.Lock();
        Tock = (Tock+1) & XrdCmsKeyItem::TickMask;
-       Bhistory[Tock].Start = Bhistory[Tock].End = 0;
-       iP = XrdCmsKeyItem::Unload(Tock);
-       myMutex.UnLock();
-       if (iP) Sched->Schedule((XrdJob *)new XrdCmsCacheJob(iP));
+       haveItems = false;
+       for (int i = 0; i < ShardNum; i++)
+           {Shard &sP = Shards[i];
+            sP.sLock.WriteLock();
+            sP.Tock = Tock;
+            sP.Bhistory[Tock].Start = sP.Bhistory[Tock].End = 0;
+            if ((iP[i] = sP.CTable.Unload(Tock))) haveItems = true;
+            sP.sLock.UnLock();
+           }
+       if (haveItems) Sched->Schedule((XrdJob *)new XrdCmsCacheJob(iP));
       } while(1);
 
 // Keep compiler happy
@@ -502,7 +572,8 @@ void XrdCmsCache::Dispatch(XrdCmsSelect &Sel, XrdCmsKeyItem *iP,
 /*                               g e t B V e c                                */
 /******************************************************************************/
   
-SMask_t XrdCmsCache::getBVec(unsigned int TODa, unsigned int &TODb)
+SMask_t XrdCmsCache::getBVec(XrdCmsCache::Shard &sP,
+                             unsigned int TODa, unsigned int &TODb)
 {
    EPNAME("getBVec");
    SMask_t BVec(0);
@@ -510,57 +581,84 @@ SMask_t XrdCmsCache::getBVec(unsigned int TODa, unsigned int &TODb)
 
 // See if we can use a previously calculated bVec
 //
-   if (Bhistory[TODa].End == BClock && Bhistory[TODa].Start <= TODb)
-      {Bhits++; TODb = BClock; return Bhistory[TODa].Vec;}
+   if (sP.Bhistory[TODa].End == BClock && sP.Bhistory[TODa].Start <= TODb)
+      {sP.Bhits++; TODb = BClock; return sP.Bhistory[TODa].Vec;}
 
 // Calculate the new vector
 //
    for (i = 0; i <= vecHi; i++)
-       if (TODb < Bounced[i]) BVec |= 1ULL << i;
-
-   Bhistory[TODa].Vec   = BVec;
-   Bhistory[TODa].Start = TODb;
-   Bhistory[TODa].End   = BClock;
-   TODb                 = BClock;
-   Bmiss++;
-   if (!(Bmiss & 0xff)) DEBUG("hits=" <<Bhits <<" miss=" <<Bmiss);
+       if (TODb < Bounced[i]) BVec.Set(i);
+
+   sP.Bhistory[TODa].Vec   = BVec;
+   sP.Bhistory[TODa].Start = TODb;
+   sP.Bhistory[TODa].End   = BClock;
+   TODb                    = BClock;
+   sP.Bmiss++;
+   if (!(sP.Bmiss & 0xff)) DEBUG("hits=" <<sP.Bhits <<" miss=" <<sP.Bmiss);
    return BVec;
 }
 
+/******************************************************************************/
+/*                                  L o c k                                   */
+/******************************************************************************/
+
+XrdCmsCache::Shard &XrdCmsCache::Lock(XrdCmsKey &Key, bool shared)
+{
+
+// The shard is selected by the path hash, so an entry always lives in the same
+// shard. Count the times we had to wait for the lock.
+//
+   if (!Key.Hash) Key.setHash();
+   Shard &sP = Shards[Key.Hash & ShardMask];
+
+   if (shared)
+      {if (!sP.sLock.CondReadLock())  {sP.sLock.ReadLock();  sP.Wait++;}}
+      else if (!sP.sLock.CondWriteLock()) {sP.sLock.WriteLock(); sP.Wait++;}
+   return sP;
+}
+
+/******************************************************************************/
+/*                               L o c k A l l                                */
+/******************************************************************************/
+
+// Server state changes are rare, we lock all shards in order to do them.
+//
+void XrdCmsCache::LockAll()
+{
+   for (int i = 0; i < ShardNum; i++) Shards[i].sLock.WriteLock();
+}
+
 /******************************************************************************/
 /*                               R e c y c l e                                */
 /******************************************************************************/
   
-void XrdCmsCache::Recycle(XrdCmsKeyItem *theList)
+void XrdCmsCache::Recycle(XrdCmsKeyItem **theList)
 {
    XrdCmsKeyItem *iP;
    char msgBuff[100];
    int numNull, numHave, numFree, numRecycled = 0;
 
-// Recycle the list of cache items, as needed
+// Recycle the per-shard lists of cache items, as needed
 //
-   while((iP = theList))
-        {theList = iP->Key.TODRef;
-         if (iP->Loc.roPend) RRQ.Del(iP->Loc.roPend, iP);
-         if (iP->Loc.rwPend) RRQ.Del(iP->Loc.rwPend, iP);
-         myMutex.Lock(); CTable.Recycle(iP); myMutex.UnLock();
-         numRecycled++;
-        }
+   for (int i = 0; i < ShardNum; i++)
+       {Shard &sP = Shards[i];
+        while((iP = theList[i]))
+             {theList[i] = iP->Key.TODRef;
+              if (iP->Loc.roPend) RRQ.Del(iP->Loc.roPend, iP);
+              if (iP->Loc.rwPend) RRQ.Del(iP->Loc.rwPend, iP);
+              sP.sLock.WriteLock(); sP.CTable.Recycle(iP); sP.sLock.UnLock();
+              numRecycled++;
+             }
+       }
 
 // See if we have enough items in reserve
 //
-   myMutex.Lock();
    XrdCmsKeyItem::Stats(numHave, numFree, numNull);
    if (numFree < XrdCmsKeyItem::minFree)
-      {myMutex.UnLock();
-       if (!(numNull /= 4)) numNull = 1;
+      {if (!(numNull /= 4)) numNull = 1;
        numHave += XrdCmsKeyItem::minAlloc * numNull;
-       while(numNull--)
-            {myMutex.Lock();
-             numFree = XrdCmsKeyItem::Replenish();
-             myMutex.UnLock();
-            }
-      } else myMutex.UnLock();
+       while(numNull--) numFree = XrdCmsKeyItem::Replenish();
+      }
 
 // Log the stats
 //
@@ -568,3 +666,12 @@ void XrdCmsCache::Recycle(XrdCmsKeyItem *theList)
            numRecycled, numHave, numFree);
    Say.Emsg("Recycle", msgBuff);
 }
+
+/******************************************************************************/
+/*                             U n L o c k A l l                              */
+/******************************************************************************/
+  
+void XrdCmsCache::UnLockAll()
+{
+   for (int i = ShardNum-1; i >= 0; i--) Shards[i].sLock.UnLock();
+}
@@ -30,6 +30,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
 #include <cstring>
   
 #include "Xrd/XrdJob.hh"
@@ -76,34 +77,77 @@ void        Drop(SMask_t mask, int SNum, int xHi);
 
 int         Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold);
 
+// Statistics() returns the sum of the per-shard counters.
+//
+struct Info {long long Hits;    // Lookups that found the path
+             long long Miss;    // Lookups that did not find the path
+             long long Wait;    // Times a shard lock was contended
+             long long Bhits;   // Bounce vector cache hits
+             long long Bmiss;   // Bounce vector cache misses
+             int       Shards;  // Number of shards
+            };
+
+void        Statistics(Info &Data);
+
 void       *TickTock();
 
 static const int min_nxTime = 60;
 
             XrdCmsCache() : okVec(0), Tick(8*60*60), Tock(0), BClock(0), 
                             nilTMO(0),
-                            DLTime(5), QDelay(5), Bhits(0), Bmiss(0), vecHi(-1),
+                            DLTime(5), QDelay(5), vecHi(-1),
                             isDFS(0)
-                          {memset(Bounced,  0, sizeof(Bounced));
-                           memset(Bhistory, 0, sizeof(Bhistory));
-                          }
+                          {memset(Bounced,  0, sizeof(Bounced));}
            ~XrdCmsCache() {}   // Never gets deleted
 
 private:
 
+// The cache is striped into shards selected by the path hash. Each shard has
+// its own lock, hash table, expiry lists and bounce vector history so that
+// lookups of different paths do not serialize. The lock is a r/w lock: a
+// GetFile() that finds an entry needing no update holds it shared so that
+// lookups of the same popular paths do not serialize either. Anything that
+// changes an entry or the shard holds it exclusive. The server state (Bounced,
+// BClock, okVec, and vecHi) is only changed while all shard locks are held.
+//
+static const int ShardNum  = 64;
+static const int ShardMask = ShardNum-1;
+
+struct Shard
+      {XrdSysRWLock  sLock;
+       XrdCmsNash    CTable;
+       struct {SMask_t      Vec;
+               unsigned int Start;
+               unsigned int End;
+              }      Bhistory[XrdCmsKeyItem::TickRate];
+       std::atomic<long long> Hits;   // Updated under a shared lock
+       std::atomic<long long> Miss;   // Ditto
+       std::atomic<long long> Wait;   // Ditto
+       long long     Bhits;
+       long long     Bmiss;
+       unsigned int  Tock;
+
+                     Shard() : CTable(987, 1597), Hits(0), Miss(0), Wait(0),
+                               Bhits(0), Bmiss(0), Tock(0)
+                             {for (unsigned int i = 0; i < XrdCmsKeyItem::TickRate; i++)
+                                  {Bhistory[i].Vec   = 0;
+                                   Bhistory[i].Start = Bhistory[i].End = 0;
+                                  }
+                             }
+                    ~Shard() {}
+      };
+
 void          Add2Q(XrdCmsRRQInfo *Info, XrdCmsKeyItem *cp, int selOpts);
 void          Dispatch(XrdCmsSelect &Sel, XrdCmsKeyItem *cinfo,
                        short roQ, short rwQ);
-SMask_t       getBVec(unsigned int todA, unsigned int &todB);
-void          Recycle(XrdCmsKeyItem *theList);
-
-struct  {SMask_t      Vec;
-         unsigned int Start;
-         unsigned int End;
-        }             Bhistory[XrdCmsKeyItem::TickRate];
-
-XrdSysMutex   myMutex;
-XrdCmsNash    CTable;
+SMask_t       getBVec(Shard &sP, unsigned int todA, unsigned int &todB);
+int           GetFileX(Shard &sP, XrdCmsSelect &Sel, SMask_t mask);
+Shard        &Lock(XrdCmsKey &Key, bool shared=false);
+void          LockAll();
+void          Recycle(XrdCmsKeyItem **theList);
+void          UnLockAll();
+
+Shard         Shards[ShardNum];
 unsigned int  Bounced[STMax];
 SMask_t       okVec;
 unsigned int  Tick;
@@ -112,8 +156,6 @@ unsigned int  BClock;
          int  nilTMO;
          int  DLTime;
          int  QDelay;
-         int  Bhits;
-         int  Bmiss;
          int  vecHi;
          int  isDFS;
 };
@@ -223,14 +223,14 @@ XrdCmsNode *AddAlt(XrdCmsClustID *cidP, XrdLink *lp, int port, int Status,
 XrdCmsNode *calcDelay(XrdCmsSelector &selR);
 int         Drop(int sent, int sinst, XrdCmsDrop *djp=0);
 void        Record(char *path, const char *reason, bool force=false);
-bool        maxBits(SMask_t mVec, int mbits);
-int         Multiple(SMask_t mVec);
+bool        maxBits(const SMask_t &mVec, int mbits);
+int         Multiple(const SMask_t &mVec);
 enum        {eExists, eDups, eROfs, eNoRep, eNoSel, eNoEnt}; // Passed to SelFail
 int         SelFail(XrdCmsSelect &Sel, int rc);
 int         SelNode(XrdCmsSelect &Sel, SMask_t  pmask, SMask_t  amask);
-XrdCmsNode *SelbyCost(SMask_t, XrdCmsSelector &selR);
-XrdCmsNode *SelbyLoad(SMask_t, XrdCmsSelector &selR);
-XrdCmsNode *SelbyRef (SMask_t, XrdCmsSelector &selR);
+XrdCmsNode *SelbyCost(const SMask_t &, XrdCmsSelector &selR);
+XrdCmsNode *SelbyLoad(const SMask_t &, XrdCmsSelector &selR);
+XrdCmsNode *SelbyRef (const SMask_t &, XrdCmsSelector &selR);
 int         SelDFS(XrdCmsSelect &Sel, SMask_t amask,
                    SMask_t &pmask, SMask_t &smask, int isRW);
 void        sendAList(XrdLink *lp);
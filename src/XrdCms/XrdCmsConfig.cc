@@ -2400,6 +2400,7 @@ int XrdCmsConfig::xreps(XrdSysError *eDest, XrdOucStream &CFile)
     static struct repsopts {const char *opname; int opval;} rsopts[] =
        {
         {"all",      RepStat_All},
+        {"cch",      RepStat_cch},
         {"frq",      RepStat_frq},
         {"shr",      RepStat_shr}
        };
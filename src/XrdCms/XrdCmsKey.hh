@@ -33,6 +33,7 @@
 #include <cstring>
 
 #include "XrdCms/XrdCmsTypes.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
 /******************************************************************************/
 /*                       C l a s s   X r d C m s K e y                        */
@@ -120,7 +121,9 @@ XrdCmsKeyLoc&  operator=(const XrdCmsKeyLoc &rhs)
   
 // The XrdCmsKeyItem object marries the XrdCmsKey and XrdCmsKeyLoc objects in
 // the key cache. It is only used by logical manipulator, XrdCmsCache, which
-// always front-ends the physical manipulator, XrdCmsNash.
+// always front-ends the physical manipulator, XrdCmsNash. The free list is
+// shared and has its own lock; the expiry lists (tockTab) belong to the
+// caller who must serialize access to them.
 //
 class XrdCmsKeyItem
 {
@@ -130,19 +133,19 @@ public:
        XrdCmsKey      Key;
        XrdCmsKeyItem *Next;
 
-static XrdCmsKeyItem *Alloc(unsigned int theTock);
+static XrdCmsKeyItem *Alloc(XrdCmsKeyItem **tockTab, unsigned int theTock);
 
        void           Recycle();
 
-       void           Reload();
+       void           Reload(XrdCmsKeyItem **tockTab);
 
 static int            Replenish();
 
 static void           Stats(int &isAlloc, int &isFree, int &wasEmpty);
 
-static XrdCmsKeyItem *Unload(unsigned int   theTock);
+static XrdCmsKeyItem *Unload(XrdCmsKeyItem **tockTab, unsigned int theTock);
 
-static XrdCmsKeyItem *Unload(XrdCmsKeyItem *theItem);
+static XrdCmsKeyItem *Unload(XrdCmsKeyItem **tockTab, XrdCmsKeyItem *theItem);
 
        XrdCmsKeyItem() {}  // Warning see the constructor!
       ~XrdCmsKeyItem() {}  // These are usually never deleted
@@ -154,7 +157,9 @@ static const          int minFree  = 1024;
 
 private:
 
-static XrdCmsKeyItem *TockTable[TickRate];
+static int            Refill();
+
+static XrdSysMutex    fMutex;
 static XrdCmsKeyItem *Free;
 static int            numFree;
 static int            numHave;
@@ -41,6 +41,14 @@ XrdCmsKeyItem *Find(XrdCmsKey &Key);
 
 int            Recycle(XrdCmsKeyItem *rip);
 
+// Unload() removes items from this table's expiry lists (see XrdCmsKeyItem).
+//
+XrdCmsKeyItem *Unload(unsigned int theTock)
+                     {return XrdCmsKeyItem::Unload(TockTable, theTock);}
+
+XrdCmsKeyItem *Unload(XrdCmsKeyItem *theItem)
+                     {return XrdCmsKeyItem::Unload(TockTable, theItem);}
+
 // When allocateing a new nash, specify the required starting size. Make
 // sure that the previous number is the correct Fibonocci antecedent. The
 // series is simply n[j] = n[j-1] + n[j-2].
@@ -55,6 +63,7 @@ static const int LoadMax = 80;
 void               Expand();
 
 XrdCmsKeyItem  **nashtable;
+XrdCmsKeyItem   *TockTable[XrdCmsKeyItem::TickRate];
 int              prevtablesize;
 int              nashtablesize;
 int              nashnum;
@@ -99,11 +99,10 @@ XrdCmsNode::XrdCmsNode(XrdLink *lnkp, const char *theIF, const char *nid,
                        int port, int lvl, int id)
 {
     static XrdSysMutex   iMutex;
-    static const SMask_t smask_1(1);
     static int           iNum = 1;
 
     Link     =  lnkp;
-    NodeMask =  (id < 0 ? 0 : smask_1 << id);
+    NodeMask =  (id < 0 ? SMask_t(0) : SMask_t::Bit(id));
     NodeID   = id;
     isOffline=  (lnkp == 0);
     logload  =  Config.LogPerf;
@@ -364,7 +363,7 @@ const char *XrdCmsNode::do_Disc(XrdCmsRRData &Arg)
 const char *XrdCmsNode::do_Gone(XrdCmsRRData &Arg)
 {
    EPNAME("do_Gone")
-   static const SMask_t allNodes(~0);
+   static const SMask_t allNodes(FULLMASK);
    int newgone;
 
 // Do some debugging
@@ -406,7 +405,7 @@ const char *XrdCmsNode::do_Gone(XrdCmsRRData &Arg)
 const char *XrdCmsNode::do_Have(XrdCmsRRData &Arg)
 {
    EPNAME("do_Have")
-   static const SMask_t allNodes(~0);
+   static const SMask_t allNodes(FULLMASK);
    XrdCmsPInfo  pinfo;
    int isnew, Opts;
 
@@ -786,7 +785,7 @@ const char *XrdCmsNode::do_Mkpath(XrdCmsRRData &Arg)
 const char *XrdCmsNode::do_Mv(XrdCmsRRData &Arg)
 {
    EPNAME("do_Mv")
-   static const SMask_t allNodes(~0);
+   static const SMask_t allNodes(FULLMASK);
    int rc;
 
 // Do some debugging
@@ -916,7 +915,7 @@ const char *XrdCmsNode::do_PrepDel(XrdCmsRRData &Arg)
 const char *XrdCmsNode::do_Rm(XrdCmsRRData &Arg)
 {
    EPNAME("do_Rm")
-   static const SMask_t allNodes(~0);
+   static const SMask_t allNodes(FULLMASK);
    int rc;
 
 // Do some debugging
@@ -951,7 +950,7 @@ const char *XrdCmsNode::do_Rm(XrdCmsRRData &Arg)
 const char *XrdCmsNode::do_Rmdir(XrdCmsRRData &Arg)
 {
    EPNAME("do_Rmdir")
-   static const SMask_t allNodes(~0);
+   static const SMask_t allNodes(FULLMASK);
    int rc;
 
 // Do some debugging
@@ -1348,7 +1347,7 @@ const char *XrdCmsNode::do_State(XrdCmsRRData &Arg)
 void XrdCmsNode::do_StateDFS(XrdCmsBaseFR *rP, int rc)
 {
    EPNAME("StateDFs");
-   static const SMask_t allNodes(~0);
+   static const SMask_t allNodes(FULLMASK);
    CmsRRHdr Request = {rP->Sid, 0, (kXR_char)(rP->Mod | kYR_raw), 0};
    XrdCmsSelect Sel(0, rP->Path, rP->PathLen);
    int isNew;
@@ -1401,7 +1400,7 @@ void XrdCmsNode::do_StateDFS(XrdCmsBaseFR *rP, int rc)
 int XrdCmsNode::do_StateFWD(XrdCmsRRData &Arg)
 {
    EPNAME("do_StateFWD");
-   static const SMask_t allNodes(~0);
+   static const SMask_t allNodes(FULLMASK);
    XrdCmsSelect Sel(0, Arg.Path, Arg.PathLen-1);
    XrdCmsPInfo  pinfo;
    int retc;
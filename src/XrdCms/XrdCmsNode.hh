@@ -142,7 +142,8 @@ inline int    Inst() {return Instance;}
 
        bool   inDomain() {return netIF.InDomain(&netID);}
 
-inline int    isNode(SMask_t smask) {return (smask & NodeMask) != 0;}
+inline int    isNode(const SMask_t &smask)
+                      {return NodeID >= 0 && smask.Test(NodeID);}
 
 inline int    isNode(const XrdNetAddr *addr) // Only for avoid processing!
                     {return netID.Same(addr);}
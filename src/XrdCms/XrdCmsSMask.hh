@@ -0,0 +1,170 @@
+#ifndef __XRDCMSSMASK_HH__
+#define __XRDCMSSMASK_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d C m s S M a s k . h h                         */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstdint>
+
+// The XrdCmsSMask class is the server set bit vector. Bit n corresponds to the
+// node whose slot number is n. The width is a multiple of 64 and is fixed at
+// compile time. All operations work on whole words in simple loops of constant
+// trip count so that the compiler unrolls or vectorizes them; with the default
+// width of 64 the object is a single word and the code is the same as using
+// an unsigned long long.
+//
+template<int nBits>
+class XrdCmsSMask
+{
+public:
+
+static const int Bits  = nBits;
+static const int Words = (nBits+63)/64;
+
+// Any() returns true if any bit is set.
+//
+inline bool     Any() const
+                   {uint64_t x = 0;
+                    for (int i = 0; i < Words; i++) x |= vec[i];
+                    return x != 0;
+                   }
+
+// Bit() returns a mask with only bit n set.
+//
+static
+inline XrdCmsSMask Bit(int n) {XrdCmsSMask m; m.Set(n); return m;}
+
+// Count() returns the number of bits set.
+//
+inline int      Count() const
+                     {int n = 0;
+                      for (int i = 0; i < Words; i++)
+                          n += __builtin_popcountll(vec[i]);
+                      return n;
+                     }
+
+// First() returns the lowest bit number that is set or -1 if none are set.
+//
+inline int      First() const
+                     {for (int i = 0; i < Words; i++)
+                          if (vec[i]) return i*64 + __builtin_ctzll(vec[i]);
+                      return -1;
+                     }
+
+// Full() returns a mask with all bits set.
+//
+static
+inline XrdCmsSMask Full() {XrdCmsSMask m;
+                           for (int i = 0; i < Words; i++) m.vec[i] = ~0ULL;
+                           return m;
+                          }
+
+// Next() returns the lowest bit number greater than n that is set or -1.
+//
+inline int      Next(int n) const
+                    {int i = ++n >> 6;
+                     if (i >= Words) return -1;
+                     uint64_t x = vec[i] & (~0ULL << (n & 63));
+                     while(!x) {if (++i >= Words) return -1; x = vec[i];}
+                     return i*64 + __builtin_ctzll(x);
+                    }
+
+inline void     Reset(int n) {vec[n >> 6] &= ~(1ULL << (n & 63));}
+
+inline void     Set(int n)   {vec[n >> 6] |=  (1ULL << (n & 63));}
+
+inline bool     Test(int n) const {return (vec[n >> 6] >> (n & 63)) & 1;}
+
+// Word() returns the n'th 64-bit word (used for display purposes).
+//
+inline uint64_t Word(int n) const {return vec[n];}
+
+explicit
+inline          operator bool() const {return Any();}
+
+inline XrdCmsSMask  operator~() const
+                   {XrdCmsSMask m;
+                    for (int i = 0; i < Words; i++) m.vec[i] = ~vec[i];
+                    return m;
+                   }
+
+inline XrdCmsSMask &operator&=(const XrdCmsSMask &rhs)
+                   {for (int i = 0; i < Words; i++) vec[i] &= rhs.vec[i];
+                    return *this;
+                   }
+
+inline XrdCmsSMask &operator|=(const XrdCmsSMask &rhs)
+                   {for (int i = 0; i < Words; i++) vec[i] |= rhs.vec[i];
+                    return *this;
+                   }
+
+inline XrdCmsSMask &operator^=(const XrdCmsSMask &rhs)
+                   {for (int i = 0; i < Words; i++) vec[i] ^= rhs.vec[i];
+                    return *this;
+                   }
+
+friend
+inline XrdCmsSMask  operator&(XrdCmsSMask lhs, const XrdCmsSMask &rhs)
+                             {return lhs &= rhs;}
+
+friend
+inline XrdCmsSMask  operator|(XrdCmsSMask lhs, const XrdCmsSMask &rhs)
+                             {return lhs |= rhs;}
+
+friend
+inline XrdCmsSMask  operator^(XrdCmsSMask lhs, const XrdCmsSMask &rhs)
+                             {return lhs ^= rhs;}
+
+friend
+inline bool         operator==(const XrdCmsSMask &lhs, const XrdCmsSMask &rhs)
+                       {uint64_t x = 0;
+                        for (int i = 0; i < Words; i++)
+                            x |= lhs.vec[i] ^ rhs.vec[i];
+                        return x == 0;
+                       }
+
+friend
+inline bool         operator!=(const XrdCmsSMask &lhs, const XrdCmsSMask &rhs)
+                              {return !(lhs == rhs);}
+
+// A mask may be initialized from an integer which sets the low order bits.
+//
+                XrdCmsSMask(unsigned long long ival=0)
+                           {vec[0] = ival;
+                            for (int i = 1; i < Words; i++) vec[i] = 0;
+                           }
+
+private:
+
+static_assert(nBits > 0 && nBits % 64 == 0,
+              "server mask width must be a multiple of 64");
+
+uint64_t vec[Words];
+};
+#endif
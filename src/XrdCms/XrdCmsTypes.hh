@@ -30,13 +30,20 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
   
-typedef unsigned long long SMask_t;
+// The following defines our cell size (maximum subscribers). It is set at
+// build time (cmake -DCMS_MAX_NODES=n) to any multiple of 64 and comes from a
+// generated header so that all libraries agree on it. All cmsd's in a cluster
+// should use the same value.
+//
+#include "XrdCms/XrdCmsMaxNodes.hh"
 
-#define FULLMASK 0xFFFFFFFFFFFFFFFFULL
+#define STMax XRDCMS_MAXNODES
 
-// The following defines our cell size (maximum subscribers)
-//
-#define STMax 64
+#include "XrdCms/XrdCmsSMask.hh"
+
+typedef XrdCmsSMask<STMax> SMask_t;
+
+#define FULLMASK SMask_t::Full()
 
 // The following defines the maximum number of redirectors. It is one greater
 // than the actual maximum as the zeroth is never used.
@@ -76,6 +76,12 @@ namespace XrdEc
 
       bool enable_plugins;
 
+      //-----------------------------------------------------------------------
+      //! Decode missing stripes on the thread pool rather than only on the
+      //! thread that noticed they were missing
+      //-----------------------------------------------------------------------
+      bool parallel_recovery;
+
     private:
 
       std::unordered_map<std::string, RedundancyProvider> redundancies;
@@ -84,7 +90,7 @@ namespace XrdEc
       //-----------------------------------------------------------------------
       //! Constructor
       //-----------------------------------------------------------------------
-      Config() : enable_plugins( true )
+      Config() : enable_plugins( true ), parallel_recovery( false )
       {
       }
 
@@ -254,7 +254,7 @@ namespace XrdEc
         stripes_t strps( self->get_stripes() );
         try
         {
-          cfg.GetRedundancy( self->objcfg ).compute( strps );
+          cfg.GetRedundancy( self->objcfg ).compute( strps, cfg.parallel_recovery );
         }
         catch( const IOError &ex )
         {
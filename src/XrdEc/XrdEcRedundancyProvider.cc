@@ -14,11 +14,14 @@
  ************************************************************************/
 
 #include "XrdEc/XrdEcRedundancyProvider.hh"
+#include "XrdEc/XrdEcThreadPool.hh"
 
 #include "isa-l/isa-l.h"
 #include <cstring>
 #include <sstream>
 #include <algorithm>
+#include <condition_variable>
+#include <thread>
 
 namespace XrdEc
 {
@@ -147,6 +150,69 @@ static int gf_gen_decode_matrix(
   return 0;
 }
 
+namespace
+{
+//--------------------------------------------------------------------------
+//! A block decode split into segments. The segments are claimed one at a
+//! time by the calling thread and by helpers from the thread pool; the
+//! calling thread only waits for segments a helper is already working on,
+//! so a busy pool cannot stall it. Helpers that start late find nothing
+//! left and return.
+//--------------------------------------------------------------------------
+struct SegmentedDecode
+{
+  SegmentedDecode( size_t seglen, size_t len, size_t nsegs ) :
+    seglen( seglen ), len( len ), nsegs( nsegs ), next( 0 ), done( 0 )
+  {
+  }
+
+  void run()
+  {
+    size_t seg;
+    while( ( seg = next++ ) < nsegs )
+    {
+      size_t offset = seg * seglen;
+      size_t count  = std::min( seglen, len - offset );
+      unsigned char* in[k];
+      unsigned char* out[nErrors];
+      for( int i = 0; i < k; ++i ) in[i] = inbuf[i] + offset;
+      for( int i = 0; i < nErrors; ++i ) out[i] = outbuf[i] + offset;
+      ec_encode_data( static_cast<int>( count ), k, nErrors, table, in, out );
+      if( ++done == nsegs )
+      {
+        std::unique_lock<std::mutex> lck( mtx );
+        cv.notify_all();
+      }
+    }
+  }
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> lck( mtx );
+    cv.wait( lck, [this]{ return done == nsegs; } );
+  }
+
+  const size_t             seglen;
+  const size_t             len;
+  const size_t             nsegs;
+  int                      k;
+  int                      nErrors;
+  unsigned char           *table;
+  unsigned char*           inbuf[256];
+  unsigned char*           outbuf[256];
+  std::atomic<size_t>      next;
+  std::atomic<size_t>      done;
+  std::mutex               mtx;
+  std::condition_variable  cv;
+};
+
+//--------------------------------------------------------------------------
+//! Segments are no smaller than this, below that the hand-off costs more
+//! than the decode
+//--------------------------------------------------------------------------
+const size_t minSegment = 64 * 1024;
+}
+
 RedundancyProvider::RedundancyProvider( const ObjCfg &objcfg ) :
     objcfg( objcfg ),
     encode_matrix( objcfg.nbchunks * objcfg.nbdata )
@@ -154,55 +220,92 @@ RedundancyProvider::RedundancyProvider( const ObjCfg &objcfg ) :
   // k = data
   // m = data + parity
   gf_gen_cauchy1_matrix( encode_matrix.data(), static_cast<int>( objcfg.nbchunks ), static_cast<int>( objcfg.nbdata ) );
+  for( size_t i = 0; i < cacheSize; ++i )
+    cache[i].store( nullptr, std::memory_order_relaxed );
+}
+
+RedundancyProvider::~RedundancyProvider()
+{
+  for( size_t i = 0; i < cacheSize; ++i )
+  {
+    CodingTable *dd = cache[i].load( std::memory_order_relaxed );
+    while( dd )
+    {
+      CodingTable *next = dd->next;
+      delete dd;
+      dd = next;
+    }
+  }
 }
 
 
-std::string RedundancyProvider::getErrorPattern( stripes_t &stripes ) const
+size_t RedundancyProvider::getErrorPattern( stripes_t &stripes, ErrorPattern &pattern ) const
 {
-  std::string pattern( objcfg.nbchunks, 0 );
+  size_t nerrs = 0;
+  memset( &pattern, 0, sizeof( pattern ) );
   for( uint8_t i = 0; i < objcfg.nbchunks; ++i )
-    if( !stripes[i].valid ) pattern[i] = '\1';
+    if( !stripes[i].valid )
+    {
+      pattern.set( i );
+      ++nerrs;
+    }
 
-  return pattern;
+  return nerrs;
 }
 
 
-RedundancyProvider::CodingTable& RedundancyProvider::getCodingTable( const std::string& pattern )
+const RedundancyProvider::CodingTable& RedundancyProvider::getCodingTable( const ErrorPattern& pattern )
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  uint64_t hash = 0;
+  for( size_t i = 0; i < 4; ++i )
+    hash = ( hash ^ pattern.bits[i] ) * 0x9e3779b97f4a7c15ULL;
+  std::atomic<CodingTable*> &bucket = cache[hash >> 56];
 
-  /* If decode matrix is not already cached we have to construct it. */
-  if( !cache.count(pattern) )
-  {
-    /* Expand pattern */
-    int nerrs = 0, nsrcerrs = 0;
-    unsigned char err_indx_list[objcfg.nbparity];
-    for (std::uint8_t i = 0; i < pattern.size(); i++) {
-      if (pattern[i]) {
-        err_indx_list[nerrs++] = i;
-        if (i < objcfg.nbdata) { nsrcerrs++; }
-      }
-    }
-
-    /* Allocate Decode Object. */
-    CodingTable dd;
-    dd.nErrors = nerrs;
-    dd.blockIndices.resize( objcfg.nbdata );
-    dd.table.resize( objcfg.nbdata * objcfg.nbparity * 32);
+  /* Look the table up, tables are immutable once published. */
+  for( CodingTable *dd = bucket.load( std::memory_order_acquire ); dd; dd = dd->next )
+    if( dd->pattern == pattern ) return *dd;
 
-    /* Compute decode matrix. */
-    std::vector<unsigned char> decode_matrix(objcfg.nbchunks * objcfg.nbdata);
-
-    if (gf_gen_decode_matrix( encode_matrix.data(), decode_matrix.data(), dd.blockIndices.data(),
-                              err_indx_list, (unsigned char*) pattern.c_str(), nerrs, nsrcerrs,
-                              static_cast<int>( objcfg.nbdata ), static_cast<int>( objcfg.nbchunks ) ) )
-      throw IOError( XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errDataError, errno, "Failed computing decode matrix" ) );
+  std::lock_guard<std::mutex> lock(mutex);
 
-    /* Compute Tables. */
-    ec_init_tables( static_cast<int>( objcfg.nbdata ), nerrs, decode_matrix.data(), dd.table.data() );
-    cache.insert( std::make_pair(pattern, dd) );
+  /* Somebody might have constructed it in the meanwhile. */
+  for( CodingTable *dd = bucket.load( std::memory_order_relaxed ); dd; dd = dd->next )
+    if( dd->pattern == pattern ) return *dd;
+
+  /* Expand pattern */
+  int nerrs = 0, nsrcerrs = 0;
+  unsigned char err_indx_list[objcfg.nbparity];
+  unsigned char src_in_err[objcfg.nbchunks];
+  for (std::uint8_t i = 0; i < objcfg.nbchunks; i++) {
+    src_in_err[i] = pattern.test( i );
+    if (src_in_err[i]) {
+      err_indx_list[nerrs++] = i;
+      if (i < objcfg.nbdata) { nsrcerrs++; }
+    }
   }
-  return cache.at(pattern);
+
+  /* Allocate Decode Object. */
+  std::unique_ptr<CodingTable> dd( new CodingTable() );
+  dd->pattern = pattern;
+  dd->nErrors = nerrs;
+  dd->blockIndices.resize( objcfg.nbdata );
+  dd->errorIndices.assign( err_indx_list, err_indx_list + nerrs );
+  dd->table.resize( objcfg.nbdata * objcfg.nbparity * 32);
+
+  /* Compute decode matrix. */
+  std::vector<unsigned char> decode_matrix(objcfg.nbchunks * objcfg.nbdata);
+
+  if (gf_gen_decode_matrix( encode_matrix.data(), decode_matrix.data(), dd->blockIndices.data(),
+                            err_indx_list, src_in_err, nerrs, nsrcerrs,
+                            static_cast<int>( objcfg.nbdata ), static_cast<int>( objcfg.nbchunks ) ) )
+    throw IOError( XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errDataError, errno, "Failed computing decode matrix" ) );
+
+  /* Compute Tables. */
+  ec_init_tables( static_cast<int>( objcfg.nbdata ), nerrs, decode_matrix.data(), dd->table.data() );
+
+  /* Publish. */
+  dd->next = bucket.load( std::memory_order_relaxed );
+  bucket.store( dd.get(), std::memory_order_release );
+  return *dd.release();
 }
 
 void RedundancyProvider::replication( stripes_t &stripes )
@@ -225,11 +328,20 @@ void RedundancyProvider::replication( stripes_t &stripes )
   }
 }
 
-void RedundancyProvider::compute( stripes_t &stripes )
+void RedundancyProvider::compute( stripes_t &stripes, bool parallel )
 {
-  /* throws if stripe is not recoverable */
-  std::string pattern = getErrorPattern( stripes );
+  /* split large blocks into segments, one per core at most */
+  size_t nsegs = 1;
+  if( parallel )
+  {
+    size_t maxsegs = std::max( 1u, std::thread::hardware_concurrency() );
+    nsegs = std::min<size_t>( maxsegs, objcfg.chunksize / minSegment );
+  }
+  computeSegmented( stripes, nsegs );
+}
 
+void RedundancyProvider::computeSegmented( stripes_t &stripes, size_t nsegs )
+{
   /* nothing to do if there are no parity blocks. */
   if ( !objcfg.nbparity ) return;
 
@@ -237,39 +349,59 @@ void RedundancyProvider::compute( stripes_t &stripes )
   if ( objcfg.nbdata == 1 )
     return replication( stripes );
 
+  /* throws if stripe is not recoverable */
+  ErrorPattern pattern;
+  size_t nerrs = getErrorPattern( stripes, pattern );
+  if( nerrs == 0 ) return;
+  if( nerrs > objcfg.nbparity )
+    throw IOError( XrdCl::XRootDStatus( XrdCl::stError, XrdCl::errDataError ) );
+
   /* normal operation: erasure coding */
-  CodingTable& dd = getCodingTable(pattern);
+  const CodingTable& dd = getCodingTable(pattern);
 
+  /* decode straight into the missing blocks */
   unsigned char* inbuf[objcfg.nbdata];
   for( uint8_t i = 0; i < objcfg.nbdata; i++ )
     inbuf[i] = reinterpret_cast<unsigned char*>( stripes[dd.blockIndices[i]].buffer );
 
-  std::vector<unsigned char> memory( dd.nErrors * objcfg.chunksize );
-
   unsigned char* outbuf[dd.nErrors];
   for (int i = 0; i < dd.nErrors; i++)
+    outbuf[i] = reinterpret_cast<unsigned char*>( stripes[dd.errorIndices[i]].buffer );
+
+  /* segments are cache line aligned */
+  size_t seglen = objcfg.chunksize;
+  if( nsegs > 1 && objcfg.chunksize > 0 )
   {
-    outbuf[i] = &memory[i * objcfg.chunksize];
+    seglen = ( ( objcfg.chunksize + nsegs - 1 ) / nsegs + 63 ) & ~size_t( 63 );
+    nsegs  = ( objcfg.chunksize + seglen - 1 ) / seglen;
   }
+  else nsegs = 1;
 
-  ec_encode_data(
-      static_cast<int>( objcfg.chunksize ), // Length of each block of data (vector) of source or destination data.
-      static_cast<int>( objcfg.nbdata ),     // The number of vector sources in the generator matrix for coding.
-      dd.nErrors,     // The number of output vectors to concurrently encode/decode.
-      dd.table.data(), // Pointer to array of input tables
-      inbuf,          // Array of pointers to source input buffers
-      outbuf          // Array of pointers to coded output buffers
-  );
-
-  int e = 0;
-  for (size_t i = 0; i < objcfg.nbchunks; i++)
+  if( nsegs <= 1 )
   {
-    if( pattern[i] )
-    {
-      memcpy( stripes[i].buffer, outbuf[e], objcfg.chunksize );
-      e++;
-    }
+    ec_encode_data(
+        static_cast<int>( objcfg.chunksize ), // Length of each block of data (vector) of source or destination data.
+        static_cast<int>( objcfg.nbdata ),     // The number of vector sources in the generator matrix for coding.
+        dd.nErrors,     // The number of output vectors to concurrently encode/decode.
+        const_cast<unsigned char*>( dd.table.data() ), // Pointer to array of input tables
+        inbuf,          // Array of pointers to source input buffers
+        outbuf          // Array of pointers to coded output buffers
+    );
+    return;
   }
+
+  std::shared_ptr<SegmentedDecode> decode =
+      std::make_shared<SegmentedDecode>( seglen, objcfg.chunksize, nsegs );
+  decode->k       = static_cast<int>( objcfg.nbdata );
+  decode->nErrors = dd.nErrors;
+  decode->table   = const_cast<unsigned char*>( dd.table.data() );
+  std::copy( inbuf, inbuf + objcfg.nbdata, decode->inbuf );
+  std::copy( outbuf, outbuf + dd.nErrors, decode->outbuf );
+
+  for( size_t i = 1; i < nsegs; ++i )
+    ThreadPool::Instance().Execute( []( std::shared_ptr<SegmentedDecode> d ){ d->run(); }, decode );
+  decode->run();
+  decode->wait();
 }
 
 
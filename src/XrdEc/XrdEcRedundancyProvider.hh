@@ -25,10 +25,11 @@
 #include "XrdEc/XrdEcObjCfg.hh"
 #include "XrdEc/XrdEcUtilities.hh"
 
+#include <atomic>
+#include <cstring>
 #include <memory>
 #include <vector>
 #include <string>
-#include <unordered_map>
 #include <mutex>
 
 namespace XrdEc
@@ -45,10 +46,32 @@ namespace XrdEc
     //! has to equal nData+nParity. Blocks can be arbitrary size, but size has
     //! to be equal within a stripe. Function will throw on incorrect input.
     //!
+    //! Missing blocks are decoded in place. In parallel mode large blocks are
+    //! split into segments that are decoded on the XrdEc thread pool, with
+    //! the calling thread taking its share.
+    //!
+    //! A call only ever sees the stripes of a single block, so the work is
+    //! split by column within that block. Different blocks are recovered by
+    //! independent calls, made from the response handlers of their reads,
+    //! and those already run concurrently on the XrdCl worker threads.
+    //!
     //! @param stripe nData+nParity blocks, missing (empty) blocks will be
     //!   computed if possible.
+    //! @param parallel spread the work over the thread pool, using at most
+    //!   one segment per core
     //--------------------------------------------------------------------------
-    void compute( stripes_t &stripes );
+    void compute( stripes_t &stripes, bool parallel = false );
+
+    //--------------------------------------------------------------------------
+    //! Same as compute() but with the number of segments given explicitly,
+    //! regardless of the number of cores.
+    //!
+    //! @param stripe nData+nParity blocks, missing (empty) blocks will be
+    //!   computed if possible.
+    //! @param nsegs split each block into this many cache line aligned
+    //!   segments (at most), 1 decodes on the calling thread only
+    //--------------------------------------------------------------------------
+    void computeSegmented( stripes_t &stripes, size_t nsegs );
 
     //--------------------------------------------------------------------------
     //! Constructor.
@@ -57,18 +80,44 @@ namespace XrdEc
     //--------------------------------------------------------------------------
     RedundancyProvider( const ObjCfg &objcfg );
 
+    //--------------------------------------------------------------------------
+    //! Destructor.
+    //--------------------------------------------------------------------------
+    ~RedundancyProvider();
+
   private:
+    //--------------------------------------------------------------------------
+    //! Error pattern / signature: bit i is set if block i is missing.
+    //--------------------------------------------------------------------------
+    struct ErrorPattern {
+      uint64_t bits[4];
+
+      bool operator==( const ErrorPattern &other ) const
+      {
+        return !memcmp( bits, other.bits, sizeof( bits ) );
+      }
+
+      bool test( size_t i ) const { return bits[i / 64] & ( 1ULL << ( i % 64 ) ); }
+      void set( size_t i ) { bits[i / 64] |= 1ULL << ( i % 64 ); }
+    };
+
     //--------------------------------------------------------------------------
     //! Data structure to store all information required for a decode process with
     //! a known error pattern.
     //--------------------------------------------------------------------------
     struct CodingTable {
+      //! the error pattern this table decodes
+      ErrorPattern pattern;
       //! the coding table
       std::vector<unsigned char> table;
       //! array of nData size, containing stripe indices to input blocks
       std::vector<unsigned int> blockIndices;
+      //! array of nErrors size, containing stripe indices to output blocks
+      std::vector<unsigned int> errorIndices;
       //! Number of errors this coding table is constructed for (maximum==nParity)
       int nErrors;
+      //! next coding table in the same cache bucket
+      CodingTable *next;
     };
 
     //--------------------------------------------------------------------------
@@ -79,20 +128,22 @@ namespace XrdEc
     //!
     //! @param stripe vector of nData+nParity blocks, missing (empty) blocks are
     //!        errors
-    //! @return a string of stripe size describing the error pattern
+    //! @param pattern the error pattern
+    //! @return the number of errors
     //--------------------------------------------------------------------------
-    std::string getErrorPattern( stripes_t &stripes ) const;
+    size_t getErrorPattern( stripes_t &stripes, ErrorPattern &pattern ) const;
 
     //--------------------------------------------------------------------------
     //! Returns a reference to the coding table for the requested error pattern,
     //! if possible from the cache. If that particular table has not been
-    //! requested before, it will be constructed.
+    //! requested before, it will be constructed. Lookups do not lock, tables
+    //! are only ever added to the cache and live as long as the provider.
     //!
     //! @param pattern error pattern / signature
     //! @return reference to the coding table for the supplied error pattern
     //--------------------------------------------------------------------------
-    CodingTable& getCodingTable(
-        const std::string& pattern
+    const CodingTable& getCodingTable(
+        const ErrorPattern& pattern
     );
 
   private:
@@ -103,9 +154,10 @@ namespace XrdEc
 
     //! the encoding matrix, required to compute any decode matrix
     std::vector<unsigned char> encode_matrix;
-    //! a cache of previously used coding tables
-    std::unordered_map<std::string, CodingTable> cache;
-    //! concurrency control
+    //! a cache of previously used coding tables, chained per bucket
+    static const size_t cacheSize = 256;
+    std::atomic<CodingTable*> cache[cacheSize];
+    //! serializes the construction of new coding tables
     std::mutex mutex;
   };
 
@@ -32,6 +32,7 @@
 #include "XrdSys/XrdSysE2T.hh"
 #include "XrdSys/XrdSysTimer.hh"
 #include "XrdOuc/XrdOucPinLoader.hh"
+#include "XrdOuc/XrdOuca2x.hh"
 #include "XrdHttpTrace.hh"
 #include "XrdHttpProtocol.hh"
 
@@ -99,6 +100,7 @@ int XrdHttpProtocol::exthandlercnt = 0;
 std::map< std::string, std::string > XrdHttpProtocol::hdr2cgimap; 
 
 bool XrdHttpProtocol::usingEC = false;
+int XrdHttpProtocol::rangeGap = 4096;
 
 XrdScheduler *XrdHttpProtocol::Sched = 0; // System scheduler
 XrdBuffManager *XrdHttpProtocol::BPool = 0; // Buffer manager
@@ -510,7 +512,13 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
       if (secxtractor)
         secxtractor->InitSSL(ssl, sslcadir);
 
-      SSL_set_bio(ssl, sbio, sbio);
+      // When the kernel may do the encryption the records must be written to
+      // the socket itself for OpenSSL to hand the keys over. Reads still go
+      // through the link.
+      BIO *wbio = 0;
+      if (xrdctx->kernelTLS())
+        wbio = BIO_new_socket(Link->FDnum(), BIO_NOCLOSE);
+      SSL_set_bio(ssl, sbio, (wbio ? wbio : sbio));
       //SSL_set_connect_state(ssl);
 
       //SSL_set_fd(ssl, Link->FDnum());
@@ -541,6 +549,11 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
       ERR_print_errors(sslbio_err);
       strcpy(SecEntity.prot, "https");
 
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+      isktls = BIO_get_ktls_send(SSL_get_wbio(ssl));
+      TRACEI(DEBUG, " Kernel TLS send: " << isktls);
+#endif
+
       // Get the voms string and auth information
       if (HandleAuthentication(Link)) {
           SSL_free(ssl);
@@ -1018,6 +1031,7 @@ int XrdHttpProtocol::Config(const char *ConfigFN, XrdOucEnv *myEnv) {
       else if TS_Xeq("header2cgi", xheader2cgi);
       else if TS_Xeq("httpsmode", xhttpsmode);
       else if TS_Xeq("tlsreuse", xtlsreuse);
+      else if TS_Xeq("rangegap", xrangegap);
       else {
         eDest.Say("Config warning: ignoring unknown directive '", var, "'.");
         Config.Echo();
@@ -1475,7 +1489,7 @@ int XrdHttpProtocol::SendData(const char *body, int bodylen) {
 
   if (body && bodylen) {
     TRACE(REQ, "Sending " << bodylen << " bytes");
-    if (ishttps) {
+    if (ishttps && !isktls) {
       r = SSL_write(ssl, body, bodylen);
       if (r <= 0) {
         ERR_print_errors(sslbio_err);
@@ -1491,6 +1505,68 @@ int XrdHttpProtocol::SendData(const char *body, int bodylen) {
   return 0;
 }
 
+/// Send a gathered list of data pieces to the client
+
+int XrdHttpProtocol::SendData(const struct iovec *iov, int iovN) {
+
+  // The largest TLS record payload. Every SSL_write() ends a record, hence
+  // the small pieces (e.g. multipart headers) are staged together with the
+  // head of the following data, the large pieces go out as they are.
+  const int sslChunk = 16384;
+  char stage[sslChunk];
+  int staged = 0, totlen = 0, r;
+
+  for (int i = 0; i < iovN; i++) totlen += iov[i].iov_len;
+  if (!totlen) return 0;
+
+  TRACE(REQ, "Sending " << totlen << " bytes in " << iovN << " pieces");
+  if (!ishttps || isktls) {
+    r = Link->Send(iov, iovN, totlen);
+    return (r <= 0 ? -1 : 0);
+  }
+
+  for (int i = 0; i < iovN; i++) {
+    const char *p = (const char *) iov[i].iov_base;
+    int len = iov[i].iov_len;
+
+    while (len > 0) {
+      if (!staged && len >= sslChunk) {
+        r = SSL_write(ssl, p, len);
+        if (r <= 0) {
+          ERR_print_errors(sslbio_err);
+          return -1;
+        }
+        break;
+      }
+
+      int l = min(len, sslChunk - staged);
+      memcpy(stage + staged, p, l);
+      staged += l;
+      p += l;
+      len -= l;
+
+      if (staged == sslChunk) {
+        r = SSL_write(ssl, stage, staged);
+        if (r <= 0) {
+          ERR_print_errors(sslbio_err);
+          return -1;
+        }
+        staged = 0;
+      }
+    }
+  }
+
+  if (staged) {
+    r = SSL_write(ssl, stage, staged);
+    if (r <= 0) {
+      ERR_print_errors(sslbio_err);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
 /******************************************************************************/
 /*                       S t a r t S i m p l e R e s p                        */
 /******************************************************************************/
@@ -1688,6 +1764,11 @@ bool XrdHttpProtocol::InitTLS() {
    uint64_t opts = XrdTlsContext::servr | XrdTlsContext::logVF |
                    XrdTlsContext::artON;
 
+// Kernel TLS offload follows the xrd.tls setting (it's off by default)
+//
+   if (xrdctx && (xrdctx->GetParams()->opts & XrdTlsContext::ktlON))
+      opts |= XrdTlsContext::ktlON;
+
 // Create a new TLS context
 //
    if (sslverifydepth > 255) sslverifydepth = 255;
@@ -1808,6 +1889,7 @@ void XrdHttpProtocol::Reset() {
   SecEntity.tident = XrdHttpSecEntityTident;
   ishttps = false;
   ssldone = false;
+  isktls = false;
 
   Bridge = 0;
   ssl = 0;
@@ -1852,6 +1934,41 @@ int XrdHttpProtocol::xhttpsmode(XrdOucStream & Config) {
   return 0;
 }
 
+/******************************************************************************/
+/*                             x r a n g e g a p                              */
+/******************************************************************************/
+
+/* Function: xrangegap
+
+   Purpose:  To parse the directive: rangegap <size>
+
+             <size>    ranges of a multi-range GET that are at most this many
+                       bytes apart are read as one extent. The default is 4k,
+                       zero only coalesces adjacent ranges.
+
+  Output: 0 upon success or !0 upon failure.
+ */
+
+int XrdHttpProtocol::xrangegap(XrdOucStream & Config) {
+  char *val;
+  long long gap;
+
+  // Get the val
+  //
+  val = Config.GetWord();
+  if (!val || !val[0]) {
+    eDest.Emsg("Config", "rangegap value not specified");
+    return 1;
+  }
+
+  // Record the val
+  //
+  if (XrdOuca2x::a2sz(eDest, "rangegap value", val, &gap, 0, 16*1024*1024))
+    return 1;
+  rangeGap = gap;
+  return 0;
+}
+
 /******************************************************************************/
 /*                   x s s l v e r i f y d e p t h                            */
 /******************************************************************************/
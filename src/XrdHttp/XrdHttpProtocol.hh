@@ -146,6 +146,10 @@ private:
   /// Send some generic data to the client
   int SendData(const char *body, int bodylen);
 
+  /// Send a gathered list of data pieces to the client, with a single writev()
+  /// on plain http and with as few, full TLS records as possible on https
+  int SendData(const struct iovec *iov, int iovN);
+
   /// Deallocate resources, in order to reutilize an object of this class
   void Cleanup();
 
@@ -208,6 +212,7 @@ private:
   static int xheader2cgi(XrdOucStream &Config);
   static int xhttpsmode(XrdOucStream &Config);
   static int xtlsreuse(XrdOucStream &Config);
+  static int xrangegap(XrdOucStream &Config);
   
   static bool isRequiredXtractor; // If true treat secxtractor errors as fatal
   static XrdHttpSecXtractor *secxtractor;
@@ -299,6 +304,10 @@ private:
   /// Flag to tell if the https handshake has finished, in the case of an https
   /// connection being established
   bool ssldone;
+
+  /// Tells that the kernel encrypts what we send (kTLS), so that the link
+  /// can be written directly, sendfile() included
+  bool isktls;
   static XrdCryptoFactory *myCryptoFactory;
 
 protected:
@@ -373,6 +382,9 @@ protected:
   /// Depth of verification of a certificate chain
   static int sslverifydepth;
 
+  /// Ranges of a multi-range GET that are at most this far apart are read together
+  static int rangeGap;
+
   /// True if the redirections must be towards https targets
   static bool isdesthttps;
   
@@ -43,6 +43,7 @@
 #include <cstring>
 #include <arpa/inet.h>
 #include <sstream>
+#include <sys/uio.h>
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdHttpProtocol.hh"
@@ -366,25 +367,16 @@ int XrdHttpReq::parseRWOp(char *str) {
   // This can be largely optimized
   if (ok) {
 
-    kXR_int32 len_ok = 0;
     long long sz = o1.byteend - o1.bytestart + 1;
-    kXR_int32 newlen = sz;
+    long long newlen = sz;
 
     if (filesize > 0)
-      newlen = (kXR_int32) min(filesize - o1.bytestart, sz);
+      newlen = min(filesize - o1.bytestart, sz);
 
     rwOps.push_back(o1);
 
-    while (len_ok < newlen) {
-      ReadWriteOp nfo;
-      int len = min(newlen - len_ok, READV_MAXCHUNKSIZE);
-
-      nfo.bytestart = o1.bytestart + len_ok;
-      nfo.byteend = nfo.bytestart + len - 1;
-      len_ok += len;
-      rwOps_split.push_back(nfo);
-    }
-    length += len_ok;
+    // The reads are chunked up once the file size is known, see ReqReadV()
+    if (newlen > 0) length += newlen;
 
 
   }
@@ -519,27 +511,42 @@ void XrdHttpReq::clientUnMarshallReadAheadList(int nitems) {
 
 int XrdHttpReq::ReqReadV() {
 
+  // The first time around, turn the ranges into the extents to read. Ranges
+  // that follow each other within rangegap bytes are coalesced, the gaps are
+  // dropped again when the response is framed. Then chunk the extents up
+  // respecting the xrootd max sizes
+  if (!rwOpSplitDone && rwOps_split.empty()) {
+    ReadWriteOp ext;
+    bool haveExt = false;
+
+    for (size_t i = 0; i < rwOps.size(); i++) {
+      if (rwOps[i].bytestart > filesize) continue;
+      if (rwOps[i].byteend < rwOps[i].bytestart) continue;
+
+      if (haveExt && (rwOps[i].bytestart > ext.byteend) &&
+          (rwOps[i].bytestart - ext.byteend - 1 <= XrdHttpProtocol::rangeGap)) {
+        ext.byteend = rwOps[i].byteend;
+        continue;
+      }
 
-  kXR_int64 total_len = 0;
-  rwOpPartialDone = 0;
-  // Now we build the protocol-ready read ahead list
-  //  and also put the correct placeholders inside the cache
-  int n = rwOps_split.size();
-  if (!ralist) ralist = (readahead_list *) malloc(n * sizeof (readahead_list));
-
-  int j = 0;
-  for (int i = 0; i < n; i++) {
+      if (haveExt) splitExtent(ext);
+      ext = rwOps[i];
+      haveExt = true;
+    }
+    if (haveExt) splitExtent(ext);
+  }
 
-    // We can suppose that we know the length of the file
-    // Hence we can sort out requests that are out of boundary or trim them
-    if (rwOps_split[i].bytestart > filesize) continue;
-    if (rwOps_split[i].byteend > filesize - 1) rwOps_split[i].byteend = filesize - 1;
+  // Now we build the protocol-ready read ahead list for the next batch of
+  // chunks. Each batch goes out as soon as it is read
+  if (!ralist) ralist = (readahead_list *) malloc(READV_MAXCHUNKS * sizeof (readahead_list));
 
+  int j = 0;
+  while ((rwOpSplitDone < rwOps_split.size()) && (j < READV_MAXCHUNKS)) {
     memcpy(&(ralist[j].fhandle), this->fhandle, 4);
 
-    ralist[j].offset = rwOps_split[i].bytestart;
-    ralist[j].rlen = rwOps_split[i].byteend - rwOps_split[i].bytestart + 1;
-    total_len += ralist[j].rlen;
+    ralist[j].offset = rwOps_split[rwOpSplitDone].bytestart;
+    ralist[j].rlen = rwOps_split[rwOpSplitDone].byteend - rwOps_split[rwOpSplitDone].bytestart + 1;
+    rwOpSplitDone++;
     j++;
   }
 
@@ -560,22 +567,142 @@ int XrdHttpReq::ReqReadV() {
   return (j * sizeof (struct readahead_list));
 }
 
-std::string XrdHttpReq::buildPartialHdr(long long bytestart, long long byteend, long long fsz, char *token) {
-  ostringstream s;
+void XrdHttpReq::splitExtent(const ReadWriteOp &ext) {
+  ReadWriteOp nfo;
+
+  for (long long offs = ext.bytestart; offs <= ext.byteend; offs += READV_MAXCHUNKSIZE) {
+    nfo.bytestart = offs;
+    nfo.byteend = min(offs + READV_MAXCHUNKSIZE - 1, ext.byteend);
+    rwOps_split.push_back(nfo);
+  }
+}
+
+int XrdHttpReq::buildPartialHdr(char *buff, long long bytestart, long long byteend, long long fsz, const char *token) {
+
+  return snprintf(buff, MULTIPART_MAXHDRLEN,
+                  "\r\n--%s\r\n"
+                  "Content-type: text/plain; charset=UTF-8\r\n"
+                  "Content-range: bytes %lld-%lld/%lld\r\n\r\n",
+                  token, bytestart, byteend, fsz);
+}
+
+int XrdHttpReq::buildPartialHdrEnd(char *buff, const char *token) {
+
+  return snprintf(buff, MULTIPART_MAXHDRLEN, "\r\n--%s--\r\n", token);
+}
+
+long long XrdHttpReq::buildParts() {
+
+  // One slot per range and one for the closing boundary, all in one buffer
+  // that is kept across the requests of the connection
+  long long cnt = 0;
+
+  partHdrs.resize((rwOps.size() + 1) * MULTIPART_MAXHDRLEN);
+  partHdrLen.assign(rwOps.size() + 1, 0);
+
+  for (size_t i = 0; i < rwOps.size(); i++) {
+
+    if (rwOps[i].bytestart > filesize) continue;
+    if (rwOps[i].byteend > filesize - 1)
+      rwOps[i].byteend = filesize - 1;
+
+    partHdrLen[i] = buildPartialHdr(&partHdrs[i * MULTIPART_MAXHDRLEN],
+                                    rwOps[i].bytestart,
+                                    rwOps[i].byteend,
+                                    filesize,
+                                    "123456");
+    cnt += (rwOps[i].byteend - rwOps[i].bytestart + 1) + partHdrLen[i];
+  }
+
+  partHdrLen[rwOps.size()] = buildPartialHdrEnd(&partHdrs[rwOps.size() * MULTIPART_MAXHDRLEN], "123456");
+  return cnt + partHdrLen[rwOps.size()];
+}
+
+void XrdHttpReq::skipRanges() {
 
-  s << "\r\n--" << token << "\r\n";
-  s << "Content-type: text/plain; charset=UTF-8\r\n";
-  s << "Content-range: bytes " << bytestart << "-" << byteend << "/" << fsz << "\r\n\r\n";
+  // The response header left these out, see buildParts()
+  while ((rwOpDone < rwOps.size()) && (rwOps[rwOpDone].bytestart > filesize))
+    rwOpDone++;
+}
+
+void XrdHttpReq::framePart(size_t i, std::vector<struct iovec> &iov) {
+  struct iovec v;
 
-  return s.str();
+  v.iov_base = &partHdrs[i * MULTIPART_MAXHDRLEN];
+  v.iov_len = partHdrLen[i];
+  iov.push_back(v);
 }
 
-std::string XrdHttpReq::buildPartialHdrEnd(char *token) {
-  ostringstream s;
+void XrdHttpReq::frameRanges(long long offs, char *data, long long dlen, std::vector<struct iovec> &iov) {
+  struct iovec v;
+  long long fed = offs;
+
+  if (rwOpDone >= rwOps.size()) return;
+  skipRanges();
+  if (rwOpDone == rwOps.size()) {
+    framePart(rwOps.size(), iov);
+    return;
+  }
+
+  while (true) {
+    long long rlen = max(rwOps[rwOpDone].byteend - rwOps[rwOpDone].bytestart + 1, 0LL);
+    long long pos = rwOps[rwOpDone].bytestart + rwOpPartialDone;
+
+    // The data of the current range are not here, they come later. This
+    // includes a range overlapping the previous one, it has its own read
+    if (rlen && ((pos < fed) || (pos >= offs + dlen))) break;
+
+    if (rwOpPartialDone == 0) {
+      TRACEI(REQ, "Sending multipart: " << rwOps[rwOpDone].bytestart << "-" << rwOps[rwOpDone].byteend);
+      framePart(rwOpDone, iov);
+    }
 
-  s << "\r\n--" << token << "--\r\n";
+    // The bytes before pos belong to a gap that was coalesced away
+    if (rlen) {
+      long long n = min(rlen - rwOpPartialDone, offs + dlen - pos);
+      v.iov_base = (data ? data + (pos - offs) : 0);
+      v.iov_len = n;
+      iov.push_back(v);
+      rwOpPartialDone += n;
+      fed = pos + n;
+      if (rwOpPartialDone < rlen) break;
+    }
 
-  return s.str();
+    rwOpDone++;
+    rwOpPartialDone = 0;
+    skipRanges();
+    if (rwOpDone == rwOps.size()) {
+      framePart(rwOps.size(), iov);
+      break;
+    }
+  }
+}
+
+int XrdHttpReq::ReqReadRange() {
+
+  // Empty ranges (they start at the end of the file) only have a part header
+  partIov.clear();
+  frameRanges(0, 0, 0, partIov);
+  if (!partIov.empty() && prot->SendData(partIov.data(), partIov.size())) return -1;
+
+  if (rwOpDone >= rwOps.size()) return 1;
+
+  long long offs = rwOps[rwOpDone].bytestart + rwOpPartialDone;
+  long l = (long) min(rwOps[rwOpDone].byteend + 1 - offs, (long long) READ_MAXCHUNKSIZE);
+
+  // --------- READ
+  memset(&xrdreq, 0, sizeof (xrdreq));
+  xrdreq.read.requestid = htons(kXR_read);
+  memcpy(xrdreq.read.fhandle, fhandle, 4);
+  xrdreq.read.offset = htonll(offs);
+  xrdreq.read.rlen = htonl(l);
+
+  if (!prot->Bridge->Run((char *) &xrdreq, 0, 0)) {
+    prot->SendSimpleResp(404, NULL, NULL, (char *) "Could not run read request.", 0, false);
+    return -1;
+  }
+
+  return 0;
 }
 
 bool XrdHttpReq::Data(XrdXrootd::Bridge::Context &info, //!< the result context
@@ -605,7 +732,20 @@ int XrdHttpReq::File(XrdXrootd::Bridge::Context &info, //!< the result context
         ) {
 
   //prot->SendSimpleResp(200, NULL, NULL, NULL, dlen);
-  int rc = info.Send(0, 0, 0, 0);
+  int rc;
+
+  if ((rwOps.size() > 1) && (ntohs(xrdreq.header.requestid) == kXR_read)) {
+    // A piece of a multi-range response: its framing goes out with the
+    // same sendfile() vector, around the data (the element without a buffer)
+    size_t k = 0;
+
+    partIov.clear();
+    frameRanges(rwOps[rwOpDone].bytestart + rwOpPartialDone, 0, dlen, partIov);
+    while ((k < partIov.size()) && partIov[k].iov_base) k++;
+    if (k >= partIov.size()) return false;
+    rc = info.Send(partIov.data(), k, partIov.data() + k + 1, partIov.size() - k - 1);
+  } else rc = info.Send(0, 0, 0, 0);
+
   TRACE(REQ, " XrdHttpReq::File dlen:" << dlen << " send rc:" << rc);
   if (rc) return false;
   writtenbytes += dlen;
@@ -1254,10 +1394,37 @@ int XrdHttpReq::ProcessHTTPReq() {
         default: // Read() or Close()
         {
 
-          if ( ((reqstate == 3 || (!m_req_digest.empty() && (reqstate == 4))) && (rwOps.size() > 1)) ||
-            (writtenbytes >= length) ) {
+          // Multiple large ranges over plain http (or https encrypted by the
+          // kernel) are read one by one
+          bool rangeByRange = (rwOps.size() > 1) && (!prot->ishttps || prot->isktls) &&
+                              (length >= (long long) rwOps.size() * READ_MINRANGESIZE);
+          bool readsDone;
+          int rc;
+
+          if (rangeByRange) {
+            if ((rc = ReqReadRange()) <= 0) return rc;
+            readsDone = true;
+          } else if (rwOps.size() > 1) {
+            // More than one chunk to read... use readv, a batch of chunks at a time
+            if ((rc = ReqReadV()) > 0) {
+              if (!prot->Bridge->Run((char *) &xrdreq, (char *) ralist, rc)) {
+                prot->SendSimpleResp(404, NULL, NULL, (char *) "Could not run read request.", 0, false);
+                return -1;
+              }
+              return 0;
+            }
 
-            // Close() if this was a readv or we have finished, otherwise read the next chunk
+            // Whatever is left has no data, e.g. the closing boundary
+            partIov.clear();
+            frameRanges(0, 0, 0, partIov);
+            if (!partIov.empty() && prot->SendData(partIov.data(), partIov.size())) return -1;
+            readsDone = true;
+          } else
+            readsDone = (writtenbytes >= length);
+
+          if (readsDone) {
+
+            // Close() if we have finished, otherwise read the next chunk
 
             // --------- CLOSE
 
@@ -1275,7 +1442,7 @@ int XrdHttpReq::ProcessHTTPReq() {
 
           }
 	  
-          if (rwOps.size() <= 1) {
+          {
             // No chunks or one chunk... Request the whole file or single read
 
             long l;
@@ -1288,18 +1455,18 @@ int XrdHttpReq::ProcessHTTPReq() {
             xrdreq.read.dlen = 0;
             
             if (rwOps.size() == 0) {
-              l = (long)min(filesize-writtenbytes, (long long)1024*1024);
+              l = (long)min(filesize-writtenbytes, (long long)READ_MAXCHUNKSIZE);
               offs = writtenbytes;
               xrdreq.read.offset = htonll(writtenbytes);
               xrdreq.read.rlen = htonl(l);
             } else {
-              l = min(rwOps[0].byteend - rwOps[0].bytestart + 1 - writtenbytes, (long long)1024*1024);
+              l = min(rwOps[0].byteend - rwOps[0].bytestart + 1 - writtenbytes, (long long)READ_MAXCHUNKSIZE);
               offs = rwOps[0].bytestart + writtenbytes;
               xrdreq.read.offset = htonll(offs);
               xrdreq.read.rlen = htonl(l);
             }
 
-            if (prot->ishttps) {
+            if (prot->ishttps && !prot->isktls) {
               if (!prot->Bridge->setSF((kXR_char *) fhandle, false)) {
                 TRACE(REQ, " XrdBridge::SetSF(false) failed.");
 
@@ -1331,16 +1498,6 @@ int XrdHttpReq::ProcessHTTPReq() {
               prot->SendSimpleResp(404, NULL, NULL, (char *) "Could not run read request.", 0, false);
               return -1;
             }
-          } else {
-            // More than one chunk to read... use readv
-
-            length = ReqReadV();
-
-            if (!prot->Bridge->Run((char *) &xrdreq, (char *) ralist, length)) {
-              prot->SendSimpleResp(404, NULL, NULL, (char *) "Could not run read request.", 0, false);
-              return -1;
-            }
-
           }
 
           // We want to be invoked again after this request is finished
@@ -2201,21 +2358,7 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
               } else
                 if (rwOps.size() > 1) {
                 // Multiple reads to perform, compose and send the header
-                int cnt = 0;
-                for (size_t i = 0; i < rwOps.size(); i++) {
-
-                  if (rwOps[i].bytestart > filesize) continue;
-                  if (rwOps[i].byteend > filesize - 1)
-                    rwOps[i].byteend = filesize - 1;
-
-                  cnt += (rwOps[i].byteend - rwOps[i].bytestart + 1);
-
-                  cnt += buildPartialHdr(rwOps[i].bytestart,
-                          rwOps[i].byteend,
-                          filesize,
-                          (char *) "123456").size();
-                }
-                cnt += buildPartialHdrEnd((char *) "123456").size();
+                long long cnt = buildParts();
                 std::string header = "Content-Type: multipart/byteranges; boundary=123456";
                 if (!m_digest_header.empty()) {
                   header += "\n";
@@ -2250,9 +2393,6 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
             // Nothing to do if we are postprocessing a close
             if (ntohs(xrdreq.header.requestid) == kXR_close) return keepalive ? 1 : -1;
             
-            // Close() if this was the third state of a readv, otherwise read the next chunk
-            if ((reqstate == 3) && (ntohs(xrdreq.header.requestid) == kXR_readv)) return keepalive ? 1: -1;
-
             // Prevent scenario where data is expected but none is actually read
             // E.g. Accessing files which return the results of a script
             if ((ntohs(xrdreq.header.requestid) == kXR_read) &&
@@ -2267,40 +2407,27 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
 
             TRACEI(REQ, "Got data vectors to send:" << iovN);
             if (ntohs(xrdreq.header.requestid) == kXR_readv) {
-              // Readv case, we must take out each individual header and format it according to the http rules
+              // Readv case, we must take out each individual header and format it according to the http rules.
+              // The data are sent from where they are, interleaved with the part headers, in one go
               readahead_list *l;
               char *p;
+              kXR_int64 offs;
               int len;
 
+              partIov.clear();
+
               // Cycle on all the data that is coming from the server
               for (int i = 0; i < iovN; i++) {
 
                 for (p = (char *) iovP[i].iov_base; p < (char *) iovP[i].iov_base + iovP[i].iov_len;) {
                   l = (readahead_list *) p;
                   len = ntohl(l->rlen);
+                  memcpy(&offs, &(l->offset), sizeof (kXR_int64));
+                  offs = ntohll(offs);
 
-                  // Now we have a chunk coming from the server. This may be a partial chunk
-
-                  if (rwOpPartialDone == 0) {
-                    string s = buildPartialHdr(rwOps[rwOpDone].bytestart,
-                            rwOps[rwOpDone].byteend,
-                            filesize,
-                            (char *) "123456");
-
-                    TRACEI(REQ, "Sending multipart: " << rwOps[rwOpDone].bytestart << "-" << rwOps[rwOpDone].byteend);
-                    if (prot->SendData((char *) s.c_str(), s.size())) return -1;
-                  }
-
-                  // Send all the data we have
-                  if (prot->SendData(p + sizeof (readahead_list), len)) return -1;
-
-                  // If we sent all the data relative to the current original chunk request
-                  // then pass to the next chunk, otherwise wait for more data
-                  rwOpPartialDone += len;
-                  if (rwOpPartialDone >= rwOps[rwOpDone].byteend - rwOps[rwOpDone].bytestart + 1) {
-                    rwOpDone++;
-                    rwOpPartialDone = 0;
-                  }
+                  // Now we have a chunk coming from the server. It may hold
+                  // several ranges, or part of one, and coalesced gaps
+                  frameRanges(offs, p + sizeof (readahead_list), len, partIov);
 
                   p += sizeof (readahead_list);
                   p += len;
@@ -2308,11 +2435,17 @@ int XrdHttpReq::PostProcessHTTPReq(bool final_) {
                 }
               }
 
-              if (rwOpDone == rwOps.size()) {
-                string s = buildPartialHdrEnd((char *) "123456");
-                if (prot->SendData((char *) s.c_str(), s.size())) return -1;
-              }
+              if (prot->SendData(partIov.data(), partIov.size())) return -1;
 
+            } else if (rwOps.size() > 1) {
+              // A piece of a multi-range response read range by range, see ReqReadRange()
+              for (int i = 0; i < iovN; i++) {
+                partIov.clear();
+                frameRanges(rwOps[rwOpDone].bytestart + rwOpPartialDone,
+                            (char *) iovP[i].iov_base, iovP[i].iov_len, partIov);
+                if (prot->SendData(partIov.data(), partIov.size())) return -1;
+                writtenbytes += iovP[i].iov_len;
+              }
             } else
               for (int i = 0; i < iovN; i++) {
                 if (prot->SendData((char *) iovP[i].iov_base, iovP[i].iov_len)) return -1;
@@ -2742,6 +2875,8 @@ void XrdHttpReq::reset() {
   rwOps_split.clear();
   rwOpDone = 0;
   rwOpPartialDone = 0;
+  rwOpSplitDone = 0;
+  partIov.clear();
   writtenbytes = 0;
   etext.clear();
   redirdest = "";
@@ -47,6 +47,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <sys/uio.h>
 
 //#include <libxml/parser.h>
 //#include <libxml/tree.h>
@@ -56,6 +57,19 @@
 #define READV_MAXCHUNKS            512
 #define READV_MAXCHUNKSIZE         (1024*128)
 
+// The largest read issued for a GET. Over plain http a read normally goes out
+// with a single sendfile(), otherwise the data arrive in buffer sized pieces,
+// so this only bounds the number of round trips through the bridge.
+#define READ_MAXCHUNKSIZE          (64*1024*1024)
+
+// Multiple ranges whose average size is at least this are read one at a time
+// over plain http, so that each can go out with sendfile() together with its
+// part header. Smaller ones are better served by a single readv.
+#define READ_MINRANGESIZE          (1024*64)
+
+// Room for the part header of a multipart response
+#define MULTIPART_MAXHDRLEN        160
+
 struct ReadWriteOp {
   // < 0 means "not specified"
   long long bytestart;
@@ -141,15 +155,40 @@ public:
   /// Parse the body of a request, assuming that it's XML and that it's entirely in memory
   int parseBody(char *body, long long len);
 
-  /// Prepare the buffers for sending a readv request
+  /// Prepare the buffers for sending the next readv request of a batch,
+  /// returns the size of the read list, 0 if there is nothing left to read
   int ReqReadV();
   readahead_list *ralist;
 
-  /// Build a partial header for a multipart response
-  std::string buildPartialHdr(long long bytestart, long long byteend, long long filesize, char *token);
+  /// Chunk up an extent to read respecting the xrootd max sizes
+  void splitExtent(const ReadWriteOp &ext);
+
+  /// Build a partial header for a multipart response into buff, which
+  /// must have room for MULTIPART_MAXHDRLEN bytes, returns its length
+  int buildPartialHdr(char *buff, long long bytestart, long long byteend, long long filesize, const char *token);
+
+  /// Build the closing part for a multipart response, as above
+  int buildPartialHdrEnd(char *buff, const char *token);
+
+  /// Build all the part headers of a multipart response at once, returns
+  /// the length of the response body
+  long long buildParts();
+
+  /// Issue the read for the next piece of a multi-range response, see
+  /// READ_MINRANGESIZE. Returns 0 if a read was issued, 1 if all the
+  /// ranges are done, -1 on error
+  int ReqReadRange();
+
+  /// Frame dlen bytes read at offs for a multi-range response: append to iov
+  /// the part headers, the pieces of data that belong to the ranges (data
+  /// may be null for data that are sent otherwise) and the closing boundary
+  void frameRanges(long long offs, char *data, long long dlen, std::vector<struct iovec> &iov);
+
+  /// Append a part header to iov, i == rwOps.size() is the closing boundary
+  void framePart(size_t i, std::vector<struct iovec> &iov);
 
-  /// Build the closing part for a multipart response
-  std::string buildPartialHdrEnd(char *token);
+  /// Skip the ranges that lie past the end of the file
+  void skipRanges();
 
   // Appends the opaque info that we have
   // NOTE: this function assumes that the strings are unquoted, and will quote them
@@ -234,7 +273,15 @@ public:
 
 
   /// To coordinate multipart responses across multiple calls
-  unsigned int rwOpDone, rwOpPartialDone;
+  unsigned int rwOpDone;
+  long long rwOpPartialDone;
+  /// How many entries of rwOps_split have been requested so far
+  size_t rwOpSplitDone;
+  /// The part headers of a multipart response, in MULTIPART_MAXHDRLEN slots
+  std::vector<char> partHdrs;
+  std::vector<int> partHdrLen;
+  /// The data and framing of a multipart response about to be sent
+  std::vector<struct iovec> partIov;
 
   /// The last issued xrd request, often pending
   ClientRequest xrdreq;
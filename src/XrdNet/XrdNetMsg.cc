@@ -112,6 +112,53 @@ int XrdNetMsg::Send(const struct iovec iov[], int iovcnt,
    return Send(buff, (int)(bp-buff), dest, -1);
 }
   
+/******************************************************************************/
+/*                             S e n d B a t c h                              */
+/******************************************************************************/
+
+int XrdNetMsg::SendBatch(const struct iovec msgs[], int mcnt)
+{
+   int done = 0, retc;
+
+   if (!destOK) {eDest->Emsg("Msg", "Destination not specified."); return -1;}
+
+#ifdef __linux__
+   static const int vMax = 64;
+   struct mmsghdr mVec[vMax];
+   int n;
+
+   while(done < mcnt)
+        {n = (mcnt - done < vMax ? mcnt - done : vMax);
+         memset(mVec, 0, sizeof(struct mmsghdr)*n);
+         for (int i = 0; i < n; i++)
+             {mVec[i].msg_hdr.msg_name    = (void *)dfltDest.SockAddr();
+              mVec[i].msg_hdr.msg_namelen = dfltDest.SockSize();
+              mVec[i].msg_hdr.msg_iov     = (struct iovec *)&msgs[done+i];
+              mVec[i].msg_hdr.msg_iovlen  = 1;
+             }
+         do {retc = sendmmsg(FD, mVec, n, 0);}
+            while (retc < 0 && errno == EINTR);
+         if (retc < 0)
+            {retErr(errno, &dfltDest);
+             return (done ? done : -1);
+            }
+         done += retc;
+        }
+#else
+   for (; done < mcnt; done++)
+       {do {retc = sendto(FD, (Sokdata_t)msgs[done].iov_base,
+                          msgs[done].iov_len, 0,
+                          dfltDest.SockAddr(), dfltDest.SockSize());}
+           while (retc < 0 && errno == EINTR);
+        if (retc < 0)
+           {retErr(errno, &dfltDest);
+            return (done ? done : -1);
+           }
+       }
+#endif
+   return done;
+}
+
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
@@ -87,6 +87,20 @@ int           Send(const struct  iovec iov[], // Remaining parms as above
                          int     iovcnt,      // Number of elements in iovec
                    const char   *dest=0,      // Hostname to send UDP datagram
                          int     tmo=-1);     // Timeout in ms (-1 = none)
+
+//------------------------------------------------------------------------------
+//! Send a batch of UDP messages to the endpoint specified in the constructor.
+//! Where available, sendmmsg() is used so that the batch costs one system call.
+//!
+//! @param  msgs     The vector of messages, each element being one datagram.
+//! @param  mcnt     The number of elements in msgs.
+//!
+//! @return <0       No message sent due to error.
+//! @return >=0      The number of messages sent (well as defined by UDP). If
+//!                  less than mcnt, an error occurred for the next message.
+//------------------------------------------------------------------------------
+
+int           SendBatch(const struct iovec msgs[], int mcnt);
 //------------------------------------------------------------------------------
 //! Constructor
 //!
@@ -818,12 +818,18 @@ int XrdOfs::ConfigXeq(char *var, XrdOucStream &Config,
   
 /* Function: xcrds
 
-   Purpose:  To parse the directive: cksrdsz <size>
+   Purpose:  To parse the directive: cksrdsz <size> [parallel <n>]
 
              <size>  number of bytes to segment reads when calclulating a
                      checksum. Can be suffixed by k,m,g. Maximum is 1g and
                      is automatically set to be atleast 64k and to be a
                      multiple of 64k.
+             <n>     the maximum number of threads used to calculate the
+                     checksum of a file spanning more than one segment. This
+                     only applies to the default checksum manager and to
+                     algorithms that can combine checksums (e.g. adler32,
+                     crc32, crc32c). The n-1 helper threads are shared by all
+                     checksum requests. The default is 1.
 
   Output: 0 upon success or !0 upon failure.
 */
@@ -833,6 +839,7 @@ int XrdOfs::xcrds(XrdOucStream &Config, XrdSysError &Eroute)
    static const long long maxRds = 1024*1024*1024;
    char *val;
    long long rdsz;
+   int cpar = 0;
 
 // Get the size
 //
@@ -842,7 +849,20 @@ int XrdOfs::xcrds(XrdOucStream &Config, XrdSysError &Eroute)
 // Now convert it
 //
    if (XrdOuca2x::a2sz(Eroute, "cksrdsz size", val, &rdsz, 1, maxRds)) return 1;
-   ofsConfig->SetCksRdSz(static_cast<int>(rdsz));
+
+// Get the optional parallel setting
+//
+   if ((val = Config.GetWord()) && val[0])
+      {if (strcmp(val, "parallel"))
+          {Eroute.Emsg("Config", "invalid cksrdsz option -", val); return 1;}
+       if (!(val = Config.GetWord()) || !val[0])
+          {Eroute.Emsg("Config", "cksrdsz parallel value not specified");
+           return 1;
+          }
+       if (XrdOuca2x::a2i(Eroute, "cksrdsz parallel", val, &cpar, 1, 64))
+          return 1;
+      }
+   ofsConfig->SetCksRdSz(static_cast<int>(rdsz), cpar);
    return 0;
 }
   
@@ -224,9 +224,10 @@ bool   Push(TheLib what, const char *plugP, const char *parmP=0);
 //! Set the checksum read size
 //!
 //! @param   rdsz    The chesum read size buffer.
+//! @param   cpar    The maximum number of threads used to checksum a file.
 //-----------------------------------------------------------------------------
 
-void   SetCksRdSz(int rdsz);
+void   SetCksRdSz(int rdsz, int cpar=0);
 
 //-----------------------------------------------------------------------------
 //! Destructor
@@ -310,6 +311,7 @@ std::vector<ctlLP> ctlVec;
 
 char         *CksAlg;
 int           CksRdsz;
+int           CksPar;
 bool          pushOK[maxXXXLib];
 bool          defLib[maxXXXLib];
 bool          ossXAttr;
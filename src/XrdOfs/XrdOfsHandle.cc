@@ -244,11 +244,8 @@ extern XrdOfsStats OfsStats;
 /*                        S t a t i c   O b j e c t s                         */
 /******************************************************************************/
   
-XrdSysMutex   XrdOfsHandle::myMutex;
-XrdOfsHanTab  XrdOfsHandle::roTable;
-XrdOfsHanTab  XrdOfsHandle::rwTable;
-XrdOssDF     *XrdOfsHandle::ossDF = (XrdOssDF *)new XrdOfsHanOss;
-XrdOfsHandle *XrdOfsHandle::Free = 0;
+XrdOfsHanShard XrdOfsHandle::hShard[1 << XrdOfsHandle::hsBits];
+XrdOssDF      *XrdOfsHandle::ossDF = (XrdOssDF *)new XrdOfsHanOss;
 
 /******************************************************************************/
 /*                    c l a s s   X r d O f s H a n d l e                     */
@@ -259,34 +256,36 @@ XrdOfsHandle *XrdOfsHandle::Free = 0;
   
 int XrdOfsHandle::Alloc(const char *thePath, int Opts, XrdOfsHandle **Handle)
 {
-   XrdOfsHandle *hP;
-   XrdOfsHanTab *theTable = (Opts & opRW ? &rwTable : &roTable);
-   XrdOfsHanKey theKey(thePath, (int)strlen(thePath));
-   int          retc;
-
-// Lock the search table and try to find the key. If found, increment the
-// the link count (can only be done with the global lock) then release the
+   XrdOfsHandle   *hP;
+   XrdOfsHanKey    theKey(thePath, (int)strlen(thePath));
+   XrdOfsHanShard &hS = Shard(theKey.Hash);
+   XrdOfsHanTab   *theTable = (Opts & opRW ? &hS.rwTable : &hS.roTable);
+   int             retc, numLeft;
+
+// Lock the shard and try to find the key. If found, increment the link count
+// (a handle can only gain a link with the shard lock held) then release the
 // lock and try to lock the handle. It can't escape between lock calls because
 // the link count is positive. If we can't lock the handle then it must be the
 // that a long running operation is occuring. Return the handle to its former
-// state and return a delay. Otherwise, return the handle.
+// state and return a delay. Otherwise, return the handle. Should our link be
+// the last one we must fully retire the handle as the holder has let it go.
 //
-   myMutex.Lock();
+   hS.Lock();
    if ((hP = theTable->Find(theKey)))
-      {hP->Path.Links++; myMutex.UnLock();
+      {hP->Path.Links++; hS.UnLock();
        if (hP->WaitLock()) {*Handle = hP; return 0;}
-       myMutex.Lock(); hP->Path.Links--; myMutex.UnLock();
+       if (!hP->DropLink(numLeft)) {hP->Lock(); hP->Retire(retc);}
        return nolokDelay;
       }
 
 // Get a new handle
 //
-   if (!(retc = Alloc(theKey, Opts, Handle))) theTable->Add(*Handle);
-   OfsStats.Add(OfsStats.Data.numHandles);
+   if (!(retc = Alloc(hS, theKey, Opts, Handle))) theTable->Add(*Handle);
 
 // All done
 //
-   myMutex.UnLock();
+   hS.UnLock();
+   OfsStats.Add(OfsStats.Data.numHandles);
    return retc;
 }
 
@@ -297,12 +296,13 @@ int XrdOfsHandle::Alloc(const char *thePath, int Opts, XrdOfsHandle **Handle)
 int XrdOfsHandle::Alloc(XrdOfsHandle **Handle)
 {
     XrdOfsHanKey myKey("dummy", 5);
+    XrdOfsHanShard &hS = Shard(myKey.Hash);
     int retc;
 
-    myMutex.Lock();
-    if (!(retc = Alloc(myKey, 0, Handle))) 
+    hS.Lock();
+    if (!(retc = Alloc(hS, myKey, 0, Handle)))
        {(*Handle)->Path.Links = 0; (*Handle)->UnLock();}
-    myMutex.UnLock();
+    hS.UnLock();
     return retc;
 }
 
@@ -310,16 +310,19 @@ int XrdOfsHandle::Alloc(XrdOfsHandle **Handle)
 /* private                      A l l o c   # 3                               */
 /******************************************************************************/
   
-int XrdOfsHandle::Alloc(XrdOfsHanKey theKey, int Opts, XrdOfsHandle **Handle)
+// The shard must be locked upon entry.
+
+int XrdOfsHandle::Alloc(XrdOfsHanShard &hS, XrdOfsHanKey &theKey,
+                        int Opts, XrdOfsHandle **Handle)
 {
    static const int minAlloc = 4096/sizeof(XrdOfsHandle);
    XrdOfsHandle *hP;
 
-// No handle currently in the table. Get a new one off the free list
+// No handle currently in the table. Get a new one off the shard's free list
 //
-   if (!Free && (hP = new XrdOfsHandle[minAlloc]))
-      {int i = minAlloc; while(i--) {hP->Next = Free; Free = hP; hP++;}}
-   if ((hP = Free)) Free = hP->Next;
+   if (!hS.Free && (hP = new XrdOfsHandle[minAlloc]))
+      {int i = minAlloc; while(i--) {hP->Next = hS.Free; hS.Free = hP; hP++;}}
+   if ((hP = hS.Free)) hS.Free = hP->Next;
 
 // Initialize the new handle, if we have one, and add it to the table
 //
@@ -345,16 +348,17 @@ int XrdOfsHandle::Alloc(XrdOfsHanKey theKey, int Opts, XrdOfsHandle **Handle)
 
 void XrdOfsHandle::Hide(const char *thePath)
 {
-   XrdOfsHandle *hP;
-   XrdOfsHanKey theKey(thePath, (int)strlen(thePath));
+   XrdOfsHandle   *hP;
+   XrdOfsHanKey    theKey(thePath, (int)strlen(thePath));
+   XrdOfsHanShard &hS = Shard(theKey.Hash);
 
-// Lock the search table and try to find the key in each table. If found,
-// clear the length field to effectively hide the item.
+// Lock the shard and try to find the key in each table. If found, clear the
+// length field to effectively hide the item.
 //
-   myMutex.Lock();
-   if ((hP = roTable.Find(theKey))) hP->Path.Len = 0;
-   if ((hP = rwTable.Find(theKey))) hP->Path.Len = 0;
-   myMutex.UnLock();
+   hS.Lock();
+   if ((hP = hS.roTable.Find(theKey))) hP->Path.Len = 0;
+   if ((hP = hS.rwTable.Find(theKey))) hP->Path.Len = 0;
+   hS.UnLock();
 }
 
 /******************************************************************************/
@@ -366,14 +370,17 @@ void XrdOfsHandle::Hide(const char *thePath)
 int XrdOfsHandle::PoscGet(short &Mode, int Done)
 {
    XrdOfsHanPsc *pP;
-   int pnum;
+   int pnum, numLeft;
 
+// Note that when an xpr object exists it holds a link in addition to the
+// caller's so dropping it can never drop the last link.
+//
    if (Posc)
       {pnum = Posc->Unum;
        Mode = Posc->Mode;
        if (Done)
           {pP = Posc; Posc = 0;
-           if (pP->xprP) {myMutex.Lock(); Path.Links--; myMutex.UnLock();}
+           if (pP->xprP) DropLink(numLeft);
            pP->Recycle();
           }
        return pnum;
@@ -457,30 +464,40 @@ const char *XrdOfsHandle::PoscUsr()
 
 int XrdOfsHandle::Retire(int &retc, long long *retsz, char *buff, int blen)
 {
+   XrdOfsHanShard &hS = Shard(Path.Hash);
    XrdOssDF *mySSI;
+   unsigned int numLinks;
    int numLeft;
 
-// Get the global lock as the links field can only be manipulated with it.
-// Decrement the links count and if zero, remove it from the table and
-// place it on the free list. Otherwise, it is still in use.
+// If ours is not the last link we can simply drop it without the shard lock.
 //
    retc = 0;
-   myMutex.Lock();
-   if (Path.Links == 1)
+   if (DropLink(numLeft)) {UnLock(); return numLeft;}
+
+// We may hold the last link. Get the shard lock as a handle can only gain a
+// link while it is held. If the count is still one, remove the handle from
+// the table and place it on the free list. Otherwise, it is still in use.
+//
+   hS.Lock();
+   do {numLinks = Path.Links;
+       if (numLinks == 1) break;
+      } while(!Path.Links.compare_exchange_weak(numLinks, numLinks-1));
+
+   if (numLinks == 1)
       {if (buff) strlcpy(buff, Path.Val, blen);
        numLeft = 0; OfsStats.Dec(OfsStats.Data.numHandles);
-       if ( (isRW ? rwTable.Remove(this) : roTable.Remove(this)) )
+       if ( (isRW ? hS.rwTable.Remove(this) : hS.roTable.Remove(this)) )
          {if (Posc) {Posc->Recycle(); Posc = 0;}
           if (Path.Val) {free((void *)Path.Val); Path.Val = (char *)"";}
           Path.Len = 0; mySSI = ssi; ssi = ossDF;
-          Next = Free; Free = this; UnLock(); myMutex.UnLock();
+          Next = hS.Free; hS.Free = this; UnLock(); hS.UnLock();
           if (mySSI && mySSI != ossDF)
              {retc = mySSI->Close(retsz); delete mySSI;}
          } else {
-          UnLock(); myMutex.UnLock();
+          UnLock(); hS.UnLock();
           OfsEroute.Emsg("Retire", "Lost handle to", buff);
         }
-      } else {numLeft = --Path.Links; UnLock(); myMutex.UnLock();}
+      } else {numLeft = numLinks-1; UnLock(); hS.UnLock();}
    return numLeft;
 }
 
@@ -489,20 +506,20 @@ int XrdOfsHandle::Retire(int &retc, long long *retsz, char *buff, int blen)
 int XrdOfsHandle::Retire(XrdOfsHanCB *cbP, int hTime)
 {
    static int allOK = StartXpr(1);
+   XrdOfsHanShard &hS = Shard(Path.Hash);
    XrdOfsHanXpr *xP;
    int retc;
 
 // The handle can only be held by one reference and only if it's a POSC and
 // deferred handling was properly set up.
 //
-   myMutex.Lock();
    if (!Posc || !allOK)
       {OfsEroute.Emsg("Retire", "ignoring deferred retire of", Path.Val);
-       if (Path.Links != 1 || !Posc || !cbP) myMutex.UnLock();
-          else {myMutex.UnLock(); cbP->Retired(this);}
+       hS.Lock();
+       if (Path.Links != 1 || !Posc || !cbP) hS.UnLock();
+          else {hS.UnLock(); cbP->Retired(this);}
        return Retire(retc);
       }
-   myMutex.UnLock();
 
 // If this object already has an xpr object (happens for bouncing connections)
 // then reuse that object. Otherwise create a new one and put it on the queue.
@@ -554,16 +571,18 @@ do{xP = XrdOfsHanXpr::Get(); hP = xP->Handle;
             hP->UnLock(); delete xP; continue;
            }
 
-// As the handle is locked we can get the global handle lock to prevent
-// additions and removals of handles as we need a stable reference count to
-// effect the callout, if any. Do so only if the reference count is one (for us)
-// and the handle is active. In all cases, drop the global lock.
+// As the handle is locked we can get the shard lock to prevent additions and
+// removals of handles as we need a stable reference count to effect the
+// callout, if any. Do so only if the reference count is one (for us) and the
+// handle is active. In all cases, drop the shard lock.
 //
-   myMutex.Lock();
-   if (hP->Path.Links != 1 || !xP->Call) myMutex.UnLock();
-      else {myMutex.UnLock();
+  {XrdOfsHanShard &hS = Shard(hP->Path.Hash);
+   hS.Lock();
+   if (hP->Path.Links != 1 || !xP->Call) hS.UnLock();
+      else {hS.UnLock();
             xP->Call->Retired(hP);
            }
+  }
 
 // We can now officially retire the handle and delete the xpr object
 //
@@ -576,6 +595,25 @@ do{xP = XrdOfsHanXpr::Get(); hP = xP->Handle;
    return 0;
 }
 
+/******************************************************************************/
+/* private                      D r o p L i n k                               */
+/******************************************************************************/
+
+// Drop a link without the shard lock unless it's the last one. This is safe
+// because a handle can only gain a link with the shard lock held and going
+// from one to zero links is always done with the shard lock held.
+
+bool XrdOfsHandle::DropLink(int &numLeft)
+{
+   unsigned int numLinks = Path.Links;
+
+   do {if (numLinks <= 1) return false;
+      } while(!Path.Links.compare_exchange_weak(numLinks, numLinks-1));
+
+   numLeft = numLinks-1;
+   return true;
+}
+
 /******************************************************************************/
 /* public:                      S u p p r e s s                               */
 /******************************************************************************/
@@ -641,6 +679,24 @@ void XrdOfsHanPsc::Recycle()
    pscMutex.UnLock();
 }
 
+/******************************************************************************/
+/*                  C l a s s   X r d O f s H a n S h a r d                   */
+/******************************************************************************/
+/******************************************************************************/
+/* public                           L o c k                                   */
+/******************************************************************************/
+
+void XrdOfsHanShard::Lock()
+{
+// Record whether or not we had to wait for the lock as this tells us how
+// well the handles are distributed across the shards.
+//
+   if (!hsMutex.CondLock())
+      {OfsStats.Add(OfsStats.Data.numHanCon);
+       hsMutex.Lock();
+      }
+}
+
 /******************************************************************************/
 /*                    C l a s s   X r d O f s H a n T a b                     */
 /******************************************************************************/
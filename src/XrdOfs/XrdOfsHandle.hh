@@ -38,6 +38,7 @@
 
 #include "XrdOuc/XrdOucCRC.hh"
 #include "XrdSys/XrdSysPthread.hh"
+#include "XrdSys/XrdSysRAtomic.hh"
 
 /******************************************************************************/
 /*                    C l a s s   X r d O f s H a n K e y                     */
@@ -48,7 +49,7 @@ class XrdOfsHanKey
 public:
 
 const char          *Val;
-unsigned int         Links;
+RAtomic_uint         Links;
 unsigned int         Hash;
 short                Len;
 
@@ -74,7 +75,9 @@ inline int           operator!=(const XrdOfsHanKey &oth)
                           XrdOucCRC::CRC32((const unsigned char *)key,kln) : 0);
                     }
 
-		    XrdOfsHanKey(const XrdOfsHanKey&) = default;
+                    XrdOfsHanKey(const XrdOfsHanKey &rhs)
+                                : Val(rhs.Val), Links(0), Hash(rhs.Hash),
+                                  Len(rhs.Len) {}
 
                    ~XrdOfsHanKey() {};
 };
@@ -114,6 +117,34 @@ int              nashnum;
 int              Threshold;
 };
 
+/******************************************************************************/
+/*                  C l a s s   X r d O f s H a n S h a r d                   */
+/******************************************************************************/
+
+// Handles are hash-partitioned into shards to reduce lock contention. Each
+// shard has its own lock, its own r/o and r/w tables (which expand on their
+// own), and its own free list. A handle's shard is fixed by its path hash.
+//
+class XrdOfsHanShard
+{
+public:
+
+XrdOfsHanTab   roTable;    // File handles open r/o
+XrdOfsHanTab   rwTable;    // File Handles open r/w
+XrdOfsHandle  *Free;       // List of free handles
+
+void           Lock();
+void           UnLock() {hsMutex.UnLock();}
+
+               XrdOfsHanShard() : roTable(89, 144), rwTable(89, 144),
+                                  Free(0) {}
+              ~XrdOfsHanShard() {} // Never gets deleted
+
+private:
+
+XrdSysMutex    hsMutex;
+};
+
 /******************************************************************************/
 /*                    C l a s s   X r d O f s H a n d l e                     */
 /******************************************************************************/
@@ -174,7 +205,12 @@ inline       void   UnLock() {hMutex.UnLock();}
          ~XrdOfsHandle() {int retc; Retire(retc);}
 
 private:
-static int           Alloc(XrdOfsHanKey, int Opts, XrdOfsHandle **Handle);
+static int           Alloc(XrdOfsHanShard &hS, XrdOfsHanKey &theKey,
+                           int Opts, XrdOfsHandle **Handle);
+       bool          DropLink(int &numLeft);
+static
+inline XrdOfsHanShard &Shard(unsigned int hash)
+                            {return hShard[hash >> (32 - hsBits)];}
        int           WaitLock(void);
 
 static const int     LockTries =   3; // Times to try for a lock
@@ -182,11 +218,10 @@ static const int     LockWait  = 333; // Mills to wait between tries
 static const int     nolokDelay=   3; // Secs to delay client when lock failed
 static const int     nomemDelay=  15; // Secs to delay client when ENOMEM
 
-static XrdSysMutex   myMutex;
-static XrdOfsHanTab  roTable;    // File handles open r/o
-static XrdOfsHanTab  rwTable;    // File Handles open r/w
+static const int     hsBits    =   5; // log2 of the number of shards
+
+static XrdOfsHanShard hShard[1 << hsBits];
 static XrdOssDF     *ossDF;      // Dummy storage sysem
-static XrdOfsHandle *Free;       // List of free handles
 
        XrdSysMutex   hMutex;
        XrdOssDF     *ssi;        // Storage System Interface
@@ -44,6 +44,7 @@ int         numOpenW;   // Write
 int         numOpenP;   // Posc
 int         numUnpsist; // Posc
 int         numHandles;
+int         numHanCon;  // Handle shard lock contentions
 int         numRedirect;
 int         numStarted;
 int         numReplies;
@@ -45,6 +45,7 @@
 
 #include "XrdOss/XrdOssApi.hh"
 #include "XrdOss/XrdOssTrace.hh"
+#include "XrdOss/XrdOssUring.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdSys/XrdSysPthread.hh"
@@ -101,10 +102,18 @@ const int OSS_AIO_WRITE_DONE = SIGRTMAX;
 
 int XrdOssFile::Fsync(XrdSfsAio *aiop)
 {
-
-#ifdef _POSIX_ASYNCHRONOUS_IO
    int rc;
 
+// If io_uring is being used, queue the request there. When the ring is full
+// we simply do the request synchronously.
+//
+   if (XrdOssSys::AioMode == XrdOssSys::aioUring)
+      {aiop->TIdent = tident;
+       if ((rc = XrdOssUring::Submit(XrdOssUring::opSync, fd, aiop)) <= 0)
+          return rc;
+      }
+
+#ifdef _POSIX_ASYNCHRONOUS_IO
 // Complete the aio request block and do the operation
 //
    if (XrdOssSys::AioAllOk)
@@ -153,11 +162,22 @@ int XrdOssFile::Fsync(XrdSfsAio *aiop)
   
 int XrdOssFile::Read(XrdSfsAio *aiop)
 {
-
-#ifdef _POSIX_ASYNCHRONOUS_IO
    EPNAME("AioRead");
    int rc;
 
+// If io_uring is being used, queue the request there. When the ring is full
+// we simply do the request synchronously.
+//
+   if (XrdOssSys::AioMode == XrdOssSys::aioUring)
+      {aiop->TIdent = tident;
+       TRACE(Debug,  "fd=" <<fd <<" uring read " <<aiop->sfsAio.aio_nbytes
+                           <<'@' <<aiop->sfsAio.aio_offset <<" aiocb="
+                           <<Xrd::hex1 <<aiop);
+       if ((rc = XrdOssUring::Submit(XrdOssUring::opRead, fd, aiop)) <= 0)
+          return rc;
+      }
+
+#ifdef _POSIX_ASYNCHRONOUS_IO
 // Complete the aio request block and do the operation
 //
    if (XrdOssSys::AioAllOk)
@@ -211,10 +231,22 @@ int XrdOssFile::Read(XrdSfsAio *aiop)
   
 int XrdOssFile::Write(XrdSfsAio *aiop)
 {
-#ifdef _POSIX_ASYNCHRONOUS_IO
    EPNAME("AioWrite");
    int rc;
 
+// If io_uring is being used, queue the request there. When the ring is full
+// we simply do the request synchronously.
+//
+   if (XrdOssSys::AioMode == XrdOssSys::aioUring)
+      {aiop->TIdent = tident;
+       TRACE(Debug, "fd=" <<fd <<" uring write " <<aiop->sfsAio.aio_nbytes
+                          <<'@' <<aiop->sfsAio.aio_offset <<" aiocb="
+                          <<Xrd::hex1 <<aiop);
+       if ((rc = XrdOssUring::Submit(XrdOssUring::opWrite, fd, aiop)) <= 0)
+          return rc;
+      }
+
+#ifdef _POSIX_ASYNCHRONOUS_IO
 // Complete the aio request block and do the operation
 //
    if (XrdOssSys::AioAllOk)
@@ -259,6 +291,7 @@ int XrdOssFile::Write(XrdSfsAio *aiop)
 /******************************************************************************/
 
 int   XrdOssSys::AioAllOk = 0;
+char  XrdOssSys::AioMode  = XrdOssSys::aioPosix;
   
 #if defined(_POSIX_ASYNCHRONOUS_IO) && !defined(HAVE_SIGWTI)
 // The folowing is for sigwaitinfo() emulation
@@ -280,6 +313,16 @@ extern "C" {extern void XrdOssAioWSH(int, siginfo_t *, void *);}
 
 int XrdOssSys::AioInit()
 {
+// If async I/O has been turned off there is nothing to do. If io_uring was
+// selected, try to start it and fall back to POSIX aio should that fail.
+//
+   if (AioMode == aioOff) return 1;
+   if (AioMode == aioUring)
+      {if (XrdOssUring::Init(OssEroute)) return 1;
+       OssEroute.Say("Config warning: falling back to posix aio.");
+       AioMode = aioPosix;
+      }
+
 #if defined(_POSIX_ASYNCHRONOUS_IO)
    EPNAME("AioInit");
    extern void *XrdOssAioWait(void *carg);
@@ -33,6 +33,7 @@
   
 #include <unistd.h>
 #include <cerrno>
+#include <climits>
 #include <fcntl.h>
 #include <signal.h>
 #include <strings.h>
@@ -41,6 +42,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/param.h>
+#include <sys/uio.h>
 #ifdef __solaris__
 #include <sys/vnode.h>
 #endif
@@ -53,7 +55,9 @@
 #include "XrdOss/XrdOssConfig.hh"
 #include "XrdOss/XrdOssError.hh"
 #include "XrdOss/XrdOssMio.hh"
+#include "XrdOss/XrdOssReadV.hh"
 #include "XrdOss/XrdOssTrace.hh"
+#include "XrdOss/XrdOssUring.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucName2Name.hh"
 #include "XrdOuc/XrdOucPinLoader.hh"
@@ -394,7 +398,8 @@ int XrdOssSys::Stats(char *buff, int blen)
 
 // If only size wanted, return what size we need
 //
-   if (!buff) return statflen + getStats(0,0);
+   if (!buff) return statflen + getStats(0,0) + XrdOssUring::Stats(0,0)
+                              + XrdOssReadV::Stats(0,0);
 
 // Make sure we have enough space
 //
@@ -407,6 +412,16 @@ int XrdOssSys::Stats(char *buff, int blen)
    n = getStats(bp, blen);
    bp += n; blen -= n;
 
+// Generate async I/O statistics (only present when io_uring is in use)
+//
+   n = XrdOssUring::Stats(bp, blen);
+   bp += n; blen -= n;
+
+// Generate vector read statistics (only present when the engine is in use)
+//
+   n = XrdOssReadV::Stats(bp, blen);
+   bp += n; blen -= n;
+
 // Add trailer
 //
    if (blen >= (int)sizeof(statfmt2))
@@ -903,6 +918,11 @@ ssize_t XrdOssFile::ReadV(XrdOucIOVec *readV, int n)
    ssize_t rdsz, totBytes = 0;
    int i;
 
+// Use the vector read engine when it is enabled. It merges nearby elements
+// and reads the resulting extents in parallel.
+//
+   if (XrdOssReadV::isOn() && n > 1) return XrdOssReadV::Read(fd, readV, n);
+
 // For platforms that support fadvise, pre-advise what we will be reading
 //
 #if (defined(__linux__) || (defined(__FreeBSD_kernel__) && defined(__GLIBC__))) && defined(HAVE_ATOMICS)
@@ -1026,6 +1046,77 @@ ssize_t XrdOssFile::Write(const void *buff, off_t offset, size_t blen)
      return retval;
 }
 
+/******************************************************************************/
+/*                                W r i t e V                                 */
+/******************************************************************************/
+
+/*
+  Function: Perform all the writes specified in the writeV vector.
+
+  Input:    writeV    - A description of the writes to perform; includes the
+                        absolute offset, the size of the write, and the buffer
+                        holding the data.
+            n         - The size of the writeV vector.
+
+  Output:   Returns the number of bytes written upon success and -errno o/w.
+            If the number of bytes written is less than requested, it is
+            considered an error.
+
+  Notes:    Elements that are adjacent in the file are written using a single
+            pwritev() call. This is most effective when the caller orders the
+            vector by offset.
+*/
+
+ssize_t XrdOssFile::WriteV(XrdOucIOVec *writeV, int n)
+{
+#if defined(IOV_MAX) && IOV_MAX < 1024
+   static const int maxIOV = IOV_MAX;
+#else
+   static const int maxIOV = 1024;
+#endif
+   struct iovec iov[maxIOV];
+   ssize_t retval, totBytes = 0;
+   long long wrOff, wrLen;
+   int i = 0, k, iovNum;
+
+   if (fd < 0) return (ssize_t)-XRDOSS_E8004;
+
+// Process each run of adjacent elements
+//
+   while(i < n)
+        {wrOff = writeV[i].offset; wrLen = 0; iovNum = 0;
+         do {iov[iovNum].iov_base = writeV[i].data;
+             iov[iovNum].iov_len  = writeV[i].size;
+             wrLen += writeV[i].size; iovNum++; i++;
+            } while(i < n && iovNum < maxIOV
+                    &&  writeV[i].offset == wrOff + wrLen);
+
+         if (XrdOssSS->MaxSize && wrOff + wrLen > XrdOssSS->MaxSize)
+            return (ssize_t)-XRDOSS_E8007;
+
+         // Write out the run. Should the write be short, we skip over what was
+         // written and try again with the remaining elements.
+         //
+         k = 0;
+         while(wrLen)
+              {do {retval = pwritev(fd, iov+k, iovNum-k, wrOff);}
+                  while(retval < 0 && errno == EINTR);
+               if (retval <= 0) return (retval < 0 ? -errno : -ESPIPE);
+               totBytes += retval; wrOff += retval; wrLen -= retval;
+               while(k < iovNum && (size_t)retval >= iov[k].iov_len)
+                    {retval -= iov[k].iov_len; k++;}
+               if (retval)
+                  {iov[k].iov_base = (char *)iov[k].iov_base + retval;
+                   iov[k].iov_len -= retval;
+                  }
+              }
+        }
+
+// All done
+//
+   return totBytes;
+}
+
 /******************************************************************************/
 /*                                F c h m o d                                 */
 /******************************************************************************/
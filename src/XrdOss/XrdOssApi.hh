@@ -112,6 +112,7 @@ ssize_t ReadV(XrdOucIOVec *readV, int);
 ssize_t ReadRaw(    void *, off_t, size_t);
 ssize_t Write(const void *, off_t, size_t);
 int     Write(XrdSfsAio *aiop);
+ssize_t WriteV(XrdOucIOVec *writeV, int);
  
         // Constructor and destructor
         XrdOssFile(const char *tid, int fdnum=-1)
@@ -163,7 +164,7 @@ int       Configure(const char *, XrdSysError &, XrdOucEnv *envP);
 void      Config_Display(XrdSysError &);
 virtual
 int       Create(const char *, const char *, mode_t, XrdOucEnv &, int opts=0);
-uint64_t  Features() {return XRDOSS_HASNAIO;} // Turn async I/O off for disk
+uint64_t  Features() {return (AioMode == aioUring ? 0 : XRDOSS_HASNAIO);}
 int       GenLocalPath(const char *, char *);
 int       GenRemotePath(const char *, char *);
 int       Init(XrdSysLogger *, const char *, XrdOucEnv *envP);
@@ -199,6 +200,11 @@ int       Stats(char *bp, int bl);
 
 static int   AioInit();
 static int   AioAllOk;
+static char  AioMode;           // Async I/O engine in use (see below)
+
+static const char aioOff   = 0; // All I/O is done synchronously
+static const char aioPosix = 1; // POSIX aio (disabled for disk by Features())
+static const char aioUring = 2; // io_uring engine
 
 static char  tryMmap;           // Memory mapped files enabled
 static char  chkMmap;           // Memory mapped files are selective
@@ -346,6 +352,7 @@ void   ConfigStats(XrdSysError &Eroute);
 void   ConfigStats(dev_t Devnum, char *lP);
 int    ConfigXeq(char *, XrdOucStream &, XrdSysError &);
 void   List_Path(const char *, const char *, unsigned long long, XrdSysError &);
+int    xaio(XrdOucStream &Config, XrdSysError &Eroute);
 int    xalloc(XrdOucStream &Config, XrdSysError &Eroute);
 int    xcache(XrdOucStream &Config, XrdSysError &Eroute);
 int    xcachescan(XrdOucStream &Config, XrdSysError &Eroute);
@@ -356,6 +363,7 @@ int    xmemf(XrdOucStream &Config, XrdSysError &Eroute);
 int    xnml(XrdOucStream &Config, XrdSysError &Eroute);
 int    xpath(XrdOucStream &Config, XrdSysError &Eroute);
 int    xprerd(XrdOucStream &Config, XrdSysError &Eroute);
+int    xreadv(XrdOucStream &Config, XrdSysError &Eroute);
 int    xspace(XrdOucStream &Config, XrdSysError &Eroute, int *isCD=0);
 int    xspace(XrdOucStream &Config, XrdSysError &Eroute,
               const char *grp, bool isAsgn);
@@ -53,6 +53,8 @@
 #include "XrdOss/XrdOssOpaque.hh"
 #include "XrdOss/XrdOssSpace.hh"
 #include "XrdOss/XrdOssTrace.hh"
+#include "XrdOss/XrdOssReadV.hh"
+#include "XrdOss/XrdOssUring.hh"
 #include "XrdOuc/XrdOuca2x.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdSys/XrdSysError.hh"
@@ -322,6 +324,10 @@ int XrdOssSys::Configure(const char *configfn, XrdSysError &Eroute,
 //
    if (!NoGo) NoGo = !AioInit();
 
+// Configure the vector read engine
+//
+   if (!NoGo) NoGo = !XrdOssReadV::Init(Eroute);
+
 // Initialize memory mapping setting to speed execution
 //
    if (!NoGo) ConfigMio(Eroute);
@@ -442,6 +448,11 @@ void XrdOssSys::Config_Display(XrdSysError &Eroute)
 
      XrdOssMio::Display(Eroute);
 
+     if (AioMode == aioUring) XrdOssUring::Display(Eroute);
+        else Eroute.Say("       oss.aio ", (AioMode == aioOff ? "off" : "posix"));
+
+     XrdOssReadV::Display(Eroute);
+
      XrdOssCache::List("       oss.", Eroute);
            List_Path("       oss.defaults ", "", DirFlags, Eroute);
      fp = RPList.First();
@@ -1046,6 +1057,7 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
     int nosubs;
     XrdOucEnv *myEnv = 0;
 
+   TS_Xeq("aio",           xaio);
    TS_Xeq("alloc",         xalloc);
    TS_Xeq("cache",         xcache);
    TS_Xeq("cachescan",     xcachescan); // Backward compatibility
@@ -1057,6 +1069,7 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
    TS_Xeq("namelib",       xnml);
    TS_Xeq("path",          xpath);
    TS_Xeq("preread",       xprerd);
+   TS_Xeq("readv",         xreadv);
    TS_Xeq("space",         xspace);
    TS_Xeq("stagecmd",      xstg);
    TS_Xeq("statlib",       xstl);
@@ -1114,6 +1127,64 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
    return 0;
 }
 
+/******************************************************************************/
+/*                                  x a i o                                   */
+/******************************************************************************/
+
+/* Function: xaio
+
+   Purpose:  To parse the directive: aio {off | posix | uring [<opts>]}
+
+             off      perform all I/O synchronously.
+             posix    use POSIX aio when the protocol requests it (default).
+             uring    use the io_uring engine; this also enables async I/O
+                      for disk files. Valid <opts> are:
+
+             rings <n>  number of rings, each with its own reaper thread.
+                        Threads are bound to a ring on first use. Default 4.
+             depth <d>  submission queue depth of each ring. Default 128.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdOssSys::xaio(XrdOucStream &Config, XrdSysError &Eroute)
+{
+    char *val;
+    int rings = 4, depth = 128;
+
+    if (!(val = Config.GetWord()))
+       {Eroute.Emsg("Config", "aio mode not specified"); return 1;}
+
+         if (!strcmp(val, "off"))   {AioMode = aioOff;   return 0;}
+    else if (!strcmp(val, "posix")) {AioMode = aioPosix; return 0;}
+    else if (strcmp(val, "uring"))
+            {Eroute.Emsg("Config", "invalid aio mode -", val); return 1;}
+
+    while((val = Config.GetWord()))
+         {     if (!strcmp(val, "rings"))
+                  {if (!(val = Config.GetWord()))
+                      {Eroute.Emsg("Config", "aio rings not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2i(Eroute,"aio rings",val,&rings,1,64))
+                      return 1;
+                  }
+          else if (!strcmp(val, "depth"))
+                  {if (!(val = Config.GetWord()))
+                      {Eroute.Emsg("Config", "aio depth not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2i(Eroute,"aio depth",val,&depth,1,4096))
+                      return 1;
+                  }
+          else {Eroute.Emsg("Config", "invalid aio option -", val); return 1;}
+         }
+
+    AioMode = aioUring;
+    XrdOssUring::Set(rings, depth);
+    return 0;
+}
+
 /******************************************************************************/
 /*                                x a l l o c                                 */
 /******************************************************************************/
@@ -1534,6 +1605,82 @@ int XrdOssSys::xprerd(XrdOucStream &Config, XrdSysError &Eroute)
       return 0;
 }
   
+/******************************************************************************/
+/*                                x r e a d v                                 */
+/******************************************************************************/
+
+/* Function: xreadv
+
+   Purpose:  To parse the directive: readv {off | on | [gap <gsz>]
+                                             [maxsz <msz>] [threads <n>]}
+
+             off      read each element of a vector read in order. This is
+                      the default.
+             on       merge and read in parallel using the defaults below.
+             <gsz>    elements separated by no more than <gsz> bytes are read
+                      together; the bytes in between are discarded. A value
+                      of 0 only merges adjacent elements. The default is 4k
+                      and the maximum is 1m.
+             <msz>    the largest single read that merging may produce. The
+                      default is 1m and the maximum is 64m.
+             <n>      the number of helper threads that read extents in
+                      parallel with the requesting thread. A value of 0 reads
+                      all extents in the requesting thread. The default is 4.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdOssSys::xreadv(XrdOucStream &Config, XrdSysError &Eroute)
+{
+    static const long long m1 = 1048576LL, m64 = 67108864LL;
+    char *val;
+    long long gap = 4096, msz = m1;
+    int threads = 4;
+
+    if (!(val = Config.GetWord()))
+       {Eroute.Emsg("Config", "readv parameters not specified"); return 1;}
+
+    if (!strcmp(val, "off"))
+       {XrdOssReadV::Set(false, 0, 0, 0); return 0;}
+
+    if (!strcmp(val, "on") && !(val = Config.GetWord()))
+       {XrdOssReadV::Set(true, static_cast<int>(gap), static_cast<int>(msz),
+                         threads);
+        return 0;
+       }
+
+    do {     if (!strcmp(val, "gap"))
+                {if (!(val = Config.GetWord()))
+                    {Eroute.Emsg("Config", "readv gap not specified");
+                     return 1;
+                    }
+                 if (XrdOuca2x::a2sz(Eroute,"readv gap",val,&gap,0,m1))
+                    return 1;
+                }
+        else if (!strcmp(val, "maxsz"))
+                {if (!(val = Config.GetWord()))
+                    {Eroute.Emsg("Config", "readv maxsz not specified");
+                     return 1;
+                    }
+                 if (XrdOuca2x::a2sz(Eroute,"readv maxsz",val,&msz,4096,m64))
+                    return 1;
+                }
+        else if (!strcmp(val, "threads"))
+                {if (!(val = Config.GetWord()))
+                    {Eroute.Emsg("Config", "readv threads not specified");
+                     return 1;
+                    }
+                 if (XrdOuca2x::a2i(Eroute,"readv threads",val,&threads,0,64))
+                    return 1;
+                }
+        else {Eroute.Emsg("Config", "invalid readv option -", val); return 1;}
+       } while((val = Config.GetWord()));
+
+    XrdOssReadV::Set(true, static_cast<int>(gap), static_cast<int>(msz),
+                     threads);
+    return 0;
+}
+
 /******************************************************************************/
 /*                                x s p a c e                                 */
 /******************************************************************************/
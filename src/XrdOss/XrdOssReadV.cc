@@ -0,0 +1,407 @@
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O s s R e a d V . c c                         */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/uio.h>
+
+#include "XrdOss/XrdOssReadV.hh"
+#include "XrdOss/XrdOssTrace.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                               G l o b a l s                                */
+/******************************************************************************/
+
+extern XrdSysTrace OssTrace;
+
+bool  XrdOssReadV::cfgOn      = false;
+int   XrdOssReadV::cfgGap     = 4096;
+int   XrdOssReadV::cfgMaxSz   = 1048576;
+int   XrdOssReadV::cfgThreads = 4;
+
+namespace
+{
+#if defined(IOV_MAX) && IOV_MAX < 1024
+const int maxIOV = IOV_MAX;
+#else
+const int maxIOV = 1024;
+#endif
+
+// Extents are only read in parallel when a request has at least this many.
+//
+const int minFanOut = 4;
+
+// Gap bytes are read into a sink that is never looked at. Each thread has its
+// own so that concurrent extents never target the same memory.
+//
+struct GapSink
+      {char *Buff;
+             GapSink() : Buff(0) {}
+            ~GapSink() {free(Buff);}
+      };
+
+thread_local GapSink gapSink;
+
+// Statistics. The merge ratio (elements per extent) of each request is kept
+// in a histogram whose buckets are 1 (nothing merged), <2, <4, <8, <16, >=16.
+//
+const int ratioSize = 6;
+
+std::atomic<long long> numReqs(0);
+std::atomic<long long> numSegs(0);
+std::atomic<long long> numXtnt(0);
+std::atomic<long long> numBytes(0);
+std::atomic<long long> gapBytes(0);
+std::atomic<long long> numPar(0);
+std::atomic<long long> Ratio[ratioSize];
+
+// The request queue feeding the helper threads
+//
+XrdSysMutex      qMutex;
+XrdSysSemaphore  qReady(0);
+XrdOssReadVReq  *qFirst = 0;
+XrdOssReadVReq  *qLast  = 0;
+}
+
+/******************************************************************************/
+/*                    C l a s s   X r d O s s R e a d V R e q                 */
+/******************************************************************************/
+
+// A request lives on the caller's stack. The caller and any helpers that pick
+// it up claim extents until all have been read. Want and Users are protected
+// by qMutex; the caller does not return until Users drops to zero.
+//
+class XrdOssReadVReq
+{
+public:
+
+struct Extent {off_t offset; ssize_t length; int iovBeg; int iovNum;};
+
+XrdOssReadVReq  *next;
+Extent          *xtVec;
+struct iovec    *ioVec;
+int              fd;
+int              xtNum;
+int              Want;     // Helpers still wanted (while queued)
+int              Users;    // Helpers working on this request
+bool             Waiting;  // Caller waits for helpers to finish
+std::atomic<int> xtNext;   // Next extent to be read
+std::atomic<int> Error;    // First error encountered (positive errno)
+XrdSysSemaphore  Done;
+
+void             Work();
+
+                 XrdOssReadVReq() : next(0), Want(0), Users(0), Waiting(false),
+                                    xtNext(0), Error(0), Done(0) {}
+                ~XrdOssReadVReq() {}
+};
+
+/******************************************************************************/
+/*                 X r d O s s R e a d V R e q : : W o r k                    */
+/******************************************************************************/
+
+void XrdOssReadVReq::Work()
+{
+   struct iovec *iov;
+   ssize_t retval, rdLen;
+   off_t rdOff;
+   int i, k, iovNum;
+
+// Claim extents until none are left or an error occurred. Gap elements have
+// no buffer until the thread reading the extent points them at its sink.
+// Should a read be short we skip over what was read and try again with the
+// rest of it.
+//
+   while((i = xtNext++) < xtNum && !Error)
+        {iov = ioVec + xtVec[i].iovBeg; iovNum = xtVec[i].iovNum;
+         rdOff = xtVec[i].offset;      rdLen  = xtVec[i].length;
+         for (k = 0; k < iovNum; k++)
+             {if (iov[k].iov_base) continue;
+              if (!gapSink.Buff
+              &&  !(gapSink.Buff = (char *)malloc(XrdOssReadV::gapSize())))
+                 {int expected = 0;
+                  Error.compare_exchange_strong(expected, ENOMEM);
+                  return;
+                 }
+              iov[k].iov_base = gapSink.Buff;
+             }
+         k = 0;
+         while(rdLen)
+              {do {retval = preadv(fd, iov+k, iovNum-k, rdOff);}
+                  while(retval < 0 && errno == EINTR);
+               if (retval <= 0)
+                  {int expected = 0;
+                   Error.compare_exchange_strong(expected,
+                                                 (retval < 0 ? errno : ESPIPE));
+                   break;
+                  }
+               rdOff += retval; rdLen -= retval;
+               while(k < iovNum && (size_t)retval >= iov[k].iov_len)
+                    {retval -= iov[k].iov_len; k++;}
+               if (retval)
+                  {iov[k].iov_base = (char *)iov[k].iov_base + retval;
+                   iov[k].iov_len -= retval;
+                  }
+              }
+        }
+}
+
+/******************************************************************************/
+/*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
+/******************************************************************************/
+
+void *XrdOssReadVHelper(void *carg)
+{
+   XrdOssReadV::Helper();
+   return (void *)0;
+}
+  
+/******************************************************************************/
+/*                              D i s p a t c h                               */
+/******************************************************************************/
+
+void XrdOssReadV::Dispatch(XrdOssReadVReq &req, int nHelp)
+{
+   XrdOssReadVReq *rP, *pP = 0;
+   int i;
+
+// Queue the request for as many helpers as we want
+//
+   req.Want = nHelp;
+   qMutex.Lock();
+   if (qLast) qLast->next = &req;
+      else    qFirst      = &req;
+   qLast = &req;
+   qMutex.UnLock();
+   for (i = 0; i < nHelp; i++) qReady.Post();
+   numPar++;
+
+// Do our share of the work. When we run out of extents, dequeue the request
+// if no helper got to it and wait for the helpers that did.
+//
+   req.Work();
+   qMutex.Lock();
+   if (req.Want)
+      {rP = qFirst;
+       while(rP && rP != &req) {pP = rP; rP = rP->next;}
+       if (rP)
+          {if (pP) pP->next = rP->next;
+              else qFirst   = rP->next;
+           if (qLast == rP) qLast = pP;
+          }
+       req.Want = 0;
+      }
+   if (req.Users) req.Waiting = true;
+   qMutex.UnLock();
+   if (req.Waiting) req.Done.Wait();
+}
+
+/******************************************************************************/
+/*                               D i s p l a y                                */
+/******************************************************************************/
+
+void XrdOssReadV::Display(XrdSysError &Eroute)
+{
+   char buff[128];
+
+   if (!cfgOn) {Eroute.Say("       oss.readv off"); return;}
+   snprintf(buff, sizeof(buff), "       oss.readv gap %d maxsz %d threads %d",
+            cfgGap, cfgMaxSz, cfgThreads);
+   Eroute.Say(buff);
+}
+
+/******************************************************************************/
+/*                                H e l p e r                                 */
+/******************************************************************************/
+
+void XrdOssReadV::Helper()
+{
+   XrdOssReadVReq *rP;
+
+// Pick up requests and help with them for as long as we exist
+//
+   do {qReady.Wait();
+       qMutex.Lock();
+       if (!(rP = qFirst)) {qMutex.UnLock(); continue;}
+       if (!(--rP->Want))
+          {if (!(qFirst = rP->next)) qLast = 0;
+           rP->next = 0;
+          }
+       rP->Users++;
+       qMutex.UnLock();
+
+       rP->Work();
+
+       qMutex.Lock();
+       if (!(--rP->Users) && rP->Waiting) rP->Done.Post();
+       qMutex.UnLock();
+      } while(true);
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+bool XrdOssReadV::Init(XrdSysError &Eroute)
+{
+   EPNAME("ReadVInit");
+   pthread_t tid;
+   int i, retc;
+
+// Nothing to do if we are not enabled
+//
+   if (!cfgOn) return true;
+
+// Start the helper threads. If we can't start them all we simply use fewer.
+//
+   for (i = 0; i < cfgThreads; i++)
+       {if ((retc = XrdSysThread::Run(&tid, XrdOssReadVHelper, 0,
+                                      0, "readv helper")))
+           {Eroute.Emsg("ReadVInit", retc, "create readv helper thread");
+            cfgThreads = i;
+            break;
+           }
+       }
+   DEBUG("started " <<cfgThreads <<" readv helper threads");
+   return true;
+}
+
+/******************************************************************************/
+/*                                  R e a d                                   */
+/******************************************************************************/
+
+ssize_t XrdOssReadV::Read(int fd, XrdOucIOVec *readV, int n)
+{
+   XrdOssReadVReq req;
+   XrdOssReadVReq::Extent *xP;
+   struct iovec *iov;
+   long long xtEnd, totBytes = 0, gapTot = 0;
+   int *idx, i, k, nSegs = 0, gap, nHelp;
+   char *mem;
+
+// Get memory for the sort index, the extents, and the I/O vector. Each element
+// may need a gap entry before it so the vector is twice as long.
+//
+   if (!(mem = (char *)malloc(n*(sizeof(int) + sizeof(XrdOssReadVReq::Extent)
+                                 + 2*sizeof(struct iovec)))))
+      return -ENOMEM;
+   iov = (struct iovec *)mem;
+   xP  = (XrdOssReadVReq::Extent *)(iov + 2*n);
+   idx = (int *)(xP + n);
+
+// Sort the elements by offset, ignoring empty ones
+//
+   for (i = 0; i < n; i++) if (readV[i].size > 0) idx[nSegs++] = i;
+   std::sort(idx, idx+nSegs, [readV](int a, int b)
+                             {return readV[a].offset < readV[b].offset;});
+
+// Build the extents. An element joins the current extent when it starts at
+// or after its end, the gap fits in the sink, and the extent stays within
+// the size and vector limits. Overlapping elements start a new extent.
+//
+   req.xtNum = 0; k = 0; xtEnd = 0;
+   for (i = 0; i < nSegs; i++)
+       {XrdOucIOVec &rv = readV[idx[i]];
+        gap = (req.xtNum ? (int)std::min(rv.offset - xtEnd, (long long)INT_MAX)
+                         : -1);
+        if (gap < 0 || gap > cfgGap
+        ||  xP[req.xtNum-1].length + gap + rv.size > cfgMaxSz
+        ||  xP[req.xtNum-1].iovNum + 2 > maxIOV)
+           {xP[req.xtNum].offset = rv.offset;
+            xP[req.xtNum].length = 0;
+            xP[req.xtNum].iovBeg = k;
+            xP[req.xtNum].iovNum = 0;
+            req.xtNum++;
+           } else if (gap)
+                     {iov[k].iov_base = 0; iov[k].iov_len = gap; k++;
+                      xP[req.xtNum-1].length += gap; xP[req.xtNum-1].iovNum++;
+                      gapTot += gap;
+                     }
+        iov[k].iov_base = rv.data; iov[k].iov_len = rv.size; k++;
+        xP[req.xtNum-1].length += rv.size; xP[req.xtNum-1].iovNum++;
+        xtEnd = rv.offset + rv.size;
+        totBytes += rv.size;
+       }
+   req.fd = fd; req.xtVec = xP; req.ioVec = iov;
+
+// Read the extents, in parallel if there are enough of them
+//
+   nHelp = std::min(cfgThreads, req.xtNum - 1);
+   if (nHelp > 0 && req.xtNum >= minFanOut) Dispatch(req, nHelp);
+      else req.Work();
+   free(mem);
+
+// Record statistics
+//
+   numReqs++; numSegs += nSegs; numXtnt += req.xtNum;
+   numBytes += totBytes; gapBytes += gapTot;
+   if (req.xtNum)
+      {int r = nSegs/req.xtNum, b = 0;
+       if (nSegs > req.xtNum)
+          for (b = 1; b < ratioSize-1 && r >= 2; b++) r >>= 1;
+       Ratio[b]++;
+      }
+
+// All done
+//
+   if (req.Error) return -req.Error;
+   return totBytes;
+}
+
+/******************************************************************************/
+/*                                 S t a t s                                  */
+/******************************************************************************/
+
+int XrdOssReadV::Stats(char *buff, int blen)
+{
+   static const char statfmt[] = "<rdv><reqs>%lld</reqs><segs>%lld</segs>"
+          "<xtnts>%lld</xtnts><bytes>%lld</bytes><gapb>%lld</gapb>"
+          "<par>%lld</par><ratio><r1>%lld</r1><r2>%lld</r2><r4>%lld</r4>"
+          "<r8>%lld</r8><r16>%lld</r16><big>%lld</big></ratio></rdv>";
+   static const int  statsz = sizeof(statfmt) + (16*12);
+
+// If only the size is wanted, return it. Nothing is generated if the engine
+// is not in use.
+//
+   if (!cfgOn) return 0;
+   if (!buff) return statsz;
+   if (blen < statsz) return 0;
+
+   return snprintf(buff, blen, statfmt, numReqs.load(), numSegs.load(),
+                   numXtnt.load(), numBytes.load(), gapBytes.load(),
+                   numPar.load(), Ratio[0].load(), Ratio[1].load(),
+                   Ratio[2].load(), Ratio[3].load(), Ratio[4].load(),
+                   Ratio[5].load());
+}
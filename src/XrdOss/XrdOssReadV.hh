@@ -0,0 +1,88 @@
+#ifndef __XRDOSSREADV_H__
+#define __XRDOSSREADV_H__
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O s s R e a d V . h h                         */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <sys/types.h>
+
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdSys/XrdSysError.hh"
+
+class XrdOssReadVReq;
+
+// The XrdOssReadV class implements the vector read engine selected via the
+// oss.readv directive; it is off by default. The elements of a vector read are
+// sorted by offset and elements that are adjacent, or separated by no more
+// than a configured gap, are merged into extents. Each extent is read by a
+// single preadv() that scatters the data directly into the caller's buffers
+// (gap bytes are read into a per-thread sink buffer and discarded). When there
+// are enough extents, helper threads read extents concurrently with the
+// calling thread.
+//
+class XrdOssReadV
+{
+public:
+
+static void    Display(XrdSysError &Eroute);
+
+// Init() returns true upon success and false otherwise.
+//
+static bool    Init(XrdSysError &Eroute);
+
+static int     gapSize() {return cfgGap;}
+
+static bool    isOn() {return cfgOn;}
+
+// Read() returns the number of bytes read upon success and -errno otherwise.
+// As with XrdOssFile::ReadV() a short read is considered an error.
+//
+static ssize_t Read(int fd, XrdOucIOVec *readV, int n);
+
+static void    Set(bool on, int gap, int maxsz, int threads)
+                  {cfgOn = on; cfgGap = gap; cfgMaxSz = maxsz;
+                   cfgThreads = threads;
+                  }
+
+// Returns the number of bytes needed (buff == 0) or placed in buff.
+//
+static int     Stats(char *buff, int blen);
+
+static void    Helper();
+
+private:
+
+static void    Dispatch(XrdOssReadVReq &req, int nHelp);
+
+static bool    cfgOn;
+static int     cfgGap;
+static int     cfgMaxSz;
+static int     cfgThreads;
+};
+#endif
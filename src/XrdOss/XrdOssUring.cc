@@ -0,0 +1,556 @@
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O s s U r i n g . c c                         */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#include "XrdOss/XrdOssTrace.hh"
+#include "XrdOss/XrdOssUring.hh"
+#include "XrdSfs/XrdSfsAio.hh"
+#include "XrdSys/XrdSysAtomics.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+// We talk to the kernel directly so that we do not need liburing. This means
+// we need both the header and the system call numbers.
+//
+#if defined(HAVE_IO_URING) && defined(__NR_io_uring_setup) \
+                           && defined(__NR_io_uring_enter)
+#define OSS_URING_OK 1
+#endif
+
+/******************************************************************************/
+/*                               G l o b a l s                                */
+/******************************************************************************/
+
+extern XrdSysTrace OssTrace;
+
+extern XrdSysError OssEroute;
+
+XrdOssUringRing **XrdOssUring::Rings    = 0;
+int               XrdOssUring::numRings = 0;
+int               XrdOssUring::cfgRings = 4;
+int               XrdOssUring::cfgDepth = 128;
+
+namespace
+{
+thread_local int myRing = -1;
+             int nxtRing = 0;
+
+inline long long Now()
+{
+   struct timespec tv;
+   clock_gettime(CLOCK_MONOTONIC, &tv);
+   return static_cast<long long>(tv.tv_sec)*1000000000LL + tv.tv_nsec;
+}
+}
+
+/******************************************************************************/
+/*                   C l a s s   X r d O s s U r i n g R i n g                */
+/******************************************************************************/
+
+class XrdOssUringRing
+{
+public:
+
+bool      Init(int depth, int rnum);
+
+void      Reap();
+
+int       Submit(XrdOssUring::OpType op, int fd, XrdSfsAio *aiop);
+
+// Statistics, all protected by sqMutex
+//
+long long numOps;     // Completed requests
+long long numFull;    // Requests rejected because the ring was full
+long long totLat;     // Sum of completion latencies (nanoseconds)
+long long maxLat;     // Maximum completion latency  (nanoseconds)
+int       inFlight;   // Current queue depth
+int       maxFlight;  // Maximum queue depth
+int       rNum;
+
+XrdSysMutex sqMutex;
+
+          XrdOssUringRing() : numOps(0), numFull(0), totLat(0), maxLat(0),
+                              inFlight(0), maxFlight(0), rNum(0),
+                              ringFD(-1), sqPend(0), sqBusy(false),
+                              Slots(0), Done(0), freeSlot(-1) {}
+         ~XrdOssUringRing() {} // Rings are never deleted
+
+private:
+
+struct    Slot {XrdSfsAio *aiop;
+                long long  tBeg;
+                int        next;
+                int        op;
+               };
+
+struct    DoneItem {XrdSfsAio *aiop;
+                    int        op;
+                    int        res;
+                   };
+
+int       Enter(unsigned int toSubmit, unsigned int minDone, unsigned int flg);
+void      Flush();
+
+int       ringFD;
+unsigned int  sqEntries;
+unsigned int  cqEntries;
+unsigned int *sqHead;
+unsigned int *sqTail;
+unsigned int *sqMask;
+unsigned int *sqArray;
+unsigned int *cqHead;
+unsigned int *cqTail;
+unsigned int *cqMask;
+#ifdef OSS_URING_OK
+struct io_uring_sqe *sqEnts;
+struct io_uring_cqe *cqEnts;
+#endif
+int       sqPend;     // Entries placed in the ring but not yet submitted
+bool      sqBusy;     // A thread is currently submitting entries
+Slot     *Slots;
+DoneItem *Done;
+int       freeSlot;
+};
+
+#ifdef OSS_URING_OK
+/******************************************************************************/
+/*                    X r d O s s U r i n g R i n g : : E n t e r             */
+/******************************************************************************/
+
+int XrdOssUringRing::Enter(unsigned int toSubmit, unsigned int minDone,
+                           unsigned int flg)
+{
+   return static_cast<int>(syscall(__NR_io_uring_enter, ringFD, toSubmit,
+                                   minDone, flg, (void *)0, 0));
+}
+
+/******************************************************************************/
+/*                    X r d O s s U r i n g R i n g : : F l u s h             */
+/******************************************************************************/
+
+// Flush() must be called with sqMutex held. It submits all pending entries
+// in as few system calls as possible. While a thread is in the kernel other
+// threads simply add entries to the ring and these are picked up in the next
+// pass. This is what batches submissions under load.
+//
+// The kernel may take fewer entries than offered or none at all when it is
+// short of resources (EAGAIN) or has completions to hand back (EBUSY). The
+// remaining entries are retried right away as long as the kernel takes some.
+// Otherwise, if requests are outstanding, the reaper retries after their
+// completions have been processed. If none are, no completion will wake the
+// reaper so we wait a bit and retry here.
+//
+void XrdOssUringRing::Flush()
+{
+   int n, rc, eNum;
+
+   if (sqBusy) return;
+   sqBusy = true;
+
+   while((n = sqPend))
+        {sqPend = 0;
+         sqMutex.UnLock();
+         do {rc = Enter(n, 0, 0);} while(rc < 0 && errno == EINTR);
+         eNum = (rc < 0 ? errno : 0);
+         sqMutex.Lock();
+         if (rc >= n) continue;
+         if (rc > 0) {sqPend += n - rc; continue;}
+         sqPend += n;
+         if (eNum && eNum != EAGAIN && eNum != EBUSY)
+            {OssEroute.Emsg("AioUring", eNum, "submit aio requests");
+             break;
+            }
+         if (inFlight > sqPend) break;
+         sqMutex.UnLock();
+         usleep(1000);
+         sqMutex.Lock();
+        }
+
+   sqBusy = false;
+}
+
+/******************************************************************************/
+/*                     X r d O s s U r i n g R i n g : : I n i t              */
+/******************************************************************************/
+
+bool XrdOssUringRing::Init(int depth, int rnum)
+{
+   struct io_uring_params uParms;
+   size_t sqSize, cqSize;
+   char *sqPtr, *cqPtr;
+   void *sqePtr;
+   int i;
+
+// Create the ring
+//
+   rNum = rnum;
+   memset(&uParms, 0, sizeof(uParms));
+   if ((ringFD = static_cast<int>(syscall(__NR_io_uring_setup, depth,
+                                          &uParms))) < 0)
+      {OssEroute.Emsg("AioUring", errno, "create io_uring");
+       return false;
+      }
+   sqEntries = uParms.sq_entries;
+   cqEntries = uParms.cq_entries;
+
+// Map in the submission and completion rings. Newer kernels allow a single
+// mapping for both.
+//
+   sqSize = uParms.sq_off.array + uParms.sq_entries * sizeof(unsigned int);
+   cqSize = uParms.cq_off.cqes  + uParms.cq_entries * sizeof(io_uring_cqe);
+   if (uParms.features & IORING_FEAT_SINGLE_MMAP)
+      {if (cqSize > sqSize) sqSize = cqSize;
+       cqSize = sqSize;
+      }
+
+   sqPtr = (char *)mmap(0, sqSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                        ringFD, IORING_OFF_SQ_RING);
+   if (sqPtr == MAP_FAILED)
+      {OssEroute.Emsg("AioUring", errno, "map io_uring submission queue");
+       close(ringFD); ringFD = -1;
+       return false;
+      }
+
+   if (uParms.features & IORING_FEAT_SINGLE_MMAP) cqPtr = sqPtr;
+      else {cqPtr = (char *)mmap(0, cqSize, PROT_READ|PROT_WRITE,
+                                 MAP_SHARED|MAP_POPULATE,
+                                 ringFD, IORING_OFF_CQ_RING);
+            if (cqPtr == MAP_FAILED)
+               {OssEroute.Emsg("AioUring",errno,"map io_uring completion queue");
+                munmap(sqPtr, sqSize);
+                close(ringFD); ringFD = -1;
+                return false;
+               }
+           }
+
+   sqePtr = mmap(0, uParms.sq_entries * sizeof(io_uring_sqe),
+                 PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                 ringFD, IORING_OFF_SQES);
+   if (sqePtr == MAP_FAILED)
+      {OssEroute.Emsg("AioUring", errno, "map io_uring submission entries");
+       if (cqPtr != sqPtr) munmap(cqPtr, cqSize);
+       munmap(sqPtr, sqSize);
+       close(ringFD); ringFD = -1;
+       return false;
+      }
+
+// Establish the ring pointers
+//
+   sqHead  = (unsigned int *)(sqPtr + uParms.sq_off.head);
+   sqTail  = (unsigned int *)(sqPtr + uParms.sq_off.tail);
+   sqMask  = (unsigned int *)(sqPtr + uParms.sq_off.ring_mask);
+   sqArray = (unsigned int *)(sqPtr + uParms.sq_off.array);
+   sqEnts  = (struct io_uring_sqe *)sqePtr;
+   cqHead  = (unsigned int *)(cqPtr + uParms.cq_off.head);
+   cqTail  = (unsigned int *)(cqPtr + uParms.cq_off.tail);
+   cqMask  = (unsigned int *)(cqPtr + uParms.cq_off.ring_mask);
+   cqEnts  = (struct io_uring_cqe *)(cqPtr + uParms.cq_off.cqes);
+
+// Allocate the request slots. We never allow more requests in flight than
+// the completion queue can hold so that completions are never dropped.
+//
+   Slots = new Slot[cqEntries];
+   Done  = new DoneItem[cqEntries];
+   for (i = 0; i < (int)cqEntries; i++) Slots[i].next = i+1;
+   Slots[cqEntries-1].next = -1;
+   freeSlot = 0;
+   return true;
+}
+
+/******************************************************************************/
+/*                     X r d O s s U r i n g R i n g : : R e a p              */
+/******************************************************************************/
+
+void XrdOssUringRing::Reap()
+{
+   EPNAME("AioReap");
+   struct io_uring_cqe *cqe;
+   unsigned int head, tail;
+   long long tNow, tLat;
+   int i, n, rc, sNum;
+
+// Wait for completions and process them in batches. All of the bookkeeping
+// for a batch is done under a single lock acquisition and the completion
+// callbacks are invoked after the lock is released.
+//
+   while(1)
+        {rc = Enter(0, 1, IORING_ENTER_GETEVENTS);
+         if (rc < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            {OssEroute.Emsg("AioUring", errno, "wait for aio completions");
+             sleep(1);
+             continue;
+            }
+
+         head = *cqHead;
+         tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+         if (head == tail) continue;
+
+         tNow = Now();
+         n = 0;
+         sqMutex.Lock();
+         while(head != tail)
+              {cqe = &cqEnts[head & *cqMask];
+               sNum = static_cast<int>(cqe->user_data);
+               Done[n].aiop = Slots[sNum].aiop;
+               Done[n].op   = Slots[sNum].op;
+               Done[n].res  = cqe->res;
+               tLat = tNow - Slots[sNum].tBeg;
+               totLat += tLat;
+               if (tLat > maxLat) maxLat = tLat;
+               Slots[sNum].next = freeSlot;
+               freeSlot = sNum;
+               head++; n++;
+              }
+         __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+         inFlight -= n;
+         numOps   += n;
+         if (sqPend) Flush();
+         sqMutex.UnLock();
+
+         for (i = 0; i < n; i++)
+             {XrdSfsAio *aiop = Done[i].aiop;
+              aiop->Result = Done[i].res;
+              DEBUG("ring " <<rNum <<" completed for " <<aiop->TIdent
+                    <<" result=" <<aiop->Result <<" aiocb=" <<Xrd::hex1 <<aiop);
+              if (Done[i].op == XrdOssUring::opRead) aiop->doneRead();
+                 else aiop->doneWrite();
+             }
+        }
+}
+
+/******************************************************************************/
+/*                   X r d O s s U r i n g R i n g : : S u b m i t            */
+/******************************************************************************/
+
+int XrdOssUringRing::Submit(XrdOssUring::OpType op, int fd, XrdSfsAio *aiop)
+{
+   struct io_uring_sqe *sqe;
+   unsigned int tail, idx;
+   int sNum;
+
+// Obtain a request slot and a submission entry. If either is not available
+// tell the caller to do this synchronously.
+//
+   sqMutex.Lock();
+   tail = *sqTail;
+   if ((sNum = freeSlot) < 0
+   ||  tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+      {numFull++;
+       sqMutex.UnLock();
+       return 1;
+      }
+   freeSlot = Slots[sNum].next;
+   Slots[sNum].aiop = aiop;
+   Slots[sNum].op   = op;
+   Slots[sNum].tBeg = Now();
+
+// Fill out the submission entry
+//
+   idx = tail & *sqMask;
+   sqe = &sqEnts[idx];
+   memset(sqe, 0, sizeof(struct io_uring_sqe));
+   sqe->fd        = fd;
+   sqe->user_data = static_cast<uint64_t>(sNum);
+   switch(op)
+         {case XrdOssUring::opRead:  sqe->opcode = IORING_OP_READ;  break;
+          case XrdOssUring::opWrite: sqe->opcode = IORING_OP_WRITE; break;
+          default:                   sqe->opcode = IORING_OP_FSYNC; break;
+         }
+   if (op != XrdOssUring::opSync)
+      {sqe->addr = (uint64_t)(uintptr_t)aiop->sfsAio.aio_buf;
+       sqe->len  = static_cast<uint32_t>(aiop->sfsAio.aio_nbytes);
+       sqe->off  = static_cast<uint64_t>(aiop->sfsAio.aio_offset);
+      }
+   sqArray[idx] = idx;
+   __atomic_store_n(sqTail, tail+1, __ATOMIC_RELEASE);
+
+// Account for the request and submit everything that is pending
+//
+   if (++inFlight > maxFlight) maxFlight = inFlight;
+   sqPend++;
+   Flush();
+   sqMutex.UnLock();
+   return 0;
+}
+
+#else
+/******************************************************************************/
+/*                     X r d O s s U r i n g R i n g   S t u b s              */
+/******************************************************************************/
+
+bool XrdOssUringRing::Init(int depth, int rnum) {return false;}
+
+void XrdOssUringRing::Reap() {}
+
+int  XrdOssUringRing::Submit(XrdOssUring::OpType op, int fd, XrdSfsAio *aiop)
+                            {return 1;}
+#endif
+
+/******************************************************************************/
+/*                 E x t e r n a l   T h r e a d   I n t e r f a c e          */
+/******************************************************************************/
+
+void *XrdOssUringReap(void *carg)
+{
+   XrdOssUringRing *rP = (XrdOssUringRing *)carg;
+   rP->Reap();
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                               D i s p l a y                                */
+/******************************************************************************/
+
+void XrdOssUring::Display(XrdSysError &Eroute)
+{
+   char buff[128];
+
+   snprintf(buff, sizeof(buff), "       oss.aio uring rings %d depth %d",
+            cfgRings, cfgDepth);
+   Eroute.Say(buff);
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+bool XrdOssUring::Init(XrdSysError &Eroute)
+{
+#ifdef OSS_URING_OK
+   EPNAME("AioInit");
+   XrdOssUringRing **rVec;
+   pthread_t tid;
+   int i, retc;
+
+// Create all of the rings
+//
+   rVec = new XrdOssUringRing*[cfgRings];
+   for (i = 0; i < cfgRings; i++)
+       {rVec[i] = new XrdOssUringRing;
+        if (!rVec[i]->Init(cfgDepth, i))
+           {Eroute.Emsg("AioInit", "Unable to create io_uring; "
+                                   "uring aio support terminated.");
+            return false; // Rings are leaked as we are falling back
+           }
+       }
+
+// Now start a reaper thread for each ring
+//
+   for (i = 0; i < cfgRings; i++)
+       {if ((retc = XrdSysThread::Run(&tid, XrdOssUringReap, (void *)rVec[i],
+                                      0, "aio uring reaper")))
+           {Eroute.Emsg("AioInit", retc, "create io_uring reaper thread; "
+                                   "uring aio support terminated.");
+            return false;
+           }
+        DEBUG("started io_uring reaper thread for ring " <<i);
+       }
+
+// All done
+//
+   Rings    = rVec;
+   numRings = cfgRings;
+   return true;
+#else
+   Eroute.Say("Config warning: io_uring is not supported on this platform.");
+   return false;
+#endif
+}
+
+/******************************************************************************/
+/*                                 S t a t s                                  */
+/******************************************************************************/
+
+int XrdOssUring::Stats(char *buff, int blen)
+{
+   static const char statfmt[] = "<aio><mode>uring</mode><rings>%d</rings>"
+          "<ops>%lld</ops><full>%lld</full><qd>%d</qd><qdmax>%d</qdmax>"
+          "<lat>%lld</lat><latmax>%lld</latmax></aio>";
+   static const int  statsz = sizeof(statfmt) + 8 + (16*4) + (8*2);
+   long long numOps = 0, numFull = 0, totLat = 0, maxLat = 0;
+   int i, inFlight = 0, maxFlight = 0;
+
+// If only the size is wanted, return it. Nothing is generated if the engine
+// is not in use.
+//
+   if (!numRings) return 0;
+   if (!buff) return statsz;
+   if (blen < statsz) return 0;
+
+// Aggregate the counters across all of the rings
+//
+   for (i = 0; i < numRings; i++)
+       {XrdOssUringRing *rP = Rings[i];
+        rP->sqMutex.Lock();
+        numOps   += rP->numOps;
+        numFull  += rP->numFull;
+        totLat   += rP->totLat;
+        inFlight += rP->inFlight;
+        if (rP->maxLat    > maxLat)    maxLat    = rP->maxLat;
+        if (rP->maxFlight > maxFlight) maxFlight = rP->maxFlight;
+        rP->sqMutex.UnLock();
+       }
+
+// Latencies are reported in microseconds
+//
+   return snprintf(buff, blen, statfmt, numRings, numOps, numFull, inFlight,
+                   maxFlight, (numOps ? totLat/numOps/1000 : 0), maxLat/1000);
+}
+
+/******************************************************************************/
+/*                                S u b m i t                                 */
+/******************************************************************************/
+
+int XrdOssUring::Submit(OpType op, int fd, XrdSfsAio *aiop)
+{
+   int rNum = myRing;
+
+// Bind this thread to a ring if it has not been bound yet
+//
+   if (rNum < 0)
+      {rNum = AtomicInc(nxtRing) % numRings;
+       myRing = rNum;
+      }
+
+// Queue the request
+//
+   return Rings[rNum]->Submit(op, fd, aiop);
+}
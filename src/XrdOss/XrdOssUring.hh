@@ -0,0 +1,78 @@
+#ifndef __XRDOSSURING_H__
+#define __XRDOSSURING_H__
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O s s U r i n g . h h                         */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdSys/XrdSysError.hh"
+
+class XrdOssUringRing;
+class XrdSfsAio;
+
+// The XrdOssUring class implements the io_uring asynchronous I/O engine that
+// is selected via "oss.aio uring". Each ring has its own submission lock and a
+// reaper thread that harvests completions in batches and calls the request's
+// doneRead() or doneWrite() method directly. Threads are bound to a ring on
+// first use so that a ring is, effectively, a per-thread set of queues.
+//
+class XrdOssUring
+{
+public:
+
+enum OpType {opRead = 0, opWrite, opSync};
+
+static void Display(XrdSysError &Eroute);
+
+// Init() returns true if the engine is usable, false otherwise. In the latter
+// case the caller should fall back to another aio mode.
+//
+static bool Init(XrdSysError &Eroute);
+
+static bool isOn() {return numRings != 0;}
+
+static void Set(int rings, int depth) {cfgRings = rings; cfgDepth = depth;}
+
+// Returns the number of bytes needed (buff == 0) or placed in buff.
+//
+static int  Stats(char *buff, int blen);
+
+// Submit() returns 0 when the request was queued, -errno on a hard failure,
+// and a positive value when the ring is full (the caller should then execute
+// the request synchronously).
+//
+static int  Submit(OpType op, int fd, XrdSfsAio *aiop);
+
+private:
+
+static XrdOssUringRing **Rings;
+static int               numRings;
+static int               cfgRings;
+static int               cfgDepth;
+};
+#endif
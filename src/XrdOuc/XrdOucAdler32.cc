@@ -0,0 +1,343 @@
+/* XrdOucAdler32.cc -- compute the adler32 checksum using vector instructions
+
+   The scalar algorithm and the combine function are derived from zlib:
+
+  Copyright (C) 1995-2011, 2016 Mark Adler
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Jean-loup Gailly        Mark Adler
+  jloup@gzip.org          madler@alumni.caltech.edu
+ */
+
+/* Modification history:
+        Added SSSE3, AVX2, and AVX-512 block kernels selected at run time. Each
+        kernel processes runs of at most NMAX bytes between modulo reductions,
+        just as the scalar code does, so all results are bit-identical.
+
+   The vector kernels use the block form of the adler32 recurrence. For a
+   block of n bytes b[0..n-1]:
+
+        s1' = s1 + sum(b[i])
+        s2' = s2 + n*s1 + sum((n-i)*b[i])
+
+   The weighted sum is computed with pmaddubsw against a vector of descending
+   weights, the plain sum with psadbw. The n*s1 term is accumulated as a
+   running prefix sum and scaled by the block size once per NMAX run.
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include "XrdOuc/XrdOucAdler32.hh"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define ADLER_SIMD 1
+#endif
+
+#define BASE 65521U     /* largest prime smaller than 65536 */
+#define NMAX 5552       /* 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
+
+#define DO1(buf,i)  {s1 += (buf)[i]; s2 += s1;}
+#define DO2(buf,i)  DO1(buf,i); DO1(buf,i+1);
+#define DO4(buf,i)  DO2(buf,i); DO2(buf,i+2);
+#define DO8(buf,i)  DO4(buf,i); DO4(buf,i+4);
+#define DO16(buf)   DO8(buf,0); DO8(buf,8);
+
+/* Finish a run of less than one vector block using scalar code. */
+static inline uint32_t adler32_tail(uint32_t s1, uint32_t s2,
+                                    const unsigned char *buf, size_t len) {
+    while (len >= 16) {
+        DO16(buf);
+        buf += 16;
+        len -= 16;
+    }
+    while (len--) {
+        s1 += *buf++;
+        s2 += s1;
+    }
+    s1 %= BASE;
+    s2 %= BASE;
+    return s1 | (s2 << 16);
+}
+
+/* Scalar adler32. */
+uint32_t xrdadler32_sw(uint32_t adler, void const *data, size_t len) {
+    const unsigned char *buf = (const unsigned char *)data;
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+
+    while (len >= NMAX) {
+        len -= NMAX;
+        unsigned n = NMAX / 16;
+        do {
+            DO16(buf);
+            buf += 16;
+        } while (--n);
+        s1 %= BASE;
+        s2 %= BASE;
+    }
+    return adler32_tail(s1, s2, buf, len);
+}
+
+#ifdef ADLER_SIMD
+
+/* SSSE3: 32 bytes per iteration using two 16 byte vectors. */
+__attribute__((target("ssse3")))
+static uint32_t adler32_ssse3(uint32_t adler, void const *data, size_t len) {
+    const unsigned char *buf = (const unsigned char *)data;
+    const unsigned BLOCK = 32;
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+    size_t blocks = len / BLOCK;
+    len -= blocks * BLOCK;
+
+    const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                       24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10,  9,
+                                        8,  7,  6,  5,  4,  3,  2,  1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+
+    while (blocks) {
+        size_t n = NMAX / BLOCK;
+        if (n > blocks) n = blocks;
+        blocks -= n;
+
+        __m128i v_ps = _mm_set_epi32(0, 0, 0, (int)(s1 * n));
+        __m128i v_s2 = _mm_set_epi32(0, 0, 0, (int)s2);
+        __m128i v_s1 = _mm_setzero_si128();
+        do {
+            const __m128i b1 = _mm_loadu_si128((const __m128i *)buf);
+            const __m128i b2 = _mm_loadu_si128((const __m128i *)(buf + 16));
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(b1, zero));
+            v_s2 = _mm_add_epi32(v_s2,
+                   _mm_madd_epi16(_mm_maddubs_epi16(b1, tap1), ones));
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(b2, zero));
+            v_s2 = _mm_add_epi32(v_s2,
+                   _mm_madd_epi16(_mm_maddubs_epi16(b2, tap2), ones));
+            buf += BLOCK;
+        } while (--n);
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0xb1));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0x4e));
+        s1 += (uint32_t)_mm_cvtsi128_si32(v_s1);
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0xb1));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0x4e));
+        s2  = (uint32_t)_mm_cvtsi128_si32(v_s2);
+        s1 %= BASE;
+        s2 %= BASE;
+    }
+    return adler32_tail(s1, s2, buf, len);
+}
+
+/* AVX2: 64 bytes per iteration using two 32 byte vectors. */
+__attribute__((target("avx2")))
+static uint32_t adler32_avx2(uint32_t adler, void const *data, size_t len) {
+    const unsigned char *buf = (const unsigned char *)data;
+    const unsigned BLOCK = 64;
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+    size_t blocks = len / BLOCK;
+    len -= blocks * BLOCK;
+
+    const __m256i tap1 = _mm256_setr_epi8(64, 63, 62, 61, 60, 59, 58, 57,
+                                          56, 55, 54, 53, 52, 51, 50, 49,
+                                          48, 47, 46, 45, 44, 43, 42, 41,
+                                          40, 39, 38, 37, 36, 35, 34, 33);
+    const __m256i tap2 = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                          24, 23, 22, 21, 20, 19, 18, 17,
+                                          16, 15, 14, 13, 12, 11, 10,  9,
+                                           8,  7,  6,  5,  4,  3,  2,  1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    while (blocks) {
+        size_t n = NMAX / BLOCK;
+        if (n > blocks) n = blocks;
+        blocks -= n;
+
+        __m256i v_ps = _mm256_setr_epi32((int)(s1 * n), 0, 0, 0, 0, 0, 0, 0);
+        __m256i v_s2 = _mm256_setr_epi32((int)s2, 0, 0, 0, 0, 0, 0, 0);
+        __m256i v_s1 = _mm256_setzero_si256();
+        do {
+            const __m256i b1 = _mm256_loadu_si256((const __m256i *)buf);
+            const __m256i b2 = _mm256_loadu_si256((const __m256i *)(buf + 32));
+            v_ps = _mm256_add_epi32(v_ps, v_s1);
+            v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(b1, zero));
+            v_s2 = _mm256_add_epi32(v_s2,
+                   _mm256_madd_epi16(_mm256_maddubs_epi16(b1, tap1), ones));
+            v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(b2, zero));
+            v_s2 = _mm256_add_epi32(v_s2,
+                   _mm256_madd_epi16(_mm256_maddubs_epi16(b2, tap2), ones));
+            buf += BLOCK;
+        } while (--n);
+        v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 6));
+
+        __m128i h1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1),
+                                   _mm256_extracti128_si256(v_s1, 1));
+        h1 = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, 0xb1));
+        h1 = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, 0x4e));
+        s1 += (uint32_t)_mm_cvtsi128_si32(h1);
+        __m128i h2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2),
+                                   _mm256_extracti128_si256(v_s2, 1));
+        h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, 0xb1));
+        h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, 0x4e));
+        s2  = (uint32_t)_mm_cvtsi128_si32(h2);
+        s1 %= BASE;
+        s2 %= BASE;
+    }
+    return adler32_tail(s1, s2, buf, len);
+}
+
+/* Horizontal sum of a 512 bit vector of 32 bit lanes. This is only done once
+   per NMAX run so we avoid the reduction intrinsics which draw spurious
+   warnings from some compilers. */
+__attribute__((target("avx512f")))
+static inline uint32_t adler32_hsum512(__m512i v) {
+    uint32_t lane[16], sum = 0;
+    _mm512_storeu_si512((void *)lane, v);
+    for (int i = 0; i < 16; i++) sum += lane[i];
+    return sum;
+}
+
+/* AVX-512: 64 bytes per iteration using one 64 byte vector. The weights can
+   not exceed 64 here as pmaddubsw pairs must not saturate a signed short. */
+__attribute__((target("avx512f,avx512bw")))
+static uint32_t adler32_avx512(uint32_t adler, void const *data, size_t len) {
+    const unsigned char *buf = (const unsigned char *)data;
+    const unsigned BLOCK = 64;
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+    size_t blocks = len / BLOCK;
+    len -= blocks * BLOCK;
+
+    const __m512i tap = _mm512_set_epi8( 1,  2,  3,  4,  5,  6,  7,  8,
+                                         9, 10, 11, 12, 13, 14, 15, 16,
+                                        17, 18, 19, 20, 21, 22, 23, 24,
+                                        25, 26, 27, 28, 29, 30, 31, 32,
+                                        33, 34, 35, 36, 37, 38, 39, 40,
+                                        41, 42, 43, 44, 45, 46, 47, 48,
+                                        49, 50, 51, 52, 53, 54, 55, 56,
+                                        57, 58, 59, 60, 61, 62, 63, 64);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i ones = _mm512_set1_epi16(1);
+
+    while (blocks) {
+        size_t n = NMAX / BLOCK;
+        if (n > blocks) n = blocks;
+        blocks -= n;
+
+        __m512i v_ps = _mm512_setzero_si512();
+        __m512i v_s2 = _mm512_setzero_si512();
+        __m512i v_s1 = _mm512_setzero_si512();
+        uint32_t ps = (uint32_t)(s1 * n);
+        do {
+            const __m512i b = _mm512_loadu_si512((const void *)buf);
+            v_ps = _mm512_add_epi32(v_ps, v_s1);
+            v_s1 = _mm512_add_epi32(v_s1, _mm512_sad_epu8(b, zero));
+            v_s2 = _mm512_add_epi32(v_s2,
+                   _mm512_madd_epi16(_mm512_maddubs_epi16(b, tap), ones));
+            buf += BLOCK;
+        } while (--n);
+        s1 += adler32_hsum512(v_s1);
+        ps += adler32_hsum512(v_ps);
+        s2 += adler32_hsum512(v_s2) + (ps << 6);
+        s1 %= BASE;
+        s2 %= BASE;
+    }
+    return adler32_tail(s1, s2, buf, len);
+}
+
+/* Select the best implementation once. */
+static pthread_once_t  adler32_once = PTHREAD_ONCE_INIT;
+static xrdadler32_func adler32_best = xrdadler32_sw;
+static const char    *adler32_name = "scalar";
+
+static void adler32_select(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) {
+        adler32_best = adler32_avx512;
+        adler32_name = "avx512";
+    } else if (__builtin_cpu_supports("avx2")) {
+        adler32_best = adler32_avx2;
+        adler32_name = "avx2";
+    } else if (__builtin_cpu_supports("ssse3")) {
+        adler32_best = adler32_ssse3;
+        adler32_name = "ssse3";
+    }
+}
+
+uint32_t xrdadler32(uint32_t adler, void const *buf, size_t len) {
+    pthread_once(&adler32_once, adler32_select);
+    return adler32_best(adler, buf, len);
+}
+
+const char *xrdadler32_impl() {
+    pthread_once(&adler32_once, adler32_select);
+    return adler32_name;
+}
+
+xrdadler32_func xrdadler32_kernel(const char *name) {
+    __builtin_cpu_init();
+    if (!strcmp(name, "scalar"))
+        return xrdadler32_sw;
+    if (!strcmp(name, "ssse3"))
+        return __builtin_cpu_supports("ssse3") ? adler32_ssse3 : 0;
+    if (!strcmp(name, "avx2"))
+        return __builtin_cpu_supports("avx2") ? adler32_avx2 : 0;
+    if (!strcmp(name, "avx512"))
+        return __builtin_cpu_supports("avx512bw") ? adler32_avx512 : 0;
+    return 0;
+}
+
+#else /* !ADLER_SIMD */
+
+uint32_t xrdadler32(uint32_t adler, void const *buf, size_t len) {
+    return xrdadler32_sw(adler, buf, len);
+}
+
+const char *xrdadler32_impl() {
+    return "scalar";
+}
+
+xrdadler32_func xrdadler32_kernel(const char *name) {
+    return strcmp(name, "scalar") ? 0 : xrdadler32_sw;
+}
+
+#endif
+
+/* Combine two adler32 values; this is zlib's adler32_combine(). */
+uint32_t xrdadler32_combine(uint32_t adler1, uint32_t adler2, long long len2) {
+    uint32_t sum1, sum2, rem;
+
+    if (len2 < 0)
+        return 0xffffffffU;
+
+    rem = (uint32_t)(len2 % BASE);
+    sum1 = adler1 & 0xffff;
+    sum2 = (rem * sum1) % BASE;
+    sum1 += (adler2 & 0xffff) + BASE - 1;
+    sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + BASE - rem;
+    if (sum1 >= BASE) sum1 -= BASE;
+    if (sum1 >= BASE) sum1 -= BASE;
+    if (sum2 >= (BASE << 1)) sum2 -= (BASE << 1);
+    if (sum2 >= BASE) sum2 -= BASE;
+    return sum1 | (sum2 << 16);
+}
@@ -0,0 +1,36 @@
+#ifndef __XRDOUCADLER32_HH__
+#define __XRDOUCADLER32_HH__
+// XrdOucAdler32.hh -- header for XrdOucAdler32.cc
+// Copyright (C) 1995-2011, 2016 Mark Adler
+// The algorithms are derived from zlib, see XrdOucAdler32.cc for the license.
+
+#include <cstddef>
+#include <cstdint>
+
+// Return the adler32 of buf[0..len-1] given the starting value adler. This can
+// be used to calculate the checksum of a sequence of bytes a chunk at a time,
+// using the previously returned value in the next call. The first call must
+// be with adler == 1. xrdadler32() uses the widest vector instructions that
+// the processor supports (AVX-512, AVX2, or SSSE3) selected at run time.
+uint32_t xrdadler32(uint32_t adler, void const *buf, size_t len);
+
+// xrdadler32_sw() is the same, but never uses vector instructions.
+uint32_t xrdadler32_sw(uint32_t adler, void const *buf, size_t len);
+
+// Return the adler32 of the concatenation of two byte sequences given the
+// adler32 of each sequence and the length of the second sequence. This allows
+// checksums computed over separate chunks to be merged.
+uint32_t xrdadler32_combine(uint32_t adler1, uint32_t adler2, long long len2);
+
+// Return the name of the implementation xrdadler32() will use.
+const char *xrdadler32_impl();
+
+// Return the implementation with the given name ("scalar", "ssse3", "avx2", or
+// "avx512"), or nil if it was not built or the processor does not support it.
+// This allows each implementation to be tested regardless of which one
+// xrdadler32() selects.
+typedef uint32_t (*xrdadler32_func)(uint32_t adler, void const *buf,
+                                    size_t len);
+
+xrdadler32_func xrdadler32_kernel(const char *name);
+#endif
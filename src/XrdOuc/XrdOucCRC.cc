@@ -45,6 +45,7 @@
       Public Domain
 */
 
+#include "XrdOuc/XrdOucAdler32.hh"
 #include "XrdOuc/XrdOucCRC.hh"
 #include "XrdOuc/XrdOucCRC32C.hh"
 
@@ -183,6 +184,28 @@ uint32_t XrdOucCRC::CRC32(const unsigned char *p, int reclen)
    return crc ^ CRC32_XOROT;
 }
 
+/******************************************************************************/
+/*                               A d l e r 3 2                                */
+/******************************************************************************/
+  
+uint32_t XrdOucCRC::Adler32(const void* data, size_t count, uint32_t prevcs)
+{
+
+// Return the checksum
+//
+   return xrdadler32(prevcs, data, count);
+}
+
+/******************************************************************************/
+  
+uint32_t XrdOucCRC::Adler32(uint32_t cs1, uint32_t cs2, long long len2)
+{
+
+// Return the combined checksum
+//
+   return xrdadler32_combine(cs1, cs2, len2);
+}
+
 /******************************************************************************/
 /*                                C R C 3 2 C                                 */
 /******************************************************************************/
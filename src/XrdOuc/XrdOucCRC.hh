@@ -53,6 +53,31 @@ public:
 
 static uint32_t CRC32(const unsigned char *data, int count);
 
+//------------------------------------------------------------------------------
+//! Compute an adler32 checksum using vector instructions if available.
+//!
+//! @param  data   Pointer to the data whose checksum it to be computed.
+//! @param  count  The number of bytes pointed to by data.
+//! @param  prevcs The previous checksum value. The initial checksum of
+//!                checksum sequence should be one, the default.
+//!
+//! @return The adler32 checksum in host byte order.
+//------------------------------------------------------------------------------
+
+static uint32_t Adler32(const void* data, size_t count, uint32_t prevcs=1);
+
+//------------------------------------------------------------------------------
+//! Combine two adler32 checksums.
+//!
+//! @param  cs1    The adler32 checksum of the first sequence of bytes.
+//! @param  cs2    The adler32 checksum of the second sequence of bytes.
+//! @param  len2   The number of bytes in the second sequence.
+//!
+//! @return The adler32 checksum of the concatenation of both sequences.
+//------------------------------------------------------------------------------
+
+static uint32_t Adler32(uint32_t cs1, uint32_t cs2, long long len2);
+
 //------------------------------------------------------------------------------
 //! Compute a CRC32C checksum using hardware assist if available.
 //!
@@ -45,6 +45,8 @@
                      XrdOucCRC32C.hh with corresponding change to include
                      statement herein. Add required casts to allow C++
                      compilation.
+        17 Oct 2026  Add crc32c_combine() so that CRCs of separately computed
+                     chunks of data can be merged.
  */
 
 #include <pthread.h>
@@ -429,6 +431,43 @@ uint32_t crc32c_sw(uint32_t crc, void const *buf, size_t len) {
         return crc32c_sw_big(crc, buf, len);
 }
 
+/* Multiply a(x) by b(x) modulo p(x), where p(x) is the CRC polynomial,
+   reflected. For speed, this requires that a not be zero. */
+static uint32_t crc32c_multmodp(uint32_t a, uint32_t b) {
+    uint32_t m = (uint32_t)1 << 31, p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = b & 1 ? (b >> 1) ^ POLY : b >> 1;
+    }
+    return p;
+}
+
+/* Return x^(n * 2^k) modulo p(x). */
+static uint32_t crc32c_x2nmodp(uint64_t n, unsigned k) {
+    uint32_t p = (uint32_t)1 << 31;     /* x^0 == 1 */
+    uint32_t x2n = (uint32_t)1 << 30;   /* x^2^0 == x^1 */
+    while (k--)
+        x2n = crc32c_multmodp(x2n, x2n);
+    while (n) {
+        if (n & 1)
+            p = crc32c_multmodp(x2n, p);
+        n >>= 1;
+        x2n = crc32c_multmodp(x2n, x2n);
+    }
+    return p;
+}
+
+/* Combine two CRC-32C values using the method of zlib 1.2.12 crc32_combine(),
+   which takes time proportional to log(len2). */
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t len2) {
+    return crc32c_multmodp(crc32c_x2nmodp(len2, 3), crc1) ^ crc2;
+}
+
 #ifdef TEST
 
 #include <cstdio>
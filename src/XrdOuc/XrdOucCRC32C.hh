@@ -16,4 +16,8 @@ uint32_t crc32c(uint32_t crc, void const *buf, size_t len);
 // crc32c_sw() is the same, but does not use the hardware instruction, even if
 // available.
 uint32_t crc32c_sw(uint32_t crc, void const *buf, size_t len);
+
+// Return the CRC-32C of the concatenation of two byte sequences given the
+// CRC-32C of each sequence and the length of the second sequence.
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t len2);
 #endif
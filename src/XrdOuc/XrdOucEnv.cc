@@ -31,18 +31,77 @@
 #include "string.h"
 #include "stdio.h"
 #include <cstdlib>
+#include <new>
 
 #include "XrdOuc/XrdOucEnv.hh"
   
+/******************************************************************************/
+/*                         L o c a l   S t a t i c s                          */
+/******************************************************************************/
+
+namespace
+{
+// The variable names are hashed using 32-bit FNV-1a
+//
+const unsigned int hInit = 2166136261U;
+const unsigned int hMult = 16777619U;
+
+inline unsigned int EnvHash(const char *name)
+{
+   unsigned int hval = hInit;
+   while(*name) hval = (hval ^ (unsigned char)*name++) * hMult;
+   return hval;
+}
+}
+
+/******************************************************************************/
+/*                    X r d O u c E n v : : E n v T a b l e                   */
+/******************************************************************************/
+
+// Variables set by the constructor point into a parsed copy of the passed
+// string and the table itself follows that copy in the global_env allocation.
+// Variables set by Put() have the name and value in one allocation starting
+// at the name. An object that never had an opaque string gets its table
+// allocated on its own by the first Put().
+//
+struct XrdOucEnv::EnvTable
+{
+struct Item
+      {const char  *name;    // Null when the slot is free
+             char  *value;
+       unsigned int hval;
+       bool         owned;   // True if allocated by Put()
+      };
+
+static const int tInit = 16; // Must be a power of two
+
+Item *Find(const char *varname, unsigned int hval);
+void  Grow();
+void  Insert(const char *name, char *value, unsigned int hval, bool owned);
+
+      EnvTable(bool isalone) : tab(tInline), tSize(tInit), tNum(0),
+                               alone(isalone)
+                             {memset(tInline, 0, sizeof(tInline));}
+     ~EnvTable();
+
+Item *tab;
+int   tSize;
+int   tNum;
+bool  alone;                // True if not part of the global_env allocation
+Item  tInline[tInit];       // Large enough for almost every opaque string
+};
+  
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
   
 XrdOucEnv::XrdOucEnv(const char *vardata, int varlen, 
                      const XrdSecEntity *secent)
-                    : env_Hash(8,13), secEntity(secent)
+                    : envTab(0), secEntity(secent)
 {
-   char *vdp, varsave, *varname, *varvalu;
+   char *vdp, *varname, *varvalu;
+   unsigned int hval;
+   int tOffs;
 
    if (!vardata) {global_env = 0; global_len = 0; return;}
 
@@ -50,38 +109,65 @@ XrdOucEnv::XrdOucEnv(const char *vardata, int varlen,
 //
    if (!varlen) varlen = strlen(vardata);
 
-// We want our env copy to start with a single ampersand
+// We want our env copy to start with a single ampersand. The same allocation
+// holds a second copy that we parse in place so that the variables need no
+// storage of their own, followed by the variable table.
 //
    while(*vardata == '&' && varlen) {vardata++; varlen--;}
    if (!varlen) {global_env = 0; global_len = 0; return;}
-   global_env = (char *)malloc(varlen+2);
+   tOffs = ((varlen+2)*2 + alignof(EnvTable)-1) & ~(int)(alignof(EnvTable)-1);
+   global_env = (char *)malloc(tOffs + sizeof(EnvTable));
+   envTab = new(global_env + tOffs) EnvTable(false);
    *global_env = '&'; vdp = global_env+1;
    memcpy((void *)vdp, (const void *)vardata, (size_t)varlen);
    *(vdp+varlen) = '\0'; global_len = varlen+1;
+   vdp = global_env + varlen+2;
+   memcpy((void *)vdp, (const void *)global_env, (size_t)varlen+2);
 
-// scan through the string looking for '&'
+// scan through the string looking for '&', hashing the name as we go
 //
    while(*vdp)
         {while(*vdp == '&') vdp++;
-         varname = vdp;
+         varname = vdp; hval = hInit;
 
-         while(*vdp && *vdp != '=' && *vdp != '&') vdp++;  // &....=
+         while(*vdp && *vdp != '=' && *vdp != '&')              // &....=
+              hval = (hval ^ (unsigned char)*vdp++) * hMult;
          if (!*vdp) break;
          if (*vdp == '&') continue;
-         *vdp = '\0';
-         varvalu = ++vdp;
+         *vdp++ = '\0';
+         varvalu = vdp;
 
-         while(*vdp && *vdp != '&') vdp++;  // &....=....&
-         varsave = *vdp; *vdp = '\0';
+         if ((vdp = strchr(vdp, '&'))) *vdp++ = '\0';  // &....=....&
+            else vdp = varvalu + strlen(varvalu);
 
          if (*varname && *varvalu)
-            env_Hash.Rep(varname, strdup(varvalu), 0, Hash_dofree);
-
-         *vdp = varsave; *(varvalu-1) = '=';
+            envTab->Insert(varname, varvalu, hval, false);
         }
    return;
 }
 
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdOucEnv::~XrdOucEnv()
+{
+   if (envTab)
+      {if (envTab->alone) delete envTab;
+          else envTab->~EnvTable();
+      }
+   if (global_env) free((void *)global_env);
+}
+
+/******************************************************************************/
+
+XrdOucEnv::EnvTable::~EnvTable()
+{
+   for (int i = 0; i < tSize; i++)
+       if (tab[i].owned) free((void *)tab[i].name);
+   if (tab != tInline) delete [] tab;
+}
+
 /******************************************************************************/
 /*                               D e l i m i t                                */
 /******************************************************************************/
@@ -93,6 +179,24 @@ char *XrdOucEnv::Delimit(char *value)
      return (char *)0;
 }
  
+/******************************************************************************/
+/* Private:                         F i n d                                   */
+/******************************************************************************/
+
+// Returns the slot holding the variable or the free slot where it would go
+//
+XrdOucEnv::EnvTable::Item *XrdOucEnv::EnvTable::Find(const char *varname,
+                                                     unsigned int hval)
+{
+   int mask = tSize-1, i = hval & mask;
+
+   while(tab[i].name)
+        {if (tab[i].hval == hval && !strcmp(tab[i].name, varname)) break;
+         i = (i+1) & mask;
+        }
+   return &tab[i];
+}
+
 /******************************************************************************/
 /*                                E x p o r t                                 */
 /******************************************************************************/
@@ -128,6 +232,31 @@ int XrdOucEnv::Export(const char *Var, int Val)
 }
 
 
+/******************************************************************************/
+/*                                   G e t                                    */
+/******************************************************************************/
+
+char *XrdOucEnv::Get(const char *varname)
+{
+   return (envTab ? envTab->Find(varname, EnvHash(varname))->value : 0);
+}
+
+/******************************************************************************/
+/* Private:                         G r o w                                   */
+/******************************************************************************/
+
+void XrdOucEnv::EnvTable::Grow()
+{
+   Item *oldTab = tab;
+   int   oldSize = tSize;
+
+   tSize *= 2;
+   tab = new Item[tSize]();
+   for (int i = 0; i < oldSize; i++)
+       if (oldTab[i].name) *Find(oldTab[i].name, oldTab[i].hval) = oldTab[i];
+   if (oldTab != tInline) delete [] oldTab;
+}
+
 /******************************************************************************/
 /*                                I m p o r t                                 */
 /******************************************************************************/
@@ -158,6 +287,30 @@ bool XrdOucEnv::Import( const char *var, long  &val )
   return true;
 }
 
+/******************************************************************************/
+/* Private:                       I n s e r t                                 */
+/******************************************************************************/
+
+// An existing variable is replaced (the last setting wins). We keep the table
+// at most three quarters full so that probe sequences stay short.
+//
+void XrdOucEnv::EnvTable::Insert(const char *name, char *value,
+                                 unsigned int hval, bool owned)
+{
+   Item *eP = Find(name, hval);
+
+   if (eP->name)
+      {if (eP->owned) free((void *)eP->name);}
+      else {if ((tNum+1)*4 > tSize*3) {Grow(); eP = Find(name, hval);}
+            tNum++;
+           }
+
+   eP->name  = name;
+   eP->value = value;
+   eP->hval  = hval;
+   eP->owned = owned;
+}
+
 /******************************************************************************/
 /*                                G e t I n t                                 */
 /******************************************************************************/
@@ -169,10 +322,27 @@ long XrdOucEnv::GetInt(const char *varname)
 // Retrieve a char* value from the Hash table and convert it into a long.
 // Return -999999999 if the varname does not exist
 //
-  if ((cP = env_Hash.Find(varname)) == NULL) return -999999999;
+  if ((cP = Get(varname)) == NULL) return -999999999;
   return atol(cP);
 }
 
+/******************************************************************************/
+/*                                   P u t                                    */
+/******************************************************************************/
+
+void XrdOucEnv::Put(const char *varname, const char *value)
+{
+   int nlen = strlen(varname)+1, vlen = strlen(value)+1;
+   char *bP = (char *)malloc(nlen+vlen);
+
+// The name and value share one allocation, the name coming first
+//
+   memcpy(bP, varname, nlen);
+   memcpy(bP+nlen, value, vlen);
+   if (!envTab) envTab = new EnvTable(true);
+   envTab->Insert(bP, bP+nlen, EnvHash(bP), true);
+}
+
 /******************************************************************************/
 /*                                P u t I n t                                 */
 /******************************************************************************/
@@ -183,7 +353,7 @@ void XrdOucEnv::PutInt(const char *varname, long value)
 //
   char stringValue[24];
   sprintf(stringValue, "%ld", value);
-  env_Hash.Rep(varname, strdup(stringValue), 0, Hash_dofree);
+  Put(varname, stringValue);
 }
 
 /******************************************************************************/
@@ -198,7 +368,7 @@ void *XrdOucEnv::GetPtr(const char *varname)
 
 // Retrieve the variable from the hash
 //
-   if ((cP = env_Hash.Find(varname)) == NULL) return (void *)0;
+   if ((cP = Get(varname)) == NULL) return (void *)0;
 
 // Verify that the string is not too long or too short
 //
@@ -241,5 +411,5 @@ void XrdOucEnv::PutPtr(const char *varname, void *value)
 
 // Replace the value in he hash
 //
-   env_Hash.Rep(varname, strdup(Buff), 0, Hash_dofree);
+   Put(varname, Buff);
 }
@@ -61,7 +61,7 @@ static bool  Import( const char *var, long  &val );
 // Get() returns the address of the string associated with the variable
 //       name. If no association exists, zero is returned.
 //
-       char *Get(const char *varname) {return env_Hash.Find(varname);}
+       char *Get(const char *varname);
 
 // GetInt() returns a long integer value. If the variable varname is not found
 //           in the hash table, return -999999999.       
@@ -75,10 +75,9 @@ static bool  Import( const char *var, long  &val );
 
 // Put() associates a string value with the a variable name. If one already
 //       exists, it is replaced. The passed value and variable strings are
-//       duplicated (value here, variable by env_Hash).
+//       duplicated.
 //
-       void  Put(const char *varname, const char *value)
-                {env_Hash.Rep((char *)varname, strdup(value), 0, Hash_dofree);}
+       void  Put(const char *varname, const char *value);
 
 // PutInt() puts a long integer value into the hash. Internally, the value gets
 //          converted into a char*
@@ -107,11 +106,17 @@ inline const XrdSecEntity *secEnv() const {return secEntity;}
        XrdOucEnv(const char *vardata=0, int vardlen=0, 
                  const XrdSecEntity *secent=0);
 
-      ~XrdOucEnv() {if (global_env) free((void *)global_env);}
+      ~XrdOucEnv();
 
 private:
 
-XrdOucHash<char> env_Hash;
+// The variables live in a table of our own rather than in an XrdOucHash. This
+// changed the layout of the object and Get() and Put() are no longer inline,
+// so code compiled against an older header must be rebuilt (libXrdUtils.so.4).
+//
+struct EnvTable;
+
+EnvTable *envTab;
 const XrdSecEntity *secEntity;
 char *global_env;
 int   global_len;
@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <sys/mman.h>
 #include <sys/statvfs.h>
 
 #include "XrdCl/XrdClConstants.hh"
@@ -60,9 +62,9 @@ void *PurgeThread(void*)
    return 0;
 }
 
-void *ProcessWriteTaskThread(void*)
+void *ProcessWriteTaskThread(void* arg)
 {
-   Cache::GetInstance().ProcessWriteTasks();
+   Cache::GetInstance().ProcessWriteTasks((int) (long) arg);
    return 0;
 }
 
@@ -103,9 +105,11 @@ XrdOucCache *XrdOucGetCache(XrdSysLogger *logger,
    {
       pthread_t tid;
 
-      for (int wti = 0; wti < instance.RefConfiguration().m_wqueue_threads; ++wti)
+      instance.SetWriteQLanes(instance.RefConfiguration().m_wqueue_threads);
+
+      for (long wti = 0; wti < instance.RefConfiguration().m_wqueue_threads; ++wti)
       {
-         XrdSysThread::Run(&tid, ProcessWriteTaskThread, 0, 0, "XrdPfc WriteTasks ");
+         XrdSysThread::Run(&tid, ProcessWriteTaskThread, (void*) wti, 0, "XrdPfc WriteTasks ");
       }
 
       if (instance.RefConfiguration().m_prefetch_max_blocks > 0)
@@ -187,9 +191,19 @@ Cache::Cache(XrdSysLogger *logger, XrdOucEnv *env) :
    m_gstream(0),
    m_prefetch_condVar(0),
    m_prefetch_enabled(false),
+   m_RAM_shard_next(0),
    m_RAM_used(0),
+   m_RAM_held(0),
    m_RAM_write_queue(0),
    m_RAM_std_size(0),
+   m_RAM_pool_hits(0),
+   m_RAM_pool_miss(0),
+   m_RAM_pool_full(0),
+   m_disk_write_ops(0),
+   m_disk_write_blks(0),
+   m_disk_write_usec(0),
+   m_RAM_slab_ptr(0),
+   m_RAM_slab_left(0),
    m_isClient(false),
    m_in_purge(false),
    m_active_cond(0),
@@ -249,29 +263,36 @@ void Cache::AddWriteTask(Block* b, bool fromRead)
 {
    TRACE(Dump, "AddWriteTask() bOff=" <<  b->m_offset);
 
-   {
-      XrdSysMutexHelper lock(&m_RAM_mutex);
-      m_RAM_write_queue += b->get_size();
-   }
+   m_RAM_write_queue += b->get_size();
 
    m_writeQ.condVar.Lock();
+   std::list<Block*> &lane = m_writeQ.LaneFor(b->m_file);
    if (fromRead)
-      m_writeQ.queue.push_back(b);
+      lane.push_back(b);
    else
-      m_writeQ.queue.push_front(b);
+      lane.push_front(b);
    m_writeQ.size++;
    m_writeQ.condVar.Signal();
    m_writeQ.condVar.UnLock();
 }
 
+void Cache::SetWriteQLanes(int n_lanes)
+{
+   XrdSysCondVarHelper lock(&m_writeQ.condVar);
+
+   // Only done before the writer threads are started, queue is still empty.
+   m_writeQ.lanes.resize(std::max(n_lanes, 1));
+}
+
 void Cache::RemoveWriteQEntriesFor(File *file)
 {
    std::list<Block*> removed_blocks;
    long long         sum_size = 0;
 
    m_writeQ.condVar.Lock();
-   std::list<Block*>::iterator i = m_writeQ.queue.begin();
-   while (i != m_writeQ.queue.end())
+   std::list<Block*> &lane = m_writeQ.LaneFor(file);
+   std::list<Block*>::iterator i = lane.begin();
+   while (i != lane.end())
    {
       if ((*i)->m_file == file)
       {
@@ -279,7 +300,7 @@ void Cache::RemoveWriteQEntriesFor(File *file)
          std::list<Block*>::iterator j = i++;
          removed_blocks.push_back(*j);
          sum_size += (*j)->get_size();
-         m_writeQ.queue.erase(j);
+         lane.erase(j);
          --m_writeQ.size;
       }
       else
@@ -289,15 +310,21 @@ void Cache::RemoveWriteQEntriesFor(File *file)
    }
    m_writeQ.condVar.UnLock();
 
-   {
-      XrdSysMutexHelper lock(&m_RAM_mutex);
-      m_RAM_write_queue -= sum_size;
-   }
+   m_RAM_write_queue -= sum_size;
 
    file->BlocksRemovedFromWriteQ(removed_blocks);
 }
 
-void Cache::ProcessWriteTasks()
+namespace
+{
+   bool WriteOrder(const Block *a, const Block *b)
+   {
+      if (a->m_file != b->m_file) return a->m_file < b->m_file;
+      return a->m_offset < b->m_offset;
+   }
+}
+
+void Cache::ProcessWriteTasks(int lane)
 {
    std::vector<Block*> blks_to_write(m_configuration.m_wqueue_blocks);
 
@@ -309,16 +336,24 @@ void Cache::ProcessWriteTasks()
          m_writeQ.condVar.Wait();
       }
 
-      // MT -- optimize to pop several blocks if they are available (or swap the list).
-      // This makes sense especially for smallish block sizes.
+      // Serve our own lane; when it is empty help out with the longest one.
+
+      std::list<Block*> *queue = &m_writeQ.lanes[lane % m_writeQ.lanes.size()];
+      if (queue->empty())
+      {
+         for (auto &l : m_writeQ.lanes)
+         {
+            if (l.size() > queue->size()) queue = &l;
+         }
+      }
 
-      int       n_pushed = std::min(m_writeQ.size, m_configuration.m_wqueue_blocks);
+      int       n_pushed = std::min((int) queue->size(), m_configuration.m_wqueue_blocks);
       long long sum_size = 0;
 
       for (int bi = 0; bi < n_pushed; ++bi)
       {
-         Block* block = m_writeQ.queue.front();
-         m_writeQ.queue.pop_front();
+         Block* block = queue->front();
+         queue->pop_front();
          m_writeQ.writes_between_purges += block->get_size();
          sum_size += block->get_size();
 
@@ -330,78 +365,246 @@ void Cache::ProcessWriteTasks()
 
       m_writeQ.condVar.UnLock();
 
-      {
-         XrdSysMutexHelper lock(&m_RAM_mutex);
-         m_RAM_write_queue -= sum_size;
-      }
+      m_RAM_write_queue -= sum_size;
 
-      for (int bi = 0; bi < n_pushed; ++bi)
+      // Group the blocks by file and offset so that each file gets a single
+      // call with adjacent blocks merged into as few writes as possible.
+
+      std::sort(blks_to_write.begin(), blks_to_write.begin() + n_pushed, WriteOrder);
+
+      auto t_beg = std::chrono::steady_clock::now();
+      int  n_ops = 0;
+
+      for (int bi = 0; bi < n_pushed; )
       {
-         Block* block = blks_to_write[bi];
+         File *file = blks_to_write[bi]->m_file;
+         int   be   = bi + 1;
 
-         block->m_file->WriteBlockToDisk(block);
+         while (be < n_pushed && blks_to_write[be]->m_file == file) ++be;
+
+         n_ops += file->WriteBlocksToDisk(&blks_to_write[bi], be - bi);
+         bi = be;
       }
+
+      auto t_end = std::chrono::steady_clock::now();
+
+      m_disk_write_ops  += n_ops;
+      m_disk_write_blks += n_pushed;
+      m_disk_write_usec += std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_beg).count();
    }
 }
 
 //==============================================================================
 
-char* Cache::RequestRAM(long long size)
+namespace
 {
-   static const size_t s_block_align = sysconf(_SC_PAGESIZE);
-
-   bool  std_size = (size == m_configuration.m_bufferSize);
+// Per-thread cache of standard-sized RAM blocks. Most blocks are released by
+// the thread that later requests one again (prefetch, read handlers, writers)
+// so this avoids touching the shared pool at all. Blocks still held when the
+// thread exits are handed back to the pool.
+struct RAMThreadCache
+{
+   static const int s_max_blocks = 4;
 
-   m_RAM_mutex.Lock();
+   char *m_blocks[s_max_blocks];
+   int   m_n_blocks;
+   int   m_shard;
 
-   long long total = m_RAM_used + size;
+   RAMThreadCache() : m_n_blocks(0), m_shard(-1) {}
 
-   if (total <= m_configuration.m_RamAbsAvailable)
+   ~RAMThreadCache()
    {
-      m_RAM_used = total;
-      if (std_size && m_RAM_std_size > 0)
-      {
-         char *buf = m_RAM_std_blocks.back();
-         m_RAM_std_blocks.pop_back();
-         --m_RAM_std_size;
+      if (m_n_blocks > 0)
+         Cache::GetInstance().ReleaseRAMBlocks(m_blocks, m_n_blocks);
+   }
+};
 
-         m_RAM_mutex.UnLock();
+thread_local RAMThreadCache t_RAM_cache;
+}
 
+char* Cache::RequestRAM(long long size)
+{
+   // Pooled blocks are already counted in m_RAM_held so taking one can not
+   // exceed the limit. Only new allocations are checked against it.
+   if (size == m_configuration.m_bufferSize)
+   {
+      char *buf = GetRAMBlock();
+      if (buf)
+      {
+         m_RAM_std_size.fetch_sub(1, std::memory_order_relaxed);
+         m_RAM_pool_hits.fetch_add(1, std::memory_order_relaxed);
+         m_RAM_used.fetch_add(size, std::memory_order_relaxed);
          return buf;
       }
-      else
+      m_RAM_pool_miss.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   char *buf = AllocRAMBlock(size);
+   if ( ! buf)
+   {
+      // Report out of mem? Probably should report it at least the first time,
+      // then periodically.
+      m_RAM_pool_full.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+   }
+   m_RAM_used.fetch_add(size, std::memory_order_relaxed);
+   return buf;
+}
+
+void Cache::ReleaseRAM(char* buf, long long size)
+{
+   m_RAM_used -= size;
+
+   if (size == m_configuration.m_bufferSize && PutRAMBlock(buf))
+      return;
+
+   free(buf);
+   m_RAM_held -= size;
+}
+
+void Cache::ReleaseRAMBlocks(char** bufs, int n)
+{
+   RAMThreadCache &tc = t_RAM_cache;
+   RAMShard       &sh = m_RAM_shards[tc.m_shard < 0 ? 0 : tc.m_shard];
+
+   XrdSysMutexHelper lock(&sh.mutex);
+   sh.blocks.insert(sh.blocks.end(), bufs, bufs + n);
+}
+
+bool Cache::ReserveRAM(long long size)
+{
+   long long held = m_RAM_held.load(std::memory_order_relaxed);
+   do
+   {
+      if (held + size > m_configuration.m_RamAbsAvailable)
+         return false;
+   } while ( ! m_RAM_held.compare_exchange_weak(held, held + size, std::memory_order_relaxed));
+   return true;
+}
+
+char* Cache::AllocRAMBlock(long long size)
+{
+   static const size_t s_block_align = sysconf(_SC_PAGESIZE);
+   static const long long s_huge_page = 2 * 1024 * 1024;
+   static const int       s_slab_blocks = 16;
+
+   char *buf;
+
+   if (m_configuration.m_RamHugePages && size == m_configuration.m_bufferSize)
+   {
+      // Standard-sized blocks are carved out of large slabs that are backed by
+      // (transparent) huge pages. Slab memory is never returned to the system,
+      // released blocks always go back to the pool. The whole slab is counted
+      // against the RAM limit when it is allocated.
+      XrdSysMutexHelper lock(&m_RAM_slab_mutex);
+
+      if (m_RAM_slab_left < size)
       {
-         m_RAM_mutex.UnLock();
-         char *buf;
-         if (posix_memalign((void**) &buf, s_block_align, (size_t) size))
+         long long slab_size = (s_slab_blocks * size + s_huge_page - 1) / s_huge_page * s_huge_page;
+         if ( ! ReserveRAM(slab_size))
          {
-            // Report out of mem? Probably should report it at least the first time,
-            // then periodically.
             return 0;
          }
-         return buf;
+         if (posix_memalign((void**) &m_RAM_slab_ptr, s_huge_page, (size_t) slab_size))
+         {
+            m_RAM_held     -= slab_size;
+            m_RAM_slab_ptr  = 0;
+            m_RAM_slab_left = 0;
+            return 0;
+         }
+#ifdef MADV_HUGEPAGE
+         madvise(m_RAM_slab_ptr, slab_size, MADV_HUGEPAGE);
+#endif
+         m_RAM_slab_left = slab_size;
       }
+      buf = m_RAM_slab_ptr;
+      m_RAM_slab_ptr  += size;
+      m_RAM_slab_left -= size;
+      return buf;
    }
-   m_RAM_mutex.UnLock();
-   return 0;
+
+   if ( ! ReserveRAM(size))
+   {
+      return 0;
+   }
+   if (posix_memalign((void**) &buf, s_block_align, (size_t) size))
+   {
+      m_RAM_held -= size;
+      return 0;
+   }
+   return buf;
 }
 
-void Cache::ReleaseRAM(char* buf, long long size)
+char* Cache::GetRAMBlock()
 {
-   bool std_size = (size == m_configuration.m_bufferSize);
+   RAMThreadCache &tc = t_RAM_cache;
+   char *buf = 0;
+
+   if (tc.m_n_blocks > 0)
    {
-      XrdSysMutexHelper lock(&m_RAM_mutex);
+      return tc.m_blocks[--tc.m_n_blocks];
+   }
+
+   if (tc.m_shard < 0)
+      tc.m_shard = m_RAM_shard_next.fetch_add(1, std::memory_order_relaxed) % s_RAM_n_shards;
 
-      m_RAM_used -= size;
+   // Try our own shard first, then steal from any shard that is not busy. If
+   // that finds nothing wait for the busy ones rather than allocate more.
+   int busy[s_RAM_n_shards], n_busy = 0;
 
-      if (std_size && m_RAM_std_size < m_configuration.m_RamKeepStdBlocks)
+   for (int i = 0; i < s_RAM_n_shards && ! buf; ++i)
+   {
+      int       si = (tc.m_shard + i) % s_RAM_n_shards;
+      RAMShard &sh = m_RAM_shards[si];
+      if (i == 0) sh.mutex.Lock();
+      else if ( ! sh.mutex.CondLock()) { busy[n_busy++] = si; continue; }
+      if ( ! sh.blocks.empty())
       {
-         m_RAM_std_blocks.push_back(buf);
-         ++m_RAM_std_size;
-         return;
+         buf = sh.blocks.back();
+         sh.blocks.pop_back();
       }
+      sh.mutex.UnLock();
    }
-   free(buf);
+
+   for (int i = 0; i < n_busy && ! buf; ++i)
+   {
+      RAMShard &sh = m_RAM_shards[busy[i]];
+      XrdSysMutexHelper lock(&sh.mutex);
+      if ( ! sh.blocks.empty())
+      {
+         buf = sh.blocks.back();
+         sh.blocks.pop_back();
+      }
+   }
+   return buf;
+}
+
+bool Cache::PutRAMBlock(char* buf)
+{
+   // Slab blocks can not be freed so they are always kept. Kept blocks stay
+   // counted in m_RAM_held wherever they are parked.
+   if (m_RAM_std_size.fetch_add(1, std::memory_order_relaxed) >= m_configuration.m_RamKeepStdBlocks &&
+       ! m_configuration.m_RamHugePages)
+   {
+      m_RAM_std_size.fetch_sub(1, std::memory_order_relaxed);
+      return false;
+   }
+
+   RAMThreadCache &tc = t_RAM_cache;
+
+   if (tc.m_n_blocks < RAMThreadCache::s_max_blocks)
+   {
+      tc.m_blocks[tc.m_n_blocks++] = buf;
+      return true;
+   }
+
+   if (tc.m_shard < 0)
+      tc.m_shard = m_RAM_shard_next.fetch_add(1, std::memory_order_relaxed) % s_RAM_n_shards;
+
+   RAMShard &sh = m_RAM_shards[tc.m_shard];
+   XrdSysMutexHelper lock(&sh.mutex);
+   sh.blocks.push_back(buf);
+   return true;
 }
 
 File* Cache::GetFile(const std::string& path, IO* io, long long off, long long filesize)
@@ -739,12 +942,13 @@ File* Cache::GetNextFileToPrefetch()
 void Cache::Prefetch()
 {
    const long long limit_RAM = m_configuration.m_RamAbsAvailable * 7 / 10;
+   const long long limit_WQ  = m_configuration.m_RamAbsAvailable * 3 / 10;
 
    while (true)
    {
-      m_RAM_mutex.Lock();
-      bool doPrefetch = (m_RAM_used < limit_RAM);
-      m_RAM_mutex.UnLock();
+      // Back off when the disk does not keep up with the write queue.
+      bool doPrefetch = (m_RAM_used.load(std::memory_order_relaxed) < limit_RAM &&
+                         m_RAM_write_queue.load(std::memory_order_relaxed) < limit_WQ);
 
       if (doPrefetch)
       {
@@ -17,10 +17,12 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
 //----------------------------------------------------------------------------------
+#include <atomic>
 #include <string>
 #include <list>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "Xrd/XrdScheduler.hh"
 #include "XrdVersion.hh"
@@ -101,6 +103,7 @@ struct Configuration
    long long m_bufferSize;              //!< prefetch buffer size, default 1MB
    long long m_RamAbsAvailable;         //!< available from configuration
    int       m_RamKeepStdBlocks;        //!< number of standard-sized blocks kept after release
+   bool      m_RamHugePages;            //!< allocate standard-sized blocks from huge-page backed slabs
    int       m_wqueue_blocks;           //!< maximum number of blocks written per write-queue loop
    int       m_wqueue_threads;          //!< number of threads writing blocks to disk
    int       m_prefetch_max_blocks;     //!< maximum number of blocks to prefetch per file
@@ -360,12 +363,34 @@ public:
 
    //---------------------------------------------------------------------
    //! Separate task which writes blocks from ram to disk.
+   //! Each writer thread owns one lane of the write queue and only
+   //! takes blocks from other lanes when its own lane is empty.
    //---------------------------------------------------------------------
-   void ProcessWriteTasks();
+   void ProcessWriteTasks(int lane);
 
+   //---------------------------------------------------------------------
+   //! Size the write queue, one lane per writer thread.
+   //---------------------------------------------------------------------
+   void SetWriteQLanes(int n_lanes);
+
+   //---------------------------------------------------------------------
+   //! Allocate a RAM block, returns 0 if RAM limit has been reached.
+   //! Standard-sized blocks are taken from a per-thread cache or from
+   //! the sharded block pool before new memory is allocated. Pooled
+   //! blocks and huge-page slabs count against the limit.
+   //---------------------------------------------------------------------
    char* RequestRAM(long long size);
+
+   //---------------------------------------------------------------------
+   //! Release a RAM block obtained via RequestRAM().
+   //---------------------------------------------------------------------
    void  ReleaseRAM(char* buf, long long size);
 
+   //---------------------------------------------------------------------
+   //! Return standard-sized blocks from a thread's cache to the pool.
+   //---------------------------------------------------------------------
+   void  ReleaseRAMBlocks(char** bufs, int n);
+
    void RegisterPrefetchFile(File*);
    void DeRegisterPrefetchFile(File*);
 
@@ -421,22 +446,54 @@ private:
    XrdSysCondVar m_prefetch_condVar;        //!< lock for vector of prefetching files
    bool          m_prefetch_enabled;        //!< set to true when prefetching is enabled
 
-   XrdSysMutex m_RAM_mutex;                 //!< lock for allcoation of RAM blocks
-   long long   m_RAM_used;
-   long long   m_RAM_write_queue;
-   std::list<char*> m_RAM_std_blocks;       //!< A list of blocks of standard size, to be reused.
-   int              m_RAM_std_size;
+   bool  ReserveRAM(long long size);
+   char* AllocRAMBlock(long long size);
+   char* GetRAMBlock();
+   bool  PutRAMBlock(char* buf);
+
+   struct RAMShard
+   {
+      XrdSysMutex        mutex;
+      std::vector<char*> blocks;            //!< capacity reserved at config time
+   };
+
+   static const int       s_RAM_n_shards = 8;
+
+   RAMShard               m_RAM_shards[s_RAM_n_shards]; //!< pool of standard-sized blocks to be reused
+   std::atomic<int>       m_RAM_shard_next;  //!< round-robin assignment of threads to shards
+   std::atomic<long long> m_RAM_used;        //!< bytes in blocks handed out by RequestRAM()
+   std::atomic<long long> m_RAM_held;        //!< bytes allocated, including pooled blocks and slabs
+   std::atomic<long long> m_RAM_write_queue;
+   std::atomic<int>       m_RAM_std_size;    //!< number of standard-sized blocks held in the pool
+   std::atomic<long long> m_RAM_pool_hits;   //!< standard-sized requests served from the pool
+   std::atomic<long long> m_RAM_pool_miss;   //!< standard-sized requests that had to allocate
+   std::atomic<long long> m_RAM_pool_full;   //!< requests refused because the RAM limit was reached
+
+   std::atomic<long long> m_disk_write_ops;  //!< number of write calls issued by the writer threads
+   std::atomic<long long> m_disk_write_blks; //!< number of blocks written by the writer threads
+   std::atomic<long long> m_disk_write_usec; //!< time spent in write calls (microseconds)
+
+   XrdSysMutex m_RAM_slab_mutex;             //!< lock for carving blocks from huge-page slabs
+   char       *m_RAM_slab_ptr;
+   long long   m_RAM_slab_left;
 
    bool        m_isClient;                  //!< True if running as client
 
    struct WriteQ
    {
-      WriteQ() : condVar(0), writes_between_purges(0), size(0) {}
+      WriteQ() : condVar(0), lanes(1), writes_between_purges(0), size(0) {}
 
       XrdSysCondVar     condVar;      //!< write list condVar
-      std::list<Block*> queue;        //!< container
+      std::vector<std::list<Block*> > lanes; //!< containers, blocks of a file always go to the same lane
       long long         writes_between_purges; //!< upper bound on amount of bytes written between two purge passes
-      int               size;         //!< current size of write queue
+      int               size;         //!< current size of write queue (all lanes)
+
+      std::list<Block*>& LaneFor(const File *f)
+      {
+         unsigned long long h = (unsigned long long) (size_t) f;
+         h = (h >> 4) * 0x9E3779B97F4A7C15ULL;
+         return lanes[(h >> 32) % lanes.size()];
+      }
    };
 
    WriteQ m_writeQ;
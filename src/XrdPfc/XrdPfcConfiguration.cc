@@ -39,6 +39,7 @@ Configuration::Configuration() :
    m_bufferSize(256*1024),
    m_RamAbsAvailable(0),
    m_RamKeepStdBlocks(0),
+   m_RamHugePages(false),
    m_wqueue_blocks(16),
    m_wqueue_threads(4),
    m_prefetch_max_blocks(10),
@@ -450,6 +451,16 @@ bool Cache::Config(const char *config_filename, const char *parameters)
    }
    // Setup number of standard-size blocks not released back to the system to 5% of total RAM.
    m_configuration.m_RamKeepStdBlocks = (m_configuration.m_RamAbsAvailable / m_configuration.m_bufferSize + 1) * 5 / 100;
+
+   // Size the block pool shards so that releasing a block does not allocate. With huge pages
+   // all standard-sized blocks are retained so allow for an even share of all of them.
+   {
+      long long n_per_shard = m_configuration.m_RamKeepStdBlocks;
+      if (m_configuration.m_RamHugePages)
+         n_per_shard += m_configuration.m_RamAbsAvailable / m_configuration.m_bufferSize / s_RAM_n_shards;
+      for (int i = 0; i < s_RAM_n_shards; ++i)
+         m_RAM_shards[i].blocks.reserve(n_per_shard);
+   }
    
 
    // Set tracing to debug if this is set in environment
@@ -477,7 +488,7 @@ bool Cache::Config(const char *config_filename, const char *parameters)
                       "       pfc.cschk %s uvkeep %s\n"
                       "       pfc.blocksize %lld\n"
                       "       pfc.prefetch %d\n"
-                      "       pfc.ram %.fg\n"
+                      "       pfc.ram %.fg%s\n"
                       "       pfc.writequeue %d %d\n"
                       "       # Total available disk: %lld\n"
                       "       pfc.diskusage %lld %lld files %lld %lld %lld purgeinterval %d purgecoldfiles %d\n"
@@ -489,7 +500,7 @@ bool Cache::Config(const char *config_filename, const char *parameters)
                       csc[int(m_configuration.m_cs_Chk)], uvk,
                       m_configuration.m_bufferSize,
                       m_configuration.m_prefetch_max_blocks,
-                      rg,
+                      rg, m_configuration.m_RamHugePages ? " hugepages" : "",
                       m_configuration.m_wqueue_blocks, m_configuration.m_wqueue_threads,
                       sP.Total,
                       m_configuration.m_diskUsageLWM, m_configuration.m_diskUsageHWM,
@@ -762,6 +773,16 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
       {
          return false;
       }
+      const char *val = cwg.GetWord();
+      if (val && *val)
+      {
+         if (strcmp(val, "hugepages"))
+         {
+            m_log.Emsg("Config", "Error: pfc.ram unknown option", val);
+            return false;
+         }
+         m_configuration.m_RamHugePages = true;
+      }
    }
    else if ( part == "writequeue")
    {
@@ -969,44 +969,119 @@ void File::WriteBlockToDisk(Block* b)
       return;
    }
 
-   const int blk_idx =  (b->m_offset - m_offset) / m_cfi.GetBufferSize();
+   BlocksWrittenToDisk(&b, 1);
+}
 
-   // Set written bit.
-   TRACEF(Dump, "WriteToDisk() success set bit for block " <<  b->m_offset << " size=" <<  size);
+//------------------------------------------------------------------------------
 
-   bool schedule_sync = false;
+int File::WriteBlocksToDisk(Block** blks, int n_blks)
+{
+   // Blocks with checksums need pgWrite(), there is no vector version of it.
+   if (n_blks == 1 || m_cfi.IsCkSumCache())
    {
-      XrdSysCondVarHelper _lck(m_state_cond);
+      for (int i = 0; i < n_blks; ++i)
+         WriteBlockToDisk(blks[i]);
+      return n_blks;
+   }
 
-      m_cfi.SetBitWritten(blk_idx);
+   // Hand each run of adjacent blocks to the oss as one vector write, so that
+   // every WriteV() is a single pwritev() and can be counted as one disk write.
+   // Blocks come sorted by offset.
+   std::vector<XrdOucIOVec> iov(n_blks);
+   int n_ops = 0;
 
-      if (b->m_prefetch)
+   for (int bi = 0; bi < n_blks; )
+   {
+      long long size = 0;
+      int       be   = bi;
+
+      do
       {
-         m_cfi.SetBitPrefetch(blk_idx);
-      }
-      if (b->req_cksum_net() && ! b->has_cksums() && m_cfi.IsCkSumNet())
+         XrdOucIOVec &v = iov[be - bi];
+         v.offset = blks[be]->m_offset - m_offset;
+         v.size   = blks[be]->get_size();
+         v.info   = 0;
+         v.data   = blks[be]->get_buff();
+         size += v.size;
+         ++be;
+      } while (be < n_blks && blks[be]->m_offset == blks[bi]->m_offset + size);
+
+      ssize_t retval = m_data_file->WriteV(iov.data(), be - bi);
+      ++n_ops;
+
+      if (retval < size)
       {
-         m_cfi.ResetCkSumNet();
-      }
+         if (retval < 0)
+         {
+            GetLog()->Emsg("WriteToDisk()", -retval, "write blocks to disk", GetLocalPath().c_str());
+         }
+         else
+         {
+            TRACEF(Error, "WriteToDisk() incomplete vector write ret=" << retval << " (should be " << size << ")");
+         }
 
-      dec_ref_count(b);
+         XrdSysCondVarHelper _lck(m_state_cond);
 
-      // Set synced bit or stash block index if in actual sync.
-      // Synced state is only written out to cinfo file when data file is synced.
-      if (m_in_sync)
-      {
-         m_writes_during_sync.push_back(blk_idx);
+         for (int i = bi; i < be; ++i)
+            dec_ref_count(blks[i]);
       }
       else
       {
-         m_cfi.SetBitSynced(blk_idx);
-         ++m_non_flushed_cnt;
-         if (m_non_flushed_cnt >= Cache::GetInstance().RefConfiguration().m_flushCnt &&
-             ! m_in_shutdown)
+         BlocksWrittenToDisk(&blks[bi], be - bi);
+      }
+
+      bi = be;
+   }
+
+   return n_ops;
+}
+
+//------------------------------------------------------------------------------
+
+void File::BlocksWrittenToDisk(Block** blks, int n_blks)
+{
+   bool schedule_sync = false;
+   {
+      XrdSysCondVarHelper _lck(m_state_cond);
+
+      for (int i = 0; i < n_blks; ++i)
+      {
+         Block     *b       = blks[i];
+         const int  blk_idx = (b->m_offset - m_offset) / m_cfi.GetBufferSize();
+
+         // Set written bit.
+         TRACEF(Dump, "WriteToDisk() success set bit for block " <<  b->m_offset << " size=" <<  b->get_size());
+
+         m_cfi.SetBitWritten(blk_idx);
+
+         if (b->m_prefetch)
          {
-            schedule_sync     = true;
-            m_in_sync         = true;
-            m_non_flushed_cnt = 0;
+            m_cfi.SetBitPrefetch(blk_idx);
+         }
+         if (b->req_cksum_net() && ! b->has_cksums() && m_cfi.IsCkSumNet())
+         {
+            m_cfi.ResetCkSumNet();
+         }
+
+         dec_ref_count(b);
+
+         // Set synced bit or stash block index if in actual sync.
+         // Synced state is only written out to cinfo file when data file is synced.
+         if (m_in_sync)
+         {
+            m_writes_during_sync.push_back(blk_idx);
+         }
+         else
+         {
+            m_cfi.SetBitSynced(blk_idx);
+            ++m_non_flushed_cnt;
+            if (m_non_flushed_cnt >= Cache::GetInstance().RefConfiguration().m_flushCnt &&
+                ! m_in_shutdown)
+            {
+               schedule_sync     = true;
+               m_in_sync         = true;
+               m_non_flushed_cnt = 0;
+            }
          }
       }
    }
@@ -211,6 +211,12 @@ public:
    void ProcessBlockResponse(BlockResponseHandler* brh, int res);
    void WriteBlockToDisk(Block* b);
 
+   //----------------------------------------------------------------------
+   //! Write blocks of this file, sorted by offset, with as few calls as
+   //! possible. Returns the number of write calls that were issued.
+   //----------------------------------------------------------------------
+   int  WriteBlocksToDisk(Block** blks, int n_blks);
+
    void Prefetch();
 
    float GetPrefetchScore() const;
@@ -364,6 +370,8 @@ private:
 
    void inc_ref_count(Block*);
    void dec_ref_count(Block*);
+
+   void BlocksWrittenToDisk(Block** blks, int n_blks);
    void free_block(Block*);
 
    bool select_current_io_or_disable_prefetching(bool skip_current);
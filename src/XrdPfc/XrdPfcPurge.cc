@@ -7,6 +7,7 @@
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOss/XrdOssAt.hh"
 #include "XrdSys/XrdSysTrace.hh"
+#include "XrdXrootd/XrdXrootdGStream.hh"
 
 using namespace XrdPfc;
 
@@ -649,15 +650,37 @@ void Cache::ResourceMonitorHeartBeat()
       // - available / used disk space (files usage calculated elsewhere (maybe))
 
       // - RAM usage
-      {  XrdSysMutexHelper lck(&m_RAM_mutex);
-         X.MemUsed   = m_RAM_used;
-         X.MemWriteQ = m_RAM_write_queue;
-      }
+      X.MemUsed     = m_RAM_used;
+      X.MemWriteQ   = m_RAM_write_queue;
       // - files opened / closed etc
 
       // do estimate of available space
       S.UnLock();
 
+      // - RAM block pool and disk writes; OucCacheStats is a public struct
+      //   so these are not part of it and go out on the g-stream instead.
+      if (m_gstream)
+      {
+         int write_queue_blks;
+         {
+            XrdSysCondVarHelper lock(&m_writeQ.condVar);
+            write_queue_blks = m_writeQ.size;
+         }
+
+         char buf[512];
+         int  len = snprintf(buf, 512, "{\"event\":\"mem_disk_stats\","
+                              "\"ram_held\":%lld,\"pool_hits\":%lld,\"pool_miss\":%lld,\"pool_full\":%lld,"
+                              "\"wq_blks\":%d,\"dwr_ops\":%lld,\"dwr_blks\":%lld,\"dwr_us\":%lld}",
+                              m_RAM_held.load(), m_RAM_pool_hits.load(), m_RAM_pool_miss.load(), m_RAM_pool_full.load(),
+                              write_queue_blks,
+                              m_disk_write_ops.load(), m_disk_write_blks.load(), m_disk_write_usec.load()
+         );
+         if (len >= 512 || ! m_gstream->Insert(buf, len + 1))
+         {
+            TRACE(Error, "Failed g-stream insertion of mem_disk_stats record, len=" << len);
+         }
+      }
+
       // if needed, schedule purge in a different thread.
       // purge is:
       // - deep scan + gather FSPurgeState
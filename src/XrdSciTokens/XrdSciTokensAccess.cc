@@ -6,6 +6,7 @@
 #include "XrdSys/XrdSysLogger.hh"
 #include "XrdVersion.hh"
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -150,14 +151,14 @@ struct MapRule
         //std::cerr << "Making a rule {sub=" << sub << ", path=" << path_prefix << ", group=" << group << ", result=" << name << "}" << std::endl;
     }
 
-    const std::string match(const std::string sub,
-                              const std::string req_path,
-                              const std::vector<std::string> groups) const
+    const std::string match(const std::string &sub,
+                            const char *req_path,
+                            const std::vector<std::string> &groups) const
     {
         if (!m_sub.empty() && sub != m_sub) {return "";}
 
         if (!m_path_prefix.empty() &&
-            strncmp(req_path.c_str(), m_path_prefix.c_str(), m_path_prefix.size()))
+            strncmp(req_path, m_path_prefix.c_str(), m_path_prefix.size()))
         {
             return "";
         }
@@ -205,43 +206,131 @@ struct IssuerConfig
     const std::vector<MapRule> m_map_rules;
 };
 
+// A character trie of the path prefixes granted by a token.  Each node holds
+// the set of operations for which the prefix ending there is authorized, and
+// the set authorized anywhere below it, so a request is decided by a single
+// walk down the requested path that stops as soon as nothing can match.
+class PathTrie
+{
+public:
+    PathTrie() : m_nodes(1) {}
+
+    void insert(Access_Operation oper, const std::string &prefix)
+    {
+        const unsigned mask = 1u << oper;
+        size_t idx = 0;
+        m_nodes[idx].m_below |= mask;
+        for (const char c : prefix) {
+            idx = child(idx, c);
+            m_nodes[idx].m_below |= mask;
+        }
+        m_nodes[idx].m_ops |= mask;
+    }
+
+    bool match(Access_Operation oper, const char *path) const
+    {
+        const unsigned mask = 1u << oper;
+        size_t idx = 0;
+        while (m_nodes[idx].m_below & mask) {
+            if (m_nodes[idx].m_ops & mask) {return true;}
+            if (!*path) {break;}
+            const auto &kids = m_nodes[idx].m_children;
+            const char c = *path++;
+            idx = 0;
+            for (const auto &kid : kids) {
+                if (kid.first == c) {idx = kid.second; break;}
+            }
+            if (!idx) {break;}
+        }
+        return false;
+    }
+
+    size_t size() const {return m_nodes.size();}
+
+private:
+    struct Node
+    {
+        unsigned m_ops{0};
+        unsigned m_below{0};
+        std::vector<std::pair<char, size_t>> m_children;
+    };
+
+    size_t child(size_t idx, char c)
+    {
+        for (const auto &kid : m_nodes[idx].m_children) {
+            if (kid.first == c) {return kid.second;}
+        }
+        const size_t next = m_nodes.size();
+        m_nodes[idx].m_children.emplace_back(c, next);
+        m_nodes.emplace_back();
+        return next;
+    }
+
+    std::vector<Node> m_nodes;
+};
+
+// FNV-1a hash of the serialized token; used to pick the cache shard and as
+// the cache key (the full token is still compared on a hit).
+inline uint64_t HashToken(const char *token)
+{
+    uint64_t hval = 14695981039346656037ULL;
+    while (*token) {
+        hval ^= static_cast<unsigned char>(*token++);
+        hval *= 1099511628211ULL;
+    }
+    return hval;
+}
+
 }
 
 
 class XrdAccRules
 {
 public:
-    XrdAccRules(uint64_t expiry_time, const std::string &username, const std::string &token_subject,
+    XrdAccRules(const char *token, uint64_t expiry_time, const std::string &username, const std::string &token_subject,
         const std::string &issuer, const std::vector<MapRule> &rules, const std::vector<std::string> &groups) :
+        m_token(token),
         m_expiry_time(expiry_time),
         m_username(username),
         m_token_subject(token_subject),
         m_issuer(issuer),
         m_map_rules(rules),
         m_groups(groups)
-    {}
-
-    ~XrdAccRules() {}
-
-    bool apply(Access_Operation oper, std::string path) {
-        for (const auto & rule : m_rules) {
-            if ((oper == rule.first) && !path.compare(0, rule.second.size(), rule.second, 0, rule.second.size())) {
-                return true;
+    {
+            // The entity handed to the chained plugin only carries the issuer
+            // and the groups; build it once here rather than on every access.
+        if (!m_issuer.empty()) {
+            m_entity.vorg = strdup(m_issuer.c_str());
+        }
+        if (!m_groups.empty()) {
+            std::string groups_str;
+            for (const auto &grp : m_groups) {
+                groups_str += grp;
+                groups_str += ' ';
             }
+            m_entity.grps = strdup(groups_str.c_str());
         }
-        return false;
     }
 
-    bool expired() const {return monotonic_time() > m_expiry_time;}
+    ~XrdAccRules() {
+        if (m_entity.vorg != nullptr) free(m_entity.vorg);
+        if (m_entity.grps != nullptr) free(m_entity.grps);
+    }
+
+    bool apply(Access_Operation oper, const char *path) const {
+        return m_rules.match(oper, path);
+    }
+
+    bool expired(uint64_t now) const {return now > m_expiry_time;}
 
     void parse(const AccessRulesRaw &rules) {
-        m_rules.reserve(rules.size());
         for (const auto &entry : rules) {
-            m_rules.emplace_back(entry.first, entry.second);
+            m_rules.insert(entry.first, entry.second);
         }
+        m_size = rules.size();
     }
 
-    std::string get_username(const std::string &req_path)
+    std::string get_username(const char *req_path) const
     {
         for (const auto &rule : m_map_rules) {
             std::string name = rule.match(m_token_subject, req_path, m_groups);
@@ -259,11 +348,17 @@ public:
     const std::string & get_default_username() const {return m_username;}
     const std::string & get_issuer() const {return m_issuer;}
 
-    size_t size() const {return m_rules.size();}
+    const std::string & token() const {return m_token;}
+    const XrdSecEntity & entity() const {return m_entity;}
+
+    size_t size() const {return m_size;}
     const std::vector<std::string> &groups() const {return m_groups;}
 
 private:
-    AccessRulesRaw m_rules;
+    PathTrie m_rules;
+    size_t m_size{0};
+    XrdSecEntity m_entity;
+    const std::string m_token;
     uint64_t m_expiry_time{0};
     const std::string m_username;
     const std::string m_token_subject;
@@ -319,13 +414,17 @@ public:
         std::shared_ptr<XrdAccRules> access_rules;
         uint64_t now = monotonic_time();
         Check(now);
+        const uint64_t token_hash = HashToken(authz);
+        CacheShard &shard = m_cache[token_hash % m_cache_shards];
+        pthread_rwlock_rdlock(&shard.m_lock);
         {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            const auto iter = m_map.find(authz);
-            if (iter != m_map.end() && !iter->second->expired()) {
+            const auto iter = shard.m_map.find(token_hash);
+            if (iter != shard.m_map.end() && !iter->second->expired(now) &&
+                iter->second->token() == authz) {
                 access_rules = iter->second;
             }
         }
+        pthread_rwlock_unlock(&shard.m_lock);
         if (!access_rules) {
             try {
 		uint64_t cache_expiry;
@@ -336,7 +435,7 @@ public:
                 std::vector<MapRule> map_rules;
                 std::vector<std::string> groups;
                 if (GenerateAcls(authz, cache_expiry, rules, username, token_subject, issuer, map_rules, groups)) {
-                    access_rules.reset(new XrdAccRules(now + cache_expiry, username, token_subject, issuer, map_rules, groups));
+                    access_rules.reset(new XrdAccRules(authz, now + cache_expiry, username, token_subject, issuer, map_rules, groups));
                     access_rules->parse(rules);
                 } else {
                     return OnMissing(Entity, path, oper, env);
@@ -345,8 +444,11 @@ public:
                 m_log.Emsg("Access", "Error generating ACLs for authorization", exc.what());
                 return OnMissing(Entity, path, oper, env);
             }
-            std::lock_guard<std::mutex> guard(m_mutex);
-            m_map[authz] = access_rules;
+            // A token whose hash collides with a cached one simply replaces it.
+            std::shared_ptr<XrdAccRules> old_rules = access_rules;
+            pthread_rwlock_wrlock(&shard.m_lock);
+            shard.m_map[token_hash].swap(old_rules);
+            pthread_rwlock_unlock(&shard.m_lock);
         }
 
         // Strategy: we populate the name in the XrdSecEntity if:
@@ -358,27 +460,9 @@ public:
         //
         // We always populate the issuer and the groups, if present.
 
-        // Access may be authorized; populate XrdSecEntity
-        XrdSecEntity new_secentity;
-        new_secentity.vorg = nullptr;
-        new_secentity.grps = nullptr;
-        new_secentity.role = nullptr;
-        const auto &issuer = access_rules->get_issuer();
-        if (!issuer.empty()) {
-            new_secentity.vorg = strdup(issuer.c_str());
-        }
-        if (access_rules->groups().size()) {
-            std::stringstream ss;
-            for (const auto &grp : access_rules->groups()) {
-                ss << grp << " ";
-            }
-            const auto &groups_str = ss.str();
-            new_secentity.grps = static_cast<char*>(malloc(groups_str.size()));
-            if (new_secentity.grps) {
-                memcpy(new_secentity.grps, groups_str.c_str(), groups_str.size());
-                new_secentity.grps[groups_str.size()] = '\0';
-            }
-        }
+        // Access may be authorized; the XrdSecEntity with the issuer and groups
+        // was populated when the token was first seen.
+        const XrdSecEntity &new_secentity = access_rules->entity();
 
         std::string username;
         bool mapping_success = false;
@@ -389,13 +473,7 @@ public:
         scope_success = access_rules->apply(oper, path);
 
         if (!scope_success && !mapping_success) {
-            auto returned_accs = OnMissing(&new_secentity, path, oper, env);
-            // Clean up the new_secentity
-            if (new_secentity.vorg != nullptr) free(new_secentity.vorg);
-            if (new_secentity.grps != nullptr) free(new_secentity.grps);
-            if (new_secentity.role != nullptr) free(new_secentity.role);
-
-            return returned_accs;
+            return OnMissing(&new_secentity, path, oper, env);
         }
 
         // Default user only applies to scope-based mappings.
@@ -419,14 +497,7 @@ public:
         }
 
         // When the scope authorized this access, allow immediately.  Otherwise, chain
-        XrdAccPrivs returned_op = scope_success ? AddPriv(oper, XrdAccPriv_None) : OnMissing(&new_secentity, path, oper, env);
-
-        // Cleanup the new_secentry
-        if (new_secentity.vorg != nullptr) free(new_secentity.vorg);
-        if (new_secentity.grps != nullptr) free(new_secentity.grps);
-        if (new_secentity.role != nullptr) free(new_secentity.role);
-
-        return returned_op;
+        return scope_success ? AddPriv(oper, XrdAccPriv_None) : OnMissing(&new_secentity, path, oper, env);
     }
 
     virtual  Issuers IssuerList() override
@@ -971,32 +1042,53 @@ private:
 
     void Check(uint64_t now)
     {
-        if (now <= m_next_clean) {return;}
-        std::lock_guard<std::mutex> guard(m_mutex);
-
-        for (auto iter = m_map.begin(); iter != m_map.end(); ) {
-            if (iter->second->expired()) {
-                iter = m_map.erase(iter);
-            } else {
-                ++iter;
+        // Only the thread that advances the deadline does the cleaning.
+        uint64_t next_clean = m_next_clean.load(std::memory_order_relaxed);
+        if (now <= next_clean) {return;}
+        if (!m_next_clean.compare_exchange_strong(next_clean, now + m_expiry_secs)) {return;}
+
+        std::vector<std::shared_ptr<XrdAccRules>> expired;
+        for (auto &shard : m_cache) {
+            pthread_rwlock_wrlock(&shard.m_lock);
+            for (auto iter = shard.m_map.begin(); iter != shard.m_map.end(); ) {
+                if (iter->second->expired(now)) {
+                    expired.emplace_back(std::move(iter->second));
+                    iter = shard.m_map.erase(iter);
+                } else {
+                    ++iter;
+                }
             }
+            pthread_rwlock_unlock(&shard.m_lock);
         }
+        expired.clear();
         Reconfig();
 
         m_next_clean = monotonic_time() + m_expiry_secs;
     }
 
+    // The token cache is split into shards, each under its own reader-writer
+    // lock, so lookups of cached tokens never serialize against each other.
+    struct CacheShard
+    {
+        CacheShard() {pthread_rwlock_init(&m_lock, nullptr);}
+        ~CacheShard() {pthread_rwlock_destroy(&m_lock);}
+
+        pthread_rwlock_t m_lock;
+        std::unordered_map<uint64_t, std::shared_ptr<XrdAccRules>> m_map;
+    };
+
+    static constexpr size_t m_cache_shards = 16;
+
     bool m_config_lock_initialized{false};
-    std::mutex m_mutex;
     pthread_rwlock_t m_config_lock;
     std::vector<std::string> m_audiences;
     std::vector<const char *> m_audiences_array;
-    std::map<std::string, std::shared_ptr<XrdAccRules>> m_map;
+    CacheShard m_cache[m_cache_shards];
     XrdAccAuthorize* m_chain;
     const std::string m_parms;
     std::vector<const char*> m_valid_issuers_array;
     std::unordered_map<std::string, IssuerConfig> m_issuers;
-    uint64_t m_next_clean{0};
+    std::atomic<uint64_t> m_next_clean{0};
     XrdSysError m_log;
     AuthzBehavior m_authz_behavior{AuthzBehavior::PASSTHROUGH};
     std::string m_cfg_file;
@@ -1,6 +1,20 @@
 
 include( XRootDCommon )
 
+#-------------------------------------------------------------------------------
+# The cms server mask width must be the same in every target using XrdCms
+#-------------------------------------------------------------------------------
+if( NOT CMS_MAX_NODES MATCHES "^[0-9]+$" OR CMS_MAX_NODES EQUAL 0 )
+  message( FATAL_ERROR "CMS_MAX_NODES must be a positive multiple of 64" )
+endif()
+math( EXPR CMS_MAX_NODES_REM "${CMS_MAX_NODES} % 64" )
+if( NOT CMS_MAX_NODES_REM EQUAL 0 )
+  message( FATAL_ERROR "CMS_MAX_NODES must be a positive multiple of 64" )
+endif()
+
+configure_file( ${CMAKE_CURRENT_SOURCE_DIR}/XrdCms/XrdCmsMaxNodes.hh.in
+                ${CMAKE_BINARY_DIR}/src/XrdCms/XrdCmsMaxNodes.hh @ONLY )
+
 #-------------------------------------------------------------------------------
 # Plugin version (this protocol loaded eithr as a plugin or as builtin).
 #-------------------------------------------------------------------------------
@@ -46,6 +60,7 @@ add_library(
   XrdXrootd/XrdXrootdPio.cc             XrdXrootd/XrdXrootdPio.hh
   XrdXrootd/XrdXrootdPrepare.cc         XrdXrootd/XrdXrootdPrepare.hh
   XrdXrootd/XrdXrootdProtocol.cc        XrdXrootd/XrdXrootdProtocol.hh
+  XrdXrootd/XrdXrootdRdvAio.cc          XrdXrootd/XrdXrootdRdvAio.hh
                                         XrdXrootd/XrdXrootdReqID.hh
   XrdXrootd/XrdXrootdResponse.cc        XrdXrootd/XrdXrootdResponse.hh
   XrdXrootd/XrdXrootdStats.cc           XrdXrootd/XrdXrootdStats.hh
@@ -133,6 +148,7 @@ add_library(
                                XrdOss/XrdOssMioFile.hh
   XrdOss/XrdOssMSS.cc
   XrdOss/XrdOssPath.cc         XrdOss/XrdOssPath.hh
+  XrdOss/XrdOssReadV.cc        XrdOss/XrdOssReadV.hh
   XrdOss/XrdOssReloc.cc
   XrdOss/XrdOssRename.cc
   XrdOss/XrdOssSpace.cc        XrdOss/XrdOssSpace.hh
@@ -140,6 +156,7 @@ add_library(
   XrdOss/XrdOssStat.cc         XrdOss/XrdOssStatInfo.hh
                                XrdOss/XrdOssTrace.hh
   XrdOss/XrdOssUnlink.cc
+  XrdOss/XrdOssUring.cc        XrdOss/XrdOssUring.hh
                                XrdOss/XrdOssWrapper.hh
                                XrdOss/XrdOssVS.hh
 
@@ -174,6 +191,7 @@ add_library(
   XrdCms/XrdCmsRTable.cc          XrdCms/XrdCmsRTable.hh
   XrdCms/XrdCmsSecurity.cc        XrdCms/XrdCmsSecurity.hh
   XrdCms/XrdCmsTalk.cc            XrdCms/XrdCmsTalk.hh
+                                  XrdCms/XrdCmsSMask.hh
                                   XrdCms/XrdCmsTypes.hh
   XrdCms/XrdCmsUtils.cc           XrdCms/XrdCmsUtils.hh
                                   XrdCms/XrdCmsVnId.hh
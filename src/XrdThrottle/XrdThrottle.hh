@@ -12,6 +12,7 @@
 #include "XrdThrottle/XrdThrottleManager.hh"
 
 class XrdSysLogger;
+class XrdOucEnv;
 class XrdOucStream;
 
 
@@ -125,6 +126,7 @@ private:
    bool m_is_open{false};
    unique_sfs_ptr m_sfs;
    int m_uid; // A unique identifier for this user; has no meaning except for the fairshare.
+   int m_vid; // The bucket of this user's VO; -1 if the VO is not limited.
    std::string m_loadshed;
    std::string m_connection_id; // Identity for the connection; may or may authenticated
    std::string m_user;
@@ -135,7 +137,7 @@ private:
 class FileSystem : public XrdSfsFileSystem
 {
 
-friend XrdSfsFileSystem * XrdSfsGetFileSystem_Internal(XrdSfsFileSystem *, XrdSysLogger *, const char *);
+friend XrdSfsFileSystem * XrdSfsGetFileSystem_Internal(XrdSfsFileSystem *, XrdSysLogger *, const char *, XrdOucEnv *);
 
 public:
 
@@ -267,7 +269,8 @@ private:
    Initialize(      FileSystem      *&fs,
                     XrdSfsFileSystem *native_fs,
                     XrdSysLogger     *lp,
-              const char             *config_file);
+              const char             *config_file,
+                    XrdOucEnv        *envP);
 
    FileSystem();
 
@@ -289,6 +292,18 @@ private:
    int
    xmaxconn(XrdOucStream &Config);
 
+   int
+   xuserlimit(XrdOucStream &Config);
+
+   int
+   xvolimit(XrdOucStream &Config);
+
+   int
+   xmonitor(XrdOucStream &Config);
+
+   int
+   xlimits(XrdOucStream &Config, const char *what, float &drate, float &irate);
+
    static FileSystem  *m_instance;
    XrdSysError         m_eroute;
    XrdOucTrace         m_trace;
@@ -296,6 +311,7 @@ private:
    XrdSfsFileSystem   *m_sfs_ptr;
    bool                m_initialized;
    XrdThrottleManager  m_throttle;
+   int                 m_report_interval;
    XrdVersionInfo     *myVersion;
 
 };
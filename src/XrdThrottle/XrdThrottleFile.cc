@@ -19,8 +19,8 @@ using namespace XrdThrottle;
 
 #define DO_THROTTLE(amount) \
 DO_LOADSHED \
-m_throttle.Apply(amount, 1, m_uid); \
-XrdThrottleTimer xtimer = m_throttle.StartIOTimer();
+m_throttle.Apply(amount, 1, m_uid, m_vid); \
+XrdThrottleTimer xtimer = m_throttle.StartIOTimer(m_uid);
 
 File::File(const char                     *user,
                  unique_sfs_ptr            sfs,
@@ -33,6 +33,7 @@ File::File(const char                     *user,
      m_sfs(sfs),
 #endif
      m_uid(0),
+     m_vid(-1),
      m_connection_id(user ? user : ""),
      m_throttle(throttle),
      m_eroute(eroute)
@@ -61,6 +62,8 @@ File::open(const char                *fileName,
    }
    if (m_user.empty()) {m_user = client->name ? client->name : "nobody";}
    m_uid = XrdThrottleManager::GetUid(m_user.c_str());
+   m_vid = m_throttle.GetVid(client->vorg);
+   m_throttle.SetUserName(m_uid, m_user);
    m_throttle.PrepLoadShed(opaque, m_loadshed);
    std::string open_error_message;
    if (!m_throttle.OpenFile(m_user, open_error_message)) {
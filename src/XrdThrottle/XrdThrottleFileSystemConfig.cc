@@ -6,6 +6,8 @@
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucStream.hh"
 
+#include "XrdXrootd/XrdXrootdGStream.hh"
+
 #include "XrdThrottle/XrdThrottle.hh"
 #include "XrdThrottle/XrdThrottleTrace.hh"
 
@@ -55,31 +57,44 @@ namespace XrdThrottle {
 XrdSfsFileSystem *
 XrdSfsGetFileSystem_Internal(XrdSfsFileSystem *native_fs,
                             XrdSysLogger     *lp,
-                            const char       *configfn)
+                            const char       *configfn,
+                            XrdOucEnv        *envP)
 {
    FileSystem* fs = NULL;
-   FileSystem::Initialize(fs, native_fs, lp, configfn);
+   FileSystem::Initialize(fs, native_fs, lp, configfn, envP);
    return fs;
 }
 }
 
-// Export the symbol necessary for this to be dynamically loaded.
+// Export the symbols necessary for this to be dynamically loaded; the
+// version 2 entry point is preferred as it gives us the g-stream.
 extern "C" {
 XrdSfsFileSystem *
 XrdSfsGetFileSystem(XrdSfsFileSystem *native_fs,
                     XrdSysLogger     *lp,
                     const char       *configfn)
 {
-   return XrdSfsGetFileSystem_Internal(native_fs, lp, configfn);
+   return XrdSfsGetFileSystem_Internal(native_fs, lp, configfn, 0);
+}
+
+XrdSfsFileSystem *
+XrdSfsGetFileSystem2(XrdSfsFileSystem *native_fs,
+                     XrdSysLogger     *lp,
+                     const char       *configfn,
+                     XrdOucEnv        *envP)
+{
+   return XrdSfsGetFileSystem_Internal(native_fs, lp, configfn, envP);
 }
 }
 
 XrdVERSIONINFO(XrdSfsGetFileSystem, FileSystem);
+XrdVERSIONINFO(XrdSfsGetFileSystem2, FileSystem);
 
 FileSystem* FileSystem::m_instance = 0;
 
 FileSystem::FileSystem()
-   : m_eroute(0), m_trace(&m_eroute), m_sfs_ptr(0), m_initialized(false), m_throttle(&m_eroute, &m_trace)
+   : m_eroute(0), m_trace(&m_eroute), m_sfs_ptr(0), m_initialized(false), m_throttle(&m_eroute, &m_trace),
+     m_report_interval(60)
 {
    myVersion = &XrdVERSIONINFOVAR(XrdSfsGetFileSystem);
 }
@@ -90,7 +105,8 @@ void
 FileSystem::Initialize(FileSystem      *&fs,
                        XrdSfsFileSystem *native_fs, 
                        XrdSysLogger     *lp,
-                       const char       *configfn)
+                       const char       *configfn,
+                       XrdOucEnv        *envP)
 {
    fs = NULL;
    if (m_instance == NULL && !(m_instance = new FileSystem()))
@@ -109,6 +125,9 @@ FileSystem::Initialize(FileSystem      *&fs,
          fs = NULL;
          return;
       }
+      XrdXrootdGStream *gs = envP ? (XrdXrootdGStream*) envP->GetPtr("throttle.gStream*") : 0;
+      fs->m_eroute.Say("Config throttle g-stream has", gs ? "" : " NOT", " been configured via xrootd.monitor directive");
+      fs->m_throttle.SetMonitor(gs, fs->m_report_interval);
       fs->m_throttle.Init();
       fs->m_initialized = true;
    }
@@ -150,6 +169,9 @@ FileSystem::Configure(XrdSysError & log, XrdSfsFileSystem *native_fs)
       TS_Xeq("throttle.max_open_files", xmaxopen);
       TS_Xeq("throttle.max_active_connections", xmaxconn);
       TS_Xeq("throttle.throttle", xthrottle);
+      TS_Xeq("throttle.user_limit", xuserlimit);
+      TS_Xeq("throttle.vo_limit", xvolimit);
+      TS_Xeq("throttle.monitor", xmonitor);
       TS_Xeq("throttle.loadshed", xloadshed);
       TS_Xeq("throttle.trace", xtrace);
       if (NoGo)
@@ -277,6 +299,137 @@ FileSystem::xthrottle(XrdOucStream &Config)
     return 0;
 }
 
+/******************************************************************************/
+/*                              x l i m i t s                                 */
+/******************************************************************************/
+
+/* Function: xlimits
+
+   Purpose:  To parse the common tail of the limit directives: [data <drate>] [iops <irate>]
+
+             <drate>    maximum bytes per second.
+             <irate>    maximum IOPS per second.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+int
+FileSystem::xlimits(XrdOucStream &Config, const char *what, float &drate, float &irate)
+{
+    long long val_rate;
+    char *val;
+
+    drate = irate = -1;
+    while ((val = Config.GetWord()))
+    {
+       if (strcmp("data", val) == 0)
+       {
+          if (!(val = Config.GetWord()))
+             {m_eroute.Emsg("Config", what, "data limit not specified."); return 1;}
+          if (XrdOuca2x::a2sz(m_eroute,"data limit value",val,&val_rate,1)) return 1;
+          drate = val_rate;
+       }
+       else if (strcmp("iops", val) == 0)
+       {
+          if (!(val = Config.GetWord()))
+             {m_eroute.Emsg("Config", what, "IOPS limit not specified."); return 1;}
+          if (XrdOuca2x::a2sz(m_eroute,"IOPS limit value",val,&val_rate,1)) return 1;
+          irate = val_rate;
+       }
+       else
+       {
+          m_eroute.Emsg("Config", what, "- unknown option specified", val);
+       }
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/*                           x u s e r l i m i t                              */
+/******************************************************************************/
+
+/* Function: xuserlimit
+
+   Purpose:  To parse the directive: user_limit [data <drate>] [iops <irate>]
+
+             <drate>    maximum bytes per second for each user.
+             <irate>    maximum IOPS per second for each user.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+int
+FileSystem::xuserlimit(XrdOucStream &Config)
+{
+    float drate, irate;
+
+    if (xlimits(Config, "user_limit", drate, irate)) return 1;
+    m_throttle.SetUserLimits(drate, irate);
+    return 0;
+}
+
+/******************************************************************************/
+/*                             x v o l i m i t                                */
+/******************************************************************************/
+
+/* Function: xvolimit
+
+   Purpose:  To parse the directive: vo_limit {<vo> | *} [data <drate>] [iops <irate>]
+
+             <vo>       the VO the limits apply to; '*' applies them to each
+                        VO that is not otherwise listed.
+             <drate>    maximum bytes per second for the VO as a whole.
+             <irate>    maximum IOPS per second for the VO as a whole.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+int
+FileSystem::xvolimit(XrdOucStream &Config)
+{
+    float drate, irate;
+    char *val;
+
+    if (!(val = Config.GetWord()) || !val[0])
+       {m_eroute.Emsg("Config", "VO not specified!  Example usage: throttle.vo_limit cms data 1g"); return 1;}
+    std::string vo = val;
+
+    if (xlimits(Config, "vo_limit", drate, irate)) return 1;
+    m_throttle.SetVoLimits(vo, drate, irate);
+    return 0;
+}
+
+/******************************************************************************/
+/*                             x m o n i t o r                                */
+/******************************************************************************/
+
+/* Function: xmonitor
+
+   Purpose:  To parse the directive: monitor [interval <rint>]
+
+             <rint>     seconds between per-user reports on the throttle
+                        g-stream (see xrootd.mongstream); defaults to 60.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+int
+FileSystem::xmonitor(XrdOucStream &Config)
+{
+    char *val;
+
+    while ((val = Config.GetWord()))
+    {
+       if (strcmp("interval", val) == 0)
+       {
+          if (!(val = Config.GetWord()))
+             {m_eroute.Emsg("Config", "monitor interval not specified."); return 1;}
+          if (XrdOuca2x::a2tm(m_eroute,"monitor interval value",val,&m_report_interval,1)) return 1;
+       }
+       else
+       {
+          m_eroute.Emsg("Config", "Warning - unknown monitor option specified", val, ".");
+       }
+    }
+    return 0;
+}
+
 /******************************************************************************/
 /*                            x l o a d s h e d                               */
 /******************************************************************************/
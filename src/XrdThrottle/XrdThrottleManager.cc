@@ -7,10 +7,16 @@
 
 #include "XrdOuc/XrdOucEnv.hh"
 
+#include "XrdXrootd/XrdXrootdGStream.hh"
+
 #define XRD_TRACE m_trace->
 #include "XrdThrottle/XrdThrottleTrace.hh"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <sstream>
+#include <thread>
 
 const char *
 XrdThrottleManager::TraceID = "ThrottleManager";
@@ -18,6 +24,9 @@ XrdThrottleManager::TraceID = "ThrottleManager";
 const
 int XrdThrottleManager::m_max_users = 1024;
 
+const
+int XrdThrottleManager::m_max_vos = 64;
+
 #if defined(__linux__) || defined(__GNU__) || (defined(__FreeBSD_kernel__) && defined(__GLIBC__))
 int clock_id;
 int XrdThrottleTimer::clock_id = clock_getcpuclockid(0, &clock_id) != ENOENT ? CLOCK_THREAD_CPUTIME_ID : CLOCK_MONOTONIC;
@@ -32,12 +41,17 @@ XrdThrottleManager::XrdThrottleManager(XrdSysError *lP, XrdOucTrace *tP) :
    m_bytes_per_second(-1),
    m_ops_per_second(-1),
    m_concurrency_limit(-1),
-   m_last_round_allocation(100*1024),
+   m_user_bytes_per_second(-1),
+   m_user_ops_per_second(-1),
+   m_vo_default(false),
    m_io_counter(0),
    m_loadshed_host(""),
    m_loadshed_port(0),
    m_loadshed_frequency(0),
-   m_loadshed_limit_hit(0)
+   m_loadshed_limit_hit(0),
+   m_gstream(0),
+   m_report_interval(60),
+   m_last_report(0)
 {
    m_stable_io_wait.tv_sec = 0;
    m_stable_io_wait.tv_nsec = 0;
@@ -47,19 +61,36 @@ void
 XrdThrottleManager::Init()
 {
    TRACE(DEBUG, "Initializing the throttle manager.");
-   // Initialize all our shares to zero.
-   m_primary_bytes_shares.reserve(m_max_users);
-   m_secondary_bytes_shares.reserve(m_max_users);
-   m_primary_ops_shares.reserve(m_max_users);
-   m_secondary_ops_shares.reserve(m_max_users);
-   // Allocate each user 100KB and 10 ops to bootstrap;
+   // Start every bucket full; until the first recompute each user's
+   // fairshare is the whole global limit.
+   long long now = Now();
+   m_users.reset(new UserSlot[m_max_users]);
+   SetRate(m_global_bytes, m_bytes_per_second, now, true);
+   SetRate(m_global_ops, m_ops_per_second, now, true);
    for (int i=0; i<m_max_users; i++)
    {
-      m_primary_bytes_shares[i] = m_last_round_allocation;
-      m_secondary_bytes_shares[i] = 0;
-      m_primary_ops_shares[i] = 10;
-      m_secondary_ops_shares[i] = 0;
+      UserSlot &user = m_users[i];
+      SetRate(user.m_fair_bytes, m_bytes_per_second, now, true);
+      SetRate(user.m_fair_ops, m_ops_per_second, now, true);
+      SetRate(user.m_cap_bytes, m_user_bytes_per_second, now, true);
+      SetRate(user.m_cap_ops, m_user_ops_per_second, now, true);
+      for (int j=0; j<m_lat_bins; j++) user.m_lat[j] = 0;
+   }
+
+   // Configured VOs come first, followed by the hashed slots sharing the
+   // default ("*") limit, if any.
+   std::pair<float, float> vo_default(-1, -1);
+   if (m_vo_default) vo_default = m_vo_rates.back();
+   int nvos = m_vo_index.size() + (m_vo_default ? m_max_vos : 0);
+   m_vos.reset(new VoSlot[nvos ? nvos : 1]);
+   for (int i=0; i<nvos; i++)
+   {
+      const std::pair<float, float> &rates = i < static_cast<int>(m_vo_index.size()) ? m_vo_rates[i] : vo_default;
+      SetRate(m_vos[i].m_bytes, rates.first, now, true);
+      SetRate(m_vos[i].m_ops, rates.second, now, true);
    }
+   if (m_gstream) m_user_names.resize(m_max_users);
+   m_last_report = now;
 
    m_io_wait.tv_sec = 0;
    m_io_wait.tv_nsec = 0;
@@ -72,39 +103,142 @@ XrdThrottleManager::Init()
 }
 
 /*
- * Take as many shares as possible to fulfill the request; update
- * request with current remaining value, or zero if satisfied.
+ * Set the refill rate (units per second) of a bucket; the bucket may
+ * accumulate one recompute interval's worth of tokens.  When reset is
+ * set, the bucket also starts out full.
  */
-inline void
-XrdThrottleManager::GetShares(int &shares, int &request)
+void
+XrdThrottleManager::SetRate(Bucket &bucket, float rate, long long now, bool reset)
 {
-   int remaining;
-   AtomicFSub(remaining, shares, request);
-   if (remaining > 0)
+   long long irate = rate < 0 ? -1 : std::max(static_cast<long long>(rate), 1LL);
+   long long burst = std::max(static_cast<long long>(irate * m_interval_length_seconds), 1LL);
+   bucket.m_burst.store(burst, std::memory_order_relaxed);
+   bucket.m_rate.store(irate, std::memory_order_relaxed);
+   if (reset)
    {
-      request -= (remaining < request) ? remaining : request;
+      bucket.m_tokens.store(burst, std::memory_order_relaxed);
+      bucket.m_last_ns.store(now, std::memory_order_relaxed);
    }
 }
 
 /*
- * Iterate through all of the secondary shares, attempting 
- * to steal enough to fulfill the request.
+ * Credit the tokens accrued since the last refill.  Only whole tokens are
+ * credited and the clock is advanced by exactly the time they represent,
+ * so frequent callers do not lose the fractional remainder.  Whichever
+ * thread wins the race on the timestamp does the refill.
  */
 void
-XrdThrottleManager::StealShares(int uid, int &reqsize, int &reqops)
+XrdThrottleManager::Refill(Bucket &bucket, long long now)
 {
-   if (!reqsize && !reqops) return;
-   TRACE(BANDWIDTH, "Stealing shares to fill request of " << reqsize << " bytes");
-   TRACE(IOPS, "Stealing shares to fill request of " << reqops << " ops.");
+   long long rate = bucket.m_rate.load(std::memory_order_relaxed);
+   long long last = bucket.m_last_ns.load(std::memory_order_relaxed);
+   if (rate <= 0 || now <= last) return;
+
+   long long add = static_cast<long long>(static_cast<double>(now - last) * rate / 1e9);
+   if (add <= 0) return;
+   long long burst = bucket.m_burst.load(std::memory_order_relaxed);
+   long long next = (add >= burst) ? now
+                  : std::min(now, last + static_cast<long long>(static_cast<double>(add) * 1e9 / rate));
+   if (!bucket.m_last_ns.compare_exchange_strong(last, next, std::memory_order_relaxed))
+      return;
+
+   long long cur = bucket.m_tokens.fetch_add(add, std::memory_order_relaxed) + add;
+   while (cur > burst && !bucket.m_tokens.compare_exchange_weak(cur, burst, std::memory_order_relaxed)) {}
+}
 
-   for (int i=uid+1; i % m_max_users == uid; i++)
+/*
+ * Take tokens from a bucket, going into debt if necessary.  Returns the
+ * number of nanoseconds the caller must wait for the debt to be repaid.
+ */
+long long
+XrdThrottleManager::Take(Bucket &bucket, long long amount, long long now)
+{
+   long long rate = bucket.m_rate.load(std::memory_order_relaxed);
+   if (rate < 0 || amount <= 0) return 0;
+   Refill(bucket, now);
+   long long left = bucket.m_tokens.fetch_sub(amount, std::memory_order_relaxed) - amount;
+   return (left >= 0) ? 0 : static_cast<long long>(static_cast<double>(-left) * 1e9 / rate);
+}
+
+/*
+ * Take tokens from the global bucket.  If it had enough, the server is below
+ * its limit and nobody waits.  Otherwise, the user is paced by its fairshare
+ * bucket instead, so that a user with many outstanding requests cannot make
+ * everyone else queue behind its debt; the global debt is capped at one
+ * interval so the bucket recovers promptly once the load drops.
+ */
+long long
+XrdThrottleManager::Share(Bucket &global, Bucket &fair, long long amount, long long now)
+{
+   if (global.m_rate.load(std::memory_order_relaxed) < 0 || amount <= 0) return 0;
+   Refill(global, now);
+   long long left = global.m_tokens.fetch_sub(amount, std::memory_order_relaxed) - amount;
+   if (left >= 0) return 0;
+
+   long long floor = -global.m_burst.load(std::memory_order_relaxed);
+   while (left < floor && !global.m_tokens.compare_exchange_weak(left, floor, std::memory_order_relaxed)) {}
+   return Take(fair, amount, now);
+}
+
+/*
+ * Record the limits of a VO; the VO named "*" provides the default limit
+ * for any VO not explicitly listed.  Must be called before Init().
+ */
+void
+XrdThrottleManager::SetVoLimits(const std::string &vo, float reqbyterate, float reqoprate)
+{
+   std::pair<float, float> rates(reqbyterate, reqoprate);
+   if (vo == "*")
+   {
+      if (m_vo_default) m_vo_rates.back() = rates;
+      else {m_vo_rates.push_back(rates); m_vo_default = true;}
+      return;
+   }
+   auto iter = m_vo_index.find(vo);
+   if (iter != m_vo_index.end())
    {
-      if (reqsize) GetShares(m_secondary_bytes_shares[i % m_max_users], reqsize);
-      if (reqops)  GetShares(m_secondary_ops_shares[  i % m_max_users], reqops);
+      m_vo_rates[iter->second] = rates;
+      return;
    }
+   int slot = m_vo_index.size();
+   m_vo_index[vo] = slot;
+   m_vo_rates.insert(m_vo_rates.begin() + slot, rates);
+}
 
-   TRACE(BANDWIDTH, "After stealing shares, " << reqsize << " of request bytes remain.");
-   TRACE(IOPS, "After stealing shares, " << reqops << " of request ops remain.");
+/*
+ * Map the client's VO (the first one, if it has several) to its bucket.
+ * Returns -1 if the VO is not subject to any limit.
+ */
+int
+XrdThrottleManager::GetVid(const char *vorg)
+{
+   if (!vorg || !*vorg || m_vo_rates.empty()) return -1;
+   std::string vo(vorg, strcspn(vorg, " ,"));
+   auto iter = m_vo_index.find(vo);
+   if (iter != m_vo_index.end()) return iter->second;
+   if (!m_vo_default) return -1;
+
+   unsigned hval = 2166136261u;
+   for (const char *cur = vo.c_str(); *cur; cur++)
+      hval = (hval ^ static_cast<unsigned char>(*cur)) * 16777619u;
+   return m_vo_index.size() + hval % m_max_vos;
+}
+
+/*
+ * Remember the name behind a uid so it can be reported on the g-stream.
+ */
+void
+XrdThrottleManager::SetUserName(int uid, const std::string &user)
+{
+   if (!m_gstream) return;
+   const std::lock_guard<std::mutex> lock(m_name_mutex);
+   std::string &name = m_user_names[uid];
+   if (name != user)
+   {
+      name = user;
+      // The name goes verbatim into a JSON string.
+      for (auto &c : name) if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) c = '?';
+   }
 }
 
 /*
@@ -253,49 +387,39 @@ XrdThrottleManager::CloseFile(const std::string &entity)
 
 /*
  * Apply the throttle.  If there are no limits set, returns immediately.  Otherwise,
- * this applies the limits as best possible, stalling the thread if necessary.
+ * takes the request from each applicable bucket and sleeps for the longest debt.
  */
 void
-XrdThrottleManager::Apply(int reqsize, int reqops, int uid)
+XrdThrottleManager::Apply(int reqsize, int reqops, int uid, int vid)
 {
-   if (m_bytes_per_second < 0)
-      reqsize = 0;
-   if (m_ops_per_second < 0)
-      reqops = 0;
-   while (reqsize || reqops)
+   UserSlot &user = m_users[uid];
+   if (m_gstream)
    {
-      // Subtract the requested out of the shares
-      AtomicBeg(m_compute_var);
-      GetShares(m_primary_bytes_shares[uid], reqsize);
-      if (reqsize)
-      {
-         TRACE(BANDWIDTH, "Using secondary shares; request has " << reqsize << " bytes left.");
-         GetShares(m_secondary_bytes_shares[uid], reqsize);
-         TRACE(BANDWIDTH, "Finished with secondary shares; request has " << reqsize << " bytes left.");
-      }
-      else
-      {
-         TRACE(BANDWIDTH, "Filled byte shares out of primary; " << m_primary_bytes_shares[uid] << " left.");
-      }
-      GetShares(m_primary_ops_shares[uid], reqops);
-      if (reqops)
-      {
-         GetShares(m_secondary_ops_shares[uid], reqops);
-      }
-      StealShares(uid, reqsize, reqops);
-      AtomicEnd(m_compute_var);
-
-      if (reqsize || reqops)
-      {
-         if (reqsize) TRACE(BANDWIDTH, "Sleeping to wait for throttle fairshare.");
-         if (reqops) TRACE(IOPS, "Sleeping to wait for throttle fairshare.");
-         m_compute_var.Wait();
-         AtomicBeg(m_compute_var);
-         AtomicInc(m_loadshed_limit_hit);
-         AtomicEnd(m_compute_var);
-      }
+      user.m_bytes.fetch_add(reqsize, std::memory_order_relaxed);
+      user.m_ops.fetch_add(reqops, std::memory_order_relaxed);
    }
+   if (!IsThrottling()) return;
+   if (!user.m_active.load(std::memory_order_relaxed))
+      user.m_active.store(1, std::memory_order_relaxed);
+
+   long long now = Now();
+   long long wait = std::max(Share(m_global_bytes, user.m_fair_bytes, reqsize, now),
+                             Share(m_global_ops, user.m_fair_ops, reqops, now));
+   wait = std::max(wait, Take(user.m_cap_bytes, reqsize, now));
+   wait = std::max(wait, Take(user.m_cap_ops, reqops, now));
+   if (vid >= 0)
+   {
+      wait = std::max(wait, Take(m_vos[vid].m_bytes, reqsize, now));
+      wait = std::max(wait, Take(m_vos[vid].m_ops, reqops, now));
+   }
+   if (wait <= 0) return;
 
+   TRACE(BANDWIDTH, "Delaying request of " << reqsize << " bytes by " << wait/1000 << "us to honor the throttle.");
+   AtomicBeg(m_compute_var);
+   AtomicInc(m_loadshed_limit_hit);
+   AtomicEnd(m_compute_var);
+   if (m_gstream) user.m_wait_ns.fetch_add(wait, std::memory_order_relaxed);
+   std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
 }
 
 void *
@@ -360,73 +484,46 @@ XrdThrottleManager::Recompute()
 }
 
 /*
- * The heart of the manager approach.
- *
- * This routine periodically recomputes the shares of each current user.
- * Each user has a "primary" and a "secondary" share.  At the end of the
- * each time interval, the remaining primary share is moved to secondary.
- * A user can utilize both shares; if both are gone, they must block until
- * the next recompute interval.
- *
- * The secondary share can be "stolen" by any other user; so, if a user
- * is idle or under-utilizing, their share can be used by someone else.
- * However, they can never be completely starved, as no one can steal
- * primary share.
+ * Rebalance the fairshares.
  *
- * In this way, we violate the throttle for an interval, but never starve.
+ * The buckets refill themselves; all that is left to do periodically is
+ * to count the users that issued any IO during the last interval and give
+ * each of them an equal share of the global limit.  A user becoming active
+ * mid-interval still gets the previous share, so we may violate the
+ * throttle for an interval, but never starve anyone.
  *
  */
 void
 XrdThrottleManager::RecomputeInternal()
 {
-   // Compute total shares for this interval; 
    float intervals_per_second = 1.0/m_interval_length_seconds;
-   float total_bytes_shares = m_bytes_per_second / intervals_per_second;
-   float total_ops_shares   = m_ops_per_second / intervals_per_second;
+   long long now = Now();
 
-   // Compute the number of active users; a user is active if they used
-   // any primary share during the last interval;
-   AtomicBeg(m_compute_var);
-   float active_users = 0;
-   long bytes_used = 0;
+   int active_users = 0;
    for (int i=0; i<m_max_users; i++)
    {
-      int primary = AtomicFAZ(m_primary_bytes_shares[i]);
-      if (primary != m_last_round_allocation)
-      {
-         active_users++;
-         if (primary >= 0)
-            m_secondary_bytes_shares[i] = primary;
-         primary = AtomicFAZ(m_primary_ops_shares[i]);
-         if (primary >= 0)
-             m_secondary_ops_shares[i] = primary;
-         bytes_used += (primary < 0) ? m_last_round_allocation : (m_last_round_allocation-primary);
-      }
+      if (m_users[i].m_active.exchange(0, std::memory_order_relaxed)) active_users++;
    }
-
    if (active_users == 0)
    {
       active_users++;
    }
 
-   // Note we allocate the same number of shares to *all* users, not
-   // just the active ones.  If a new user becomes active in the next
-   // interval, we'll go over our bandwidth budget just a bit.
-   m_last_round_allocation = static_cast<int>(total_bytes_shares / active_users);
-   int ops_shares = static_cast<int>(total_ops_shares / active_users);
-   TRACE(BANDWIDTH, "Round byte allocation " << m_last_round_allocation << " ; last round used " << bytes_used << ".");
-   TRACE(IOPS, "Round ops allocation " << ops_shares);
+   float bytes_shares = (m_bytes_per_second < 0) ? -1 : m_bytes_per_second / active_users;
+   float ops_shares   = (m_ops_per_second < 0)   ? -1 : m_ops_per_second / active_users;
+   TRACE(BANDWIDTH, "Fairshare byte rate " << bytes_shares << " for " << active_users << " active users.");
+   TRACE(IOPS, "Fairshare ops rate " << ops_shares);
    for (int i=0; i<m_max_users; i++)
    {
-      m_primary_bytes_shares[i] = m_last_round_allocation;
-      m_primary_ops_shares[i] = ops_shares;
+      SetRate(m_users[i].m_fair_bytes, bytes_shares, now, false);
+      SetRate(m_users[i].m_fair_ops, ops_shares, now, false);
    }
 
    // Reset the loadshed limit counter.
+   AtomicBeg(m_compute_var);
    int limit_hit = AtomicFAZ(m_loadshed_limit_hit);
-   TRACE(DEBUG, "Throttle limit hit " << limit_hit << " times during last interval.");
-
    AtomicEnd(m_compute_var);
+   TRACE(DEBUG, "Throttle limit hit " << limit_hit << " times during last interval.");
 
    // Update the IO counters
    m_compute_var.Lock();
@@ -443,6 +540,56 @@ XrdThrottleManager::RecomputeInternal()
    m_compute_var.UnLock();
    TRACE(IOLOAD, "Current IO counter is " << m_stable_io_counter << "; total IO wait time is " << (m_stable_io_wait.tv_sec*1000+m_stable_io_wait.tv_nsec/1000000) << "ms.");
    m_compute_var.Broadcast();
+
+   if (m_gstream && now - m_last_report >= m_report_interval*1000000000LL)
+   {
+      Report(now);
+   }
+}
+
+/*
+ * Send one g-stream record per user that did IO since the last report,
+ * carrying its totals and a log2 histogram of the IO latency.  Bin 0
+ * counts requests under 1us, bin i those of [2^(i-1), 2^i) us and the
+ * last bin everything longer.
+ */
+void
+XrdThrottleManager::Report(long long now)
+{
+   time_t end = time(0);
+   time_t start = end - (now - m_last_report) / 1000000000LL;
+   m_last_report = now;
+
+   char buf[2048];
+   for (int i=0; i<m_max_users; i++)
+   {
+      UserSlot &user = m_users[i];
+      long long ops = user.m_ops.exchange(0, std::memory_order_relaxed);
+      if (!ops) continue;
+      long long bytes = user.m_bytes.exchange(0, std::memory_order_relaxed);
+      long long wait_ns = user.m_wait_ns.exchange(0, std::memory_order_relaxed);
+
+      std::string name;
+      {
+         const std::lock_guard<std::mutex> lock(m_name_mutex);
+         name = m_user_names[i];
+      }
+      int len = snprintf(buf, sizeof(buf), "{\"event\":\"throttle_user\","
+                         "\"user\":\"%.512s\",\"start\":%lld,\"end\":%lld,"
+                         "\"ops\":%lld,\"bytes\":%lld,\"wait_ms\":%lld,\"lat_us_log2\":[",
+                         name.c_str(), (long long) start, (long long) end,
+                         ops, bytes, wait_ns / 1000000);
+      for (int j=0; j<m_lat_bins; j++)
+      {
+         len += snprintf(buf+len, sizeof(buf)-len, "%s%u", j ? "," : "",
+                         user.m_lat[j].exchange(0, std::memory_order_relaxed));
+      }
+      len += snprintf(buf+len, sizeof(buf)-len, "]}");
+      if (len >= static_cast<int>(sizeof(buf)) || !m_gstream->Insert(buf, len + 1))
+      {
+         TRACE(DEBUG, "Failed g-stream insertion of throttle record, len=" << len);
+      }
+   }
 }
 
 /*
@@ -452,22 +599,21 @@ int
 XrdThrottleManager::GetUid(const char *username)
 {
    const char *cur = username;
-   int hval = 0;
+   unsigned hval = 2166136261u;
    while (cur && *cur && *cur != '@' && *cur != '.')
    {
-      hval += *cur;
-      hval %= m_max_users;
+      hval = (hval ^ static_cast<unsigned char>(*cur)) * 16777619u;
       cur++;
    }
    //cerr << "Calculated UID " << hval << " for " << username << endl;
-   return hval;
+   return hval % m_max_users;
 }
 
 /*
  * Create an IO timer object; increment the number of outstanding IOs.
  */
 XrdThrottleTimer
-XrdThrottleManager::StartIOTimer()
+XrdThrottleManager::StartIOTimer(int uid)
 {
    AtomicBeg(m_compute_var);
    int cur_counter = AtomicInc(m_io_counter);
@@ -483,21 +629,34 @@ XrdThrottleManager::StartIOTimer()
       cur_counter = AtomicInc(m_io_counter);
       AtomicEnd(m_compute_var);
    }
-   return XrdThrottleTimer(*this);
+   return XrdThrottleTimer(*this, uid);
 }
 
 /*
- * Finish recording an IO timer.
+ * Finish recording an IO timer.  A thread waiting on the concurrency limit
+ * is woken immediately rather than at the next recompute.
  */
 void
-XrdThrottleManager::StopIOTimer(struct timespec timer)
+XrdThrottleManager::StopIOTimer(struct timespec timer, int uid, long long lat_ns)
 {
    AtomicBeg(m_compute_var);
-   AtomicDec(m_io_counter);
+   int cur_counter = AtomicDec(m_io_counter);
    AtomicAdd(m_io_wait.tv_sec, timer.tv_sec);
    // Note this may result in tv_nsec > 1e9
    AtomicAdd(m_io_wait.tv_nsec, timer.tv_nsec);
    AtomicEnd(m_compute_var);
+   if (m_concurrency_limit >= 0 && cur_counter >= m_concurrency_limit)
+   {
+      m_compute_var.Signal();
+   }
+
+   if (lat_ns >= 0 && uid >= 0)
+   {
+      long long usecs = lat_ns / 1000;
+      int bin = 0;
+      while (usecs && bin < m_lat_bins-1) {usecs >>= 1; bin++;}
+      m_users[uid].m_lat[bin].fetch_add(1, std::memory_order_relaxed);
+   }
 }
 
 /*
@@ -9,8 +9,16 @@
  *
  * The XrdThrottleManager is user-aware and provides fairshare.
  *
- * This works by having a separate thread periodically refilling
- * each user's shares.
+ * Each limit is a token bucket that is refilled lazily from the monotonic
+ * clock by whichever thread next touches it; a request takes its tokens
+ * up front and, if the bucket went into debt, sleeps exactly as long as
+ * the refill rate needs to pay it back.  Limits are hierarchical: an
+ * optional per-user cap, an optional per-VO cap and the global limit.
+ * While the global bucket has tokens nobody waits; once it runs dry, each
+ * user is paced by a fairshare bucket holding 1/N of the global rate, where
+ * N is the number of users active during the last interval.  A separate
+ * thread only recomputes N, the IO load statistics and the monitoring
+ * reports.
  *
  * Note that we do not actually keep close track of users, but rather
  * put them into a hash.  This way, we can pretend there's a constant
@@ -28,6 +36,8 @@
 #define unlikely(x)     x
 #endif
 
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <ctime>
@@ -40,6 +50,7 @@
 class XrdSysError;
 class XrdOucTrace;
 class XrdThrottleTimer;
+class XrdXrootdGStream;
 
 class XrdThrottleManager
 {
@@ -53,9 +64,11 @@ void        Init();
 bool        OpenFile(const std::string &entity, std::string &open_error_message);
 bool        CloseFile(const std::string &entity);
 
-void        Apply(int reqsize, int reqops, int uid);
+void        Apply(int reqsize, int reqops, int uid, int vid=-1);
 
-bool        IsThrottling() {return (m_ops_per_second > 0) || (m_bytes_per_second > 0);}
+bool        IsThrottling() {return (m_ops_per_second > 0) || (m_bytes_per_second > 0)
+                                || (m_user_ops_per_second > 0) || (m_user_bytes_per_second > 0)
+                                || !m_vo_rates.empty();}
 
 void        SetThrottles(float reqbyterate, float reqoprate, int concurrency, float interval_length)
             {m_interval_length_seconds = interval_length; m_bytes_per_second = reqbyterate;
@@ -68,12 +81,24 @@ void        SetMaxOpen(unsigned long max_open) {m_max_open = max_open;}
 
 void        SetMaxConns(unsigned long max_conns) {m_max_conns = max_conns;}
 
+void        SetUserLimits(float reqbyterate, float reqoprate)
+            {m_user_bytes_per_second = reqbyterate; m_user_ops_per_second = reqoprate;}
+
+void        SetVoLimits(const std::string &vo, float reqbyterate, float reqoprate);
+
+void        SetMonitor(XrdXrootdGStream *gs, int report_interval)
+            {m_gstream = gs; m_report_interval = report_interval;}
+
+void        SetUserName(int uid, const std::string &user);
+
 //int         Stats(char *buff, int blen, int do_sync=0) {return m_pool.Stats(buff, blen, do_sync);}
 
 static
 int         GetUid(const char *username);
 
-XrdThrottleTimer StartIOTimer();
+int         GetVid(const char *vorg);
+
+XrdThrottleTimer StartIOTimer(int uid=-1);
 
 void        PrepLoadShed(const char *opaque, std::string &lsOpaque);
 
@@ -87,22 +112,65 @@ void        PerformLoadShed(const std::string &opaque, std::string &host, unsign
 
 protected:
 
-void        StopIOTimer(struct timespec);
+void        StopIOTimer(struct timespec, int uid, long long lat_ns);
+
+static
+long long   Now() {return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();}
 
 private:
 
+// A lazily refilled token bucket; a negative rate means no limit.
+struct Bucket
+{
+   std::atomic<long long> m_tokens{0};
+   std::atomic<long long> m_last_ns{0};
+   std::atomic<long long> m_rate{-1};
+   std::atomic<long long> m_burst{0};
+};
+
+static const
+int         m_lat_bins = 24;
+
+struct UserSlot
+{
+   Bucket   m_fair_bytes;  // Share of the global limit
+   Bucket   m_fair_ops;
+   Bucket   m_cap_bytes;   // throttle.user_limit
+   Bucket   m_cap_ops;
+   std::atomic<int> m_active{0};
+   // Monitoring counters; reset at each report.
+   std::atomic<long long> m_bytes{0};
+   std::atomic<long long> m_ops{0};
+   std::atomic<long long> m_wait_ns{0};
+   std::atomic<unsigned>  m_lat[m_lat_bins];
+};
+
+struct VoSlot
+{
+   Bucket   m_bytes;
+   Bucket   m_ops;
+};
+
 void        Recompute();
 
 void        RecomputeInternal();
 
+void        Report(long long now);
+
 static
 void *      RecomputeBootstrap(void *pp);
 
-int         WaitForShares();
+void        SetRate(Bucket &bucket, float rate, long long now, bool reset);
 
-void        GetShares(int &shares, int &request);
+static
+void        Refill(Bucket &bucket, long long now);
 
-void        StealShares(int uid, int &reqsize, int &reqops);
+static
+long long   Take(Bucket &bucket, long long amount, long long now);
+
+static
+long long   Share(Bucket &global, Bucket &fair, long long amount, long long now);
 
 XrdOucTrace * m_trace;
 XrdSysError * m_log;
@@ -115,14 +183,22 @@ float       m_bytes_per_second;
 float       m_ops_per_second;
 int         m_concurrency_limit;
 
-// Maintain the shares
+// Hierarchical limits; the VO limits are indexed by their slot.
+float       m_user_bytes_per_second;
+float       m_user_ops_per_second;
+std::unordered_map<std::string, int> m_vo_index;
+std::vector<std::pair<float, float>> m_vo_rates;
+bool        m_vo_default;
+
+// Maintain the buckets
 static const
 int         m_max_users;
-std::vector<int> m_primary_bytes_shares;
-std::vector<int> m_secondary_bytes_shares;
-std::vector<int> m_primary_ops_shares;
-std::vector<int> m_secondary_ops_shares;
-int         m_last_round_allocation;
+static const
+int         m_max_vos;
+Bucket      m_global_bytes;
+Bucket      m_global_ops;
+std::unique_ptr<UserSlot[]> m_users;
+std::unique_ptr<VoSlot[]>   m_vos;
 
 // Active IO counter
 int         m_io_counter;
@@ -137,6 +213,13 @@ unsigned m_loadshed_port;
 unsigned m_loadshed_frequency;
 int m_loadshed_limit_hit;
 
+// Monitoring; user names are only kept when a g-stream is configured.
+XrdXrootdGStream *m_gstream;
+int         m_report_interval;
+long long   m_last_report;
+std::vector<std::string> m_user_names;
+std::mutex  m_name_mutex;
+
 // Maximum number of open files
 unsigned long m_max_open{0};
 unsigned long m_max_conns{0};
@@ -176,7 +259,8 @@ void StopTimer()
    }
    if (m_timer.tv_nsec != -1)
    {
-      m_manager.StopIOTimer(end_timer);
+      m_manager.StopIOTimer(end_timer, m_uid,
+                            m_start_ns ? XrdThrottleManager::Now() - m_start_ns : -1);
    }
    m_timer.tv_sec = 0;
    m_timer.tv_nsec = -1;
@@ -192,8 +276,10 @@ void StopTimer()
 
 protected:
 
-XrdThrottleTimer(XrdThrottleManager & manager) :
-   m_manager(manager)
+XrdThrottleTimer(XrdThrottleManager & manager, int uid) :
+   m_manager(manager),
+   m_uid(uid),
+   m_start_ns((manager.m_gstream && uid >= 0) ? XrdThrottleManager::Now() : 0)
 {
 #if defined(__linux__) || defined(__GNU__) || (defined(__FreeBSD_kernel__) && defined(__GLIBC__))
    int retval = clock_gettime(clock_id, &m_timer);
@@ -209,6 +295,8 @@ XrdThrottleTimer(XrdThrottleManager & manager) :
 
 private:
 XrdThrottleManager &m_manager;
+int m_uid;
+long long m_start_ns; // Wall-clock start for the latency histogram; 0 if unused.
 struct timespec m_timer;
 
 static int clock_id;
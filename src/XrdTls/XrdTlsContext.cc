@@ -16,12 +16,17 @@
 // along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
 //------------------------------------------------------------------------------
 
+#include <cerrno>
 #include <cstdio>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <openssl/bio.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
 #include <openssl/ssl.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "XrdOuc/XrdOucUtils.hh"
 #include "XrdSys/XrdSysAtomics.hh"
@@ -291,6 +296,45 @@ bool Setup_Flusher(XrdTlsContextImpl *pImpl, int flushT)
 }
 }
   
+/******************************************************************************/
+/*                   K e r n e l   T L S   S u p p o r t                      */
+/******************************************************************************/
+
+namespace XrdTlsKTLS
+{
+/******************************************************************************/
+/*                             A v a i l a b l e                              */
+/******************************************************************************/
+
+// OpenSSL silently falls back to user space when the kernel lacks the "tls"
+// upper layer protocol, but we want to know so that callers only route I/O
+// around OpenSSL when it can actually pay off. Attaching the ULP to an
+// unconnected socket fails with ENOTCONN if the kernel supports it and with
+// ENOENT if it does not (the module is loaded on demand when we have the
+// privilege to do so). The probe is done once.
+//
+bool Probe()
+{
+#if defined(TCP_ULP)
+   int sfd, rc;
+
+   if ((sfd = socket(AF_INET, SOCK_STREAM, 0)) < 0) return false;
+   rc = setsockopt(sfd, SOL_TCP, TCP_ULP, "tls", sizeof("tls"));
+   if (rc) rc = errno;
+   close(sfd);
+   return rc == 0 || rc == ENOTCONN;
+#else
+   return false;
+#endif
+}
+
+bool Available()
+{
+   static const bool isOK = Probe();
+   return isOK;
+}
+}
+
 /******************************************************************************/
 /*                 S S L   T h r e a d i n g   S u p p o r t                  */
 /******************************************************************************/
@@ -639,6 +683,15 @@ XrdTlsContext::XrdTlsContext(const char *cert,  const char *key,
 //
    SSL_CTX_set_options(pImpl->ctx, sslOpts);
 
+// Let the kernel do the record encryption (kTLS) if so wanted and possible.
+// OpenSSL decides per connection, falling back to user space for ciphers
+// the kernel does not handle.
+//
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+   if ((opts & ktlON) && XrdTlsKTLS::Available())
+      SSL_CTX_set_options(pImpl->ctx, SSL_OP_ENABLE_KTLS);
+#endif
+
 // Handle session re-negotiation automatically
 //
 // SSL_CTX_set_mode(pImpl->ctx, sslMode);
@@ -804,6 +857,19 @@ const char *XrdTlsContext::Init()
    return 0;
 }
 
+/******************************************************************************/
+/*                             k e r n e l T L S                              */
+/******************************************************************************/
+
+bool XrdTlsContext::kernelTLS()
+{
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+   return pImpl->ctx && (SSL_CTX_get_options(pImpl->ctx) & SSL_OP_ENABLE_KTLS);
+#else
+   return false;
+#endif
+}
+
 /******************************************************************************/
 /*                                  i s O K                                   */
 /******************************************************************************/
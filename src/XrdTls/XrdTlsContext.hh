@@ -137,6 +137,17 @@ static const int scFMax = 0x00007fff; //!< Maximum flush interval in seconds
 
       int       SessionCache(int opts=scNone, const char *id=0, int idlen=0);
 
+//------------------------------------------------------------------------
+//! Check if connections using this context may offload TLS encryption to
+//! the kernel (kTLS). Whether a particular connection does so depends on
+//! the negotiated cipher; see XrdTlsSocket::KernelSend().
+//!
+//! @return True if kTLS was requested (ktlON) and the kernel supports it,
+//!         false otherwise.
+//------------------------------------------------------------------------
+
+       bool     kernelTLS();
+
 //------------------------------------------------------------------------
 //! Set allowed ciphers for this context.
 //!
@@ -195,6 +206,8 @@ void            SetDefaultCiphers(const char *ciphers);
 //!                  crlFC   - Apply crl check to full chain
 //!                  crlRF   - Initial crl refresh interval in minutes.
 //!                  dnsok   - trust DNS when verifying hostname.
+//!                  ktlON   - Offload TLS encryption to the kernel (kTLS)
+//!                            when the kernel and the cipher allow it.
 //!                  hsto    - the handshake timeout value in seconds.
 //!                  logVF   - Turn on verification failure logging.
 //!                  nopxy   - Do not allow proxy cert (normally allowed)
@@ -233,6 +246,7 @@ static const uint64_t crlFC = 0x000000C000000000; //!< Full crl chain checking
 static const uint64_t crlRF = 0x000000003fff0000; //!< Init crl refresh in Min
 static const int      crlRS = 16;                 //!< Bits to shift   vdept
 static const uint64_t artON = 0x0000002000000000; //!< Auto retry Handshake
+static const uint64_t ktlON = 0x0000001000000000; //!< Use kernel TLS offload
 
        XrdTlsContext(const char *cert=0,  const char *key=0,
                      const char *cadir=0, const char *cafile=0,
@@ -28,6 +28,7 @@
 #include <openssl/err.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "XrdNet/XrdNetAddrInfo.hh"
 #include "XrdSys/XrdSysE2T.hh"
@@ -523,6 +524,21 @@ const char *XrdTlsSocket::Init( XrdTlsContext &ctx, int sfd,
    return 0;
 }
 
+/******************************************************************************/
+/*                            K e r n e l S e n d                             */
+/******************************************************************************/
+
+bool XrdTlsSocket::KernelSend()
+{
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+   BIO *wbio;
+   return pImpl->ssl && (wbio = SSL_get_wbio(pImpl->ssl))
+       && BIO_get_ktls_send(wbio);
+#else
+   return false;
+#endif
+}
+
 /******************************************************************************/
 /*                                  P e e k                                   */
 /******************************************************************************/
@@ -763,9 +779,7 @@ void XrdTlsSocket::Shutdown(XrdTlsSocket::SDType sdType)
 XrdTls::RC XrdTlsSocket::Write( const char *buffer, size_t size,
                                 int &bytesWritten )
 {
-    EPNAME("Write");
     XrdSysMutexHelper mHelper;
-    int ssler;
 
     //------------------------------------------------------------------------
     // Serialize call if need be
@@ -780,6 +794,107 @@ XrdTls::RC XrdTlsSocket::Write( const char *buffer, size_t size,
 
     if (pImpl->fatal) return (XrdTls::RC)pImpl->fatal;
 
+    return PutData(buffer, size, bytesWritten);
+}
+
+/******************************************************************************/
+
+XrdTls::RC XrdTlsSocket::Write( const struct iovec *iov, int iocnt,
+                                int &bytesOut, int &recsOut )
+{
+    static const int recMax = SSL3_RT_MAX_PLAIN_LENGTH;
+    XrdSysMutexHelper mHelper;
+    XrdTls::RC retc;
+    char stage[recMax];
+    const char *buff;
+    int blen, n, staged = 0;
+
+    bytesOut = recsOut = 0;
+
+    //------------------------------------------------------------------------
+    // Serialize the whole vector, not just each record, if need be
+    //------------------------------------------------------------------------
+
+    if (pImpl->isSerial) mHelper.Lock(&(pImpl->sslMutex));
+
+    if (pImpl->fatal) return (XrdTls::RC)pImpl->fatal;
+
+    //------------------------------------------------------------------------
+    // Every SSL_write() ends a record. So, pieces are staged until a record
+    // is full. When nothing is staged, the full records of a large piece are
+    // written as they are (OpenSSL splits them) as is the final piece; only
+    // the tail of a large piece that would otherwise end up in a short record
+    // is copied.
+    //------------------------------------------------------------------------
+
+    for (int i = 0; i < iocnt; i++)
+        {buff = (const char *)iov[i].iov_base;
+         blen = iov[i].iov_len;
+         while(blen > 0)
+              {if (!staged && (blen >= recMax || i == iocnt-1))
+                  {n = (i == iocnt-1 ? blen : blen - blen % recMax);
+                   if ((retc = PutAll(buff, n)) != XrdTls::TLS_AOK)
+                      return retc;
+                   bytesOut += n; recsOut += (n + recMax - 1) / recMax;
+                   buff += n; blen -= n;
+                   continue;
+                  }
+               n = (blen < recMax - staged ? blen : recMax - staged);
+               memcpy(stage + staged, buff, n);
+               staged += n; buff += n; blen -= n;
+               if (staged == recMax)
+                  {if ((retc = PutAll(stage, staged)) != XrdTls::TLS_AOK)
+                      return retc;
+                   bytesOut += staged; recsOut++; staged = 0;
+                  }
+              }
+        }
+
+    //------------------------------------------------------------------------
+    // Write whatever is left over as the last record
+    //------------------------------------------------------------------------
+
+    if (staged)
+       {if ((retc = PutAll(stage, staged)) != XrdTls::TLS_AOK) return retc;
+        bytesOut += staged; recsOut++;
+       }
+    return XrdTls::TLS_AOK;
+}
+
+/******************************************************************************/
+/* Private:                       P u t A l l                                 */
+/******************************************************************************/
+
+// Write all of the data, as SSL_write() may write less than asked for. Since
+// the socket blocks for writes, a write that makes no progress is an error.
+// The caller must have serialized the call if need be.
+//
+XrdTls::RC XrdTlsSocket::PutAll( const char *buffer, int size )
+{
+    XrdTls::RC retc;
+    int n;
+
+    while(size > 0)
+         {if ((retc = PutData(buffer, size, n)) != XrdTls::TLS_AOK)
+             return retc;
+          if (n <= 0) return XrdTls::TLS_SYS_Error;
+          buffer += n; size -= n;
+         }
+    return XrdTls::TLS_AOK;
+}
+
+/******************************************************************************/
+/* Private:                      P u t D a t a                                */
+/******************************************************************************/
+
+// The caller must have serialized the call if need be.
+//
+XrdTls::RC XrdTlsSocket::PutData( const char *buffer, size_t size,
+                                  int &bytesWritten )
+{
+    EPNAME("Write");
+    int ssler;
+
     //------------------------------------------------------------------------
     // If necessary, SSL_write() will negotiate a TLS/SSL session, so we don't
     // have to explicitly call SSL_connect or SSL_do_handshake.
@@ -26,6 +26,7 @@
 // Forward declarations
 //----------------------------------------------------------------------------
 
+struct iovec;
 class  XrdNetAddrInfo;
 class  XrdSysError;
 class  XrdTlsContext;
@@ -165,6 +166,17 @@ XrdTlsPeerCerts *getCerts(bool ver=true);
   const char *Init( XrdTlsContext &ctx, int sfd, RW_Mode rwm, HS_Mode hsm,
                     bool isClient, bool serial=true, const char *tid="" );
 
+//------------------------------------------------------------------------
+//! Check if outgoing records are encrypted by the kernel (kTLS). When true,
+//! plaintext written directly to the socket (write, writev, or sendfile)
+//! is sent as TLS records and Write() need not be used. This is only
+//! meaningful after the handshake has completed.
+//!
+//! @return True if the kernel handles transmission, false otherwise.
+//------------------------------------------------------------------------
+
+  bool KernelSend();
+
 //------------------------------------------------------------------------
 //! Peek at the TLS connection data. If necessary, a handshake will be done.
 //!
@@ -239,6 +251,26 @@ XrdTlsPeerCerts *getCerts(bool ver=true);
 
   XrdTls::RC Write( const char *buffer, size_t size, int &bytesOut );
 
+//------------------------------------------------------------------------
+//! Gather write to the TLS connection. The data is packed into full size
+//! TLS records (16KB) regardless of how it is split across the vector so
+//! that small pieces (e.g. response headers) do not each cost a record,
+//! its framing, and usually a TCP segment. All of the data is written
+//! before returning, so the socket should be in blocking write mode. If
+//! necessary, a handshake will be done.
+//!
+//! @param  iov        - Pointer to the vector describing the data.
+//! @param  iocnt      - The number of elements in the vector.
+//! @param  bytesOut   - Number of bytes actually written.
+//! @param  recsOut    - Number of TLS records used to write them.
+//!
+//! @return TLS_AOK if the operation was successful; otherwise the appropraite
+//!                 return code indicating the problem.
+//------------------------------------------------------------------------
+
+  XrdTls::RC Write( const struct iovec *iov, int iocnt,
+                    int &bytesOut, int &recsOut );
+
 //------------------------------------------------------------------------
 //! @return  :  true if the TLS/SSL session is not established yet,
 //!             false otherwise
@@ -258,6 +290,8 @@ void AcceptEMsg(std::string *eWhy, const char *reason);
 int  Diagnose(const char *what, int sslrc, int tcode);
 std::string Err2Text(int sslerr);
 bool NeedHS();
+XrdTls::RC PutAll(const char *buffer, int size);
+XrdTls::RC PutData(const char *buffer, size_t size, int &bytesOut);
 bool Wait4OK(bool wantRead);
 
 XrdTlsSocketImpl *pImpl;
@@ -4,8 +4,8 @@ include( XRootDCommon )
 #-------------------------------------------------------------------------------
 # Shared library version
 #-------------------------------------------------------------------------------
-set( XRD_UTILS_VERSION   3.0.0 )
-set( XRD_UTILS_SOVERSION 3 )
+set( XRD_UTILS_VERSION   4.0.0 )
+set( XRD_UTILS_SOVERSION 4 )
 set( XRD_ZCRC32_VERSION   3.0.0 )
 set( XRD_ZCRC32_SOVERSION 3 )
 
@@ -128,6 +128,7 @@ endif()
   #-----------------------------------------------------------------------------
 set ( XrdOucSources
   XrdOuc/XrdOuca2x.cc           XrdOuc/XrdOuca2x.hh
+  XrdOuc/XrdOucAdler32.cc       XrdOuc/XrdOucAdler32.hh
   XrdOuc/XrdOucArgs.cc          XrdOuc/XrdOucArgs.hh
   XrdOuc/XrdOucBackTrace.cc     XrdOuc/XrdOucBackTrace.hh
   XrdOuc/XrdOucBuffer.cc        XrdOuc/XrdOucBuffer.hh
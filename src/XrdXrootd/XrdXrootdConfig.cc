@@ -778,7 +778,7 @@ int XrdXrootdProtocol::ConfigSecurity(XrdOucEnv &xEnv, const char *cfn)
                                        [minsize <iosz>] [maxstalls <cnt>]
                                        [timeout <tos>]
                                        [Debug] [force] [syncw] [off]
-                                       [nocache] [nosf]
+                                       [nocache] [nordv] [nosf]
 
              <aiopl>  maximum number of async req per link. Default 8.
              <msegs>  maximum number of async ops per request. Default 8.
@@ -800,6 +800,8 @@ int XrdXrootdProtocol::ConfigSecurity(XrdOucEnv &xEnv, const char *cfn)
              syncw    Use synchronous i/o for write requests.
              off      Disables async i/o
              nocache  Disables async I/O is this is a caching proxy.
+             nordv    Disables pipelined readv responses that span more than
+                      one transfer unit. These do not use file system aio.
              nosf     Disables use of sendfile to send data to the client.
 
    Output: 0 upon success or 1 upon failure.
@@ -811,7 +813,7 @@ int XrdXrootdProtocol::xasync(XrdOucStream &Config)
     int  i, ppp;
     int  V_force=-1, V_syncw = -1, V_off = -1, V_mstall = -1, V_nosf = -1;
     int  V_limit=-1, V_msegs=-1, V_mtot=-1, V_minsz=-1, V_segsz=-1;
-    int  V_minsf=-1, V_debug=-1, V_noca=-1, V_tmo=-1;
+    int  V_minsf=-1, V_debug=-1, V_noca=-1, V_tmo=-1, V_nordv=-1;
     long long llp;
     struct asyncopts {const char *opname; int minv; int *oploc;
                       const char *opmsg;} asopts[] =
@@ -820,6 +822,7 @@ int XrdXrootdProtocol::xasync(XrdOucStream &Config)
         {"force",     -1, &V_force, ""},
         {"off",       -1, &V_off,   ""},
         {"nocache",   -1, &V_noca,  ""},
+        {"nordv",     -1, &V_nordv, ""},
         {"nosf",      -1, &V_nosf,  ""},
         {"syncw",     -1, &V_syncw, ""},
         {"limit",      0, &V_limit, "async limit"},
@@ -904,10 +907,11 @@ int XrdXrootdProtocol::xasync(XrdOucStream &Config)
    if (V_mstall> 0) as_maxstalls = V_mstall;
    if (V_debug > 0) asyncFlags  |= asDebug;
    if (V_force > 0) as_force     = true;
-   if (V_off   > 0) as_aioOK     = false;
+   if (V_off   > 0) as_aioOK     = as_rdvaio = false;
    if (V_syncw > 0) as_syncw     = true;
    if (V_noca  > 0) asyncFlags  |= asNoCache;
    if (V_nosf  > 0) as_nosf      = true;
+   if (V_nordv > 0) as_rdvaio    = false;
    if (V_minsf > 0) as_minsfsz   = V_minsf;
 
    return 0;
@@ -84,6 +84,8 @@ struct XrdXrootdGSReal::GSParms gsObj[] =
         {"pfc",    0, XROOTD_MON_PFC,   0, -1, XROOTD_MON_GSPFC, 0,
                    XrdXrootdGSReal::fmtBin, XrdXrootdGSReal::hdrNorm},
         {"TcpMon", 0, XROOTD_MON_TCPMO, 0, -1, XROOTD_MON_GSTCP, 0,
+                   XrdXrootdGSReal::fmtBin, XrdXrootdGSReal::hdrNorm},
+        {"throttle",0,XROOTD_MON_THROT, 0, -1, XROOTD_MON_GSTHR, 0,
                    XrdXrootdGSReal::fmtBin, XrdXrootdGSReal::hdrNorm}
        };
 }
@@ -97,7 +99,7 @@ bool XrdXrootdProtocol::ConfigGStream(XrdOucEnv &myEnv, XrdOucEnv *urEnv)
    XrdXrootdGStream *gs;
    int numgs = sizeof(gsObj)/sizeof(struct XrdXrootdGSReal::GSParms);
    char vbuff[64];
-   bool aOK, gXrd[] = {false, false, true};
+   bool aOK, gXrd[] = {false, false, true, false};
 
 // For each enabled monitoring provider, allocate a g-stream and put
 // its address in our environment.
@@ -177,7 +179,8 @@ bool XrdXrootdProtocol::ConfigMon(XrdProtocol_Config *pi, XrdOucEnv &xrootdEnv)
                                       [rbuff <sz>] [rnums <cnt>] [window <sec>]
                                       [dest [Events] <host:port>]
 
-   Events: [ccm] [files] [fstat] [info] [io] [iov] [pfc] [redir] [tcpmon] [user]
+   Events: [ccm] [files] [fstat] [info] [io] [iov] [pfc] [redir] [tcpmon]
+           [throttle] [user]
 
          all                enables monitoring for all connections.
          auth               add authentication information to "user".
@@ -209,6 +212,7 @@ bool XrdXrootdProtocol::ConfigMon(XrdProtocol_Config *pi, XrdOucEnv &xrootdEnv)
          pfc                monitor proxy file cache
          redir              monitors request redirections
          tcpmon             monitors tcp connection closes.
+         throttle           monitor per-user throttle statistics
          user               monitors user login and disconnect events.
          <host:port>        where monitor records are to be sentvia UDP.
 
@@ -339,6 +343,7 @@ int XrdXrootdProtocol::xmon(XrdOucStream &Config)
               else if (!strcmp("pfc",  val)) MP->monMode[i] |=  XROOTD_MON_PFC;
               else if (!strcmp("redir",val)) MP->monMode[i] |=  XROOTD_MON_REDR;
               else if (!strcmp("tcpmon",val))MP->monMode[i] |=  XROOTD_MON_TCPMO;
+              else if (!strcmp("throttle",val))MP->monMode[i]|= XROOTD_MON_THROT;
               else if (!strcmp("user", val)) MP->monMode[i] |=  XROOTD_MON_USER;
               else break;
 
@@ -429,7 +434,7 @@ char *XrdXrootdProtocol::xmondest(const char *what, char *val)
 
    Purpose:  Parse directive: mongstream <strm> use <opts>
 
-   <strm>:  {all | ccm | pfc | tcpmon}  [<strm>]
+   <strm>:  {all | ccm | pfc | tcpmon | throttle}  [<strm>]
 
    <opts>:  [flust <t>] [maxlen <l>] [send <fmt> [noident] <host:port>]
 
@@ -441,6 +446,7 @@ char *XrdXrootdProtocol::xmondest(const char *what, char *val)
          ccm                gstream: cache context management
          pfc                gstream: proxy file cache
          tcpmon             gstream: tcp connection monitoring
+         throttle           gstream: throttle plugin per-user statistics
 
          noXXX              do not include information.
 
@@ -461,7 +467,8 @@ int XrdXrootdProtocol::xmongs(XrdOucStream &Config)
    int numopts = sizeof(gsopts)/sizeof(struct gsOpts);
 
    int numgs = sizeof(gsObj)/sizeof(struct XrdXrootdGSReal::GSParms);
-   int selAll = XROOTD_MON_CCM | XROOTD_MON_PFC | XROOTD_MON_TCPMO;
+   int selAll = XROOTD_MON_CCM | XROOTD_MON_PFC | XROOTD_MON_TCPMO
+              | XROOTD_MON_THROT;
    int i, selMon = 0, opt = -1, hdr = -1, fmt = -1, flushVal = -1;
    long long maxlVal = -1;
    char *val, *dest = 0;
@@ -116,6 +116,7 @@ const kXR_char XROOTD_MON_MAPXFER       = 'x';
 const kXR_char XROOTD_MON_GSCCM         = 'M'; // pfc: Cache context mgt info
 const kXR_char XROOTD_MON_GSPFC         = 'C'; // pfc: Cache monitoring  info
 const kXR_char XROOTD_MON_GSTCP         = 'T'; // TCP connection statistics
+const kXR_char XROOTD_MON_GSTHR         = 'R'; // Throttle (rate limit) statistics
 
 // The following bits are insert in the low order 4 bits of the MON_REDIRECT
 // entry code to indicate the actual operation that was requestded.
@@ -28,12 +28,14 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include "XrdVersion.hh"
 
@@ -42,6 +44,7 @@
 #include "XrdOuc/XrdOucUtils.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
 #include "Xrd/XrdScheduler.hh"
 #include "XrdXrootd/XrdXrootdMonitor.hh"
@@ -196,6 +199,248 @@ XrdScheduler  *Sched;     // System scheduler
 int            Window;
 };
 
+/******************************************************************************/
+/*          C l a s s   X r d X r o o t d M o n i t o r _ S e n d e r         */
+/******************************************************************************/
+
+// Finished packets are copied into a bounded multi-producer single-consumer
+// ring and sent by a dedicated thread so that threads producing monitoring
+// data never wait on a collector or on each other. Each slot has a buffer
+// preallocated to hold the largest monitor buffer so that posting a packet is
+// a plain copy; the rare larger packet is copied into heap memory. The thread
+// drains the ring in batches and sends each batch to each destination with a
+// single system call, releasing the slots only once the batch is sent.
+// Sequence numbers are assigned per destination as packets are sent. Should
+// the ring be full, the packet is dropped and counted.
+//
+class XrdXrootdMonitor_Sender
+{
+public:
+
+bool          Post(int mMode, const void *buff, int blen, bool setseq);
+
+void          Run();
+
+bool          Start(int bsz);
+
+              XrdXrootdMonitor_Sender() : slotMem(0), slotSize(0),
+                                          enqPos(0), deqPos(0), isIdle(false),
+                                          Drops(0), dropsSaid(0), nextSay(0),
+                                          seq1(0), seq2(0)
+                                        {for (unsigned int i = 0; i < qSize; i++)
+                                             ring[i].seq = i;
+                                        }
+             ~XrdXrootdMonitor_Sender() {free(slotMem);}
+
+private:
+
+static const unsigned int qSize = 256;  // Must be a power of two
+static const int          bMax  = 64;   // Most packets sent in one go
+
+struct Slot
+      {std::atomic<unsigned int> seq;
+       char                     *buff;  // Preallocated slotSize bytes
+       char                     *data;  // Either buff or heap memory
+       int                       blen;
+       int                       mMode;
+       bool                      setseq;
+      };
+
+void          Batch(XrdNetMsg *dest, int dMode, int &seq, Slot **sv, int sn);
+
+Slot                      ring[qSize];
+char                     *slotMem;
+int                       slotSize;
+std::atomic<unsigned int> enqPos;
+unsigned int              deqPos;
+std::atomic<bool>         isIdle;
+std::atomic<long long>    Drops;
+long long                 dropsSaid;
+time_t                    nextSay;
+XrdSysSemaphore           wakeUp;
+int                       seq1;
+int                       seq2;
+};
+
+namespace
+{
+XrdXrootdMonitor_Sender *monSender = 0; // Never deleted once running
+
+void *XrdXrootdMonitorSend(void *pp)
+{
+   XrdXrootdMonitor_Sender *sP = (XrdXrootdMonitor_Sender *)pp;
+   sP->Run();
+   return (void *)0;
+}
+}
+
+/******************************************************************************/
+/*                 X r d X r o o t d M o n i t o r _ S e n d e r              */
+/******************************************************************************/
+/******************************************************************************/
+/*                                 B a t c h                                  */
+/******************************************************************************/
+
+void XrdXrootdMonitor_Sender::Batch(XrdNetMsg *dest, int dMode, int &seq,
+                                    Slot **sv, int sn)
+{
+#ifndef NODEBUG
+   const char *TraceID = "MonSend";
+#endif
+   struct iovec iov[bMax];
+   int n = 0, rc;
+
+// Select the packets this destination wants, sequencing them as needed. The
+// header is rewritten for each destination, it's fine as we send right away.
+//
+   for (int i = 0; i < sn; i++)
+       {if (!(sv[i]->mMode & dMode)) continue;
+        if (sv[i]->setseq)
+           ((XrdXrootdMonHeader *)sv[i]->data)->pseq = (seq++) & 0xff;
+        iov[n].iov_base = sv[i]->data;
+        iov[n].iov_len  = sv[i]->blen;
+        n++;
+       }
+
+// Send them off
+//
+   if (n)
+      {rc = dest->SendBatch(iov, n);
+       TRACE(DEBUG, n <<" packets sent to "
+                    <<(dest == XrdXrootdMonitor::InetDest1
+                               ? XrdXrootdMonitor::Dest1
+                               : XrdXrootdMonitor::Dest2) <<" rc=" <<rc);
+      }
+}
+
+/******************************************************************************/
+/*                                  P o s t                                   */
+/******************************************************************************/
+
+bool XrdXrootdMonitor_Sender::Post(int mMode, const void *buff, int blen,
+                                   bool setseq)
+{
+   unsigned int pos;
+   char *data = 0;
+   Slot *sP;
+   int   dif;
+
+// A packet larger than a slot buffer needs memory of its own. The caller
+// reuses the buffer as soon as we return so we must copy it in any case.
+//
+   if (blen > slotSize && !(data = (char *)malloc(blen)))
+      {Drops++; return false;}
+
+// Claim the next slot. A slot is free when its sequence equals the position
+// and it is filled when the sequence is one beyond it. A slot that is still
+// occupied from the previous lap means the ring is full.
+//
+   pos = enqPos.load(std::memory_order_relaxed);
+   while(true)
+        {sP = &ring[pos & (qSize-1)];
+         dif = (int)(sP->seq.load(std::memory_order_acquire) - pos);
+         if (!dif)
+            {if (enqPos.compare_exchange_weak(pos, pos+1,
+                                              std::memory_order_relaxed)) break;
+            }
+            else if (dif < 0) {free(data); Drops++; return false;}
+                    else pos = enqPos.load(std::memory_order_relaxed);
+        }
+
+// Fill the slot and publish it. Wake up the sender should it be waiting.
+//
+   if (!data) data = sP->buff;
+   memcpy(data, buff, blen);
+   sP->data   = data;
+   sP->blen   = blen;
+   sP->mMode  = mMode;
+   sP->setseq = setseq;
+   sP->seq.store(pos+1);
+   if (isIdle.load() && isIdle.exchange(false)) wakeUp.Post();
+   return true;
+}
+
+/******************************************************************************/
+/*                                   R u n                                    */
+/******************************************************************************/
+
+void XrdXrootdMonitor_Sender::Run()
+{
+   Slot     *sv[bMax], *sP;
+   long long nDrops;
+   time_t    Now;
+   int       sn;
+
+// Drain the ring in batches; sleeping when it is empty. The slots of a batch
+// stay ours until they are released after the batch has been sent.
+//
+   while(true)
+        {for (sn = 0; sn < bMax; sn++)
+             {sP = &ring[(deqPos+sn) & (qSize-1)];
+              if (sP->seq.load(std::memory_order_acquire) != deqPos+sn+1) break;
+              sv[sn] = sP;
+             }
+
+         if (!sn)
+            {isIdle = true;
+             if (ring[deqPos & (qSize-1)].seq.load() != deqPos+1) wakeUp.Wait();
+             isIdle = false;
+             continue;
+            }
+
+         if (XrdXrootdMonitor::InetDest1)
+            Batch(XrdXrootdMonitor::InetDest1, XrdXrootdMonitor::monMode1,
+                  seq1, sv, sn);
+         if (XrdXrootdMonitor::InetDest2)
+            Batch(XrdXrootdMonitor::InetDest2, XrdXrootdMonitor::monMode2,
+                  seq2, sv, sn);
+
+         for (int i = 0; i < sn; i++)
+             {if (sv[i]->data != sv[i]->buff) free(sv[i]->data);
+              sv[i]->seq.store(deqPos+qSize, std::memory_order_release);
+              deqPos++;
+             }
+
+         // Report drops but not too often
+         //
+         if ((nDrops = Drops.load()) != dropsSaid && (Now = time(0)) >= nextSay)
+            {char buff[64];
+             snprintf(buff, sizeof(buff), "%lld", nDrops - dropsSaid);
+             eDest->Emsg("Monitor", buff, "packets dropped; send queue full.");
+             dropsSaid = nDrops;
+             nextSay   = Now + 60;
+            }
+        }
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+
+bool XrdXrootdMonitor_Sender::Start(int bsz)
+{
+   pthread_t tid;
+
+// Allocate the slot buffers, keeping each one aligned
+//
+   slotSize = (bsz + 63) & ~63;
+   if (posix_memalign((void **)&slotMem, getpagesize(), qSize*slotSize))
+      {slotMem = 0;
+       eDest->Emsg("Monitor", ENOMEM, "allocate send queue; sending inline.");
+       return false;
+      }
+   for (unsigned int i = 0; i < qSize; i++) ring[i].buff = slotMem + i*slotSize;
+
+// Start the thread that sends the packets
+//
+   if (XrdSysThread::Run(&tid, XrdXrootdMonitorSend, (void *)this,
+                         0, "Monitor sender"))
+      {eDest->Emsg("Monitor", errno, "start monitor sender; sending inline.");
+       return false;
+      }
+   return true;
+}
+
 /******************************************************************************/
 /*            C l a s s   X r d X r o o t d M o n i t o r L o c k             */
 /******************************************************************************/
@@ -716,6 +961,16 @@ int XrdXrootdMonitor::Init()
           }
       }
 
+// Start the thread that sends the packets (we send inline should this fail).
+// Its queue holds packets as large as the largest monitor buffer.
+//
+   if ((InetDest1 || InetDest2) && !monSender)
+      {int bsz = (monBlen > monRlen ? monBlen : monRlen);
+       if (bsz < (int)sizeof(XrdXrootdMonMap)) bsz = sizeof(XrdXrootdMonMap);
+       monSender = new XrdXrootdMonitor_Sender;
+       if (!monSender->Start(bsz)) {delete monSender; monSender = 0;}
+      }
+
 // Now schedule the first identification record
 //
    if (Sched && monIdent >= 0) Sched->Schedule((XrdJob *)&MonIdent);
@@ -1163,6 +1418,11 @@ int XrdXrootdMonitor::Send(int monMode, void *buff, int blen, bool setseq)
     XrdXrootdMonHeader *mHdr=0;
     int rc1, rc2;
 
+// Hand off the packet to the sender thread if it's running so that we never
+// wait here. We return -1 if the packet had to be dropped.
+//
+   if (monSender) return (monSender->Post(monMode, buff, blen, setseq) ? 0 : -1);
+
 // If we are to set sequence numbers, recast the buffer. We are assured that
 // the buffer always starts with the standard monitor header.
 //
@@ -57,7 +57,9 @@
 #define XROOTD_MON_CCM   0x00000200
 #define XROOTD_MON_PFC   0x00000400
 #define XROOTD_MON_TCPMO 0x00000800
-#define XROOTD_MON_GSTRM (XROOTD_MON_CCM | XROOTD_MON_PFC | XROOTD_MON_TCPMO)
+#define XROOTD_MON_THROT 0x00001000
+#define XROOTD_MON_GSTRM (XROOTD_MON_CCM | XROOTD_MON_PFC | XROOTD_MON_TCPMO \
+                        | XROOTD_MON_THROT)
 
 #define XROOTD_MON_FSLFN    1
 #define XROOTD_MON_FSOPS    2
@@ -78,6 +80,7 @@ public:
        class User;
 friend class User;
 friend class XrdXrootdMonFile;
+friend class XrdXrootdMonitor_Sender;
 
 // All values for Add_xx() must be passed in network byte order
 //
@@ -160,6 +160,7 @@ void XrdXrootdPgrwAio::CopyF2L()
 {
    XrdXrootdAioBuff *bP;
    XrdXrootdAioPgrw *aioP;
+   bool aOK = true;
 
 // Pick a finished element off the pendQ. Wait for an oustanding buffer if we
 // reached our buffer limit. Otherwise, ask for a return if we can start anew.
@@ -195,26 +196,73 @@ do{bool doWait = dataLen <= 0 || inFlight >= XrdXrootdProtocol::as_maxperreq;
       XrdOucPgrwUtils::csCalc((char *)aioP->sfsAio.aio_buf,
                        aioP->sfsAio.aio_offset, aioP->Result, aioP->cksVec);
 
-// Step 5: If this is the last block to be read then save it for final status
+// Step 5: Since block may come back out of order we need to make sure we are
+//         sending then in proper order with no gaps. Each response carries
+//         its offset but clients place the data in the order it arrives.
+//
+   if (aioP->sfsAio.aio_offset != sendOffset && !isDone)
+      {XrdXrootdAioBuff *qP = sendQ, *qPP = 0;
+       while(qP)
+            {if (aioP->sfsAio.aio_offset < qP->sfsAio.aio_offset) break;
+             qPP = qP; qP = qP->next;
+            }
+       bP->next = qP;
+       if (qPP) qPP->next = bP;
+          else  sendQ = bP;
+       reorders++;
+       TRACEP(FSAIO,"pgrd inQ "<<aioP->Result<<'@'<<aioP->sfsAio.aio_offset);
+       continue;
+      }
+
+// Step 6: If this is the last block to be read then establish the actual
+//         last block to be used for final status.
 //
    if (inFlight == 0 && dataLen == 0 && !finalRead)
-      {finalRead = aioP;
-       break;
+      {if (!sendQ)
+          {finalRead = aioP;
+           break;
+          } else {
+           XrdXrootdAioBuff *qP = sendQ, *qPP = 0;
+           while(qP->next) {qPP = qP; qP = qP->next;}
+           if (qPP) {finalRead = qP; qPP->next = 0;}
+              else  {finalRead = sendQ; sendQ = 0;}
+          }
       }
 
-// Step 8: Send the data to the client and if successful, see if we need to
+// Step 7: Send the data to the client and if successful, see if we need to
 //         schedule more data to be read from the data source.
 //
    if (!isDone && SendData(aioP) && dataLen) {if (!CopyF2L_Add2Q(aioP)) break;}
       else aioP->Recycle();
 
-   } while(inFlight > 0);
+// Step 8: Now send any queued blocks that are eligible to be sent
+//
+   while(sendQ && sendQ->sfsAio.aio_offset == sendOffset && aOK)
+      {aioP  = sendQ->pgrwP;
+       sendQ = sendQ->next;
+       TRACEP(FSAIO,"pgrd deQ "<<aioP->Result<<'@'<<aioP->sfsAio.aio_offset);
+       if (!isDone && SendData(aioP) && dataLen) aOK = CopyF2L_Add2Q(aioP);
+          else aioP->Recycle();
+      }
+
+   } while(inFlight > 0 && aOK);
 
 // If we are here then the request has finished. If all went well,
 // fire off the final response.
 //
-   if (!isDone) SendData(finalRead, true);
+   if (!isDone)
+      {if (sendQ)
+          {char ebuff[80];
+           snprintf(ebuff, sizeof(ebuff), "aio read failed at offset %lld; "
+                    "missing data", static_cast<long long>(sendOffset));
+           SendError(ENODEV, ebuff);
+          } else SendData(finalRead, true);
+      }
+
+// Cleanup anything left over
+//
    if (finalRead) finalRead->Recycle();
+   while((bP = sendQ)) {sendQ = sendQ->next; bP->Recycle();}
 
 // If we encountered a fatal link error then cancel any pending aio reads on
 // this link. Otherwise if we have not yet scheduled the next aio, do so.
@@ -365,7 +413,7 @@ void XrdXrootdPgrwAio::Read(long long offs, int dlen)
 
 // Setup the copy from the file to the network
 //
-   dataOffset = highOffset = offs;
+   dataOffset = highOffset = sendOffset = offs;
    dataLen    = dlen;
    aioState   = aioRead | aioPage;
 
@@ -403,8 +451,9 @@ void XrdXrootdPgrwAio::Recycle(bool release)
 // Do some traceing
 //
    TRACEP(FSAIO,"pgrw recycle "<<(release ? "" : "hold ")
-                <<(aioState & aioRead ? 'R' : 'W')<<" D-S="
-                <<isDone<<'-'<<int(Status));
+                <<(aioState & aioRead ? 'R' : 'W')<<"; reorders="<<reorders
+                <<" D-S="<<isDone<<'-'<<int(Status));
+   reorders = 0;
 
 // Place the object on the free queue if possible
 //
@@ -449,6 +498,7 @@ bool XrdXrootdPgrwAio::SendData(XrdXrootdAioBuff *bP, bool final)
        struct iovec *ioVec = bP->pgrwP->iov4Send(iovNum, iovLen, true);
        pgrResp.ofs = htonll(bP->sfsAio.aio_offset);
        rc = Response.Send(pgrResp.rsp, infoLen, ioVec, iovNum, iovLen);
+       sendOffset = bP->sfsAio.aio_offset + bP->Result;
       } else {
        pgrResp.rsp.bdy.dlen = 0;
        pgrResp.ofs          = htonll(dataOffset);
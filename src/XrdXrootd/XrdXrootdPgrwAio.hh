@@ -56,7 +56,8 @@ static const int    aioSZ = 64*1024; // 64K I/O size
 
 private:
 
-         XrdXrootdPgrwAio() : XrdXrootdAioTask("pgaio request") {}
+         XrdXrootdPgrwAio() : XrdXrootdAioTask("pgaio request"),
+                              sendQ(0), reorders(0) {}
 virtual ~XrdXrootdPgrwAio() {}
 
        bool               CopyF2L_Add2Q(XrdXrootdAioPgrw *aioP=0);
@@ -70,5 +71,8 @@ virtual ~XrdXrootdPgrwAio() {}
 static const char        *TraceID;
 
        XrdXrootdPgwBadCS *badCSP;     // -> Bad checksum recorder
+       XrdXrootdAioBuff  *sendQ;
+       off_t              sendOffset; // Required offset of next chunk to send
+       int                reorders;   // Number of buffers that were reordered
 };
 #endif
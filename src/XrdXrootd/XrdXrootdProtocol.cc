@@ -130,6 +130,7 @@ short                 XrdXrootdProtocol::as_timeout   = 45;
 bool                  XrdXrootdProtocol::as_force     = false;
 bool                  XrdXrootdProtocol::as_aioOK     = true;
 bool                  XrdXrootdProtocol::as_nosf      = false;
+bool                  XrdXrootdProtocol::as_rdvaio    = true;
 bool                  XrdXrootdProtocol::as_syncw     = false;
 
 const char           *XrdXrootdProtocol::myInst  = 0;
@@ -69,6 +69,7 @@
 class XrdNetSocket;
 class XrdOucEnv;
 class XrdOucErrInfo;
+struct XrdOucIOVec;
 class XrdOucReqID;
 class XrdOucStream;
 class XrdOucTList;
@@ -89,6 +90,7 @@ class XrdXrootdJob;
 class XrdXrootdMonitor;
 class XrdXrootdPgwCtl;
 class XrdXrootdPio;
+class XrdXrootdRdvAio;
 class XrdXrootdStats;
 class XrdXrootdWVInfo;
 class XrdXrootdXPath;
@@ -228,6 +230,7 @@ static short         as_timeout;   // request timeout (usually < stream timeout)
 static bool          as_force;     // aio to be forced
 static bool          as_aioOK;     // aio is enabled
 static bool          as_nosf;      // sendfile is disabled
+static bool          as_rdvaio;    // readv responses may be pipelined
 static bool          as_syncw;     // writes to be synchronous
 
 private:
@@ -280,6 +283,10 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_Qxattr();
        int   do_Read();
        int   do_ReadV();
+       int   do_ReadVAio(XrdXrootdRdvAio *aioP, XrdOucIOVec *rdVec,
+                         int rdVNum);
+       void  do_ReadVMon(XrdOucIOVec *rdVec, int rdVBeg, int rdVEnd,
+                         int rdVXfr);
        int   do_ReadAll();
        int   do_ReadNone(int &retc, int &pathID);
        int   do_Rm();
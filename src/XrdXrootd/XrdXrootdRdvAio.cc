@@ -0,0 +1,372 @@
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d X r o o t d R d v A i o . c c                     */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "Xrd/XrdBuffer.hh"
+#include "Xrd/XrdLink.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysPlatform.hh"
+#include "XrdXrootd/XrdXrootdFile.hh"
+#include "XrdXrootd/XrdXrootdProtocol.hh"
+#include "XrdXrootd/XrdXrootdRdvAio.hh"
+#include "XrdXrootd/XrdXrootdTrace.hh"
+
+#define TRACELINK dataLink
+ 
+/******************************************************************************/
+/*                        G l o b a l   S t a t i c s                         */
+/******************************************************************************/
+
+extern XrdSysTrace  XrdXrootdTrace;
+
+namespace XrdXrootd
+{
+extern XrdBuffManager *BPool;
+extern XrdSysError     eLog;
+extern XrdScheduler   *Sched;
+}
+using namespace XrdXrootd;
+  
+/******************************************************************************/
+/*                       S t a t i c   M e m e b e r s                        */
+/******************************************************************************/
+
+const char *XrdXrootdRdvAio::TraceID = "RdvAio";
+  
+/******************************************************************************/
+/*                         L o c a l   S t a t i c s                          */
+/******************************************************************************/
+
+namespace
+{
+XrdSysMutex       fqMutex;
+XrdXrootdRdvAio  *fqFirst = 0;
+int               numFree = 0;
+
+static const int  maxKeep = 16; // Keep in reserve (objects are large)
+static const int  hdrSZ   = sizeof(readahead_list);
+}
+
+/******************************************************************************/
+/*                                   A d d                                    */
+/******************************************************************************/
+  
+void XrdXrootdRdvAio::Add(XrdXrootdFile *fP, XrdOucIOVec &ioV)
+{
+// Start a new quantum if this element does not fit in the current one. This
+// is the same layout that the synchronous readv uses.
+//
+   if (qLeft < ioV.size + hdrSZ)
+      {qBeg[numQ++] = numV;
+       qLeft = qSize;
+      }
+   qLeft -= ioV.size + hdrSZ;
+
+// Record the element
+//
+   rdvFile[numV]  = fP;
+   rdvVec[numV++] = ioV;
+}
+
+/******************************************************************************/
+/*                                 A l l o c                                  */
+/******************************************************************************/
+  
+XrdXrootdRdvAio *XrdXrootdRdvAio::Alloc(XrdXrootdProtocol *protP,
+                                        XrdXrootdResponse &resp, int qSize)
+{
+   XrdXrootdRdvAio *reqP;
+
+// Obtain a preallocated request object
+//
+   fqMutex.Lock();
+   if ((reqP = fqFirst))
+      {fqFirst = reqP->nextFree;
+       numFree--;
+      }
+   fqMutex.UnLock();
+
+// If we have no object, create a new one
+//
+   if (!reqP) reqP = new XrdXrootdRdvAio;
+
+// Initialize the object
+//
+   reqP->Protocol = protP;
+   reqP->dataLink = resp.theLink();
+   reqP->Response = resp;
+   reqP->errFile  = 0;
+   reqP->errRC    = 0;
+   reqP->qSize    = qSize;
+   reqP->qLeft    = 0;
+   reqP->numQ     = reqP->numV = 0;
+   reqP->nextFill = reqP->nextSend = 0;
+   reqP->isDone   = reqP->isLive = false;
+   reqP->rdActive = reqP->rdFail = reqP->txActive = false;
+
+// Obtain the buffers we will alternate between
+//
+   for (int i = 0; i < nBuff; i++)
+       if (!(reqP->rdvBuff[i] = BPool->Obtain(qSize)))
+          {reqP->Recycle();
+           return 0;
+          }
+   return reqP;
+}
+  
+/******************************************************************************/
+/*                                  D o I t                                   */
+/******************************************************************************/
+
+// This is the reader. It fills as many quanta as there are free buffers and
+// starts the sender as each one becomes ready. It stops when both buffers are
+// full, all quanta have been read, or an error occurred. The sender restarts
+// it when a buffer is freed.
+  
+void XrdXrootdRdvAio::DoIt()
+{
+   int bNum, dLen, qNum;
+   bool isFin;
+
+   rdvMutex.Lock();
+   while(!isDone && canFill())
+        {qNum = nextFill; bNum = qNum % nBuff;
+         rdvMutex.UnLock();
+         dLen = Fill(qNum, rdvBuff[bNum]->buff);
+         rdvMutex.Lock();
+         rdvBLen[bNum] = dLen;
+         nextFill++;
+         if (dLen < 0) rdFail = true;
+         if (!txActive)
+            {txActive = true;
+             Sched->Schedule(&xmitJob);
+            }
+        }
+   rdActive = false;
+   isFin = isDone && !txActive;
+   rdvMutex.UnLock();
+
+// If the sender finished while we were reading then it's up to us to cleanup
+//
+   if (isFin) Recycle();
+}
+
+/******************************************************************************/
+/* Private:                         F i l l                                   */
+/******************************************************************************/
+  
+int XrdXrootdRdvAio::Fill(int qNum, char *buff)
+{
+   struct readahead_list respHdr;
+   XrdXrootdFile *fP;
+   XrdSfsXferSize rdVAmt, xfrSZ;
+   char *buffp = buff;
+   int i, k, qEnd = qBeg[qNum+1];
+
+// Run through the elements of this quantum issuing one readv() for each run
+// of elements that refer to the same file. Each element is preceded by its
+// response header.
+//
+   for (i = qBeg[qNum]; i < qEnd; i = k)
+       {fP = rdvFile[i]; rdVAmt = 0;
+        memcpy(respHdr.fhandle, &rdvVec[i].info, sizeof(respHdr.fhandle));
+        for (k = i; k < qEnd && rdvVec[k].info == rdvVec[i].info; k++)
+            {xfrSZ = rdvVec[k].size; rdVAmt += xfrSZ;
+             respHdr.rlen   = htonl(xfrSZ);
+             respHdr.offset = htonll(rdvVec[k].offset);
+             memcpy(buffp, &respHdr, hdrSZ);
+             rdvVec[k].data = buffp + hdrSZ;
+             buffp += (xfrSZ+hdrSZ);
+            }
+        xfrSZ = fP->XrdSfsp->readv(&rdvVec[i], k-i);
+        TRACEP(FSAIO, "rdv fill q=" <<qNum <<" segs=" <<k-i <<" amt=" <<rdVAmt
+                      <<" result=" <<xfrSZ);
+        if (xfrSZ != rdVAmt)
+           {if (xfrSZ >= 0)
+               {xfrSZ = SFS_ERROR;
+                fP->XrdSfsp->error.setErrInfo(-ENODATA,"readv past EOF");
+               }
+            errFile = fP;
+            errRC   = xfrSZ;
+            return -1;
+           }
+       }
+
+// Return the number of bytes placed in the buffer
+//
+   return buffp - buff;
+}
+
+/******************************************************************************/
+/*                                  R e a d                                   */
+/******************************************************************************/
+
+void XrdXrootdRdvAio::Read()
+{
+
+// Close off the quantum list
+//
+   qBeg[numQ] = numV;
+   isLive     = true;
+   rdActive   = true;
+
+// Reads run disconnected and are self-terminating, so we need to increase the
+// refcount for the link we will be using to prevent it from disapearing. Each
+// file is referenced once per run of elements. We also account for the aio
+// request and the buffers we hold as these count against the aio limits.
+//
+   dataLink->setRef(1);
+   for (int i = 0; i < numV; i++)
+       if (!i || rdvFile[i] != rdvFile[i-1]) rdvFile[i]->Ref(1);
+   Protocol->aioUpdReq(1);
+   Protocol->aioUpdate(nBuff);
+
+// Schedule ourselves to run this asynchronously and return
+//
+   TRACEP(FSAIO, "rdv beg " <<numV <<" segs in " <<numQ <<" quanta");
+   Sched->Schedule(this);
+}
+  
+/******************************************************************************/
+/*                               R e c y c l e                                */
+/******************************************************************************/
+
+void XrdXrootdRdvAio::Recycle()
+{
+// Update request count, file and link reference count
+//
+   if (isLive)
+      {for (int i = 0; i < numV; i++)
+           if (!i || rdvFile[i] != rdvFile[i-1]) rdvFile[i]->Ref(-1);
+       Protocol->aioUpdate(-nBuff);
+       Protocol->aioUpdReq(-1);
+       TRACEP(FSAIO, "rdv recycle; sent " <<nextSend <<" of " <<numQ
+                     <<" quanta");
+       dataLink->setRef(-1);
+       isLive = false;
+      }
+
+// Return the buffers
+//
+   for (int i = 0; i < nBuff; i++)
+       if (rdvBuff[i]) {BPool->Release(rdvBuff[i]); rdvBuff[i] = 0;}
+
+// Place the object on the free queue if possible
+//
+   fqMutex.Lock();
+   if (numFree >= maxKeep)
+      {fqMutex.UnLock();
+       delete this;
+      } else {
+       nextFree = fqFirst;
+       fqFirst = this;
+       numFree++;
+       fqMutex.UnLock();
+      }
+}
+
+/******************************************************************************/
+/* Private:                  S e n d F S E r r o r                            */
+/******************************************************************************/
+  
+void XrdXrootdRdvAio::SendFSError()
+{
+   XrdOucErrInfo &myError = errFile->XrdSfsp->error;
+   const char *eMsg;
+   int eCode, rc;
+
+// We can only handle actual errors. Anything else is treated as a server error.
+//
+   if (errRC != SFS_ERROR)
+      {char eBuff[256];
+       snprintf(eBuff, sizeof(eBuff), "fs returned unexpected rc %d", errRC);
+       eLog.Emsg("RdvAio", dataLink->ID, eBuff, errFile->FileKey);
+       rc = Response.Send(kXR_ServerError, eBuff);
+      } else {
+       eMsg = myError.getErrText(eCode);
+       eLog.Emsg("RdvAio", dataLink->ID, eMsg, errFile->FileKey);
+       rc = Response.Send((XErrorCode)XProtocol::mapError(eCode), eMsg);
+      }
+
+// Clear error message
+//
+   if (myError.extData()) myError.Reset();
+   if (rc) TRACEP(FSAIO, "rdv error response failed");
+}
+
+/******************************************************************************/
+/* Private:                       X m i t 2 L                                 */
+/******************************************************************************/
+
+// This is the sender. It sends filled quanta in order, the last one as the
+// final response, and restarts the reader whenever a buffer becomes free.
+  
+void XrdXrootdRdvAio::Xmit2L()
+{
+   XResponseType code;
+   int bNum, dLen, qNum;
+   bool isFin, isLast;
+
+   rdvMutex.Lock();
+   while(!isDone && nextSend < nextFill)
+        {qNum = nextSend; bNum = qNum % nBuff; dLen = rdvBLen[bNum];
+         rdvMutex.UnLock();
+         if (dLen < 0)
+            {SendFSError();
+             isLast = true;
+            } else {
+             isLast = (qNum+1 == numQ);
+             code   = (isLast ? kXR_ok : kXR_oksofar);
+             if (Response.Send(code, rdvBuff[bNum]->buff, dLen) < 0)
+                {TRACEP(FSAIO, "rdv send failed at quantum " <<qNum);
+                 isLast = true;
+                }
+            }
+         rdvMutex.Lock();
+         nextSend++;
+         if (isLast) isDone = true;
+            else if (!rdActive && canFill())
+                    {rdActive = true;
+                     Sched->Schedule(this);
+                    }
+        }
+   txActive = false;
+   isFin = isDone && !rdActive;
+   rdvMutex.UnLock();
+
+// If the reader is idle then it's up to us to cleanup
+//
+   if (isFin) Recycle();
+}
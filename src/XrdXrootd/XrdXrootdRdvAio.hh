@@ -0,0 +1,127 @@
+#ifndef __XRDXROOTDRDVAIO_HH__
+#define __XRDXROOTDRDVAIO_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                    X r d X r o o t d R d v A i o . h h                     */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "Xrd/XrdJob.hh"
+#include "XProtocol/XProtocol.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdXrootd/XrdXrootdResponse.hh"
+
+class XrdBuffer;
+class XrdLink;
+class XrdXrootdFile;
+class XrdXrootdProtocol;
+
+// The XrdXrootdRdvAio class runs a kXR_readv request that spans more than one
+// transfer quantum. The response is laid out into quanta when the request is
+// set up. The object itself is the reader job which fills the quanta using the
+// file system readv() while a companion sender job writes filled quanta to the
+// link. Two buffers are used so that the next quantum is read from disk while
+// the previous one is on the wire. Neither job runs on the link thread.
+//
+class XrdXrootdRdvAio : public XrdJob
+{
+public:
+
+// Add() appends a read element for file fP to the request. It must be called,
+// in vector order, for every element before Read() is called.
+//
+       void             Add(XrdXrootdFile *fP, XrdOucIOVec &ioV);
+
+static XrdXrootdRdvAio *Alloc(XrdXrootdProtocol *protP,
+                              XrdXrootdResponse &resp, int qSize);
+
+       void             DoIt() override;
+
+// Read() starts the request. The object recycles itself upon completion.
+//
+       void             Read();
+
+// Recycle() returns an object that was never started to the free queue.
+//
+       void             Recycle();
+
+private:
+
+         XrdXrootdRdvAio() : XrdJob("readv aio request"), xmitJob(this),
+                             rdvBuff{0, 0} {}
+virtual ~XrdXrootdRdvAio() {}
+
+class Xmit : public XrdJob
+     {public:
+      void             DoIt() override {rdvP->Xmit2L();}
+                       Xmit(XrdXrootdRdvAio *rP)
+                           : XrdJob("readv aio send"), rdvP(rP) {}
+                      ~Xmit() {}
+      XrdXrootdRdvAio *rdvP;
+     };
+
+       bool             canFill()
+                               {return !rdFail && nextFill < numQ
+                                    && nextFill < nextSend + nBuff;
+                               }
+       int              Fill(int qNum, char *buff);
+       void             SendFSError();
+       void             Xmit2L();
+
+static const char      *TraceID;
+static const int        nBuff = 2;
+static const int        maxVec = XrdProto::maxRvecsz;
+
+       XrdSysMutex        rdvMutex;   // Locks the pipeline state below
+       Xmit               xmitJob;
+       XrdXrootdRdvAio   *nextFree;
+       XrdXrootdProtocol *Protocol;   // -> Protocol associated with dataLink
+       XrdLink           *dataLink;   // -> Network link
+       XrdXrootdFile     *errFile;    // -> File that failed the readv
+       XrdBuffer         *rdvBuff[nBuff];
+       int                rdvBLen[nBuff]; // Bytes in buffer or -1 if failed
+       int                errRC;      // readv() return code for errFile
+       int                qSize;      // Size of a quantum
+       int                qLeft;      // Bytes left in the last quantum
+       int                numQ;       // Number of quanta
+       int                numV;       // Number of elements
+       int                nextFill;   // Next quantum to be read
+       int                nextSend;   // Next quantum to be sent
+       bool               isDone;     // Final response has been sent
+       bool               isLive;     // Read() was called
+       bool               rdActive;   // Reader job is scheduled or running
+       bool               rdFail;     // Reader encountered an error
+       bool               txActive;   // Sender job is scheduled or running
+
+       XrdXrootdResponse  Response;
+
+       XrdXrootdFile     *rdvFile[maxVec];
+       XrdOucIOVec        rdvVec[maxVec];
+       int                qBeg[maxVec+1]; // Index of first element in quantum
+};
+#endif
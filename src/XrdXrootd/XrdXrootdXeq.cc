@@ -62,6 +62,7 @@
 #include "XrdXrootd/XrdXrootdNormAio.hh"
 #include "XrdXrootd/XrdXrootdPio.hh"
 #include "XrdXrootd/XrdXrootdPrepare.hh"
+#include "XrdXrootd/XrdXrootdRdvAio.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
@@ -2349,10 +2350,12 @@ int XrdXrootdProtocol::do_Read()
    if (!IO.IOLen) return Response.Send();
 
 // There are many competing ways to accomplish a read. Pick the one we
-// will use and if possible, do a fast dispatch.
+// will use and if possible, do a fast dispatch. Sendfile is fine for TLS
+// links when the kernel does the encryption.
 //
         if (IO.File->isMMapped) IO.Mode = XrdXrootd::IOParms::useMMap;
-   else if (IO.File->sfEnabled && !isTLS && IO.IOLen >= as_minsfsz
+   else if (IO.File->sfEnabled && (!isTLS || Link->hasKTLS())
+        &&  IO.IOLen >= as_minsfsz
         &&  IO.Offset+IO.IOLen <= IO.File->Stats.fSize)
            IO.Mode = XrdXrootd::IOParms::useSF;
    else if (IO.File->AsyncMode && IO.IOLen >= as_miniosz
@@ -2513,11 +2516,9 @@ int XrdXrootdProtocol::do_ReadV()
    struct readahead_list *raVec, respHdr;
    long long totSZ;
    XrdSfsXferSize rdVAmt, rdVXfr, xfrSZ = 0;
-   int rdVBeg, rdVBreak, rdVNow, rdVNum, rdVecNum;
+   int rdVBeg, rdVBreak, rdVNow, rdVecNum;
    int currFH, i, k, Quantum, Qleft, rdVecLen = Request.header.dlen;
-   int rvMon = Monitor.InOut();
-   int ioMon = (rvMon > 1);
-   char *buffp, vType = (ioMon ? XROOTD_MON_READU : XROOTD_MON_READV);
+   char *buffp;
 
 // Compute number of elements in the read vector and make sure we have no
 // partial elements.
@@ -2570,6 +2571,16 @@ int XrdXrootdProtocol::do_ReadV()
 // transfer unit and the actual amount we need to transfer.
 //
    if ((Quantum = static_cast<int>(totSZ)) > maxTransz) Quantum = maxTransz;
+
+// If the response spans more than one quantum then run it asynchronously so
+// that reading the next quantum overlaps sending the previous one.
+//
+   if (totSZ > maxTransz && as_rdvaio && !Link->hasBridge()
+   &&  linkAioReq < as_maxperlnk && srvrAioOps < as_maxpersrv)
+      {XrdXrootdRdvAio *aioP = XrdXrootdRdvAio::Alloc(this, Response, Quantum);
+       if (aioP) return do_ReadVAio(aioP, rdVec, rdVBreak);
+       SI->AsyncRej++;
+      }
    
 // Now obtain the right size buffer
 //
@@ -2602,15 +2613,7 @@ int XrdXrootdProtocol::do_ReadV()
        {if (rdVec[i].info != currFH)
            {xfrSZ = IO.File->XrdSfsp->readv(&rdVec[rdVNow], i-rdVNow);
             if (xfrSZ != rdVAmt) break;
-            rdVNum = i - rdVBeg; rdVXfr += rdVAmt;
-            IO.File->Stats.rvOps(rdVXfr, rdVNum);
-            if (rvMon)
-               {Monitor.Agent->Add_rv(IO.File->Stats.FileID, htonl(rdVXfr),
-                                              htons(rdVNum), rvSeq, vType);
-                if (ioMon) for (k = rdVBeg; k < i; k++)
-                    Monitor.Agent->Add_rd(IO.File->Stats.FileID,
-                            htonl(rdVec[k].size), htonll(rdVec[k].offset));
-               }
+            do_ReadVMon(rdVec, rdVBeg, i, rdVXfr + rdVAmt);
             rdVXfr = rdVAmt = 0;
             if (i == rdVBreak) break;
             rdVBeg = rdVNow = i; currFH = rdVec[i].info;
@@ -2656,6 +2659,86 @@ int XrdXrootdProtocol::do_ReadV()
    return (Quantum != Qleft ? Response.Send(argp->buff, Quantum-Qleft) : 0);
 }
 
+/******************************************************************************/
+/*                            d o _ R e a d V A i o                           */
+/******************************************************************************/
+
+// aioP   = the async readv object to be used
+// rdVec  = the read vector
+// rdVNum = number of elements in the read vector (excluding the dummy element)
+  
+int XrdXrootdProtocol::do_ReadVAio(XrdXrootdRdvAio *aioP,
+                                   XrdOucIOVec *rdVec, int rdVNum)
+{
+   XrdSfsXferSize rdVXfr = 0;
+   int currFH = 0, rdVBeg = 0, i;
+
+// Check that we really have at least one file open
+//
+   if (!FTab)
+      {aioP->Recycle();
+       return Response.Send(kXR_FileNotOpen,
+                            "readv does not refer to an open file");
+      }
+
+// Run through the elements resolving the file handles and recording the
+// monitoring information for each run of elements for the same file, just as
+// the synchronous path does. This is done here, on the link thread, as the
+// monitor is not thread safe. So, like do_Read(), a run is recorded even if
+// reading it later fails.
+//
+   IO.File = 0; rvSeq++;
+   for (i = 0; i <= rdVNum; i++)
+       {if (i == rdVNum || !IO.File || rdVec[i].info != currFH)
+           {if (IO.File) do_ReadVMon(rdVec, rdVBeg, i, rdVXfr);
+            if (i == rdVNum) break;
+            rdVBeg = i; rdVXfr = 0; currFH = rdVec[i].info;
+            if (!(IO.File = FTab->Get(currFH)))
+               {aioP->Recycle();
+                return Response.Send(kXR_FileNotOpen,
+                                     "readv does not refer to an open file");
+               }
+           }
+        rdVXfr += rdVec[i].size;
+        aioP->Add(IO.File, rdVec[i]);
+        TRACEP(FSIO,"fh=" <<currFH<<" readV "<< rdVec[i].size <<'@'
+                          <<rdVec[i].offset);
+       }
+
+// Start the request. It will send all of the responses.
+//
+   aioP->Read();
+   return 0;
+}
+
+/******************************************************************************/
+/*                            d o _ R e a d V M o n                           */
+/******************************************************************************/
+
+// rdVec  = the read vector
+// rdVBeg = index of the first element of a run of elements for IO.File
+// rdVEnd = index of the element following the run
+// rdVXfr = number of bytes in the run, which may span several quanta
+
+void XrdXrootdProtocol::do_ReadVMon(XrdOucIOVec *rdVec, int rdVBeg, int rdVEnd,
+                                    int rdVXfr)
+{
+   int rvMon = Monitor.InOut();
+   int ioMon = (rvMon > 1);
+   char vType = (ioMon ? XROOTD_MON_READU : XROOTD_MON_READV);
+
+// Record one readv for the whole run and, if wanted, each of its elements
+//
+   IO.File->Stats.rvOps(rdVXfr, rdVEnd - rdVBeg);
+   if (rvMon)
+      {Monitor.Agent->Add_rv(IO.File->Stats.FileID, htonl(rdVXfr),
+                             htons(rdVEnd - rdVBeg), rvSeq, vType);
+       if (ioMon) for (int k = rdVBeg; k < rdVEnd; k++)
+           Monitor.Agent->Add_rd(IO.File->Stats.FileID,
+                   htonl(rdVec[k].size), htonll(rdVec[k].offset));
+      }
+}
+
 /******************************************************************************/
 /*                                 d o _ R m                                  */
 /******************************************************************************/
@@ -183,6 +183,9 @@ namespace XrdZip
         minZipVersion = 10;
       else
         minZipVersion = 45;
+      // compression may require a later version
+      if ( lfh->minZipVersion > minZipVersion )
+        minZipVersion = lfh->minZipVersion;
 
       cdfhSize = cdfhBaseSize + filenameLength + extraLength + commentLength;
     }
@@ -24,6 +24,7 @@
 #include "CppUnitXrdHelpers.hh"
 
 #include <pthread.h>
+#include <set>
 
 #include "TestEnv.hh"
 #include "IdentityPlugIn.hh"
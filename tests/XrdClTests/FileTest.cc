@@ -47,6 +47,7 @@ class FileTest: public CppUnit::TestCase
     CPPUNIT_TEST_SUITE( FileTest );
       CPPUNIT_TEST( RedirectReturnTest );
       CPPUNIT_TEST( ReadTest );
+      CPPUNIT_TEST( ReadAheadTest );
       CPPUNIT_TEST( WriteTest );
       CPPUNIT_TEST( WriteVTest );
       CPPUNIT_TEST( VectorReadTest );
@@ -57,6 +58,7 @@ class FileTest: public CppUnit::TestCase
     CPPUNIT_TEST_SUITE_END();
     void RedirectReturnTest();
     void ReadTest();
+    void ReadAheadTest();
     void WriteTest();
     void WriteVTest();
     void VectorReadTest();
@@ -242,6 +244,156 @@ void FileTest::ReadTest()
 }
 
 
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Handler for an asynchronous read that records whether it has been called
+  // by the thread that issued the read
+  //----------------------------------------------------------------------------
+  class ReadAheadHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      ReadAheadHandler():
+        caller( pthread_self() ), calledInline( false ), bytesRead( 0 ),
+        sem( 0 ) {}
+
+      void HandleResponse( XrdCl::XRootDStatus *status,
+                           XrdCl::AnyObject    *response )
+      {
+        calledInline = pthread_equal( pthread_self(), caller );
+        st = *status;
+        if( status->IsOK() && response )
+        {
+          XrdCl::ChunkInfo *chunk = 0;
+          response->Get( chunk );
+          bytesRead = chunk->length;
+        }
+        delete status;
+        delete response;
+        sem.Post();
+      }
+
+      pthread_t            caller;
+      bool                 calledInline;
+      XrdCl::XRootDStatus  st;
+      uint32_t             bytesRead;
+      XrdSysSemaphore      sem;
+  };
+}
+
+//------------------------------------------------------------------------------
+// Read-ahead test
+//------------------------------------------------------------------------------
+void FileTest::ReadAheadTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string dataPath;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "DataPath", dataPath ) );
+
+  std::string fileUrl = address + "/" + dataPath +
+                        "/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat";
+
+  const uint32_t MB = 1024*1024;
+  const uint32_t KB = 1024;
+  Env *env = DefaultEnv::GetEnv();
+  env->PutInt( "ReadAheadBlocks", 8 );
+  env->PutInt( "ReadAheadBlockSize", MB );
+
+  char *buffer1 = new char[40*MB];
+  char *buffer2 = new char[40*MB];
+  uint32_t bytesRead = 0;
+  File f;
+
+  CPPUNIT_ASSERT_XRDST( f.Open( fileUrl, OpenFlags::Read ) );
+
+  //----------------------------------------------------------------------------
+  // Sequential reads smaller and larger than a block are served from the
+  // ring once the pattern is detected; the data is the same as in ReadTest
+  //----------------------------------------------------------------------------
+  uint32_t sizes[] = { 256*KB, 3*MB, 100*KB };
+  uint64_t offset  = 10*MB;
+  for( uint32_t i = 0; offset < 50*MB; ++i )
+  {
+    uint32_t size = std::min<uint64_t>( sizes[i % 3], 50*MB - offset );
+    CPPUNIT_ASSERT_XRDST( f.Read( offset, size, buffer1 + ( offset - 10*MB ),
+                                  bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == size );
+    offset += size;
+  }
+  CPPUNIT_ASSERT( Utils::ComputeCRC32( buffer1, 40*MB ) == 3303853367UL );
+
+  //----------------------------------------------------------------------------
+  // Forward and backward strides
+  //----------------------------------------------------------------------------
+  for( int64_t stride : { (int64_t)MB + 4*KB, -(int64_t)MB - 4*KB } )
+  {
+    memset( buffer2, 0, 40*MB );
+    offset = stride > 0 ? 10*MB : 50*MB - 64*KB;
+    for( int i = 0; i < 30; ++i, offset += stride )
+    {
+      char *buf = buffer2 + ( offset - 10*MB );
+      CPPUNIT_ASSERT_XRDST( f.Read( offset, 64*KB, buf, bytesRead ) );
+      CPPUNIT_ASSERT( bytesRead == 64*KB );
+      CPPUNIT_ASSERT( !memcmp( buf, buffer1 + ( offset - 10*MB ), 64*KB ) );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Asynchronous reads are never answered from within Read(), even if the
+  // data is already in the ring
+  //----------------------------------------------------------------------------
+  offset = 10*MB;
+  for( int i = 0; i < 32; ++i, offset += 64*KB )
+  {
+    ReadAheadHandler handler;
+    CPPUNIT_ASSERT_XRDST( f.Read( offset, 64*KB, buffer2, &handler ) );
+    handler.sem.Wait();
+    CPPUNIT_ASSERT_XRDST( handler.st );
+    CPPUNIT_ASSERT( !handler.calledInline );
+    CPPUNIT_ASSERT( handler.bytesRead == 64*KB );
+    CPPUNIT_ASSERT( !memcmp( buffer2, buffer1 + ( offset - 10*MB ), 64*KB ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Reading up to and past the end of the file
+  //----------------------------------------------------------------------------
+  uint64_t fileSize = 1048576000;
+  offset = fileSize - 10*MB;
+  uint32_t total = 0;
+  for( int i = 0; i < 12; ++i, offset += MB )
+  {
+    CPPUNIT_ASSERT_XRDST( f.Read( offset, MB, buffer2, bytesRead ) );
+    CPPUNIT_ASSERT( bytesRead == ( offset < fileSize ? MB : 0 ) );
+    total += bytesRead;
+  }
+  CPPUNIT_ASSERT( total == 10*MB );
+
+  //----------------------------------------------------------------------------
+  // Close with read-ahead requests in flight, then reopen
+  //----------------------------------------------------------------------------
+  for( offset = 0; offset < 4*MB; offset += 256*KB )
+    CPPUNIT_ASSERT_XRDST( f.Read( offset, 256*KB, buffer2, bytesRead ) );
+  CPPUNIT_ASSERT_XRDST( f.Close() );
+  CPPUNIT_ASSERT_XRDST( f.Open( fileUrl, OpenFlags::Read ) );
+  CPPUNIT_ASSERT_XRDST( f.Read( 10*MB, 64*KB, buffer2, bytesRead ) );
+  CPPUNIT_ASSERT( !memcmp( buffer2, buffer1, 64*KB ) );
+  CPPUNIT_ASSERT_XRDST( f.Close() );
+
+  env->PutInt( "ReadAheadBlocks", DefaultReadAheadBlocks );
+  env->PutInt( "ReadAheadBlockSize", DefaultReadAheadBlockSize );
+  delete [] buffer1;
+  delete [] buffer2;
+}
+
 //------------------------------------------------------------------------------
 // Read test
 //------------------------------------------------------------------------------
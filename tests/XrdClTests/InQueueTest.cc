@@ -0,0 +1,336 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "XProtocol/XProtocol.hh"
+#include "XrdCl/XrdClInQueue.hh"
+#include "XrdCl/XrdClMessage.hh"
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace XrdCl;
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class InQueueTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( InQueueTest );
+      CPPUNIT_TEST( LookupTest );
+      CPPUNIT_TEST( CallbackTest );
+      CPPUNIT_TEST( NestedTest );
+      CPPUNIT_TEST( ConcurrencyTest );
+    CPPUNIT_TEST_SUITE_END();
+    void LookupTest();
+    void CallbackTest();
+    void NestedTest();
+    void ConcurrencyTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( InQueueTest );
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // A handler counting its calls, the callbacks may be overridden
+  //----------------------------------------------------------------------------
+  class TestHandler: public MsgHandler
+  {
+    public:
+      TestHandler( uint16_t sid = 0 ): sid( sid ), examined( 0 ), events( 0 ),
+        action( RemoveHandler | NoProcess ) {}
+
+      uint16_t Examine( std::shared_ptr<Message>& )
+      {
+        ++examined;
+        if( onExamine ) return onExamine();
+        return action;
+      }
+
+      uint8_t OnStreamEvent( StreamEvent, XRootDStatus )
+      {
+        ++events;
+        if( onEvent ) return onEvent();
+        return 0;
+      }
+
+      uint16_t InspectStatusRsp() { return 0; }
+      uint16_t GetSid() const { return sid; }
+      time_t   GetExpiration() { return 0; }
+      void     OnStatusReady( const Message*, XRootDStatus ) {}
+
+      uint16_t                  sid;
+      std::atomic<int>          examined;
+      std::atomic<int>          events;
+      uint16_t                  action;
+      std::function<uint16_t()> onExamine;
+      std::function<uint8_t()>  onEvent;
+  };
+
+  //----------------------------------------------------------------------------
+  // A response for the given SID
+  //----------------------------------------------------------------------------
+  std::shared_ptr<Message> Response( uint16_t sid )
+  {
+    std::shared_ptr<Message> msg = std::make_shared<Message>( 8 );
+    ServerResponse *rsp = (ServerResponse*)msg->GetBuffer();
+    memset( rsp, 0, 8 );
+    rsp->hdr.streamid[0] = sid & 0xff;
+    rsp->hdr.streamid[1] = sid >> 8;
+    return msg;
+  }
+
+  MsgHandler *Lookup( InQueue &queue, uint16_t sid )
+  {
+    std::shared_ptr<Message> msg = Response( sid );
+    time_t   expires;
+    uint16_t action;
+    return queue.GetHandlerForMessage( msg, expires, action );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Adding, finding and removing handlers
+//------------------------------------------------------------------------------
+void InQueueTest::LookupTest()
+{
+  InQueue     queue;
+  TestHandler h5( 5 ), h300( 300 ), hmax( 0xffff );
+  bool        rmMsg;
+
+  CPPUNIT_ASSERT( !Lookup( queue, 5 ) );
+
+  //----------------------------------------------------------------------------
+  // A handler consumes the response and goes away, the next response for the
+  // SID is kept until a handler for it is added
+  //----------------------------------------------------------------------------
+  queue.AddMessageHandler( &h5, 0, rmMsg );
+  CPPUNIT_ASSERT( !rmMsg );
+  queue.AddMessage( Response( 5 ) );
+  CPPUNIT_ASSERT( h5.examined == 1 );
+  queue.AddMessage( Response( 5 ) );
+  CPPUNIT_ASSERT( h5.examined == 1 );
+  queue.AddMessageHandler( &h5, 0, rmMsg );
+  CPPUNIT_ASSERT( rmMsg );
+  queue.AddMessageHandler( &h5, 0, rmMsg );
+  CPPUNIT_ASSERT( !rmMsg );
+
+  //----------------------------------------------------------------------------
+  // Handlers in other pages, one staying in place after Examine()
+  //----------------------------------------------------------------------------
+  h300.action = MsgHandler::NoProcess;
+  queue.AddMessageHandler( &h300, 1234, rmMsg );
+  queue.AddMessageHandler( &hmax, 0, rmMsg );
+
+  time_t   expires = 0;
+  uint16_t action  = 0;
+  std::shared_ptr<Message> msg = Response( 300 );
+  CPPUNIT_ASSERT( queue.GetHandlerForMessage( msg, expires, action ) == &h300 );
+  CPPUNIT_ASSERT( expires == 1234 && action == MsgHandler::NoProcess );
+  CPPUNIT_ASSERT( Lookup( queue, 300 ) == &h300 );
+  CPPUNIT_ASSERT( Lookup( queue, 0xffff ) == &hmax );
+  CPPUNIT_ASSERT( !Lookup( queue, 0xffff ) );
+  CPPUNIT_ASSERT( !Lookup( queue, 301 ) );
+
+  queue.RemoveMessageHandler( &h300 );
+  CPPUNIT_ASSERT( !Lookup( queue, 300 ) );
+  queue.RemoveMessageHandler( &h300 );
+  CPPUNIT_ASSERT( Lookup( queue, 5 ) == &h5 );
+
+  //----------------------------------------------------------------------------
+  // Only the expired handlers time out
+  //----------------------------------------------------------------------------
+  TestHandler early( 7 ), late( 8 );
+  early.onEvent = [] { return (uint8_t)MsgHandler::RemoveHandler; };
+  late.onEvent  = early.onEvent;
+  queue.AddMessageHandler( &early, 100, rmMsg );
+  queue.AddMessageHandler( &late,  200, rmMsg );
+  queue.ReportTimeout( 150 );
+  CPPUNIT_ASSERT( early.events == 1 && late.events == 0 );
+  CPPUNIT_ASSERT( !Lookup( queue, 7 ) );
+  CPPUNIT_ASSERT( Lookup( queue, 8 ) == &late );
+}
+
+//------------------------------------------------------------------------------
+// Handlers changing the queue from within their callbacks
+//------------------------------------------------------------------------------
+void InQueueTest::CallbackTest()
+{
+  InQueue queue;
+  bool    rmMsg;
+
+  //----------------------------------------------------------------------------
+  // A handler removing and re-adding itself from Examine()
+  //----------------------------------------------------------------------------
+  TestHandler self( 10 );
+  self.onExamine = [&]() -> uint16_t
+  {
+    queue.RemoveMessageHandler( &self );
+    queue.ReAddMessageHandler( &self, 0 );
+    return MsgHandler::NoProcess;
+  };
+  queue.AddMessageHandler( &self, 0, rmMsg );
+  queue.AddMessage( Response( 10 ) );
+  CPPUNIT_ASSERT( self.examined == 1 );
+  CPPUNIT_ASSERT( Lookup( queue, 10 ) == &self );
+  queue.RemoveMessageHandler( &self );
+
+  //----------------------------------------------------------------------------
+  // On a stream event a handler removes one that has not been called yet,
+  // another adds a new one and re-adds itself
+  //----------------------------------------------------------------------------
+  TestHandler first( 20 ), victim( 600 ), adder( 700 ), added( 21 );
+  first.onEvent = [&]() -> uint8_t
+  {
+    queue.RemoveMessageHandler( &victim );
+    return 0;
+  };
+  adder.onEvent = [&]() -> uint8_t
+  {
+    queue.AddMessageHandler( &added, 0, rmMsg );
+    queue.ReAddMessageHandler( &adder, 0 );
+    return 0;
+  };
+  queue.AddMessageHandler( &first, 0, rmMsg );
+  queue.AddMessageHandler( &victim, 0, rmMsg );
+  queue.AddMessageHandler( &adder, 0, rmMsg );
+
+  queue.ReportStreamEvent( MsgHandler::Broken, XRootDStatus() );
+  CPPUNIT_ASSERT( first.events == 1 );
+  CPPUNIT_ASSERT( victim.events == 0 );
+  CPPUNIT_ASSERT( adder.events == 1 );
+  CPPUNIT_ASSERT( !Lookup( queue, 600 ) );
+  CPPUNIT_ASSERT( Lookup( queue, 700 ) == &adder );
+  CPPUNIT_ASSERT( Lookup( queue, 21 ) == &added );
+}
+
+//------------------------------------------------------------------------------
+// Handlers delivering responses for other SIDs from within Examine(), deeper
+// than any fixed per-thread bookkeeping would allow
+//------------------------------------------------------------------------------
+void InQueueTest::NestedTest()
+{
+  const int depth = 100;
+  InQueue   queue;
+  bool      rmMsg;
+
+  std::vector<TestHandler> handlers( depth );
+  for( int i = 0; i < depth; ++i )
+  {
+    handlers[i].sid = i * 257;
+    handlers[i].onExamine = [&, i]() -> uint16_t
+    {
+      if( i + 1 < depth )
+        queue.AddMessage( Response( handlers[i + 1].sid ) );
+      // The first handler is removed by its outermost caller, the others
+      // remove themselves
+      if( i ) queue.RemoveMessageHandler( &handlers[i] );
+      return MsgHandler::NoProcess | ( i ? 0 : MsgHandler::RemoveHandler );
+    };
+    queue.AddMessageHandler( &handlers[i], 0, rmMsg );
+  }
+
+  queue.AddMessage( Response( 0 ) );
+  for( int i = 0; i < depth; ++i )
+  {
+    CPPUNIT_ASSERT( handlers[i].examined == 1 );
+    CPPUNIT_ASSERT( !Lookup( queue, handlers[i].sid ) );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Concurrent use: every response reaches its handler exactly once while
+// stream events and timeouts walk the table, and handlers touching each
+// other's SIDs from their callbacks on different threads do not deadlock
+//------------------------------------------------------------------------------
+void InQueueTest::ConcurrencyTest()
+{
+  const int nThreads = 4;
+  const int nSids    = 1000;
+  const int rounds   = 50;
+  const int pings    = 20000;
+
+  InQueue           queue;
+  std::atomic<bool> stop( false );
+  std::atomic<int>  failed( 0 );
+
+  //----------------------------------------------------------------------------
+  // Two handlers re-adding each other from Examine()
+  //----------------------------------------------------------------------------
+  TestHandler ping( 60000 ), pong( 60001 );
+  ping.onExamine = [&]() -> uint16_t
+  {
+    queue.ReAddMessageHandler( &pong, 0 );
+    return MsgHandler::NoProcess;
+  };
+  pong.onExamine = [&]() -> uint16_t
+  {
+    queue.ReAddMessageHandler( &ping, 0 );
+    return MsgHandler::NoProcess;
+  };
+  bool rmMsg;
+  queue.AddMessageHandler( &ping, 0, rmMsg );
+  queue.AddMessageHandler( &pong, 0, rmMsg );
+
+  std::vector<std::thread> threads;
+  for( int t = 0; t < nThreads; ++t )
+    threads.emplace_back( [&, t]()
+    {
+      std::vector<TestHandler> handlers( nSids );
+      for( int i = 0; i < nSids; ++i )
+        handlers[i].sid = 1 + t + i * nThreads;
+
+      for( int r = 0; r < rounds; ++r )
+      {
+        bool rm;
+        for( int i = 0; i < nSids; ++i )
+          queue.AddMessageHandler( &handlers[i], time( 0 ) + 3600, rm );
+        for( int i = 0; i < nSids; ++i )
+          queue.AddMessage( Response( handlers[i].sid ) );
+      }
+
+      for( int i = 0; i < pings; ++i )
+        queue.AddMessage( Response( t & 1 ? 60000 : 60001 ) );
+
+      for( int i = 0; i < nSids; ++i )
+        if( handlers[i].examined != rounds || Lookup( queue, handlers[i].sid ) )
+          ++failed;
+    } );
+
+  std::thread walker( [&]()
+  {
+    while( !stop )
+    {
+      queue.ReportStreamEvent( MsgHandler::Ready, XRootDStatus() );
+      queue.ReportTimeout();
+    }
+  } );
+
+  for( auto &t : threads ) t.join();
+  stop = true;
+  walker.join();
+
+  CPPUNIT_ASSERT( failed == 0 );
+  CPPUNIT_ASSERT( ping.examined + pong.examined == nThreads * pings );
+}
@@ -29,6 +29,8 @@
 #include "XrdCl/XrdClTaskManager.hh"
 #include "XrdCl/XrdClSIDManager.hh"
 #include "XrdCl/XrdClPropertyList.hh"
+#include "XrdCl/XrdClMessage.hh"
+#include "XrdCl/XrdClBufferPool.hh"
 
 //------------------------------------------------------------------------------
 // Declaration
@@ -42,12 +44,14 @@ class UtilsTest: public CppUnit::TestCase
       CPPUNIT_TEST( TaskManagerTest );
       CPPUNIT_TEST( SIDManagerTest );
       CPPUNIT_TEST( PropertyListTest );
+      CPPUNIT_TEST( BufferPoolTest );
     CPPUNIT_TEST_SUITE_END();
     void URLTest();
     void AnyTest();
     void TaskManagerTest();
     void SIDManagerTest();
     void PropertyListTest();
+    void BufferPoolTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( UtilsTest );
@@ -459,3 +463,112 @@ void UtilsTest::PropertyListTest()
   for( size_t i = 0; i < v1.size(); ++i )
     CPPUNIT_ASSERT( v1[i] == v2[i] );
 }
+
+//------------------------------------------------------------------------------
+// Buffer pool test
+//------------------------------------------------------------------------------
+void UtilsTest::BufferPoolTest()
+{
+  using namespace XrdCl;
+
+  CPPUNIT_ASSERT( BufferPool::Capacity( 0 )     == BufferPool::MinSize );
+  CPPUNIT_ASSERT( BufferPool::Capacity( 64 )    == 64 );
+  CPPUNIT_ASSERT( BufferPool::Capacity( 65 )    == 128 );
+  CPPUNIT_ASSERT( BufferPool::Capacity( 65536 ) == 65536 );
+  CPPUNIT_ASSERT( BufferPool::Capacity( 65537 ) == 65537 );
+
+  //----------------------------------------------------------------------------
+  // A block that is handed back is served again
+  //----------------------------------------------------------------------------
+  uint32_t capacity;
+  char *block = BufferPool::Get( 100, capacity );
+  CPPUNIT_ASSERT( capacity == 128 );
+  BufferPool::Put( block, capacity );
+  CPPUNIT_ASSERT( BufferPool::Get( 120, capacity ) == block );
+  free( block ); // pooled blocks are malloc blocks
+
+  //----------------------------------------------------------------------------
+  // Growing within the size class keeps the memory, growing or shrinking
+  // across classes keeps the contents
+  //----------------------------------------------------------------------------
+  Buffer buff( 8 );
+  memcpy( buff.GetBuffer(), "abcdefgh", 8 );
+  char *ptr = buff.GetBuffer();
+  buff.ReAllocate( 64 );
+  CPPUNIT_ASSERT( buff.GetBuffer() == ptr );
+  CPPUNIT_ASSERT( buff.GetSize() == 64 );
+  buff.ReAllocate( 100 );
+  memset( buff.GetBuffer( 8 ), 'x', 92 );
+  buff.ReAllocate( 100000 );
+  CPPUNIT_ASSERT( memcmp( buff.GetBuffer(), "abcdefgh", 8 ) == 0 );
+  CPPUNIT_ASSERT( buff.GetBuffer()[99] == 'x' );
+  memset( buff.GetBuffer( 100 ), 'y', 99900 );
+  buff.ReAllocate( 200000 );
+  CPPUNIT_ASSERT( memcmp( buff.GetBuffer(), "abcdefgh", 8 ) == 0 );
+  CPPUNIT_ASSERT( buff.GetBuffer()[99999] == 'y' );
+  buff.ReAllocate( 1000 );
+  CPPUNIT_ASSERT( buff.GetSize() == 1000 );
+  CPPUNIT_ASSERT( memcmp( buff.GetBuffer(), "abcdefgh", 8 ) == 0 );
+  memset( buff.GetBuffer(), 'z', 1024 ); // the whole size class is usable
+  buff.ReAllocate( 16 );
+  memset( buff.GetBuffer(), 'z', 64 );
+  buff.ReAllocate( 0 );
+  buff.ReAllocate( 64 );
+  memset( buff.GetBuffer(), 'z', 64 );
+
+  //----------------------------------------------------------------------------
+  // Released memory belongs to the caller, grabbed memory to the buffer; it
+  // is not reused beyond its size but moved into the pool when it grows
+  //----------------------------------------------------------------------------
+  char *raw = buff.Release();
+  CPPUNIT_ASSERT( buff.GetSize() == 0 );
+  free( raw );
+  raw = (char *)malloc( 16 );
+  memcpy( raw, "0123456789abcdef", 16 );
+  buff.Grab( raw, 16 );
+  buff.ReAllocate( 64 );
+  CPPUNIT_ASSERT( memcmp( buff.GetBuffer(), "0123456789abcdef", 16 ) == 0 );
+  memset( buff.GetBuffer( 16 ), 0, 48 );
+  buff.ReAllocate( 65 );
+  CPPUNIT_ASSERT( memcmp( buff.GetBuffer(), "0123456789abcdef", 16 ) == 0 );
+  free( buff.Release() );
+
+  //----------------------------------------------------------------------------
+  // Blocks the pool did not allocate, like the exact size blocks of code
+  // built against an older XrdClBuffer.hh, are freed rather than pooled
+  //----------------------------------------------------------------------------
+  BufferPool::Stats before = BufferPool::GetStats();
+  raw = (char *)malloc( 70 );
+  CPPUNIT_ASSERT( !BufferPool::Owns( raw, 128 ) );
+  BufferPool::Put( raw, 128 );
+  block = BufferPool::Get( 128, capacity );
+  CPPUNIT_ASSERT( block != raw );
+  CPPUNIT_ASSERT( BufferPool::Owns( block, 128 ) );
+  CPPUNIT_ASSERT( !BufferPool::Owns( block, 64 ) );
+  memset( block, 'w', capacity );
+  BufferPool::Put( block, capacity );
+  BufferPool::Stats after = BufferPool::GetStats();
+  CPPUNIT_ASSERT( after.foreign == before.foreign + 1 );
+  CPPUNIT_ASSERT( after.puts    == before.puts + 1 );
+  CPPUNIT_ASSERT( after.hits + after.misses == before.hits + before.misses + 1 );
+
+  raw = (char *)malloc( 70 );
+  memset( raw, 'v', 70 );
+  buff.Grab( raw, 70 );
+  buff.ReAllocate( 120 );
+  memset( buff.GetBuffer(), 'v', 120 );
+  CPPUNIT_ASSERT( BufferPool::Owns( buff.GetBuffer(), 128 ) );
+  buff.Free();
+
+  //----------------------------------------------------------------------------
+  // Messages come zeroed, whatever the block held before
+  //----------------------------------------------------------------------------
+  for( int i = 0; i < 4; ++i )
+  {
+    Message *msg = new Message( 200 );
+    for( uint32_t j = 0; j < msg->GetSize(); ++j )
+      CPPUNIT_ASSERT( msg->GetBuffer()[j] == 0 );
+    memset( msg->GetBuffer(), 0xff, msg->GetSize() );
+    delete msg;
+  }
+}
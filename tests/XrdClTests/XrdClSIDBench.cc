@@ -0,0 +1,242 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// This program measures the request/response bookkeeping of a channel: every
+// operation allocates a SID, registers a handler for it, looks the handler up
+// for a response and releases the SID. A number of threads share a single
+// SID manager and incoming queue, each keeping a window of requests in
+// flight. The same workload is run against a copy of the list, set and map
+// based implementation the lock-free tables replaced.
+//
+// Usage: xrdclsidbench [threads [in-flight per thread [seconds]]]
+//------------------------------------------------------------------------------
+
+#include "XProtocol/XProtocol.hh"
+#include "XrdCl/XrdClInQueue.hh"
+#include "XrdCl/XrdClMessage.hh"
+#include "XrdCl/XrdClSIDManager.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // A handler that accepts the response for its SID
+  //----------------------------------------------------------------------------
+  class BenchHandler: public MsgHandler
+  {
+    public:
+      uint16_t Examine( std::shared_ptr<Message>& ) { return RemoveHandler; }
+      uint16_t InspectStatusRsp() { return 0; }
+      uint16_t GetSid() const { return sid; }
+      void     OnStatusReady( const Message*, XRootDStatus ) {}
+      time_t   GetExpiration() { return 0; }
+
+      uint16_t sid;
+  };
+
+  //----------------------------------------------------------------------------
+  // The current implementation
+  //----------------------------------------------------------------------------
+  struct Current
+  {
+    Current(): sidMgr( SIDMgrPool::Instance().GetSIDMgr(
+                                         URL( "root://bench:1094//" ) ) ) {}
+
+    bool Allocate( uint8_t sid[2] ) { return sidMgr->AllocateSID( sid ).IsOK(); }
+    void Release( uint8_t sid[2] ) { sidMgr->ReleaseSID( sid ); }
+
+    void Add( MsgHandler *handler )
+    {
+      bool rmMsg;
+      queue.AddMessageHandler( handler, 0, rmMsg );
+    }
+
+    MsgHandler *Get( std::shared_ptr<Message> &msg )
+    {
+      time_t   expires;
+      uint16_t action;
+      return queue.GetHandlerForMessage( msg, expires, action );
+    }
+
+    std::shared_ptr<SIDManager> sidMgr;
+    InQueue                     queue;
+  };
+
+  //----------------------------------------------------------------------------
+  // A copy of what the SID manager and the incoming queue used to do
+  //----------------------------------------------------------------------------
+  struct Legacy
+  {
+    Legacy(): ceiling( 1 ) {}
+
+    bool Allocate( uint8_t sid[2] )
+    {
+      XrdSysMutexHelper scopedLock( sidMutex );
+      uint16_t allocSID;
+      if( !freeSIDs.empty() )
+      {
+        allocSID = freeSIDs.front();
+        freeSIDs.pop_front();
+      }
+      else
+      {
+        if( ceiling == 0xffff ) return false;
+        allocSID = ceiling++;
+      }
+      memcpy( sid, &allocSID, 2 );
+      return true;
+    }
+
+    void Release( uint8_t sid[2] )
+    {
+      XrdSysMutexHelper scopedLock( sidMutex );
+      uint16_t relSID;
+      memcpy( &relSID, sid, 2 );
+      freeSIDs.push_back( relSID );
+      timedOut.erase( relSID );
+    }
+
+    void Add( MsgHandler *handler )
+    {
+      XrdSysMutexHelper scopedLock( qMutex );
+      messages.erase( handler->GetSid() );
+      handlers[handler->GetSid()] = std::make_pair( handler, time_t( 0 ) );
+    }
+
+    MsgHandler *Get( std::shared_ptr<Message> &msg )
+    {
+      ServerResponse *rsp = (ServerResponse*)msg->GetBuffer();
+      uint16_t sid = ((uint16_t)rsp->hdr.streamid[1] << 8) |
+                     (uint16_t)rsp->hdr.streamid[0];
+      XrdSysMutexHelper scopedLock( qMutex );
+      auto it = handlers.find( sid );
+      if( it == handlers.end() ) return 0;
+      MsgHandler *handler = it->second.first;
+      if( handler->Examine( msg ) & MsgHandler::RemoveHandler )
+        handlers.erase( it );
+      return handler;
+    }
+
+    std::list<uint16_t>  freeSIDs;
+    std::set<uint16_t>   timedOut;
+    uint16_t             ceiling;
+    XrdSysMutex          sidMutex;
+
+    std::map<uint16_t, std::pair<MsgHandler*, time_t>>   handlers;
+    std::map<uint16_t, std::shared_ptr<Message>>         messages;
+    XrdSysRecMutex                                        qMutex;
+  };
+
+  //----------------------------------------------------------------------------
+  // Run the workload, return the operations per second
+  //----------------------------------------------------------------------------
+  template<typename Impl>
+  double Run( int nThreads, int window, double seconds )
+  {
+    Impl impl;
+    std::atomic<bool>     stop( false );
+    std::atomic<uint64_t> total( 0 );
+    std::atomic<bool>     failed( false );
+    std::vector<std::thread> threads;
+
+    for( int t = 0; t < nThreads; ++t )
+      threads.emplace_back( [&]()
+      {
+        std::vector<BenchHandler>             handlers( window );
+        std::vector<std::shared_ptr<Message>> msgs;
+        for( int i = 0; i < window; ++i )
+          msgs.emplace_back( std::make_shared<Message>( 8 ) );
+
+        uint64_t ops = 0;
+        int      next = 0, inFlight = 0;
+        while( !stop.load( std::memory_order_relaxed ) )
+        {
+          //--------------------------------------------------------------------
+          // Retire the oldest request once the window is full
+          //--------------------------------------------------------------------
+          if( inFlight == window )
+          {
+            ServerResponse *rsp = (ServerResponse*)msgs[next]->GetBuffer();
+            memcpy( rsp->hdr.streamid, &handlers[next].sid, 2 );
+            if( impl.Get( msgs[next] ) != &handlers[next] ) failed = true;
+            impl.Release( rsp->hdr.streamid );
+            --inFlight;
+            ++ops;
+          }
+
+          uint8_t sid[2];
+          if( !impl.Allocate( sid ) )
+          {
+            failed = true;
+            break;
+          }
+          memcpy( &handlers[next].sid, sid, 2 );
+          impl.Add( &handlers[next] );
+          next = ( next + 1 ) % window;
+          ++inFlight;
+        }
+        total += ops;
+      } );
+
+    std::this_thread::sleep_for( std::chrono::duration<double>( seconds ) );
+    stop = true;
+    for( auto &t : threads ) t.join();
+    if( failed ) fprintf( stderr, "handler lookup failed!\n" );
+    return total / seconds;
+  }
+}
+
+int main( int argc, char **argv )
+{
+  int    nThreads = argc > 1 ? atoi( argv[1] ) : 4;
+  int    window   = argc > 2 ? atoi( argv[2] ) : 1024;
+  double seconds  = argc > 3 ? atof( argv[3] ) : 2;
+
+  if( nThreads < 1 || window < 1 || nThreads * window > 60000 )
+  {
+    fprintf( stderr, "usage: %s [threads [in-flight per thread "
+                     "[seconds]]], at most 60000 in flight\n", argv[0] );
+    return 1;
+  }
+
+  printf( "%d threads, %d requests in flight each\n", nThreads, window );
+  printf( "  current tables:   %12.0f ops/s\n",
+          Run<Current>( nThreads, window, seconds ) );
+  printf( "  list/set/map:     %12.0f ops/s\n",
+          Run<Legacy>( nThreads, window, seconds ) );
+  return 0;
+}
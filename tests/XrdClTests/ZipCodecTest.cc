@@ -0,0 +1,416 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "CppUnitXrdHelpers.hh"
+#include "XrdCl/XrdClZipArchive.hh"
+#include "XrdCl/XrdClZipOperations.hh"
+#include "XrdCl/XrdClZipCodec.hh"
+#include "XrdCl/XrdClZipCodecCache.hh"
+#include "XrdCl/XrdClMessageUtils.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <zlib.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class ZipCodecTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( ZipCodecTest );
+      CPPUNIT_TEST( RoundTripTest );
+      CPPUNIT_TEST( CorruptDataTest );
+      CPPUNIT_TEST( RegistryTest );
+      CPPUNIT_TEST( CacheTest );
+      CPPUNIT_TEST( ArchiveTest );
+      CPPUNIT_TEST( ReadAfterCloseTest );
+    CPPUNIT_TEST_SUITE_END();
+    void RoundTripTest();
+    void CorruptDataTest();
+    void RegistryTest();
+    void CacheTest();
+    void ArchiveTest();
+    void ReadAfterCloseTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ZipCodecTest );
+
+namespace
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Data that compresses, with some noise so that it is not trivial
+  //----------------------------------------------------------------------------
+  std::vector<char> MakeData( size_t size, bool compressible = true )
+  {
+    std::vector<char> data( size );
+    uint32_t x = 12345;
+    for( size_t i = 0; i < size; ++i )
+    {
+      x = x * 1103515245 + 12345;
+      data[i] = compressible ? "XRootD zip codec "[i % 17] ^ ( ( x >> 16 ) & 1 )
+                             : char( x >> 16 );
+    }
+    return data;
+  }
+
+  //----------------------------------------------------------------------------
+  // Decompress feeding the codec small, odd sized pieces
+  //----------------------------------------------------------------------------
+  XRootDStatus Decompress( ZipCodec &codec, const std::vector<char> &in,
+                           std::vector<char> &out, uint32_t inStep,
+                           uint32_t outStep )
+  {
+    const char *next_in   = in.data();
+    uint32_t    left_in   = in.size();
+    size_t      produced  = 0;
+
+    while( produced < out.size() )
+    {
+      uint32_t avail_in  = std::min( left_in, inStep );
+      uint32_t avail_out = std::min<size_t>( out.size() - produced, outStep );
+      char    *next_out  = out.data() + produced;
+      uint32_t before_in = avail_in, before_out = avail_out;
+
+      XRootDStatus st = codec.Decompress( next_in, avail_in, next_out, avail_out );
+      if( !st.IsOK() ) return st;
+      left_in  -= before_in - avail_in;
+      produced += before_out - avail_out;
+      if( st.code == suContinue && !left_in )
+        return XRootDStatus( stError, errDataError, 0, "Truncated" );
+    }
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Collects the outcome of a cache read
+  //----------------------------------------------------------------------------
+  class ReadHandler: public ResponseHandler
+  {
+    public:
+      ReadHandler(): cond( 0 ), done( false ), length( 0 ), next( 0 ) {}
+
+      void HandleResponse( XRootDStatus *st, AnyObject *rsp )
+      {
+        status = *st;
+        if( rsp )
+        {
+          ChunkInfo *chunk = 0;
+          rsp->Get( chunk );
+          length = chunk->length;
+        }
+        delete st;
+        delete rsp;
+        // queue the follow-up read from within the callback
+        if( next ) next();
+        XrdSysCondVarHelper lck( cond );
+        done = true;
+        cond.Broadcast();
+      }
+
+      void Wait()
+      {
+        XrdSysCondVarHelper lck( cond );
+        while( !done ) cond.Wait();
+      }
+
+      XrdSysCondVar         cond;
+      bool                  done;
+      XRootDStatus          status;
+      uint32_t              length;
+      std::function<void()> next;
+  };
+
+  ZipCodec *DeflateFactory()
+  {
+    return ZipCodec::Create( ZipCodec::Deflate );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Compress and decompress with every built in codec
+//------------------------------------------------------------------------------
+void ZipCodecTest::RoundTripTest()
+{
+  using namespace XrdCl;
+
+  std::vector<uint16_t> methods = { ZipCodec::Deflate, ZipCodec::Zstd };
+  for( uint16_t method : methods )
+  {
+    if( !ZipCodec::IsSupported( method ) )
+    {
+      CPPUNIT_ASSERT( method != ZipCodec::Deflate );
+      continue;
+    }
+
+    for( bool compressible : { true, false } )
+    {
+      std::vector<char> data = MakeData( 300000, compressible );
+      std::vector<char> packed;
+      std::unique_ptr<ZipCodec> codec( ZipCodec::Create( method ) );
+      CPPUNIT_ASSERT( codec );
+      CPPUNIT_ASSERT_XRDST( codec->Compress( data.data(), data.size(), packed ) );
+      if( compressible ) CPPUNIT_ASSERT( packed.size() < data.size() / 2 );
+
+      std::vector<char> out( data.size() );
+      std::unique_ptr<ZipCodec> decoder( ZipCodec::Create( method ) );
+      CPPUNIT_ASSERT_XRDST( Decompress( *decoder, packed, out, 997, 1531 ) );
+      CPPUNIT_ASSERT( out == data );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Nothing in, nothing out
+  //----------------------------------------------------------------------------
+  std::vector<char> packed, out;
+  std::unique_ptr<ZipCodec> codec( ZipCodec::Create( ZipCodec::Deflate ) );
+  CPPUNIT_ASSERT_XRDST( codec->Compress( "", 0, packed ) );
+  std::unique_ptr<ZipCodec> decoder( ZipCodec::Create( ZipCodec::Deflate ) );
+  CPPUNIT_ASSERT_XRDST( Decompress( *decoder, packed, out, 1, 1 ) );
+}
+
+//------------------------------------------------------------------------------
+// Corrupted input is reported as a data error
+//------------------------------------------------------------------------------
+void ZipCodecTest::CorruptDataTest()
+{
+  using namespace XrdCl;
+
+  std::vector<char> data = MakeData( 100000 );
+  std::vector<char> packed;
+  std::unique_ptr<ZipCodec> codec( ZipCodec::Create( ZipCodec::Deflate ) );
+  CPPUNIT_ASSERT_XRDST( codec->Compress( data.data(), data.size(), packed ) );
+
+  for( size_t i = 0; i < packed.size(); i += 7 )
+    packed[i] = ~packed[i];
+
+  std::vector<char> out( data.size() );
+  std::unique_ptr<ZipCodec> decoder( ZipCodec::Create( ZipCodec::Deflate ) );
+  XRootDStatus st = Decompress( *decoder, packed, out, 4096, 4096 );
+  CPPUNIT_ASSERT( !st.IsOK() );
+  CPPUNIT_ASSERT( st.code == errDataError );
+}
+
+//------------------------------------------------------------------------------
+// Adding and removing methods
+//------------------------------------------------------------------------------
+void ZipCodecTest::RegistryTest()
+{
+  using namespace XrdCl;
+
+  const uint16_t method = 0xfe01;
+  CPPUNIT_ASSERT( ZipCodec::IsSupported( ZipCodec::Deflate ) );
+  CPPUNIT_ASSERT( !ZipCodec::IsSupported( method ) );
+  CPPUNIT_ASSERT( !ZipCodec::Create( method ) );
+
+  ZipCodec::Register( method, DeflateFactory );
+  CPPUNIT_ASSERT( ZipCodec::IsSupported( method ) );
+  std::unique_ptr<ZipCodec> codec( ZipCodec::Create( method ) );
+  CPPUNIT_ASSERT( codec );
+
+  ZipCodec::Register( method, 0 );
+  CPPUNIT_ASSERT( !ZipCodec::IsSupported( method ) );
+  CPPUNIT_ASSERT_THROW( ZipCodecCache cache( method ), ZipError );
+}
+
+//------------------------------------------------------------------------------
+// Responses arriving out of order and reads queued from the callback
+//------------------------------------------------------------------------------
+void ZipCodecTest::CacheTest()
+{
+  using namespace XrdCl;
+
+  std::vector<char> data = MakeData( 200000 );
+  std::vector<char> packed;
+  std::unique_ptr<ZipCodec> codec( ZipCodec::Create( ZipCodec::Deflate ) );
+  CPPUNIT_ASSERT_XRDST( codec->Compress( data.data(), data.size(), packed ) );
+
+  ZipCodecCache cache( ZipCodec::Deflate );
+  std::vector<char> out( data.size() );
+  const uint32_t chunk = 30000;
+  const int      nreq  = ( data.size() + chunk - 1 ) / chunk;
+  std::vector<ReadHandler> handlers( nreq );
+
+  // every handler queues the next read, only the first one is queued here
+  for( int i = 0; i + 1 < nreq; ++i )
+  {
+    uint64_t off = uint64_t( i + 1 ) * chunk;
+    uint32_t len = std::min<uint64_t>( chunk, data.size() - off );
+    ReadHandler *next = &handlers[i + 1];
+    handlers[i].next = [&cache, &out, off, len, next]()
+                       {
+                         cache.QueueReq( off, len, out.data() + off, next );
+                       };
+  }
+  cache.QueueReq( 0, chunk, out.data(), &handlers[0] );
+
+  // feed the compressed data in pieces, last piece first
+  const uint32_t piece = 1000;
+  std::vector<uint64_t> offsets;
+  for( uint64_t off = 0; off < packed.size(); off += piece )
+    offsets.push_back( off );
+  std::swap( offsets.front(), offsets.back() );
+  for( uint64_t off : offsets )
+  {
+    size_t len = std::min<size_t>( piece, packed.size() - off );
+    cache.QueueRsp( XRootDStatus(), off,
+                    ZipCodecCache::buffer_t( packed.begin() + off,
+                                             packed.begin() + off + len ) );
+  }
+
+  for( int i = 0; i < nreq; ++i )
+  {
+    handlers[i].Wait();
+    CPPUNIT_ASSERT_XRDST( handlers[i].status );
+  }
+  CPPUNIT_ASSERT( handlers[nreq - 1].length == data.size() - ( nreq - 1 ) * chunk );
+  CPPUNIT_ASSERT( out == data );
+
+  // a failed response fails the pending read
+  ZipCodecCache failing( ZipCodec::Deflate );
+  ReadHandler h;
+  failing.QueueReq( 0, 100, out.data(), &h );
+  failing.QueueRsp( XRootDStatus( stError, errOSError ), 0,
+                    ZipCodecCache::buffer_t( 10 ) );
+  h.Wait();
+  CPPUNIT_ASSERT( !h.status.IsOK() );
+}
+
+namespace
+{
+  using namespace XrdCl;
+
+  struct Member
+  {
+    std::string       name;
+    uint16_t          method;
+    std::vector<char> data;
+  };
+
+  //----------------------------------------------------------------------------
+  // Write a local archive with the given members
+  //----------------------------------------------------------------------------
+  void WriteArchive( const std::string &path, const std::vector<Member> &members )
+  {
+    unlink( path.c_str() );
+    ZipArchive zip;
+    CPPUNIT_ASSERT_XRDST( WaitFor( OpenArchive( zip, path, OpenFlags::New | OpenFlags::Write ) ) );
+    for( auto &m : members )
+    {
+      uint32_t crc = crc32( 0, (const Bytef*)m.data.data(), m.data.size() );
+      SyncResponseHandler h;
+      CPPUNIT_ASSERT_XRDST( zip.AppendFile( m.name, m.method, crc, m.data.size(),
+                                            m.data.data(), &h ) );
+      CPPUNIT_ASSERT_XRDST( MessageUtils::WaitForStatus( &h ) );
+    }
+    CPPUNIT_ASSERT_XRDST( WaitFor( CloseArchive( zip ) ) );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Write members with and without compression and read them back in chunks,
+// the archive is too big to be held in memory so the data are read remotely
+//------------------------------------------------------------------------------
+void ZipCodecTest::ArchiveTest()
+{
+  using namespace XrdCl;
+
+  std::string path = "/tmp/xrdcl-zipcodectest-" + std::to_string( getpid() ) + ".zip";
+  std::vector<Member> members =
+  {
+    { "deflated.txt", ZipCodec::Deflate, MakeData( 150000 )        },
+    { "stored.txt",   ZipCodec::Stored,  MakeData( 1000 )          },
+    { "random.bin",   ZipCodec::Deflate, MakeData( 80000, false )  }, // stored, it does not compress
+  };
+  if( ZipCodec::IsSupported( ZipCodec::Zstd ) )
+    members.push_back( { "zstd.txt", ZipCodec::Zstd, MakeData( 150000 ) } );
+  WriteArchive( path, members );
+
+  ZipArchive zip;
+  CPPUNIT_ASSERT_XRDST( WaitFor( OpenArchive( zip, path, OpenFlags::Read ) ) );
+  for( auto &m : members )
+  {
+    std::vector<char> out( m.data.size() + 100 );
+    uint32_t chunk = 7000, got = 0;
+    for( uint64_t off = 0; off <= m.data.size(); off += chunk )
+    {
+      uint32_t length = 0;
+      CPPUNIT_ASSERT_XRDST( WaitFor(
+          ReadFrom( zip, m.name, off, chunk, out.data() + off ) >>
+            [&length]( XRootDStatus &s, ChunkInfo &c ) { if( s.IsOK() ) length = c.length; }
+        ) );
+      got += length;
+    }
+    CPPUNIT_ASSERT( got == m.data.size() );
+    CPPUNIT_ASSERT( std::equal( m.data.begin(), m.data.end(), out.begin() ) );
+  }
+  CPPUNIT_ASSERT_XRDST( WaitFor( CloseArchive( zip ) ) );
+  unlink( path.c_str() );
+}
+
+//------------------------------------------------------------------------------
+// Close and destroy the archive while the decompression is still pending
+//------------------------------------------------------------------------------
+void ZipCodecTest::ReadAfterCloseTest()
+{
+  using namespace XrdCl;
+
+  std::string path = "/tmp/xrdcl-zipcodectest-close-" + std::to_string( getpid() ) + ".zip";
+  std::vector<Member> members;
+  for( int i = 0; i < 8; ++i )
+    members.push_back( { "member" + std::to_string( i ), ZipCodec::Deflate,
+                         MakeData( 20000 + i ) } );
+  WriteArchive( path, members );
+
+  for( int round = 0; round < 20; ++round )
+  {
+    std::vector<std::vector<char>> out( members.size() );
+    std::vector<ReadHandler>       handlers( members.size() );
+
+    // the archive is small enough to be held in memory, so every read
+    // hands the decompression to the job manager
+    ZipArchive *zip = new ZipArchive();
+    CPPUNIT_ASSERT_XRDST( WaitFor( OpenArchive( *zip, path, OpenFlags::Read ) ) );
+    for( size_t i = 0; i < members.size(); ++i )
+    {
+      out[i].resize( members[i].data.size() );
+      CPPUNIT_ASSERT_XRDST( zip->ReadFrom( members[i].name, 0, out[i].size(),
+                                           out[i].data(), &handlers[i] ) );
+    }
+    CPPUNIT_ASSERT_XRDST( WaitFor( CloseArchive( *zip ) ) );
+    delete zip;
+
+    for( size_t i = 0; i < members.size(); ++i )
+    {
+      handlers[i].Wait();
+      CPPUNIT_ASSERT_XRDST( handlers[i].status );
+      CPPUNIT_ASSERT( out[i] == members[i].data );
+    }
+  }
+  unlink( path.c_str() );
+}
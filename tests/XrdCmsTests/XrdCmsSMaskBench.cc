@@ -0,0 +1,149 @@
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d C m s S M a s k B e n c h . c c                    */
+/*                                                                            */
+/* (c) 2026 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+// This program measures the cost of a server selection as done by the cmsd
+// (XrdCmsCluster::SelbyLoad() over the node table, after the cache and
+// SelNode() have combined the location masks) for several server mask widths
+// and cluster sizes. With the mask at a given width the cost should only
+// depend on the number of nodes, not on the width.
+//
+// Usage: xrdcmssmaskbench [selections]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "XrdCms/XrdCmsSMask.hh"
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+namespace
+{
+template<int nBits>
+struct Node
+{
+XrdCmsSMask<nBits> NodeMask;
+int                NodeID;
+int                myLoad;
+int                RefR;
+bool               isBad;
+};
+
+template<int nBits>
+struct Cluster
+{
+typedef XrdCmsSMask<nBits> Mask;
+
+std::vector<Node<nBits> *> NodeTab;
+int                        STHi;
+Mask                       badMask;
+
+// Build a cluster of nNodes with pseudo-random loads, a few suspended nodes
+//
+      Cluster(int nNodes) : NodeTab(nBits, (Node<nBits> *)0), STHi(nNodes-1)
+             {for (int i = 0; i < nNodes; i++)
+                  {Node<nBits> *np = new Node<nBits>;
+                   np->NodeMask = Mask::Bit(i);
+                   np->NodeID   = i;
+                   np->myLoad   = (i*7919) % 97;
+                   np->RefR     = 0;
+                   np->isBad    = (i % 31) == 30;
+                   if (np->isBad) badMask |= np->NodeMask;
+                   NodeTab[i] = np;
+                  }
+             }
+     ~Cluster() {for (auto np : NodeTab) delete np;}
+
+// Mirrors SelNode(): combine the have and pending masks, drop the bad nodes,
+// then pick the least loaded node in the result as SelbyLoad() does.
+//
+int   Select(const Mask &hfMask, const Mask &pfMask)
+           {Mask pmask = (hfMask | pfMask) & ~badMask;
+            Node<nBits> *np, *sp = 0;
+            if (!pmask) return -1;
+            if (pmask.Count() == 1) return pmask.First();
+            for (int i = 0; i <= STHi; i++)
+                if ((np = NodeTab[i]) && pmask.Test(np->NodeID))
+                   {if (np->isBad) continue;
+                    if (!sp || sp->myLoad > np->myLoad
+                    ||  (sp->myLoad == np->myLoad && sp->RefR > np->RefR))
+                       sp = np;
+                   }
+            if (sp) sp->RefR++;
+            return (sp ? sp->NodeID : -1);
+           }
+};
+
+// Times selections against location masks where about half the nodes have
+// the file, returning nanoseconds per selection.
+//
+template<int nBits>
+double Run(int nNodes, int iters, long &sum)
+{
+   typedef XrdCmsSMask<nBits> Mask;
+   typedef std::chrono::steady_clock Clock;
+   Cluster<nBits> cluster(nNodes);
+   std::vector<Mask> have(64), pend(64);
+
+   for (int j = 0; j < 64; j++)
+       for (int i = 0; i < nNodes; i++)
+           {if (((i+j)*2654435761U) % 2) have[j].Set(i);
+            if (((i+j)*40503U) % 17 == 0) pend[j].Set(i);
+           }
+
+   Clock::time_point beg = Clock::now();
+   for (int k = 0; k < iters; k++) sum += cluster.Select(have[k&63], pend[k&63]);
+   return std::chrono::duration<double, std::nano>(Clock::now() - beg).count()
+          / iters;
+}
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char **argv)
+{
+   int iters = (argc > 1 ? atoi(argv[1]) : 200000);
+   long sum = 0;
+
+   printf("%-6s %10s %10s %10s\n", "nodes", "64 bits", "256 bits", "1024 bits");
+   printf("%-6d %10.1f %10.1f %10.1f\n", 64, Run<64>(64, iters, sum),
+          Run<256>(64, iters, sum), Run<1024>(64, iters, sum));
+   printf("%-6d %10s %10.1f %10.1f\n", 256, "-",
+          Run<256>(256, iters, sum), Run<1024>(256, iters, sum));
+   printf("%-6d %10s %10s %10.1f\n", 1024, "-", "-",
+          Run<1024>(1024, iters, sum));
+   printf("ns per selection (checksum %ld)\n", sum);
+   return 0;
+}
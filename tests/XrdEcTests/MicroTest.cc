@@ -29,6 +29,7 @@
 #include "XrdEc/XrdEcStrmWriter.hh"
 #include "XrdEc/XrdEcReader.hh"
 #include "XrdEc/XrdEcObjCfg.hh"
+#include "XrdEc/XrdEcRedundancyProvider.hh"
 
 #include "XrdCl/XrdClMessageUtils.hh"
 
@@ -37,6 +38,9 @@
 #include <string>
 #include <memory>
 #include <limits>
+#include <algorithm>
+#include <functional>
+#include <random>
 
 #include <unistd.h>
 #include <cstdio>
@@ -63,6 +67,7 @@ class MicroTest: public CppUnit::TestCase
       CPPUNIT_TEST( BigWriteTestIsalCrcNoMt );
       CPPUNIT_TEST( AlignedWrite1MissingTestIsalCrcNoMt );
       CPPUNIT_TEST( AlignedWrite2MissingTestIsalCrcNoMt );
+      CPPUNIT_TEST( RecoveryTest );
     CPPUNIT_TEST_SUITE_END();
 
     void Init( bool usecrc32c );
@@ -161,6 +166,8 @@ class MicroTest: public CppUnit::TestCase
       VarlenWriteTest( 77, false );
     }
 
+    void RecoveryTest();
+
     void Verify()
     {
       ReadVerifyAll();
@@ -556,3 +563,50 @@ void MicroTest::VarlenWriteTest( uint32_t wrtlen, bool usecrc32c )
   CleanUp();
 }
 
+
+void MicroTest::RecoveryTest()
+{
+  // big enough chunks for the parallel decode to kick in
+  ObjCfg cfg( "test.txt", nbdata, nbparity, 1024 * 1024, true );
+  RedundancyProvider redundancy( cfg );
+  std::vector<buffer_t> block( cfg.nbchunks, buffer_t( cfg.chunksize ) );
+  std::default_random_engine random_engine( 1234 );
+  for( size_t i = 0; i < cfg.nbdata; ++i )
+    std::generate( block[i].begin(), block[i].end(), std::ref( random_engine ) );
+  // compute the parity
+  stripes_t stripes;
+  for( size_t i = 0; i < cfg.nbchunks; ++i )
+    stripes.emplace_back( block[i].data(), i < cfg.nbdata );
+  redundancy.compute( stripes );
+
+  // lose every combination of up to nbparity chunks and recover them,
+  // serially, in parallel as configured, and forced into several segments
+  // (an uneven number too) whatever the number of cores
+  const size_t nsegs[] = { 1, 0, 3, 16 };
+  for( size_t mask = 1; mask < ( 1u << cfg.nbchunks ); ++mask )
+  {
+    if( __builtin_popcount( mask ) > cfg.nbparity ) continue;
+    for( size_t n : nsegs )
+    {
+      std::vector<buffer_t> copy( block );
+      stripes_t strps;
+      for( size_t i = 0; i < cfg.nbchunks; ++i )
+      {
+        bool lost = mask & ( 1u << i );
+        if( lost ) std::fill( copy[i].begin(), copy[i].end(), 0 );
+        strps.emplace_back( copy[i].data(), !lost );
+      }
+      if( n )
+        redundancy.computeSegmented( strps, n );
+      else
+        redundancy.compute( strps, true );
+      CPPUNIT_ASSERT( copy == block );
+    }
+  }
+
+  // losing more than nbparity chunks is an error
+  stripes_t strps;
+  for( size_t i = 0; i < cfg.nbchunks; ++i )
+    strps.emplace_back( block[i].data(), i > cfg.nbparity );
+  CPPUNIT_ASSERT_THROW( redundancy.compute( strps ), IOError );
+}
@@ -0,0 +1,293 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "XrdOss/XrdOssReadV.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class XrdOssReadVTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( XrdOssReadVTest );
+      CPPUNIT_TEST( MergeTest );
+      CPPUNIT_TEST( LimitTest );
+      CPPUNIT_TEST( EOFTest );
+      CPPUNIT_TEST( RandomTest );
+      CPPUNIT_TEST( ConcurrentTest );
+    CPPUNIT_TEST_SUITE_END();
+    void setUp();
+    void MergeTest();
+    void LimitTest();
+    void EOFTest();
+    void RandomTest();
+    void ConcurrentTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( XrdOssReadVTest );
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Every byte of the test file is a function of its offset
+  //----------------------------------------------------------------------------
+  const long long fileSize = 4 * 1024 * 1024;
+
+  char Expect( long long offset )
+  {
+    return (char)( ( offset * 7 ) ^ ( offset >> 9 ) );
+  }
+
+  int fileFD = -1;
+
+  //----------------------------------------------------------------------------
+  // A vector read whose elements each own a buffer
+  //----------------------------------------------------------------------------
+  class Request
+  {
+    public:
+      void Add( long long offset, int size )
+      {
+        XrdOucIOVec elem;
+        elem.offset = offset;
+        elem.size   = size;
+        elem.info   = 0;
+        elem.data   = 0;
+        vec.push_back( elem );
+        bufs.emplace_back( size + 2, '#' );
+      }
+
+      // Read via the engine, checking the guard bytes around each buffer
+      ssize_t Read( int fd = fileFD )
+      {
+        for( size_t i = 0; i < vec.size(); ++i )
+          vec[i].data = &bufs[i][1];
+        ssize_t rc = XrdOssReadV::Read( fd, vec.data(), vec.size() );
+        for( size_t i = 0; i < vec.size(); ++i )
+          if( bufs[i].front() != '#' || bufs[i].back() != '#' ) return -EFAULT;
+        return rc;
+      }
+
+      // Compare each buffer with what pread() returns
+      bool Check()
+      {
+        for( size_t i = 0; i < vec.size(); ++i )
+        {
+          std::vector<char> want( vec[i].size );
+          if( vec[i].size && pread( fileFD, want.data(), vec[i].size,
+                                    vec[i].offset ) != vec[i].size )
+            return false;
+          if( memcmp( want.data(), &bufs[i][1], vec[i].size ) ) return false;
+          for( int k = 0; k < vec[i].size; ++k )
+            if( bufs[i][k+1] != Expect( vec[i].offset + k ) ) return false;
+        }
+        return true;
+      }
+
+      long long Bytes()
+      {
+        long long total = 0;
+        for( auto &elem : vec ) total += elem.size;
+        return total;
+      }
+
+      std::vector<XrdOucIOVec>       vec;
+      std::vector<std::vector<char>> bufs;
+  };
+
+  //----------------------------------------------------------------------------
+  // A random request of up to maxElems elements, mostly close together so
+  // that they merge, with some overlapping and some far apart
+  //----------------------------------------------------------------------------
+  void Random( Request &req, std::mt19937 &rng, int maxElems )
+  {
+    int n = 1 + rng() % maxElems;
+    long long offset = rng() % ( fileSize / 2 );
+    for( int i = 0; i < n; ++i )
+    {
+      int size = rng() % 5 ? 1 + rng() % 8192 : 0;
+      switch( rng() % 6 )
+      {
+        case 0:  offset += rng() % 64;           break;  // adjacent or close
+        case 1:  offset += 4096 + rng() % 8192;  break;  // around the gap
+        case 2:  offset -= rng() % 4096;         break;  // overlapping
+        case 3:  offset  = rng() % fileSize;     break;  // anywhere
+        default: break;                                  // adjacent
+      }
+      if( offset < 0 ) offset = 0;
+      if( offset + size > fileSize ) offset = fileSize - size;
+      req.Add( offset, size );
+      offset += size;
+    }
+  }
+
+  bool inited = false;
+}
+
+//------------------------------------------------------------------------------
+// Create the test file and start the helpers once for all tests
+//------------------------------------------------------------------------------
+void XrdOssReadVTest::setUp()
+{
+  XrdOssReadV::Set( true, 4096, 1048576, 4 );
+  if( inited ) return;
+
+  char path[] = "/tmp/XrdOssReadVTest.XXXXXX";
+  fileFD = mkstemp( path );
+  CPPUNIT_ASSERT( fileFD >= 0 );
+  unlink( path );
+  std::vector<char> data( fileSize );
+  for( long long i = 0; i < fileSize; ++i ) data[i] = Expect( i );
+  CPPUNIT_ASSERT( write( fileFD, data.data(), fileSize ) == fileSize );
+
+  static XrdSysLogger logger;
+  static XrdSysError  eDest( &logger, "ReadVTest" );
+  CPPUNIT_ASSERT( XrdOssReadV::Init( eDest ) );
+  inited = true;
+}
+
+//------------------------------------------------------------------------------
+// Unsorted, adjacent, gapped, overlapping, duplicate and empty elements
+//------------------------------------------------------------------------------
+void XrdOssReadVTest::MergeTest()
+{
+  Request req;
+  req.Add( 100000,  1000 );   // read last, after the others
+  req.Add( 0,       100 );
+  req.Add( 100,     200 );    // adjacent
+  req.Add( 1000,    50 );     // small gap
+  req.Add( 1000 + 50 + 4096, 10 );  // gap of exactly the limit
+  req.Add( 20000,   10 );     // gap too large
+  req.Add( 19995,   20 );     // overlaps the previous one
+  req.Add( 19995,   20 );     // duplicate
+  req.Add( 50000,   0 );      // empty
+  req.Add( 99990,   30 );     // overlaps the first one
+  req.Add( fileSize - 7, 7 ); // the very end of the file
+  CPPUNIT_ASSERT( req.Read() == req.Bytes() );
+  CPPUNIT_ASSERT( req.Check() );
+
+  // Without a gap only adjacent elements merge
+  XrdOssReadV::Set( true, 0, 1048576, 4 );
+  Request adj;
+  for( int i = 0; i < 64; ++i ) adj.Add( i * 3000 + ( i & 1 ) * 1000, 1000 );
+  CPPUNIT_ASSERT( adj.Read() == adj.Bytes() );
+  CPPUNIT_ASSERT( adj.Check() );
+}
+
+//------------------------------------------------------------------------------
+// Extents are split at the size limit and at the iovec limit
+//------------------------------------------------------------------------------
+void XrdOssReadVTest::LimitTest()
+{
+  XrdOssReadV::Set( true, 4096, 4096, 4 );
+  Request small;
+  for( int i = 0; i < 100; ++i ) small.Add( i * 1500, 1000 );
+  small.Add( 200000, 10000 );  // larger than the limit on its own
+  CPPUNIT_ASSERT( small.Read() == small.Bytes() );
+  CPPUNIT_ASSERT( small.Check() );
+
+  XrdOssReadV::Set( true, 4096, 1048576, 4 );
+  Request many;
+  for( int i = 0; i < 3000; ++i ) many.Add( i * 16 + ( i % 3 ) * 4, 8 );
+  CPPUNIT_ASSERT( many.Read() == many.Bytes() );
+  CPPUNIT_ASSERT( many.Check() );
+
+  // The same without helpers
+  XrdOssReadV::Set( true, 4096, 1048576, 0 );
+  Request solo;
+  for( int i = 0; i < 3000; ++i ) solo.Add( i * 16 + ( i % 3 ) * 4, 8 );
+  CPPUNIT_ASSERT( solo.Read() == solo.Bytes() );
+  CPPUNIT_ASSERT( solo.Check() );
+}
+
+//------------------------------------------------------------------------------
+// A short read is an error
+//------------------------------------------------------------------------------
+void XrdOssReadVTest::EOFTest()
+{
+  Request req;
+  for( int i = 0; i < 8; ++i ) req.Add( i * 100000, 100 );
+  req.Add( fileSize - 10, 20 );
+  CPPUNIT_ASSERT( req.Read() == -ESPIPE );
+
+  Request past;
+  past.Add( 0, 10 );
+  past.Add( fileSize + 100, 10 );
+  CPPUNIT_ASSERT( past.Read() == -ESPIPE );
+
+  Request bad;
+  bad.Add( 0, 10 );
+  bad.Add( 100, 10 );
+  CPPUNIT_ASSERT( bad.Read( -1 ) == -EBADF );
+}
+
+//------------------------------------------------------------------------------
+// Random requests compared with pread()
+//------------------------------------------------------------------------------
+void XrdOssReadVTest::RandomTest()
+{
+  std::mt19937 rng( 11 );
+  for( int i = 0; i < 200; ++i )
+  {
+    Request req;
+    Random( req, rng, 1024 );
+    CPPUNIT_ASSERT( req.Read() == req.Bytes() );
+    CPPUNIT_ASSERT( req.Check() );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Concurrent requests share the helpers; gaps are read into per-thread sinks
+//------------------------------------------------------------------------------
+void XrdOssReadVTest::ConcurrentTest()
+{
+  const int nThreads = 6, nReqs = 50;
+  std::vector<int> failed( nThreads, 0 );
+  std::vector<std::thread> threads;
+
+  for( int t = 0; t < nThreads; ++t )
+    threads.emplace_back( [&failed, t]()
+    {
+      std::mt19937 rng( 100 + t );
+      for( int i = 0; i < nReqs; ++i )
+      {
+        Request req;
+        Random( req, rng, 256 );
+        if( req.Read() != req.Bytes() || !req.Check() ) failed[t]++;
+      }
+    } );
+  for( auto &thread : threads ) thread.join();
+
+  for( int t = 0; t < nThreads; ++t ) CPPUNIT_ASSERT( failed[t] == 0 );
+}
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "XrdOuc/XrdOucAdler32.hh"
+#include "XrdOuc/XrdOucCRC.hh"
+
+#include <zlib.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class XrdOucAdler32Test: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( XrdOucAdler32Test );
+      CPPUNIT_TEST( KernelTest );
+      CPPUNIT_TEST( CombineTest );
+    CPPUNIT_TEST_SUITE_END();
+    void KernelTest();
+    void CombineTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( XrdOucAdler32Test );
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Use a buffer larger than NMAX and include runs of 0xff bytes to exercise
+  // the worst case for the modulo reductions
+  //----------------------------------------------------------------------------
+  void Fill( std::vector<unsigned char> &buff )
+  {
+    buff.resize( 3 * 1024 * 1024 + 77 );
+    srand( 1234 );
+    for( size_t i = 0; i < buff.size(); ++i )
+      buff[i] = ( i / 4096 ) % 3 ? rand() & 0xff : 0xff;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Every kernel against zlib
+//------------------------------------------------------------------------------
+void XrdOucAdler32Test::KernelTest()
+{
+  std::vector<unsigned char> buff;
+  Fill( buff );
+
+  //----------------------------------------------------------------------------
+  // Each kernel the processor supports must match zlib for all alignments,
+  // for lengths around the vector block sizes and NMAX, and when starting
+  // from a checksum whose sums are at their largest
+  //----------------------------------------------------------------------------
+  const char *kernels[] = { "scalar", "ssse3", "avx2", "avx512" };
+  const size_t lens[] = { 5551, 5552, 5553, 5552 + 31, 5552 + 65,
+                          2 * 5552 - 1, 2 * 5552 + 127, 3 * 5552 + 63,
+                          65536 + 17, 1048576 + 3 };
+  const uint32_t seeds[] = { 1, 0, 0xfff0fff0, 0x1234abcd % 65521 };
+
+  std::vector<unsigned char> ones( 4 * 5552 + 128, 0xff );
+  for( size_t k = 0; k < sizeof( kernels ) / sizeof( kernels[0] ); ++k )
+  {
+    xrdadler32_func kernel = xrdadler32_kernel( kernels[k] );
+    if( !kernel ) continue;  // not supported by this processor
+
+    for( size_t off = 0; off < 64; ++off )
+    {
+      for( size_t len = 0; len < 1024; len += 1 + len / 8 )
+      {
+        uint32_t zcs = adler32( 1, buff.data() + off, len );
+        CPPUNIT_ASSERT( kernel( 1, buff.data() + off, len ) == zcs );
+      }
+      for( size_t l = off % 2; l < sizeof( lens ) / sizeof( lens[0] ); l += 2 )
+      {
+        uint32_t zcs = adler32( 1, buff.data() + off, lens[l] );
+        CPPUNIT_ASSERT( kernel( 1, buff.data() + off, lens[l] ) == zcs );
+      }
+    }
+
+    for( size_t s = 0; s < sizeof( seeds ) / sizeof( seeds[0] ); ++s )
+    {
+      for( size_t off = 0; off < 64; off += 7 )
+      {
+        size_t len = ones.size() - off;
+        CPPUNIT_ASSERT( kernel( seeds[s], ones.data() + off, len ) ==
+                        adler32( seeds[s], ones.data() + off, len ) );
+        CPPUNIT_ASSERT( kernel( seeds[s], buff.data() + off, len ) ==
+                        adler32( seeds[s], buff.data() + off, len ) );
+      }
+    }
+  }
+
+  for( size_t off = 0; off < 64; ++off )
+  {
+    for( size_t len = 0; len < 1024; len += 1 + len / 8 )
+      CPPUNIT_ASSERT( xrdadler32( 1, buff.data() + off, len ) ==
+                      adler32( 1, buff.data() + off, len ) );
+  }
+  CPPUNIT_ASSERT( xrdadler32_kernel( xrdadler32_impl() ) != 0 );
+  CPPUNIT_ASSERT( xrdadler32_kernel( "none" ) == 0 );
+}
+
+//------------------------------------------------------------------------------
+// Incremental updates and combining independently computed chunks must
+// produce the checksum of the whole buffer
+//------------------------------------------------------------------------------
+void XrdOucAdler32Test::CombineTest()
+{
+  std::vector<unsigned char> buff;
+  Fill( buff );
+
+  uint32_t zcs = adler32( 1, buff.data(), buff.size() );
+  CPPUNIT_ASSERT( XrdOucCRC::Adler32( buff.data(), buff.size() ) == zcs );
+  CPPUNIT_ASSERT( xrdadler32_sw( 1, buff.data(), buff.size() ) == zcs );
+
+  const size_t chunks[] = { 1, 15, 4096, 5552, 65536, 1000003 };
+  for( size_t c = 0; c < sizeof( chunks ) / sizeof( size_t ); ++c )
+  {
+    uint32_t cs = 1, ccs = 1;
+    for( size_t pos = 0; pos < buff.size(); pos += chunks[c] )
+    {
+      size_t len = std::min( chunks[c], buff.size() - pos );
+      cs  = XrdOucCRC::Adler32( buff.data() + pos, len, cs );
+      ccs = XrdOucCRC::Adler32( ccs, XrdOucCRC::Adler32( buff.data() + pos,
+                                                         len ), len );
+    }
+    CPPUNIT_ASSERT( cs  == zcs );
+    CPPUNIT_ASSERT( ccs == zcs );
+  }
+}
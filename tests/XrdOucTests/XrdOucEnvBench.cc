@@ -0,0 +1,193 @@
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d O u c E n v B e n c h . c c                      */
+/*                                                                            */
+/* (c) 2023 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+// This program compares the cost of building an XrdOucEnv from typical WLCG
+// opaque strings and looking up the variables an open would use with that of
+// the hash table based parser it replaced. It also verifies that both give
+// the same answers.
+//
+// Usage: xrdoucenvbench [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdOuc/XrdOucHash.hh"
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+
+// This is a copy of the parser XrdOucEnv used before.
+//
+class OldEnv
+{
+public:
+
+char *Get(const char *varname) {return env_Hash.Find(varname);}
+
+      OldEnv(const char *vardata) : env_Hash(8,13)
+            {char *vdp, varsave, *varname, *varvalu;
+             int varlen = strlen(vardata);
+             while(*vardata == '&' && varlen) {vardata++; varlen--;}
+             if (!varlen) {global_env = 0; return;}
+             global_env = (char *)malloc(varlen+2);
+             *global_env = '&'; vdp = global_env+1;
+             memcpy((void *)vdp, (const void *)vardata, (size_t)varlen);
+             *(vdp+varlen) = '\0';
+             while(*vdp)
+                  {while(*vdp == '&') vdp++;
+                   varname = vdp;
+                   while(*vdp && *vdp != '=' && *vdp != '&') vdp++;
+                   if (!*vdp) break;
+                   if (*vdp == '&') continue;
+                   *vdp = '\0';
+                   varvalu = ++vdp;
+                   while(*vdp && *vdp != '&') vdp++;
+                   varsave = *vdp; *vdp = '\0';
+                   if (*varname && *varvalu)
+                      env_Hash.Rep(varname, strdup(varvalu), 0, Hash_dofree);
+                   *vdp = varsave; *(varvalu-1) = '=';
+                  }
+            }
+     ~OldEnv() {if (global_env) free(global_env);}
+
+private:
+XrdOucHash<char> env_Hash;
+char            *global_env;
+};
+
+// The variables looked up while opening a file (most are usually absent)
+//
+const char *getVars[] = {"authz", "tried", "triedrc", "oss.asize", "oss.cgroup",
+                         "ofs.posc", "cms.need", "xrd.gsiusrpxy", "scitag.flow",
+                         "xrdcl.requuid", "xrd.wantprot", "ofs.tpc", 0};
+
+std::string Token(int len)
+{
+   static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                             "0123456789-_";
+   std::string tok("Bearer%20eyJhbGciOiJSUzI1NiIsImtpZCI6InJzYTEifQ.");
+   for (int i = 0; i < len; i++) tok += b64[(i*7919) % 64];
+   return tok;
+}
+
+double Elapsed(Clock::time_point beg)
+{
+   return std::chrono::duration<double, std::nano>(Clock::now() - beg).count();
+}
+
+template<class T> double Run(const char *cgi, int iters, long &found)
+{
+   Clock::time_point beg = Clock::now();
+   for (int i = 0; i < iters; i++)
+       {T env(cgi);
+        for (int j = 0; getVars[j]; j++) if (env.Get(getVars[j])) found++;
+       }
+   return Elapsed(beg)/iters;
+}
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char **argv)
+{
+   int iters = (argc > 1 ? atoi(argv[1]) : 200000);
+   std::string many;
+   long oFound = 0, nFound = 0;
+   int bad = 0;
+
+   for (int i = 0; i < 40; i++)
+       many += "&xrdcl.var" + std::to_string(i) + "=" + std::to_string(i*i);
+   many += "&authz=" + Token(300) + "&tried=a.cern.ch&oss.asize=42";
+   many.erase(0, 1);
+
+   std::string cgis[][2] =
+      {{"xrdcp open",
+        "xrdcl.requuid=0b1c6a52-25c8-4a8e-b0a6-0c3e4d1f7a9e&oss.asize=1048576"},
+       {"token open",
+        "authz=" + Token(900) + "&scitag.flow=144"
+        "&xrdcl.requuid=0b1c6a52-25c8-4a8e-b0a6-0c3e4d1f7a9e"},
+       {"retry open",
+        "tried=eosatlas-fst12.cern.ch,eosatlas-fst47.cern.ch&triedrc=enoent,ioerr"
+        "&xrd.wantprot=ztn,gsi,unix&oss.lcl=1&ofs.posc=1&cms.need=1"
+        "&xrdcl.requuid=0b1c6a52-25c8-4a8e-b0a6-0c3e4d1f7a9e"},
+       {"tpc pull",
+        "authz=" + Token(1200) + "&tpc.src=root://dcache-door.example.org:1094"
+        "&tpc.key=1a2b3c4d5e6f&tpc.dlg=gsiftp&tpc.stage=copy&tpc.ttl=60"
+        "&oss.asize=5368709120&xrd.gsiusrpxy=/tmp/x509up_u1000&ofs.tpc=pull"},
+       {"43 variables", many}
+      };
+
+// Verify that the answers are the same, including for the variables that
+// are present but not looked up during the timing runs.
+//
+   for (auto &c : cgis)
+       {OldEnv oEnv(c[1].c_str());
+        XrdOucEnv nEnv(c[1].c_str());
+        std::string probe = "&" + c[1] + "&missing=&=x";
+        for (size_t p = 0; (p = probe.find('&', p)) != std::string::npos; p++)
+            {std::string var = probe.substr(p+1, probe.find('=', p) - p - 1);
+             const char *ov = oEnv.Get(var.c_str()), *nv = nEnv.Get(var.c_str());
+             if ((ov == 0) != (nv == 0) || (ov && strcmp(ov, nv)))
+                {printf("%s: '%s' differs ('%s' vs '%s')\n", c[0].c_str(),
+                        var.c_str(), (ov ? ov : "<none>"), (nv ? nv : "<none>"));
+                 bad++;
+                }
+            }
+        int envlen;
+        if (strcmp(nEnv.Env(envlen), ("&" + c[1]).c_str()))
+           {printf("%s: Env() differs\n", c[0].c_str()); bad++;}
+       }
+
+// Now time building the environment and doing the lookups
+//
+   printf("%-14s %6s %14s %14s %8s\n", "opaque", "bytes", "hash ns", "flat ns",
+          "speedup");
+   for (auto &c : cgis)
+       {double oNs = Run<OldEnv>   (c[1].c_str(), iters, oFound);
+        double nNs = Run<XrdOucEnv>(c[1].c_str(), iters, nFound);
+        printf("%-14s %6d %14.1f %14.1f %7.2fx\n", c[0].c_str(),
+               (int)c[1].size(), oNs, nNs, oNs/nNs);
+       }
+
+   if (oFound != nFound)
+      {printf("lookups found %ld vs %ld variables\n", oFound, nFound); bad++;}
+   return (bad ? 1 : 0);
+}
@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "XrdOuc/XrdOucEnv.hh"
+
+#include <cstring>
+#include <string>
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class XrdOucEnvTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( XrdOucEnvTest );
+      CPPUNIT_TEST( ParseTest );
+      CPPUNIT_TEST( PutTest );
+      CPPUNIT_TEST( ReplaceTest );
+      CPPUNIT_TEST( GrowTest );
+      CPPUNIT_TEST( PtrIntTest );
+    CPPUNIT_TEST_SUITE_END();
+    void ParseTest();
+    void PutTest();
+    void ReplaceTest();
+    void GrowTest();
+    void PtrIntTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( XrdOucEnvTest );
+
+namespace
+{
+  bool Is( XrdOucEnv &env, const char *var, const char *val )
+  {
+    const char *v = env.Get( var );
+    if( !val ) return v == 0;
+    return v && !strcmp( v, val );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Opaque string parsing
+//------------------------------------------------------------------------------
+void XrdOucEnvTest::ParseTest()
+{
+  int envlen;
+
+  XrdOucEnv empty;
+  CPPUNIT_ASSERT( empty.Env( envlen ) == 0 && envlen == 0 );
+  CPPUNIT_ASSERT( Is( empty, "a", 0 ) );
+
+  XrdOucEnv amps( "&&&" );
+  CPPUNIT_ASSERT( amps.Env( envlen ) == 0 && envlen == 0 );
+
+  const char *cgi = "&&a=1&b=&=x&c&d=4&&a=5&e=x=y";
+  XrdOucEnv env( cgi );
+  CPPUNIT_ASSERT( !strcmp( env.Env( envlen ), cgi + 1 ) );
+  CPPUNIT_ASSERT( envlen == (int)strlen( cgi + 1 ) );
+  CPPUNIT_ASSERT( Is( env, "a", "5" ) );   // the last setting wins
+  CPPUNIT_ASSERT( Is( env, "b", 0 ) );     // empty values are ignored
+  CPPUNIT_ASSERT( Is( env, "", 0 ) );
+  CPPUNIT_ASSERT( Is( env, "c", 0 ) );     // so are names without a value
+  CPPUNIT_ASSERT( Is( env, "d", "4" ) );
+  CPPUNIT_ASSERT( Is( env, "e", "x=y" ) );
+  CPPUNIT_ASSERT( Is( env, "f", 0 ) );
+
+  // Only the passed length is used
+  XrdOucEnv part( "x=12&y=34", 4 );
+  CPPUNIT_ASSERT( Is( part, "x", "12" ) );
+  CPPUNIT_ASSERT( Is( part, "y", 0 ) );
+  CPPUNIT_ASSERT( !strcmp( part.Env( envlen ), "&x=12" ) );
+}
+
+//------------------------------------------------------------------------------
+// Put() into an object with and without an opaque string
+//------------------------------------------------------------------------------
+void XrdOucEnvTest::PutTest()
+{
+  char value[] = "value";
+  int envlen;
+
+  XrdOucEnv env;
+  env.Put( "name", value );
+  value[0] = 'V';                          // the value must have been copied
+  CPPUNIT_ASSERT( Is( env, "name", "value" ) );
+  CPPUNIT_ASSERT( Is( env, "other", 0 ) );
+  CPPUNIT_ASSERT( env.Env( envlen ) == 0 );
+
+  XrdOucEnv cgi( "a=1&b=2" );
+  cgi.Put( "c", "3" );
+  CPPUNIT_ASSERT( Is( cgi, "a", "1" ) );
+  CPPUNIT_ASSERT( Is( cgi, "b", "2" ) );
+  CPPUNIT_ASSERT( Is( cgi, "c", "3" ) );
+  CPPUNIT_ASSERT( !strcmp( cgi.Env( envlen ), "&a=1&b=2" ) );
+}
+
+//------------------------------------------------------------------------------
+// Replacing variables set by the constructor and by Put()
+//------------------------------------------------------------------------------
+void XrdOucEnvTest::ReplaceTest()
+{
+  int envlen;
+  XrdOucEnv env( "a=1&b=2" );
+
+  env.Put( "a", "one" );
+  CPPUNIT_ASSERT( Is( env, "a", "one" ) );
+  env.Put( "a", "uno" );
+  CPPUNIT_ASSERT( Is( env, "a", "uno" ) );
+  env.Put( "a", "" );
+  CPPUNIT_ASSERT( Is( env, "a", "" ) );
+  CPPUNIT_ASSERT( Is( env, "b", "2" ) );
+
+  // The original opaque string is not affected
+  CPPUNIT_ASSERT( !strcmp( env.Env( envlen ), "&a=1&b=2" ) );
+}
+
+//------------------------------------------------------------------------------
+// Growing the table past its inline size, then replacing
+//------------------------------------------------------------------------------
+void XrdOucEnvTest::GrowTest()
+{
+  std::string cgi;
+  for( int i = 0; i < 40; ++i )
+    cgi += "&c" + std::to_string( i ) + "=" + std::to_string( i * i );
+
+  XrdOucEnv env( cgi.c_str() );
+  for( int i = 0; i < 300; ++i )
+    env.Put( ( "p" + std::to_string( i ) ).c_str(), std::to_string( i ).c_str() );
+
+  for( int i = 0; i < 40; ++i )
+    CPPUNIT_ASSERT( Is( env, ( "c" + std::to_string( i ) ).c_str(),
+                        std::to_string( i * i ).c_str() ) );
+  for( int i = 0; i < 300; ++i )
+    CPPUNIT_ASSERT( Is( env, ( "p" + std::to_string( i ) ).c_str(),
+                        std::to_string( i ).c_str() ) );
+
+  for( int i = 0; i < 300; i += 3 )
+    env.Put( ( "p" + std::to_string( i ) ).c_str(), "x" );
+  for( int i = 0; i < 40; i += 2 )
+    env.Put( ( "c" + std::to_string( i ) ).c_str(), "y" );
+
+  for( int i = 0; i < 300; ++i )
+    CPPUNIT_ASSERT( Is( env, ( "p" + std::to_string( i ) ).c_str(),
+                        i % 3 ? std::to_string( i ).c_str() : "x" ) );
+  for( int i = 0; i < 40; ++i )
+    CPPUNIT_ASSERT( Is( env, ( "c" + std::to_string( i ) ).c_str(),
+                        i % 2 ? std::to_string( i * i ).c_str() : "y" ) );
+  CPPUNIT_ASSERT( Is( env, "p300", 0 ) );
+
+  // A table that starts without an opaque string grows the same way
+  XrdOucEnv bare;
+  for( int i = 0; i < 100; ++i )
+    bare.Put( std::to_string( i ).c_str(), std::to_string( -i ).c_str() );
+  for( int i = 0; i < 100; ++i )
+    CPPUNIT_ASSERT( Is( bare, std::to_string( i ).c_str(),
+                        std::to_string( -i ).c_str() ) );
+}
+
+//------------------------------------------------------------------------------
+// PutPtr()/GetPtr() and PutInt()/GetInt()
+//------------------------------------------------------------------------------
+void XrdOucEnvTest::PtrIntTest()
+{
+  int target;
+  XrdOucEnv env( "n=42&p=xyz" );
+
+  CPPUNIT_ASSERT( env.GetPtr( "obj*" ) == 0 );
+  env.PutPtr( "obj*", &target );
+  CPPUNIT_ASSERT( env.GetPtr( "obj*" ) == &target );
+  env.PutPtr( "obj*", 0 );
+  CPPUNIT_ASSERT( env.GetPtr( "obj*" ) == 0 );
+  env.PutPtr( "obj*", &env );
+  CPPUNIT_ASSERT( env.GetPtr( "obj*" ) == &env );
+  CPPUNIT_ASSERT( env.GetPtr( "p" ) == 0 );  // not a pointer
+
+  CPPUNIT_ASSERT( env.GetInt( "n" ) == 42 );
+  CPPUNIT_ASSERT( env.GetInt( "m" ) == -999999999 );
+  env.PutInt( "n", -7 );
+  CPPUNIT_ASSERT( env.GetInt( "n" ) == -7 );
+  env.PutInt( "m", 1234567890123L );
+  CPPUNIT_ASSERT( env.GetInt( "m" ) == 1234567890123L );
+}
@@ -0,0 +1,194 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d S c h e d B e n c h . c c                       */
+/*                                                                            */
+/* (c) 2023 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+// This program compares the cost of timed job insertion and cancellation in
+// the scheduler's timing wheel with the sorted list it replaced and then
+// checks how late jobs scheduled with millisecond delays actually run.
+//
+// Usage: xrdschedbench [njobs ...]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <unistd.h>
+#include <vector>
+
+#include "Xrd/XrdJob.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+
+// This is a copy of the sorted list the scheduler used for timed jobs.
+//
+class ListTimer
+{
+public:
+
+struct Item {Item *next; time_t when;};
+
+void Cancel(Item *ip)
+           {Item *p, *pp = 0;
+            tMutex.Lock();
+            p = tQueue;
+            while(p && p != ip) {pp = p; p = p->next;}
+            if (p)
+               {if (pp) pp->next = p->next;
+                   else tQueue  = p->next;
+               }
+            tMutex.UnLock();
+           }
+
+void Schedule(Item *ip, time_t atime)
+             {Item *pp = 0, *p;
+              Cancel(ip);
+              ip->when = atime;
+              tMutex.Lock();
+              p = tQueue;
+              while(p && p->when <= atime) {pp = p; p = p->next;}
+              ip->next = p;
+              if (pp) pp->next = ip;
+                 else tQueue = ip;
+              tMutex.UnLock();
+             }
+
+     ListTimer() : tQueue(0) {}
+
+private:
+Item       *tQueue;
+XrdSysMutex tMutex;
+};
+
+class BenchJob : public XrdJob
+{
+public:
+
+void DoIt() {long long late = std::chrono::duration_cast
+                              <std::chrono::microseconds>
+                              (Clock::now() - due).count();
+             long long mx = maxLate;
+             while(late > mx && !maxLate.compare_exchange_weak(mx, late)) {}
+             sumLate += late;
+             numRun++;
+            }
+
+Clock::time_point        due;
+
+static std::atomic<long long> numRun;
+static std::atomic<long long> sumLate;
+static std::atomic<long long> maxLate;
+
+     BenchJob() : XrdJob(".bench") {}
+};
+
+std::atomic<long long> BenchJob::numRun(0);
+std::atomic<long long> BenchJob::sumLate(0);
+std::atomic<long long> BenchJob::maxLate(0);
+
+double Elapsed(Clock::time_point beg)
+{
+   return std::chrono::duration<double, std::nano>(Clock::now() - beg).count();
+}
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+  
+int main(int argc, char **argv)
+{
+   std::vector<int> sizes;
+   std::mt19937 rng(1234);
+   XrdScheduler *sched = new XrdScheduler(3, 64, 0);
+   time_t now = time(0);
+
+   for (int i = 1; i < argc; i++) sizes.push_back(atoi(argv[i]));
+   if (sizes.empty()) sizes = {1000, 10000, 30000};
+
+// Insert n timed jobs with random times between 1 second and 1 hour from
+// now and then cancel them in random order.
+//
+   printf("%8s %14s %14s %14s %14s\n", "jobs", "list ins ns", "list can ns",
+          "wheel ins ns", "wheel can ns");
+   for (int n : sizes)
+       {std::vector<time_t> when(n);
+        std::vector<int>    order(n);
+        for (int i = 0; i < n; i++)
+            {when[i] = now + 1 + rng() % 3600; order[i] = i;}
+        std::shuffle(order.begin(), order.end(), rng);
+
+        ListTimer lTimer;
+        std::vector<ListTimer::Item> items(n);
+        Clock::time_point beg = Clock::now();
+        for (int i = 0; i < n; i++) lTimer.Schedule(&items[i], when[i]);
+        double lIns = Elapsed(beg)/n;
+        beg = Clock::now();
+        for (int i = 0; i < n; i++) lTimer.Cancel(&items[order[i]]);
+        double lCan = Elapsed(beg)/n;
+
+        std::vector<BenchJob> jobs(n);
+        beg = Clock::now();
+        for (int i = 0; i < n; i++) sched->Schedule(&jobs[i], when[i]);
+        double wIns = Elapsed(beg)/n;
+        beg = Clock::now();
+        for (int i = 0; i < n; i++) sched->Cancel(&jobs[order[i]]);
+        double wCan = Elapsed(beg)/n;
+
+        printf("%8d %14.1f %14.1f %14.1f %14.1f\n", n, lIns, lCan, wIns, wCan);
+       }
+
+// Now run jobs with delays of up to two seconds and see how late they are
+//
+   const int nRun = 2000;
+   std::vector<BenchJob> jobs(nRun);
+   sched->Start();
+   for (int i = 0; i < nRun; i++)
+       {int msec = rng() % 2000;
+        jobs[i].due = Clock::now() + std::chrono::milliseconds(msec);
+        sched->ScheduleIn(&jobs[i], msec);
+       }
+   for (int i = 0; i < 40 && BenchJob::numRun < nRun; i++) usleep(100000);
+
+   printf("ran %lld of %d timed jobs; lateness avg %lld us max %lld us\n",
+          BenchJob::numRun.load(), nRun,
+          (BenchJob::numRun ? BenchJob::sumLate/BenchJob::numRun : 0LL),
+          BenchJob::maxLate.load());
+   return (BenchJob::numRun == nRun ? 0 : 1);
+}
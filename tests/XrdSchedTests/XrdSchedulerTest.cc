@@ -0,0 +1,288 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// This file is part of the XRootD software suite.
+//
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//
+// In applying this licence, CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//------------------------------------------------------------------------------
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "Xrd/XrdJob.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdSys/XrdSysTimer.hh"
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Declaration
+//------------------------------------------------------------------------------
+class XrdSchedulerTest: public CppUnit::TestCase
+{
+  public:
+    CPPUNIT_TEST_SUITE( XrdSchedulerTest );
+      CPPUNIT_TEST( ScheduleTest );
+      CPPUNIT_TEST( TimedTest );
+      CPPUNIT_TEST( CancelTest );
+      CPPUNIT_TEST( RescheduleTest );
+      CPPUNIT_TEST( ManyTimedTest );
+    CPPUNIT_TEST_SUITE_END();
+    void setUp();
+    void ScheduleTest();
+    void TimedTest();
+    void CancelTest();
+    void RescheduleTest();
+    void ManyTimedTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( XrdSchedulerTest );
+
+namespace
+{
+  typedef std::chrono::steady_clock Clock;
+
+  //----------------------------------------------------------------------------
+  // How late (msec) a job may run on a loaded machine before a test fails
+  //----------------------------------------------------------------------------
+  const int Slack = 1500;
+
+  //----------------------------------------------------------------------------
+  // Wait up to msec milliseconds for a count to reach a value
+  //----------------------------------------------------------------------------
+  bool WaitFor( std::atomic<int> &count, int want, int msec )
+  {
+    for( int i = 0; i < msec / 5 && count < want; ++i )
+      XrdSysTimer::Wait( 5 );
+    return count == want;
+  }
+
+  //----------------------------------------------------------------------------
+  // A job that counts its runs and remembers when it last ran
+  //----------------------------------------------------------------------------
+  class CountJob: public XrdJob
+  {
+    public:
+      CountJob(): XrdJob( "test job" ), runs( 0 ) {}
+
+      void DoIt()
+      {
+        ran = Clock::now();
+        runs++;
+      }
+
+      bool Wait( int msec )
+      {
+        return WaitFor( runs, 1, msec );
+      }
+
+      std::atomic<int>  runs;
+      Clock::time_point ran;
+  };
+
+  //----------------------------------------------------------------------------
+  // A job that counts its runs in a shared counter
+  //----------------------------------------------------------------------------
+  class TallyJob: public XrdJob
+  {
+    public:
+      TallyJob(): XrdJob( "tally job" ), runs( 0 ), total( 0 ) {}
+
+      void DoIt()
+      {
+        runs++;
+        (*total)++;
+      }
+
+      std::atomic<int>  runs;
+      std::atomic<int> *total;
+  };
+
+  long long Since( Clock::time_point start, Clock::time_point end )
+  {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>( end - start ).count();
+  }
+
+  XrdScheduler *Sched = 0;
+}
+
+//------------------------------------------------------------------------------
+// All tests share one scheduler; like the server's it is never deleted
+//------------------------------------------------------------------------------
+void XrdSchedulerTest::setUp()
+{
+  if( !Sched )
+  {
+    Sched = new XrdScheduler( 4, 64, 60 );
+    Sched->Start();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Immediate jobs scheduled one at a time and as a list, from many threads
+//------------------------------------------------------------------------------
+void XrdSchedulerTest::ScheduleTest()
+{
+  const int nThreads = 8, nJobs = 1000;
+  std::atomic<int> total( 0 );
+  std::vector<TallyJob> jobs( nThreads * nJobs );
+  for( auto &job : jobs ) job.total = &total;
+
+  std::vector<std::thread> threads;
+  for( int t = 0; t < nThreads; ++t )
+    threads.emplace_back( [&jobs, t]()
+    {
+      TallyJob *mine = &jobs[t * nJobs];
+      if( t & 1 )
+        for( int i = 0; i < nJobs; ++i ) Sched->Schedule( &mine[i] );
+      else
+        for( int i = 0; i < nJobs; i += 10 )
+        {
+          for( int k = i; k < i + 9; ++k ) mine[k].NextJob = &mine[k+1];
+          Sched->Schedule( 10, &mine[i], &mine[i+9] );
+        }
+    } );
+  for( auto &thread : threads ) thread.join();
+
+  CPPUNIT_ASSERT( WaitFor( total, nThreads * nJobs, 10000 ) );
+  for( auto &job : jobs ) CPPUNIT_ASSERT( job.runs == 1 );
+}
+
+//------------------------------------------------------------------------------
+// Timed jobs run once, not before they are due, including delays that have
+// to move down from the higher levels of the wheel
+//------------------------------------------------------------------------------
+void XrdSchedulerTest::TimedTest()
+{
+  const int delays[] = { 0, 1, 5, 50, 255, 256, 300, 1100 };
+  const int nJobs = sizeof( delays ) / sizeof( delays[0] );
+  CountJob jobs[nJobs];
+
+  Clock::time_point start = Clock::now();
+  for( int i = 0; i < nJobs; ++i ) Sched->ScheduleIn( &jobs[i], delays[i] );
+
+  for( int i = 0; i < nJobs; ++i )
+  {
+    CPPUNIT_ASSERT( jobs[i].Wait( delays[i] + 2000 ) );
+    CPPUNIT_ASSERT( Since( start, jobs[i].ran ) >= delays[i] );
+  }
+
+  // Wall clock times are whole seconds
+  CountJob job;
+  start = Clock::now();
+  Sched->Schedule( &job, time( 0 ) + 1 );
+  CPPUNIT_ASSERT( job.Wait( 2000 + Slack ) );
+  CPPUNIT_ASSERT( Since( start, job.ran ) <= 2000 + Slack );
+
+  XrdSysTimer::Wait( 100 );
+  for( int i = 0; i < nJobs; ++i ) CPPUNIT_ASSERT( jobs[i].runs == 1 );
+  CPPUNIT_ASSERT( job.runs == 1 );
+}
+
+//------------------------------------------------------------------------------
+// Cancelled jobs do not run; cancelling jobs that are not timed is harmless
+//------------------------------------------------------------------------------
+void XrdSchedulerTest::CancelTest()
+{
+  CountJob near, far, kept, never;
+
+  Sched->ScheduleIn( &near, 100 );
+  Sched->ScheduleIn( &far, 70000 );
+  Sched->ScheduleIn( &kept, 150 );
+  Sched->Cancel( &near );
+  Sched->Cancel( &far );
+  Sched->Cancel( &far );
+  Sched->Cancel( &never );
+
+  // A job that has already run is no longer on the wheel
+  CPPUNIT_ASSERT( kept.Wait( 2000 ) );
+  Sched->Cancel( &kept );
+
+  XrdSysTimer::Wait( 200 );
+  CPPUNIT_ASSERT( near.runs == 0 );
+  CPPUNIT_ASSERT( far.runs == 0 );
+  CPPUNIT_ASSERT( kept.runs == 1 );
+  CPPUNIT_ASSERT( never.runs == 0 );
+
+  // Cancelled jobs can be scheduled again
+  Sched->ScheduleIn( &near, 10 );
+  CPPUNIT_ASSERT( near.Wait( 2000 ) );
+  CPPUNIT_ASSERT( near.runs == 1 );
+}
+
+//------------------------------------------------------------------------------
+// Scheduling a timed job again moves it instead of adding it twice
+//------------------------------------------------------------------------------
+void XrdSchedulerTest::RescheduleTest()
+{
+  CountJob later, sooner;
+
+  Clock::time_point start = Clock::now();
+  Sched->ScheduleIn( &later, 50 );
+  Sched->ScheduleIn( &later, 400 );
+  Sched->ScheduleIn( &sooner, 5000 );
+  Sched->ScheduleIn( &sooner, 20 );
+
+  // It must not still be waiting for the first time it was given
+  CPPUNIT_ASSERT( sooner.Wait( 5000 - Slack ) );
+  CPPUNIT_ASSERT( Since( start, sooner.ran ) < 5000 - Slack );
+  CPPUNIT_ASSERT( later.Wait( 2000 ) );
+  CPPUNIT_ASSERT( Since( start, later.ran ) >= 400 );
+
+  XrdSysTimer::Wait( 100 );
+  CPPUNIT_ASSERT( later.runs == 1 );
+  CPPUNIT_ASSERT( sooner.runs == 1 );
+}
+
+//------------------------------------------------------------------------------
+// Many timed jobs from many threads, some cancelled, each running at most once
+//------------------------------------------------------------------------------
+void XrdSchedulerTest::ManyTimedTest()
+{
+  const int nThreads = 4, nJobs = 2500;
+  std::atomic<int> total( 0 );
+  std::vector<TallyJob> jobs( nThreads * nJobs );
+  for( auto &job : jobs ) job.total = &total;
+
+  std::vector<std::thread> threads;
+  for( int t = 0; t < nThreads; ++t )
+    threads.emplace_back( [&jobs, t]()
+    {
+      std::mt19937 rng( t );
+      TallyJob *mine = &jobs[t * nJobs];
+      for( int i = 0; i < nJobs; ++i )
+        Sched->ScheduleIn( &mine[i], rng() % 600 );
+      for( int i = 0; i < nJobs; i += 5 )
+        Sched->Cancel( &mine[i] );
+    } );
+  for( auto &thread : threads ) thread.join();
+
+  // Jobs cancelled too late have run; all others must run exactly once
+  XrdSysTimer::Wait( 1000 );
+  int expect = 0;
+  for( int i = 0; i < nThreads * nJobs; ++i )
+  {
+    CPPUNIT_ASSERT( jobs[i].runs <= 1 );
+    if( i % 5 ) CPPUNIT_ASSERT( jobs[i].runs == 1 );
+    expect += jobs[i].runs;
+  }
+  CPPUNIT_ASSERT( total == expect );
+}